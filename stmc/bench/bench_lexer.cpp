@@ -0,0 +1,62 @@
+#include "core/lexer.hpp"
+#include "core/scan.hpp"
+#include "types/input_file.hpp"
+#include "types/token.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace stm {
+
+namespace bench {
+
+/// Returns a synthetic source of roughly |size| bytes with a mix of the
+/// constructs the lexer has fast paths for.
+static std::string make_source(u64 size) {
+    const std::string chunk = 
+        "// Compute the sum of the first n numbers in a loop.\n"
+        "sum_to_n :: (n: i64) -> i64 {\n"
+        "    let total: mut i64 = 0;\n"
+        "    let counter: mut i64 = 0;\n"
+        "    /* The loop body is intentionally trivial. */\n"
+        "    while counter < n {\n"
+        "        total += counter * 3.14159;\n"
+        "        counter += 1;\n"
+        "    }\n"
+        "    print(\"the total of the first n numbers is:\\n\");\n"
+        "    ret total;\n"
+        "}\n\n";
+
+    std::string src;
+    src.reserve(size + chunk.size());
+    while (src.size() < size)
+        src += chunk;
+
+    return src;
+}
+
+static void BM_LexerThroughput(benchmark::State& state) {
+    const std::string src = make_source(state.range(0));
+    InputFile file { "bench" };
+    file.overwrite(src);
+
+    for (auto _ : state) {
+        Lexer lexer { file };
+        u64 count = 0;
+        while (lexer.lex().kind != TOKEN_KIND_END_OF_FILE)
+            count++;
+
+        benchmark::DoNotOptimize(count);
+    }
+
+    // Reported as bytes_per_second, i.e. lexer throughput in MB/s.
+    state.SetBytesProcessed(state.iterations() * src.size());
+    state.SetLabel(scan::isa());
+}
+
+BENCHMARK(BM_LexerThroughput)->Arg(64 << 10)->Arg(8 << 20);
+
+} // namespace bench
+
+} // namespace stm
@@ -0,0 +1,279 @@
+#include "generator.hpp"
+
+#include "core/lexer.hpp"
+#include "siir/cfg.hpp"
+#include "siir/machine_analysis.hpp"
+#include "siir/machine_object.hpp"
+#include "siir/ssa_rewrite_pass.hpp"
+#include "siir/target.hpp"
+#include "tree/parser.hpp"
+#include "tree/root.hpp"
+#include "tree/visitor.hpp"
+#include "types/input_file.hpp"
+#include "types/options.hpp"
+#include "types/token.hpp"
+#include "types/translation_unit.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stm {
+
+namespace bench {
+
+/// The phases of the pipeline that are benchmarked, in the order they run.
+enum class Phase : u8 {
+    Lex,
+    Parse,
+    SymbolAnalysis,
+    SemanticAnalysis,
+    Codegen,
+    SSARewrite,
+    InstSelection,
+    RegisterAllocation,
+    AsmWriter,
+};
+
+/// A compilation of a single unit that can be taken up to any phase.
+///
+/// The machine phases lower the graph as codegen left it, without the SIIR
+/// passes, since the native backend cannot yet spill the values that they
+/// promote to registers when many of them are live at once.
+class Pipeline final {
+    InputFile m_file { "bench" };
+    Options m_opts {};
+    siir::Target m_target {
+        siir::Target::x64, siir::Target::SystemV, siir::Target::Linux
+    };
+
+    std::unique_ptr<TranslationUnit> m_unit = nullptr;
+    std::unique_ptr<siir::CFG> m_graph = nullptr;
+    std::unique_ptr<siir::MachineObject> m_obj = nullptr;
+
+public:
+    Pipeline(const std::string& source) { m_file.overwrite(source); }
+
+    /// Drop the results of all phases run so far.
+    void reset() {
+        m_obj = nullptr;
+        m_graph = nullptr;
+        m_unit = nullptr;
+    }
+
+    /// Run |phase|, which must come directly after the last phase run.
+    void run(Phase phase) {
+        switch (phase) {
+        case Phase::Lex: {
+            Lexer lexer { m_file };
+            u64 count = 0;
+            while (lexer.lex().kind != TOKEN_KIND_END_OF_FILE)
+                count++;
+
+            benchmark::DoNotOptimize(count);
+            break;
+        }
+
+        case Phase::Parse: {
+            m_unit = std::make_unique<TranslationUnit>(m_file);
+            Parser parser { m_file };
+            parser.parse(*m_unit);
+            m_unit->get_root().validate();
+            break;
+        }
+
+        case Phase::SymbolAnalysis: {
+            SymbolAnalysis syma { m_opts, m_unit->get_root() };
+            m_unit->get_root().accept(syma);
+            break;
+        }
+
+        case Phase::SemanticAnalysis: {
+            SemanticAnalysis sema { m_opts, m_unit->get_root() };
+            m_unit->get_root().accept(sema);
+            break;
+        }
+
+        case Phase::Codegen: {
+            m_graph = std::make_unique<siir::CFG>(m_file, m_target);
+            Codegen cgn { m_opts, m_unit->get_root(), *m_graph };
+            m_unit->get_root().accept(cgn);
+            break;
+        }
+
+        case Phase::SSARewrite: {
+            siir::SSARewritePass SSAR { *m_graph };
+            SSAR.run();
+            break;
+        }
+
+        case Phase::InstSelection: {
+            m_obj = std::make_unique<siir::MachineObject>(
+                m_graph.get(), &m_target);
+            siir::CFGMachineAnalysis CMA { *m_graph };
+            CMA.run(*m_obj);
+            break;
+        }
+
+        case Phase::RegisterAllocation: {
+            siir::FunctionRegisterAnalysis FRA { *m_obj };
+            FRA.run();
+            break;
+        }
+
+        case Phase::AsmWriter: {
+            std::ostringstream os;
+            siir::MachineObjectAsmWriter writer { *m_obj };
+            writer.run(os);
+            benchmark::DoNotOptimize(os.tellp());
+            break;
+        }
+        }
+    }
+
+    /// Run every phase that |phase| depends on, from scratch.
+    void run_until(Phase phase) {
+        reset();
+        for (u8 prev = 0; prev != static_cast<u8>(phase); ++prev) {
+            // Lexing is part of parsing, and the SIIR passes are skipped on
+            // the way to the machine phases.
+            if (prev == static_cast<u8>(Phase::Lex) ||
+              prev == static_cast<u8>(Phase::SSARewrite))
+                continue;
+
+            run(static_cast<Phase>(prev));
+        }
+    }
+};
+
+/// Benchmarks |phase| alone over a program of |shape|, with a size of the
+/// benchmark argument. Every iteration runs the phases before it afresh,
+/// which is kept out of the timings.
+static void BM_Phase(benchmark::State& state, Phase phase, Shape shape) {
+    const u32 size = state.range(0);
+    Pipeline pipeline { SourceGenerator().generate(shape, size) };
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        pipeline.run_until(phase);
+        state.ResumeTiming();
+
+        pipeline.run(phase);
+    }
+
+    state.SetComplexityN(size);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+/// Parses, links, and analyzes a graph of files as large as the benchmark
+/// argument, where each file uses up to 4 of the others.
+static void BM_ImportGraph(benchmark::State& state) {
+    const u32 count = state.range(0);
+    const std::vector<GeneratedFile> sources =
+        SourceGenerator().import_graph(count, 4);
+    Options opts {};
+
+    std::vector<std::unique_ptr<InputFile>> files;
+    for (const GeneratedFile& source : sources) {
+        files.push_back(std::make_unique<InputFile>(source.name.c_str()));
+        files.back()->overwrite(source.source);
+    }
+
+    std::vector<std::unique_ptr<TranslationUnit>> units;
+    for (auto _ : state) {
+        state.PauseTiming();
+        units.clear();
+        state.ResumeTiming();
+
+        std::unordered_map<std::string, TranslationUnit*> names;
+        for (u32 idx = 0; idx != count; ++idx) {
+            units.push_back(std::make_unique<TranslationUnit>(*files[idx]));
+            Parser parser { *files[idx] };
+            parser.parse(*units.back());
+            names.emplace(sources[idx].name, units.back().get());
+        }
+
+        // Files only use the files before them, so a single pass in order
+        // links every use.
+        for (auto& unit : units) {
+            Root& root = unit->get_root();
+            for (auto& use : root.uses()) {
+                TranslationUnit* dep = names.at(use->path() + ".stm");
+                use->resolve(dep);
+
+                for (auto& exp : dep->get_root().exports()) {
+                    root.imports().push_back(exp);
+                    root.get_scope()->add(exp);
+                }
+            }
+        }
+
+        for (auto& unit : units) {
+            Root& root = unit->get_root();
+            root.validate();
+
+            SymbolAnalysis syma { opts, root };
+            root.accept(syma);
+
+            SemanticAnalysis sema { opts, root };
+            root.accept(sema);
+        }
+    }
+
+    state.SetComplexityN(count);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Registers a benchmark of |phase| for every shape of program, each over a
+/// range of sizes wide enough for its complexity to be fit.
+static bool register_phase(const char* name, Phase phase) {
+    struct Sizes final {
+        const char* name;
+        Shape shape;
+        u32 min;
+        u32 max;
+    };
+
+    // Nesting is kept shallow, since the analyses recurse over it.
+    static constexpr Sizes shapes[] = {
+        { "wide", Shape::Wide, 256, 4096 },
+        { "long", Shape::Long, 1024, 16384 },
+        { "deep", Shape::Deep, 16, 128 },
+        { "locals", Shape::Locals, 256, 4096 },
+    };
+
+    for (const Sizes& sizes : shapes) {
+        benchmark::RegisterBenchmark(
+            (std::string(name) + '/' + sizes.name).c_str(), BM_Phase, phase,
+            sizes.shape)
+            ->RangeMultiplier(2)->Range(sizes.min, sizes.max)
+            ->Complexity()
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    return true;
+}
+
+[[maybe_unused]] static const bool registered =
+    register_phase("Lexer", Phase::Lex) &&
+    register_phase("Parser", Phase::Parse) &&
+    register_phase("SymbolAnalysis", Phase::SymbolAnalysis) &&
+    register_phase("SemanticAnalysis", Phase::SemanticAnalysis) &&
+    register_phase("Codegen", Phase::Codegen) &&
+    register_phase("SSARewritePass", Phase::SSARewrite) &&
+    register_phase("X64InstSelection", Phase::InstSelection) &&
+    register_phase("RegisterAllocation", Phase::RegisterAllocation) &&
+    register_phase("X64AsmWriter", Phase::AsmWriter);
+
+BENCHMARK(BM_ImportGraph)
+    ->RangeMultiplier(2)->Range(32, 512)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace bench
+
+} // namespace stm
@@ -0,0 +1,102 @@
+#include "core/thread_pool.hpp"
+#include "siir/cfg.hpp"
+#include "siir/ssa_rewrite_pass.hpp"
+#include "siir/target.hpp"
+#include "siir/trivial_dce_pass.hpp"
+#include "tree/parser.hpp"
+#include "tree/root.hpp"
+#include "tree/visitor.hpp"
+#include "types/input_file.hpp"
+#include "types/options.hpp"
+#include "types/translation_unit.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+namespace stm {
+
+namespace bench {
+
+/// The number of functions in the synthetic unit.
+static constexpr u32 FUNCTIONS = 10000;
+
+/// Returns a synthetic source with |count| functions, each with a local that
+/// is written on both sides of branches, so that promoting it needs phis and
+/// leaves dead code behind.
+static std::string make_source(u32 count) {
+    std::string src;
+    src.reserve(count * 256);
+
+    for (u32 idx = 0; idx != count; ++idx) {
+        const std::string n = std::to_string(idx);
+        src += "f" + n + " :: (x: s64, y: s64) -> s64 {\n"
+            "    let a: mut s64 = x;\n"
+            "    let z: f64 = 2.5;\n"
+            "    if a < " + n + " { a = a * 3; }\n"
+            "    else { a = a + y; }\n"
+            "    if a > 100 { a = a - cast<s64>(z); }\n"
+            "    if a == y { a = 0; }\n"
+            "    ret a;\n"
+            "}\n";
+    }
+
+    return src;
+}
+
+/// Runs the O1 SIIR passes over a unit of |FUNCTIONS| functions, on a pool of
+/// as many threads as the benchmark argument. Each iteration lowers the unit
+/// afresh, which is kept out of the timings.
+static void BM_FunctionPasses(benchmark::State& state) {
+    const u32 threads = state.range(0);
+    InputFile file { "bench" };
+    file.overwrite(make_source(FUNCTIONS));
+    Options opts {};
+    siir::Target target {
+        siir::Target::x64, siir::Target::SystemV, siir::Target::Linux
+    };
+    ThreadPool pool { threads };
+
+    std::unique_ptr<TranslationUnit> unit = nullptr;
+    std::unique_ptr<siir::CFG> graph = nullptr;
+    for (auto _ : state) {
+        state.PauseTiming();
+        graph = nullptr;
+        unit = std::make_unique<TranslationUnit>(file);
+
+        Parser parser { file };
+        parser.parse(*unit);
+        Root& root = unit->get_root();
+        root.validate();
+
+        SymbolAnalysis syma { opts, root };
+        root.accept(syma);
+
+        SemanticAnalysis sema { opts, root };
+        root.accept(sema);
+
+        graph = std::make_unique<siir::CFG>(file, target);
+        Codegen cgn { opts, root, *graph };
+        root.accept(cgn);
+        state.ResumeTiming();
+
+        siir::SSARewritePass SSAR { *graph, &pool };
+        SSAR.run();
+
+        siir::TrivialDCEPass TDCE { *graph, &pool };
+        TDCE.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * FUNCTIONS);
+}
+
+BENCHMARK(BM_FunctionPasses)
+    ->ArgName("threads")
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace bench
+
+} // namespace stm
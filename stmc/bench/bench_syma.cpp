@@ -0,0 +1,81 @@
+#include "tree/parser.hpp"
+#include "tree/root.hpp"
+#include "tree/visitor.hpp"
+#include "types/input_file.hpp"
+#include "types/options.hpp"
+#include "types/translation_unit.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+namespace stm {
+
+namespace bench {
+
+/// The number of blocks nested inside of each other in the synthetic source.
+static constexpr u32 DEPTH = 64;
+
+/// Returns a synthetic source with |count| global variables, and a function
+/// that references each of them once from the innermost of |DEPTH| nested
+/// blocks, so that every reference must walk the whole scope chain.
+static std::string make_source(u32 count) {
+    std::string src;
+    src.reserve(count * 64);
+
+    for (u32 idx = 0; idx != count; ++idx)
+        src += "global_" + std::to_string(idx) + " :: s64 = 0;\n";
+
+    src += "bench :: () -> s64 {\n";
+    src += "    let total: mut s64 = 0;\n";
+    for (u32 d = 0; d != DEPTH; ++d)
+        src += "{\n";
+
+    for (u32 idx = 0; idx != count; ++idx)
+        src += "total = total + global_" + std::to_string(idx) + ";\n";
+
+    for (u32 d = 0; d != DEPTH; ++d)
+        src += "}\n";
+
+    src += "    ret total;\n}\n";
+    return src;
+}
+
+/// Parses a unit with many globals and deeply nested references, and runs
+/// symbol analysis over it. This covers every scope insertion made by the
+/// parser as well as every lookup made to resolve references.
+static void BM_ScopeResolution(benchmark::State& state) {
+    const u32 count = state.range(0);
+    InputFile file { "bench" };
+    file.overwrite(make_source(count));
+    Options opts {};
+
+    std::unique_ptr<TranslationUnit> unit = nullptr;
+    for (auto _ : state) {
+        // Keep the teardown of the last tree out of the timings.
+        state.PauseTiming();
+        unit = std::make_unique<TranslationUnit>(file);
+        state.ResumeTiming();
+
+        Parser parser { file };
+        parser.parse(*unit);
+        Root& root = unit->get_root();
+        root.validate();
+
+        SymbolAnalysis syma { opts, root };
+        root.accept(syma);
+    }
+
+    state.SetComplexityN(count);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_ScopeResolution)
+    ->RangeMultiplier(2)->Range(3125, 50000)
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace bench
+
+} // namespace stm
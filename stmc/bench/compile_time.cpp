@@ -0,0 +1,339 @@
+#include "generator.hpp"
+#include "runner.hpp"
+
+#include "core/logger.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using namespace stm;
+using namespace stm::bench;
+
+/// The number of copies of the samples in the scaled up samples case.
+static constexpr u32 SAMPLE_COPIES = 8;
+
+/// A program of the corpus, compiled as one invocation of stmc.
+struct Case final {
+    std::string name;
+
+    /// The source files of the program, relative to the directory of the
+    /// case.
+    std::vector<std::string> files;
+};
+
+/// The measurements of one compilation of a case.
+struct Measurement final {
+    bool ok = false;
+    f64 wall_ms = 0;
+    i64 rss_kb = 0;
+    u64 object_bytes = 0;
+};
+
+/// Write |source| to the file at |path|, creating its directory if needed.
+static void write_file(const fs::path& path, const std::string& source) {
+    fs::create_directories(path.parent_path());
+    std::ofstream file(path);
+    if (!file.is_open())
+        Logger::fatal("could not write corpus file: '" + path.string() + "'");
+
+    file << source;
+}
+
+/// Write the corpus into |work| and return its cases. The samples come from
+/// |samples|, and the rest are generated.
+static std::vector<Case> write_corpus(const fs::path& work,
+                                      const fs::path& samples) {
+    static constexpr const char* sample_files[] = {
+        "natives.stm", "mem.stm", "string.stm", "file.stm"
+    };
+
+    std::vector<Case> cases;
+
+    // The samples as they are, and scaled up by compiling many copies of
+    // them at once.
+    Case original { "samples" };
+    Case scaled { "samples-x" + std::to_string(SAMPLE_COPIES) };
+    for (const char* name : sample_files) {
+        std::ifstream file(samples / name);
+        if (!file.is_open()) {
+            Logger::fatal("could not read sample: '" +
+                (samples / name).string() + "'");
+        }
+
+        std::stringstream source;
+        source << file.rdbuf();
+
+        write_file(work / original.name / name, source.str());
+        original.files.push_back(name);
+
+        for (u32 copy = 0; copy != SAMPLE_COPIES; ++copy) {
+            const std::string path = "copy" + std::to_string(copy) + "/" +
+                name;
+            write_file(work / scaled.name / path, source.str());
+            scaled.files.push_back(path);
+        }
+    }
+
+    cases.push_back(std::move(original));
+    cases.push_back(std::move(scaled));
+
+    // The generated stress programs.
+    SourceGenerator generator;
+    const std::pair<const char*, std::string> generated[] = {
+        { "wide", generator.wide(1000) },
+        { "long", generator.long_function(4000) },
+        { "deep", generator.deep(64) },
+        { "locals", generator.locals(500) },
+    };
+
+    for (const auto& [name, source] : generated) {
+        write_file(work / name / "main.stm", source);
+        cases.push_back({ name, { "main.stm" } });
+    }
+
+    Case imports { "imports" };
+    for (GeneratedFile& file : generator.import_graph(128, 4)) {
+        write_file(work / imports.name / file.name, file.source);
+        imports.files.push_back(file.name);
+    }
+
+    cases.push_back(std::move(imports));
+    return cases;
+}
+
+/// Returns the total size of the objects under |dir|, removing them.
+static u64 collect_objects(const fs::path& dir) {
+    u64 size = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".o") {
+            size += entry.file_size();
+            fs::remove(entry.path());
+        }
+    }
+
+    return size;
+}
+
+/// Compile |c| in |dir| with |stmc| and |flags|, |repeat| times, keeping the
+/// fastest run.
+static Measurement measure(const std::string& stmc, const fs::path& dir,
+                           const Case& c, const std::vector<std::string>& flags,
+                           u32 repeat) {
+    std::vector<std::string> args { stmc, "-c" };
+    args.insert(args.end(), flags.begin(), flags.end());
+    args.insert(args.end(), c.files.begin(), c.files.end());
+
+    Measurement best {};
+    for (u32 run = 0; run != repeat; ++run) {
+        collect_objects(dir);
+
+        RunResult result = run_process(args, dir);
+        Measurement curr {};
+        curr.ok = result.ok;
+        curr.wall_ms = result.wall / 1e6;
+        curr.rss_kb = result.rss;
+        curr.object_bytes = collect_objects(dir);
+
+        if (!curr.ok)
+            return curr;
+
+        if (run == 0 || curr.wall_ms < best.wall_ms)
+            best = curr;
+    }
+
+    return best;
+}
+
+/// Read the baseline at |path| into |baseline|, keyed by the case, level
+/// and backend of each measurement. A missing baseline is left empty.
+static void read_baseline(const fs::path& path,
+                          std::map<std::string, Measurement>& baseline) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream is(line);
+        std::string name, level, backend, status;
+        Measurement m {};
+        if (!(is >> name >> level >> backend >> status >> m.wall_ms >>
+          m.rss_kb >> m.object_bytes)) {
+            Logger::fatal("invalid baseline line: '" + line + "'");
+        }
+
+        m.ok = status == "ok";
+        baseline[name + ' ' + level + ' ' + backend] = m;
+    }
+}
+
+/// Write |results| to the baseline at |path|.
+static void write_baseline(const fs::path& path,
+                           const std::map<std::string, Measurement>& results) {
+    std::ofstream file(path);
+    if (!file.is_open())
+        Logger::fatal("could not write baseline: '" + path.string() + "'");
+
+    file << "# stmc compile-time baseline, written by stmc_compile_bench "
+        "-update.\n";
+    file << "# Times are machine dependent, so update this file on the "
+        "machine that\n# is checked against it.\n";
+    file << "# case level backend status wall_ms rss_kb object_bytes\n";
+    file << std::fixed << std::setprecision(2);
+    for (const auto& [key, m] : results) {
+        file << key << ' ' << (m.ok ? "ok" : "fail") << ' ' << m.wall_ms <<
+            ' ' << m.rss_kb << ' ' << m.object_bytes << '\n';
+    }
+}
+
+/// Returns the change from |base| to |curr| as a signed percentage.
+static std::string delta(f64 base, f64 curr) {
+    if (base == 0)
+        return "";
+
+    std::ostringstream os;
+    os << std::showpos << std::fixed << std::setprecision(0) <<
+        (curr - base) / base * 100 << '%';
+    return os.str();
+}
+
+/// Compiles the corpus with stmc at every optimization level, on both the
+/// native and LLVM backends, and compares the wall time, peak RSS and object
+/// size of each compilation against the baseline. Exits with 1 if any of them
+/// grew beyond the tolerance, or if a compilation that passed now fails.
+///
+/// usage: stmc_compile_bench [-stmc <path>] [-baseline <file>] [-work <dir>]
+///                           [-tolerance <percent>] [-repeat <n>] [-update]
+i32 main(i32 argc, char** argv) {
+    Logger::init();
+
+    std::string stmc = STMC_SOURCE_DIR "/stmc";
+    fs::path baseline_path = STMC_SOURCE_DIR "/bench/compile_time.baseline";
+    fs::path work = fs::temp_directory_path() / "stmc-compile-bench";
+    f64 tolerance = 10;
+    u32 repeat = 3;
+    bool update = false;
+
+    for (i32 i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-update") {
+            update = true;
+            continue;
+        }
+
+        if (++i >= argc)
+            Logger::fatal("expected value after '" + arg + "' argument");
+
+        if (arg == "-stmc") {
+            stmc = fs::absolute(argv[i]).string();
+        } else if (arg == "-baseline") {
+            baseline_path = argv[i];
+        } else if (arg == "-work") {
+            work = fs::absolute(argv[i]);
+        } else if (arg == "-tolerance") {
+            tolerance = std::stod(argv[i]);
+        } else if (arg == "-repeat") {
+            repeat = std::max(1, std::stoi(argv[i]));
+        } else {
+            Logger::fatal("unrecognized argument: '" + arg + "'");
+        }
+    }
+
+    if (!fs::exists(stmc))
+        Logger::fatal("stmc not found: '" + stmc + "'");
+
+    fs::remove_all(work);
+    const std::vector<Case> cases = write_corpus(
+        work, STMC_SOURCE_DIR "/samples");
+
+    std::map<std::string, Measurement> baseline;
+    if (!update)
+        read_baseline(baseline_path, baseline);
+
+    std::cout << std::left << std::setw(14) << "case" << std::setw(4) <<
+        "opt" << std::setw(8) << "backend" << std::right <<
+        std::setw(16) << "wall (ms)" << std::setw(18) << "rss (kB)" <<
+        std::setw(20) << "object (B)" << '\n';
+
+    std::map<std::string, Measurement> results;
+    u32 regressions = 0;
+    for (const Case& c : cases) {
+        for (u32 level = 0; level <= 3; ++level) {
+            for (bool llvm : { false, true }) {
+                std::vector<std::string> flags { "-O" + std::to_string(level) };
+                if (llvm)
+                    flags.push_back("-ll");
+
+                const std::string key = c.name + " O" + std::to_string(level) +
+                    ' ' + (llvm ? "llvm" : "native");
+                const Measurement m = measure(
+                    stmc, work / c.name, c, flags, repeat);
+                results[key] = m;
+
+                std::cout << std::left << std::setw(14) << c.name <<
+                    std::setw(4) << flags[0] << std::setw(8) <<
+                    (llvm ? "llvm" : "native") << std::right;
+
+                auto base = baseline.find(key);
+                if (!m.ok) {
+                    std::cout << "  failed";
+                    if (base != baseline.end() && base->second.ok) {
+                        std::cout << "  REGRESSION";
+                        regressions++;
+                    }
+
+                    std::cout << '\n';
+                    continue;
+                }
+
+                const bool compare = base != baseline.end() &&
+                    base->second.ok;
+                const bool fixed = base != baseline.end() && !base->second.ok;
+                const Measurement b = compare ? base->second : Measurement {};
+                const f64 limit = 1 + tolerance / 100;
+
+                std::cout << std::fixed << std::setprecision(2) <<
+                    std::setw(10) << m.wall_ms << std::setw(6) <<
+                    delta(b.wall_ms, m.wall_ms) << std::setw(12) << m.rss_kb <<
+                    std::setw(6) << delta(b.rss_kb, m.rss_kb) <<
+                    std::setw(14) << m.object_bytes << std::setw(6) <<
+                    delta(b.object_bytes, m.object_bytes);
+
+                if (compare && (m.wall_ms > b.wall_ms * limit ||
+                  m.rss_kb > b.rss_kb * limit ||
+                  m.object_bytes > b.object_bytes * limit)) {
+                    std::cout << "  REGRESSION";
+                    regressions++;
+                } else if (fixed) {
+                    std::cout << "  FIXED";
+                }
+
+                std::cout << '\n';
+            }
+        }
+    }
+
+    if (update) {
+        write_baseline(baseline_path, results);
+        std::cout << "wrote baseline: " << baseline_path.string() << '\n';
+        return 0;
+    }
+
+    if (regressions != 0) {
+        std::cout << std::defaultfloat << regressions <<
+            " regression(s) beyond " << tolerance <<
+            "% of the baseline\n";
+        return 1;
+    }
+
+    return 0;
+}
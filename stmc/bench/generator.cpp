@@ -0,0 +1,174 @@
+#include "generator.hpp"
+
+#include <cassert>
+
+using namespace stm;
+using namespace stm::bench;
+
+/// The number of mutable locals that long functions cycle through.
+static constexpr u32 LONG_LOCALS = 4;
+
+/// The signature of the main function that every program ends with.
+static constexpr const char* MAIN_BEGIN =
+    "main :: (argc: s64, argv: **char) -> s64 {\n";
+
+const char* SourceGenerator::binop() {
+    static constexpr const char* ops[] = { "+", "-", "*" };
+    return ops[next(3)];
+}
+
+std::string SourceGenerator::generate(Shape shape, u32 size) {
+    switch (shape) {
+    case Shape::Wide:
+        return wide(size);
+    case Shape::Long:
+        return long_function(size);
+    case Shape::Deep:
+        return deep(size);
+    case Shape::Locals:
+        return locals(size);
+    }
+
+    assert(false && "unknown program shape!");
+    return "";
+}
+
+std::string SourceGenerator::wide(u32 count) {
+    assert(count != 0 && "program must have a function!");
+
+    std::string src;
+    src.reserve(count * 192);
+
+    for (u32 idx = 0; idx != count; ++idx) {
+        const std::string n = std::to_string(idx);
+        src += "f" + n + " :: (x: s64, y: s64) -> s64 {\n";
+        src += "    let a: mut s64 = x " + std::string(binop()) + " " +
+            std::to_string(next(100)) + ";\n";
+        src += "    if a < y { a = a " + std::string(binop()) + " y; }\n";
+        src += "    else { a = a " + std::string(binop()) + " " + n + "; }\n";
+
+        if (idx != 0)
+            src += "    a = a + f" + std::to_string(idx - 1) + "(y, a);\n";
+
+        src += "    ret a;\n}\n\n";
+    }
+
+    src += MAIN_BEGIN;
+    src += "    ret f" + std::to_string(count - 1) + "(1, 2);\n}\n";
+    return src;
+}
+
+std::string SourceGenerator::long_function(u32 count) {
+    std::string src;
+    src.reserve(count * 32 + 256);
+
+    src += "long :: (x: s64) -> s64 {\n";
+    for (u32 idx = 0; idx != LONG_LOCALS; ++idx) {
+        src += "    let v" + std::to_string(idx) + ": mut s64 = x + " +
+            std::to_string(idx) + ";\n";
+    }
+
+    for (u32 idx = 0; idx != count; ++idx) {
+        src += "    v" + std::to_string(next(LONG_LOCALS)) + " = v" +
+            std::to_string(next(LONG_LOCALS)) + " " + binop() + " v" +
+            std::to_string(next(LONG_LOCALS)) + ";\n";
+    }
+
+    src += "    ret v0 + v1 + v2 + v3;\n}\n\n";
+    src += MAIN_BEGIN;
+    src += "    ret long(1);\n}\n";
+    return src;
+}
+
+std::string SourceGenerator::deep(u32 depth) {
+    std::string src;
+    src.reserve(depth * 96 + 256);
+
+    src += "deep :: (x: s64) -> s64 {\n";
+    src += "    let a: mut s64 = x;\n";
+    for (u32 idx = 0; idx != depth; ++idx) {
+        const std::string indent((idx + 1) * 4, ' ');
+        src += indent + "if a < " + std::to_string(next(1000)) + " {\n";
+        src += indent + "    a = a " + binop() + " " +
+            std::to_string(idx + 1) + ";\n";
+    }
+
+    for (u32 idx = depth; idx != 0; --idx) {
+        const std::string indent(idx * 4, ' ');
+        src += indent + "} else {\n";
+        src += indent + "    a = a - " + std::to_string(idx) + ";\n";
+        src += indent + "}\n";
+    }
+
+    src += "    ret a;\n}\n\n";
+    src += MAIN_BEGIN;
+    src += "    ret deep(1);\n}\n";
+    return src;
+}
+
+std::string SourceGenerator::locals(u32 count) {
+    std::string src;
+    src.reserve(count * 64 + 256);
+
+    src += "locals :: (x: s64) -> s64 {\n";
+    for (u32 idx = 0; idx != count; ++idx) {
+        const std::string prev = idx ? "l" + std::to_string(next(idx)) : "x";
+        src += "    let l" + std::to_string(idx) + ": s64 = " + prev + " " +
+            binop() + " " + std::to_string(next(100)) + ";\n";
+    }
+
+    src += "    let sum: mut s64 = 0;\n";
+    for (u32 idx = 0; idx != count; ++idx)
+        src += "    sum = sum + l" + std::to_string(idx) + ";\n";
+
+    src += "    ret sum;\n}\n\n";
+    src += MAIN_BEGIN;
+    src += "    ret locals(1);\n}\n";
+    return src;
+}
+
+std::vector<GeneratedFile> SourceGenerator::import_graph(u32 count,
+                                                         u32 fanout) {
+    assert(count != 0 && "graph must have a file!");
+
+    std::vector<GeneratedFile> files;
+    files.reserve(count);
+
+    for (u32 idx = 0; idx != count; ++idx) {
+        const std::string n = std::to_string(idx);
+
+        // Pick the files to use, without using any one twice.
+        std::vector<u32> deps;
+        for (u32 tries = 0; tries != fanout && idx != 0; ++tries) {
+            const u32 dep = next(idx);
+            bool seen = false;
+            for (u32 other : deps)
+                seen |= other == dep;
+
+            if (!seen)
+                deps.push_back(dep);
+        }
+
+        std::string src;
+        for (u32 dep : deps)
+            src += "use \"m" + std::to_string(dep) + "\";\n";
+
+        src += "\n$public\ng" + n + " :: (x: s64) -> s64 {\n";
+        src += "    let a: mut s64 = x + " + n + ";\n";
+        for (u32 dep : deps)
+            src += "    a = a " + std::string(binop()) + " g" +
+                std::to_string(dep) + "(x);\n";
+
+        src += "    ret a;\n}\n";
+
+        if (idx + 1 == count) {
+            src += "\n";
+            src += MAIN_BEGIN;
+            src += "    ret g" + n + "(1);\n}\n";
+        }
+
+        files.push_back({ "m" + n + ".stm", std::move(src) });
+    }
+
+    return files;
+}
@@ -0,0 +1,82 @@
+#ifndef STATIM_BENCH_GENERATOR_HPP_
+#define STATIM_BENCH_GENERATOR_HPP_
+
+#include "types/types.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace stm {
+
+namespace bench {
+
+/// A generated source file, named relative to the other files generated with
+/// it.
+struct GeneratedFile final {
+    std::string name;
+    std::string source;
+};
+
+/// The shapes of program that the generator can produce, each of which grows
+/// a different dimension of the compiler's input with its size.
+enum class Shape : u8 {
+    /// Many small functions that call each other.
+    Wide,
+
+    /// One function with a single huge basic block.
+    Long,
+
+    /// One function with deeply nested branches.
+    Deep,
+
+    /// One function with many locals that are all live at once.
+    Locals,
+};
+
+/// Deterministic generator of synthetic programs for benchmarks.
+///
+/// Programs are well-formed, and only use the constructs that every stage of
+/// the native backend supports, so that any stage of the pipeline can be run
+/// over them. Two generators with the same seed produce the same programs.
+class SourceGenerator final {
+    std::mt19937_64 m_rng;
+
+    /// Returns a number in [0, |bound|).
+    u64 next(u64 bound) { return m_rng() % bound; }
+
+    /// Returns a random binary arithmetic operator.
+    const char* binop();
+
+public:
+    SourceGenerator(u64 seed = 0x5ee0) : m_rng(seed) {}
+
+    /// Returns a program of |shape| with a size of |size|, i.e. the number of
+    /// functions, statements, nested blocks or locals.
+    std::string generate(Shape shape, u32 size);
+
+    /// Returns a program of |count| small functions, each of which branches
+    /// and calls the function before it.
+    std::string wide(u32 count);
+
+    /// Returns a program with a function of |count| straight-line statements.
+    std::string long_function(u32 count);
+
+    /// Returns a program with a function of |depth| nested if statements.
+    std::string deep(u32 depth);
+
+    /// Returns a program with a function of |count| locals, all of which are
+    /// read after the last is defined.
+    std::string locals(u32 count);
+
+    /// Returns a program of |count| files, named "m<n>.stm", where each file
+    /// uses up to |fanout| of the files before it and calls into each one.
+    /// The last file is the root of the graph, and defines main.
+    std::vector<GeneratedFile> import_graph(u32 count, u32 fanout);
+};
+
+} // namespace bench
+
+} // namespace stm
+
+#endif // STATIM_BENCH_GENERATOR_HPP_
@@ -0,0 +1,118 @@
+#include "runner.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace stm;
+using namespace stm::bench;
+
+/// Open a counter of the hardware event |config| for the user space of the
+/// process |pid|, which starts counting once the process calls exec. Returns
+/// -1 if the counter could not be opened.
+static i32 open_counter(pid_t pid, u64 config) {
+    struct perf_event_attr attr {};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return ::syscall(SYS_perf_event_open, &attr, pid, -1, -1,
+        PERF_FLAG_FD_CLOEXEC);
+}
+
+/// Read the value of the counter |fd| into |value| and close it. Returns
+/// false if the counter was never opened or could not be read.
+static bool close_counter(i32 fd, u64& value) {
+    if (fd < 0)
+        return false;
+
+    const bool ok = ::read(fd, &value, sizeof(value)) == sizeof(value);
+    ::close(fd);
+    return ok;
+}
+
+RunResult bench::run_process(const std::vector<std::string>& args,
+                             const std::string& dir, bool count) {
+    assert(!args.empty() && "process must have a program!");
+
+    std::vector<char*> argv;
+    for (const std::string& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+
+    argv.push_back(nullptr);
+
+    // The child waits on |gate| until its counters are open, so that they
+    // see all of it from the exec onwards.
+    i32 gate[2];
+    if (::pipe(gate) != 0)
+        return {};
+
+    const auto start = std::chrono::steady_clock::now();
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        char go;
+        ::close(gate[1]);
+        if (::read(gate[0], &go, 1) != 1)
+            ::_exit(127);
+
+        const i32 null = ::open("/dev/null", O_WRONLY);
+        ::dup2(null, STDOUT_FILENO);
+        ::dup2(null, STDERR_FILENO);
+
+        if (::chdir(dir.c_str()) == 0)
+            ::execv(argv[0], argv.data());
+
+        ::_exit(127);
+    }
+
+    ::close(gate[0]);
+
+    RunResult result {};
+    if (pid < 0) {
+        ::close(gate[1]);
+        result.status = -1;
+        return result;
+    }
+
+    i32 cycles = -1;
+    i32 instructions = -1;
+    if (count) {
+        cycles = open_counter(pid, PERF_COUNT_HW_CPU_CYCLES);
+        instructions = open_counter(pid, PERF_COUNT_HW_INSTRUCTIONS);
+    }
+
+    const char go = 1;
+    [[maybe_unused]] const ssize_t written = ::write(gate[1], &go, 1);
+    ::close(gate[1]);
+
+    i32 status = 0;
+    struct rusage usage {};
+    ::wait4(pid, &status, 0, &usage);
+
+    result.wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    result.rss = usage.ru_maxrss;
+
+    result.counted = close_counter(cycles, result.cycles);
+    result.counted &= close_counter(instructions, result.instructions);
+
+    if (WIFEXITED(status)) {
+        result.exited = true;
+        result.status = WEXITSTATUS(status);
+        result.ok = result.status == 0;
+    } else {
+        result.status = WTERMSIG(status);
+        result.ok = false;
+    }
+
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef STATIM_BENCH_RUNNER_HPP_
+#define STATIM_BENCH_RUNNER_HPP_
+
+#include "types/types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace stm {
+
+namespace bench {
+
+/// The outcome of a single run of a child process.
+struct RunResult final {
+    /// True if the process exited normally with a status of 0.
+    bool ok;
+
+    /// True if the process exited normally, rather than by a signal.
+    bool exited;
+
+    /// The exit status of the process, or the signal that terminated it.
+    i32 status;
+
+    /// The wall time of the process in nanoseconds.
+    u64 wall;
+
+    /// The peak resident set size of the process in kilobytes.
+    i64 rss;
+
+    /// True if the hardware counters below were read for the process.
+    bool counted;
+
+    /// The CPU cycles and instructions spent by the process in user space.
+    u64 cycles;
+    u64 instructions;
+};
+
+/// Run the program |args| in the directory |dir| with its output discarded,
+/// and wait for it to exit. If |count| is set, the hardware counters of the
+/// process are read as well, if the system allows it.
+RunResult run_process(const std::vector<std::string>& args,
+                      const std::string& dir, bool count = false);
+
+} // namespace bench
+
+} // namespace stm
+
+#endif // STATIM_BENCH_RUNNER_HPP_
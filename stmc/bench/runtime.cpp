@@ -0,0 +1,237 @@
+#include "runner.hpp"
+
+#include "core/logger.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using namespace stm;
+using namespace stm::bench;
+
+/// A compute kernel of the runtime corpus.
+struct Kernel final {
+    const char* name;
+
+    /// The samples that the kernel uses, which are compiled along with it.
+    std::vector<const char*> samples;
+};
+
+/// The kernels of the corpus, each in bench/runtime/<name>.stm.
+static const Kernel kernels[] = {
+    { "int_arith", {} },
+    { "float_arith", {} },
+    { "pointer_chase", {} },
+    { "string_build", { "mem.stm", "string.stm" } },
+    { "alloc_churn", { "mem.stm" } },
+    { "buffered_io", {} },
+};
+
+/// The measurements of the runs of one build of a kernel.
+struct Measurement final {
+    /// Why the build could not be measured, or empty if it was.
+    std::string error = "";
+
+    /// The exit status of the kernel, which every build of it should agree
+    /// on.
+    i32 status = 0;
+
+    /// The fastest run of the kernel.
+    RunResult best {};
+};
+
+/// Copy |from| to |to|, exiting if it cannot be copied.
+static void copy_input(const fs::path& from, const fs::path& to) {
+    std::error_code err;
+    fs::create_directories(to.parent_path());
+    fs::copy_file(from, to, fs::copy_options::overwrite_existing, err);
+    if (err)
+        Logger::fatal("could not copy file: '" + from.string() + "'");
+}
+
+/// Build |kernel| in |dir| with |stmc| and |flags|, and run it |repeat| times,
+/// keeping the fastest run.
+static Measurement measure(const std::string& stmc, const fs::path& dir,
+                           const Kernel& kernel,
+                           const std::vector<std::string>& flags,
+                           u32 repeat) {
+    std::vector<std::string> args { stmc, "-o", "kernel" };
+    args.insert(args.end(), flags.begin(), flags.end());
+    args.push_back(std::string(kernel.name) + ".stm");
+    args.insert(args.end(), kernel.samples.begin(), kernel.samples.end());
+
+    Measurement m {};
+    fs::remove(dir / "kernel");
+    if (!run_process(args, dir).ok) {
+        m.error = "compile failed";
+        return m;
+    }
+
+    const std::string program = (dir / "kernel").string();
+    for (u32 run = 0; run != repeat; ++run) {
+        const RunResult result = run_process({ program }, dir, true);
+        if (!result.exited) {
+            m.error = "crashed (signal " + std::to_string(result.status) + ")";
+            return m;
+        }
+
+        if (run == 0 || result.wall < m.best.wall) {
+            m.status = result.status;
+            m.best = result;
+        }
+    }
+
+    return m;
+}
+
+/// Print |value| scaled down by |scale| with a precision of 2, or a dash if
+/// it was not measured.
+static std::string scaled(bool measured, f64 value, f64 scale) {
+    if (!measured)
+        return "-";
+
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << value / scale;
+    return os.str();
+}
+
+/// Compiles each kernel of the runtime corpus with the native and the LLVM
+/// backend at every optimization level, runs it, and reports the wall time,
+/// cycles and instructions of its fastest run. Native builds are compared to
+/// the LLVM build at the same level, and a build that exits with a different
+/// status than the others of its kernel is reported as a mismatch.
+///
+/// usage: stmc_runtime_bench [-stmc <path>] [-rt <object>] [-work <dir>]
+///                           [-repeat <n>] [-filter <kernel>]
+i32 main(i32 argc, char** argv) {
+    Logger::init();
+
+    std::string stmc = STMC_SOURCE_DIR "/stmc";
+    fs::path rt = STMC_SOURCE_DIR "/std/rt.o";
+    fs::path work = fs::temp_directory_path() / "stmc-runtime-bench";
+    std::string filter = "";
+    u32 repeat = 5;
+
+    for (i32 i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (++i >= argc)
+            Logger::fatal("expected value after '" + arg + "' argument");
+
+        if (arg == "-stmc") {
+            stmc = fs::absolute(argv[i]).string();
+        } else if (arg == "-rt") {
+            rt = fs::absolute(argv[i]);
+        } else if (arg == "-work") {
+            work = fs::absolute(argv[i]);
+        } else if (arg == "-repeat") {
+            repeat = std::max(1, std::stoi(argv[i]));
+        } else if (arg == "-filter") {
+            filter = argv[i];
+        } else {
+            Logger::fatal("unrecognized argument: '" + arg + "'");
+        }
+    }
+
+    if (!fs::exists(stmc))
+        Logger::fatal("stmc not found: '" + stmc + "'");
+
+    if (!fs::exists(rt)) {
+        Logger::fatal("runtime object not found: '" + rt.string() +
+            "', build it from std/rt.c");
+    }
+
+    std::cout << std::left << std::setw(16) << "kernel" << std::setw(4) <<
+        "opt" << std::setw(8) << "backend" << std::right <<
+        std::setw(12) << "wall (ms)" << std::setw(14) << "cycles (M)" <<
+        std::setw(14) << "insts (M)" << std::setw(8) << "ipc" <<
+        std::setw(10) << "vs llvm" << '\n';
+
+    u32 mismatches = 0;
+    for (const Kernel& kernel : kernels) {
+        if (!filter.empty() && filter != kernel.name)
+            continue;
+
+        const fs::path dir = work / kernel.name;
+        fs::remove_all(dir);
+        copy_input(fs::path(STMC_SOURCE_DIR "/bench/runtime") /
+            (std::string(kernel.name) + ".stm"),
+            dir / (std::string(kernel.name) + ".stm"));
+        copy_input(rt, dir / "std" / "rt.o");
+        for (const char* sample : kernel.samples) {
+            copy_input(fs::path(STMC_SOURCE_DIR "/samples") / sample,
+                dir / sample);
+        }
+
+        // The status that builds of this kernel should exit with, taken from
+        // the first build that ran.
+        bool has_status = false;
+        i32 status = 0;
+
+        for (u32 level = 0; level <= 3; ++level) {
+            // The LLVM build runs first, so that the native one can be
+            // compared to it.
+            Measurement llvm {};
+            for (bool is_llvm : { true, false }) {
+                std::vector<std::string> flags { "-O" + std::to_string(level) };
+                if (is_llvm)
+                    flags.push_back("-ll");
+
+                const Measurement m = measure(
+                    stmc, dir, kernel, flags, repeat);
+                if (is_llvm)
+                    llvm = m;
+
+                std::cout << std::left << std::setw(16) << kernel.name <<
+                    std::setw(4) << flags[0] << std::setw(8) <<
+                    (is_llvm ? "llvm" : "native") << std::right;
+
+                if (!m.error.empty()) {
+                    std::cout << "  " << m.error << '\n';
+                    continue;
+                }
+
+                const RunResult& r = m.best;
+                std::cout << std::setw(12) << scaled(true, r.wall, 1e6) <<
+                    std::setw(14) << scaled(r.counted, r.cycles, 1e6) <<
+                    std::setw(14) << scaled(r.counted, r.instructions, 1e6) <<
+                    std::setw(8) << scaled(r.counted && r.cycles,
+                        r.instructions, r.cycles);
+
+                // Compare cycles where both builds were counted, and wall
+                // time otherwise.
+                if (!is_llvm && llvm.error.empty()) {
+                    const RunResult& l = llvm.best;
+                    const bool cycles = r.counted && l.counted && l.cycles;
+                    std::cout << std::setw(9) << (cycles
+                        ? scaled(true, r.cycles, l.cycles)
+                        : scaled(l.wall != 0, r.wall, l.wall)) << 'x';
+                }
+
+                if (!has_status) {
+                    has_status = true;
+                    status = m.status;
+                } else if (m.status != status) {
+                    std::cout << "  MISMATCH (exit " << m.status << ", not " <<
+                        status << ")";
+                    mismatches++;
+                }
+
+                std::cout << '\n';
+            }
+        }
+    }
+
+    if (mismatches != 0) {
+        std::cout << mismatches << " build(s) disagree on the result of their "
+            "kernel\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "core/cache.hpp"
+#include "core/logger.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+using namespace stm;
+
+/// The FNV-1a offset basis and prime for 128-bit hashes.
+static constexpr unsigned __int128 gBasis =
+    (static_cast<unsigned __int128>(0x6C62272E07BB0142) << 64) |
+    0x62B821756295C58D;
+static constexpr unsigned __int128 gPrime =
+    (static_cast<unsigned __int128>(1) << 88) | 0x13B;
+
+ContentHash::ContentHash() : m_state(gBasis) {}
+
+void ContentHash::update(const void* data, u64 size) {
+    const u8* bytes = static_cast<const u8*>(data);
+    for (u64 idx = 0; idx != size; ++idx) {
+        m_state ^= bytes[idx];
+        m_state *= gPrime;
+    }
+}
+
+void ContentHash::update(std::string_view str) {
+    update(static_cast<u64>(str.size()));
+    update(str.data(), str.size());
+}
+
+void ContentHash::update(u64 value) {
+    update(&value, sizeof(value));
+}
+
+std::string ContentHash::hex() const {
+    static constexpr char digits[] = "0123456789abcdef";
+
+    std::string str(32, '0');
+    unsigned __int128 state = m_state;
+    for (u32 idx = 32; idx != 0; --idx, state >>= 4)
+        str[idx - 1] = digits[state & 0xF];
+
+    return str;
+}
+
+ObjectCache::ObjectCache(const std::string& dir) : m_dir(dir) {
+    std::error_code err;
+    std::filesystem::create_directories(m_dir, err);
+    if (err) {
+        Logger::warn("could not create cache directory '" + m_dir + "': " +
+            err.message());
+    }
+}
+
+bool ObjectCache::load(const std::string& key, std::vector<u8>& bytes) {
+    std::ifstream file(m_dir + "/" + key + ".o", std::ios::binary);
+    if (!file.is_open()) {
+        m_misses++;
+        return false;
+    }
+
+    bytes.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        m_misses++;
+        return false;
+    }
+
+    m_hits++;
+    return true;
+}
+
+void ObjectCache::store(const std::string& key,
+                        const std::vector<u8>& bytes) {
+    static std::atomic<u32> counter = 0;
+
+    const std::string path = m_dir + "/" + key + ".o";
+    const std::string tmp = path + ".tmp." + std::to_string(::getpid()) + "." +
+        std::to_string(counter++);
+
+    std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+    if (file.is_open()) {
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        file.close();
+    }
+
+    std::error_code err;
+    if (!file.fail())
+        std::filesystem::rename(tmp, path, err);
+
+    if (file.fail() || err) {
+        std::filesystem::remove(tmp, err);
+        Logger::warn("could not write cache entry '" + path + "'");
+    }
+}
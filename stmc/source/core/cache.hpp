@@ -0,0 +1,71 @@
+#ifndef STATIM_CACHE_HPP_
+#define STATIM_CACHE_HPP_
+
+#include "types/types.hpp"
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace stm {
+
+/// An incremental 128-bit FNV-1a hash over a sequence of bytes.
+class ContentHash final {
+    unsigned __int128 m_state;
+
+public:
+    ContentHash();
+
+    /// Mix the |size| bytes at |data| into this hash.
+    void update(const void* data, u64 size);
+
+    /// Mix the length and contents of |str| into this hash, so that adjacent
+    /// strings cannot run into each other.
+    void update(std::string_view str);
+
+    /// Mix the integer |value| into this hash.
+    void update(u64 value);
+
+    /// Returns this hash as a string of 32 hexadecimal digits.
+    std::string hex() const;
+};
+
+/// An on-disk cache of compiled object files, keyed by content hash.
+///
+/// Each entry is a single file in the cache directory named after its key.
+/// Entries are written to a temporary file and renamed into place, so that
+/// concurrent compilers sharing a directory never read a partial entry. The
+/// cache is only an optimization, so failing to read or write an entry is
+/// never fatal.
+class ObjectCache final {
+    std::string m_dir;
+    std::atomic<u32> m_hits = 0;
+    std::atomic<u32> m_misses = 0;
+
+public:
+    /// Create a cache of entries in the directory |dir|, creating it if it
+    /// does not exist yet.
+    ObjectCache(const std::string& dir);
+
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache& operator = (const ObjectCache&) = delete;
+
+    /// Returns the directory of this cache.
+    const std::string& dir() const { return m_dir; }
+
+    /// Load the entry for |key| into |bytes|, and return true if there was
+    /// one. Each call counts as either a hit or a miss.
+    bool load(const std::string& key, std::vector<u8>& bytes);
+
+    /// Store |bytes| as the entry for |key|, replacing any existing entry.
+    void store(const std::string& key, const std::vector<u8>& bytes);
+
+    /// Returns the number of lookups that found or missed an entry.
+    u32 hits() const { return m_hits.load(); }
+    u32 misses() const { return m_misses.load(); }
+};
+
+} // namespace stm
+
+#endif // STATIM_CACHE_HPP_
@@ -1,6 +1,9 @@
 #include "core/lexer.hpp"
 #include "core/logger.hpp"
+#include "core/scan.hpp"
+#include "types/source_manager.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace stm;
@@ -13,40 +16,198 @@ static bool is_whitespace(char c) {
     return c == ' ' || c == '\t';
 }
 
+/// The values that escape sequences map to, so that escaped character
+/// literals can view them without any allocation.
+static constexpr char escapes[] = { 
+    '\0', '\n', '\t', '\r', '\b', '\f', '\v', '\\', '\'', '\"' 
+};
+
+/// Returns the index in |escapes| for the escape sequence character |c|, or
+/// -1 if |c| does not form a simple escape sequence.
+static i32 escape_index(char c) {
+    switch (c) {
+    case '0': return 0;
+    case 'n': return 1;
+    case 't': return 2;
+    case 'r': return 3;
+    case 'b': return 4;
+    case 'f': return 5;
+    case 'v': return 6;
+    case '\\': return 7;
+    case '\'': return 8;
+    case '\"': return 9;
+    default: return -1;
+    }
+}
+
+namespace {
+
+/// A keyword and the kind of token it lexes to.
+struct Keyword final {
+    std::string_view    name;
+    TokenKind           kind;
+};
+
+/// All keywords of the language.
+constexpr Keyword keywords[] = {
+    { "__asm__", TOKEN_KIND_ASM },
+    { "break", TOKEN_KIND_BREAK },
+    { "cast", TOKEN_KIND_CAST },
+    { "continue", TOKEN_KIND_CONTINUE },
+    { "else", TOKEN_KIND_ELSE },
+    { "enum", TOKEN_KIND_ENUM },
+    { "false", TOKEN_KIND_FALSE },
+    { "if", TOKEN_KIND_IF },
+    { "let", TOKEN_KIND_LET },
+    { "mut", TOKEN_KIND_MUT },
+    { "null", TOKEN_KIND_NULL },
+    { "private", TOKEN_KIND_PRIVATE },
+    { "public", TOKEN_KIND_PUBLIC },
+    { "ret", TOKEN_KIND_RET },
+    { "sizeof", TOKEN_KIND_SIZEOF },
+    { "struct", TOKEN_KIND_STRUCT },
+    { "true", TOKEN_KIND_TRUE },
+    { "use", TOKEN_KIND_USE },
+    { "volatile", TOKEN_KIND_VOLATILE },
+    { "while", TOKEN_KIND_WHILE },
+};
+
+/// The number of bits in a keyword hash, and so the number of slots in the
+/// keyword table.
+constexpr u32 KEYWORD_BITS = 6;
+constexpr u32 KEYWORD_SLOTS = 1 << KEYWORD_BITS;
+
+/// Hashes the identifier |str| of at least two characters with the given
+/// |seed|, resulting in a slot of the keyword table.
+constexpr u32 keyword_hash(std::string_view str, u32 seed) {
+    u32 key = (u32(u8(str[0])) << 24) | (u32(u8(str[1])) << 16) | 
+        (u32(u8(str.back())) << 8) | u32(str.size());
+    return (key * seed) >> (32 - KEYWORD_BITS);
+}
+
+/// Returns true if |seed| hashes every keyword to a distinct slot.
+constexpr bool is_perfect_seed(u32 seed) {
+    bool used[KEYWORD_SLOTS] = {};
+    for (const Keyword& kw : keywords) {
+        u32 slot = keyword_hash(kw.name, seed);
+        if (used[slot])
+            return false;
+
+        used[slot] = true;
+    }
+
+    return true;
+}
+
+/// Find the first odd seed that makes the keyword hash perfect.
+constexpr u32 find_keyword_seed() {
+    for (u32 seed = 1; seed != 0; seed += 2) {
+        if (is_perfect_seed(seed))
+            return seed;
+    }
+
+    return 0;
+}
+
+constexpr u32 KEYWORD_SEED = find_keyword_seed();
+static_assert(KEYWORD_SEED != 0, "no perfect hash for keywords!");
+
+/// The keyword table, indexed by keyword hash. Empty slots are left with an
+/// empty name, which no identifier can match.
+struct KeywordTable final {
+    Keyword slots[KEYWORD_SLOTS] = {};
+
+    constexpr KeywordTable() {
+        for (const Keyword& kw : keywords)
+            slots[keyword_hash(kw.name, KEYWORD_SEED)] = kw;
+    }
+};
+
+constexpr KeywordTable keyword_table {};
+
+} // namespace
+
+/// Returns the keyword kind of the identifier |str|, or an identifier kind if
+/// it is not a keyword.
+static TokenKind classify_identifier(std::string_view str) {
+    if (str.size() < 2)
+        return TOKEN_KIND_IDENTIFIER;
+
+    const Keyword& kw = keyword_table.slots[keyword_hash(str, KEYWORD_SEED)];
+    return kw.name == str ? kw.kind : TOKEN_KIND_IDENTIFIER;
+}
+
 Lexer::Lexer(InputFile& file, const std::string& src) 
-        : mFile(file), mBuf(src.empty() ? file.source() : src), mLoc(file, 1, 1) {
-    mLexed.push_back(Token { mLoc });
+        : mFile(file), mWindow(WINDOW, Token { SourceLocation() }), 
+          mEscaped(WINDOW) {
+    static_assert((WINDOW & (WINDOW - 1)) == 0, 
+        "lexer window must be a power of two!");
+
+    if (!src.empty())
+        file.overwrite(src);
+
+    mBuf = file.source();
+    mStart = SourceManager::location(SourceManager::add(file), 0);
 };
 
 const Token& Lexer::last() const {
-    return mLexed.back();
+    return mWindow[mCount & (WINDOW - 1)];
 }
 
 const Token& Lexer::last(u32 n) const {
-    return mLexed.at(std::max(mLexed.size() - 1 - n, u64(0)));
+    assert(n < WINDOW && "lookbehind exceeds the lexer window!");
+    return mWindow[(mCount - std::min(n, mCount)) & (WINDOW - 1)];
+}
+
+Token& Lexer::next_token() {
+    Token& token = mWindow[++mCount & (WINDOW - 1)];
+    token.loc = SourceLocation(mStart.offset + mPos);
+    token.kind = TOKEN_KIND_END_OF_FILE;
+    token.value = {};
+    token.symbol = {};
+    return token;
 }
 
 const Token& Lexer::lex() {
-    if (is_eof()) {
-        if (mLexed.back().kind != TOKEN_KIND_END_OF_FILE)
-            mLexed.push_back(Token { mLoc, TOKEN_KIND_END_OF_FILE });
+    const char* buf = mBuf.data();
+    const u32 size = mBuf.size();
 
-        return mLexed.back();
-    }
+    // Skip any whitespace and comments before the next token. This is done
+    // iteratively so that long runs of comments can't exhaust the stack.
+    for (;;) {
+        if (is_eof()) {
+            if (last().kind != TOKEN_KIND_END_OF_FILE)
+                next_token();
 
-    if (curr() == '\n') {
-        mPos++;
-        end_line();
-        return lex();
-    } else if (is_whitespace(curr())) {
-        while (is_whitespace(curr()))
+            return last();
+        }
+
+        const char c = buf[mPos];
+        if (c == '\n') {
             move();
+        } else if (is_whitespace(c)) {
+            skip_to(scan::skip_whitespace(buf, mPos, size));
+        } else if (c == '/' && peek() == '/') {
+            move(2); // //
+            skip_to(scan::find(buf, mPos, size, '\n'));
+        } else if (c == '/' && peek() == '*') {
+            move(2); // /*
+
+            for (;;) {
+                skip_to(scan::find(buf, mPos, size, '*'));
+                if (is_eof() || peek() == '/')
+                    break;
 
-        return lex();
+                move();
+            }
+
+            move(2); // */
+        } else {
+            break;
+        }
     }
 
-    mLexed.push_back(Token { mLoc });
-    Token& token = mLexed.back();
+    Token& token = next_token();
 
     switch (curr()) {
     case '+':
@@ -89,30 +250,7 @@ const Token& Lexer::lex() {
         break;
 
     case '/':
-        if (peek() == '/') {
-            move(2);
-            while (curr() != '\n' && curr() != '\0')
-                move();
-            
-            return lex();
-        } else if (peek() == '*') {
-            move(2); // /*
-
-            while (curr() != '\0') {
-                if (curr() == '*' && peek() == '/')
-                    break;
-
-                if (curr() == '\n') {
-                    mPos++;
-                    end_line();
-                } else {
-                    move(1);
-                }
-            }
-
-            move(2); // */
-            return lex();
-        } else if (peek() == '=') {
+        if (peek() == '=') {
             token.kind = TOKEN_KIND_SLASH_EQUALS;
             move(2);
         } else {
@@ -302,22 +440,14 @@ const Token& Lexer::lex() {
 
         if (curr() == '\\') {
             move();
-            switch (curr()) {
-                case '0': token.value = "\0"; break;
-                case 'n': token.value = "\n"; break;
-                case 't': token.value = "\t"; break;
-                case 'r': token.value = "\r"; break;
-                case 'b': token.value = "\b"; break;
-                case 'f': token.value = "\f"; break;
-                case 'v': token.value = "\v"; break;
-                case '\\': token.value = "\\"; break;
-                case '\'': token.value = "\'"; break;
-                case '\"': token.value = "\""; break;
-                default: 
-                    Logger::fatal("unknown character escape sequence.");
-            }
+
+            i32 idx = escape_index(curr());
+            if (idx == -1)
+                Logger::fatal("unknown character escape sequence.");
+
+            token.value = std::string_view(&escapes[idx], 1);
         } else
-            token.value = curr();
+            token.value = mBuf.substr(std::min<u64>(mPos, mBuf.size()), 1);
 
         if (peek() != '\'')
             token.kind = TOKEN_KIND_APOSTROPHE;
@@ -326,78 +456,90 @@ const Token& Lexer::lex() {
             
         break;
 
-    case '"':
+    case '"': {
         move();
         token.kind = TOKEN_KIND_STRING;
-        token.value = "";
 
-        while (curr() != '"') {
-            if (curr() == '\\') {
-                move();
-                switch (curr()) {
-                    case '0': token.value += '\0'; break;
-                    case 'n': token.value += '\n'; break;
-                    case 't': token.value += '\t'; break;
-                    case 'r': token.value += '\r'; break;
-                    case 'b': token.value += '\b'; break;
-                    case 'f': token.value += '\f'; break;
-                    case 'v': token.value += '\v'; break;
-                    case '\\': token.value += '\\'; break;
-                    case '\'': token.value += '\''; break;
-                    case '\"': token.value += '\"'; break;
-                    default: {
-                        if (is_octal_digit(curr())) {
-                            i32 oct_val = 0;
-                            i32 digits = 0;
-
-                            while (digits < 3 && is_octal_digit(curr())) {
-                                oct_val = (oct_val << 3) + (curr() - '0');
-                                move();
-                                digits++;
-                            }
-
-                            token.value += static_cast<char>(oct_val);
-                            continue;
-                        } else {
-                            Logger::fatal("unknown string escape sequence.");
-                        }
-                    }
+        // Most string literals have no escape sequences, so view them 
+        // directly from the source and only materialize an owned value once
+        // an escape sequence is found.
+        const u32 begin = mPos;
+        skip_to(scan::find_either(buf, mPos, size, '"', '\\'));
+
+        if (curr() != '\\') {
+            token.value = mBuf.substr(begin, mPos - begin);
+            move();
+            break;
+        }
+
+        // Escaped values live alongside their token in the window, and so 
+        // are overwritten once the token falls out of it.
+        std::string& value = mEscaped[mCount & (WINDOW - 1)];
+        value = mBuf.substr(begin, mPos - begin);
+
+        while (!is_eof() && curr() != '"') {
+            if (curr() != '\\') {
+                const u32 end = scan::find_either(buf, mPos, size, '"', '\\');
+                value += mBuf.substr(mPos, end - mPos);
+                skip_to(end);
+                continue;
+            }
+
+            move(); // '\'
+
+            i32 idx = escape_index(curr());
+            if (idx != -1) {
+                value += escapes[idx];
+            } else if (is_octal_digit(curr())) {
+                i32 oct_val = 0;
+                i32 digits = 0;
+
+                while (digits < 3 && is_octal_digit(curr())) {
+                    oct_val = (oct_val << 3) + (curr() - '0');
+                    move();
+                    digits++;
                 }
+
+                value += static_cast<char>(oct_val);
+                continue;
             } else {
-                token.value += curr();  
+                Logger::fatal("unknown string escape sequence.");
             }
             move();
         }
         move();
+
+        token.value = value;
         break;
+    }
     
     default: {
+        const u32 begin = mPos;
+
         if (std::isdigit(curr()) || curr() == '-') {
             token.kind = TOKEN_KIND_INTEGER;
 
-            if (curr() == '-') {
-                token.value += curr();
+            if (curr() == '-')
                 move();
-            }
 
-            while (std::isdigit(curr()) || curr() == '.') {
-                if (curr() == '.') {
-                    if (!std::isdigit(peek()) || token.kind == TOKEN_KIND_FLOAT)
-                        break;
+            skip_to(scan::skip_digits(buf, mPos, size));
 
-                    token.kind = TOKEN_KIND_FLOAT;
-                }
-                    
-                token.value += curr();
-                move();
+            if (curr() == '.' && std::isdigit(peek())) {
+                token.kind = TOKEN_KIND_FLOAT;
+                move(); // '.'
+                skip_to(scan::skip_digits(buf, mPos, size));
             }
+
+            token.value = mBuf.substr(begin, mPos - begin);
         } else if (std::isalpha(curr()) || curr() == '_') {
             token.kind = TOKEN_KIND_IDENTIFIER;
             
-            while (std::isalnum(curr()) || curr() == '_') {
-                token.value += curr();
-                move();
-            }
+            skip_to(scan::skip_identifier(buf, mPos, size));
+
+            token.value = mBuf.substr(begin, mPos - begin);
+            token.kind = classify_identifier(token.value);
+            if (token.kind == TOKEN_KIND_IDENTIFIER)
+                token.symbol = token.value;
         } else {
             Logger::fatal("unrecognized token.");
         }
@@ -423,12 +565,10 @@ char Lexer::peek(u32 n) const {
     return mBuf[mPos + n];
 }
 
-void Lexer::end_line() {
-    mLoc.line++;
-    mLoc.column = 1;
+void Lexer::skip_to(u32 pos) {
+    mPos = pos;
 }
 
 void Lexer::move(u32 n) {
     mPos += n;
-    mLoc.column++;
 }
@@ -4,24 +4,38 @@
 #include "types/input_file.hpp"
 #include "types/token.hpp"
 
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace stm {
 
 class Lexer final {
-    InputFile&          mFile;
-    std::string         mBuf;
-    std::vector<Token>  mLexed;
-    SourceLocation      mLoc;
-    u32                 mPos = 0;
+public:
+    /// The number of tokens kept by the lexer. The parser looks back at most
+    /// one token behind the last, so a small window keeps lexer memory
+    /// constant in the size of the source. Must be a power of two.
+    static constexpr u32 WINDOW = 4;
+
+private:
+    InputFile&                  mFile;
+    std::string_view            mBuf;
+    std::vector<Token>          mWindow;
+    std::vector<std::string>    mEscaped;
+    u32                         mCount = 0;
+    SourceLocation              mStart;
+    u32                         mPos = 0;
 
 public:
+    /// Create a new lexer over the source of |file|. If |src| is provided, it
+    /// overwrites the file contents, for devel purposes.
     Lexer(InputFile& file, const std::string& src = "");
 
     /// Get the most previously lexed token.
     const Token& last() const;
 
-    /// Get the token lexed \p n iterations ago.
+    /// Get the token lexed \p n iterations ago. \p n must be less than the
+    /// lexer window size.
     const Token& last(u32 n) const;
 
     /// Lex a new token.
@@ -31,17 +45,20 @@ public:
     bool is_eof() const;
 
 private:
+    /// Claim the next token in the window, overwriting the oldest one.
+    Token& next_token();
+
     /// Get the current character in the stream.
     char curr() const;
 
     /// Peek at the character in \p n positions.
     char peek(u32 n = 1) const;
 
-    /// End the current source location line.
-    void end_line();
-
     /// Move the lexer cursor by \p n positions.
     void move(u32 n = 1);
+
+    /// Move the lexer cursor forward to \p pos.
+    void skip_to(u32 pos);
 };
 
 } // namespace stm
@@ -1,52 +1,58 @@
 #include "core/logger.hpp"
 #include "types/input_file.hpp"
+#include "types/source_manager.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
-#include <vector>
 
 using namespace stm;
 
-static std::vector<std::string> source(const Span& span) {
-    std::vector<std::string> lines { span.end.line - span.begin.line };
-    const std::string& full = span.begin.file.source();
-
-    std::size_t line = 1;
-    std::size_t start = 0;
-    for (std::size_t idx = 0; idx <= full.length(); ++idx) {
-        if (idx == full.length() || full[idx] == '\n') {
-            if (line >= span.begin.line && line <= span.end.line)
-                lines.push_back(full.substr(start, idx - start));
-            
-            start = idx + 1;
-            line++;
-        }
-    }
+namespace {
 
-    return lines;
-}
+/// Thrown by a fatal diagnostic to stop a task that is capturing diagnostics.
+struct CaptureAbort final {};
+
+} // namespace
+
+/// The buffer that diagnostics from this thread are captured into, if any.
+static thread_local Logger::Buffer* gCapture = nullptr;
+
+/// Guards writes to the logger output.
+static std::mutex gMutex;
 
 std::ostream* Logger::pOutput = nullptr;
 bool Logger::color = false;
 
-void Logger::log_src(const Span& span) {
-    u32 line_len = std::to_string(span.begin.line).length();
+std::ostream& Logger::stream(std::unique_lock<std::mutex>& lock) {
+    if (gCapture)
+        return gCapture->m_stream;
 
-    *pOutput << std::string(line_len + 2, ' ') << "┌─[" << 
-        span.begin.file.absolute() << ':' << span.begin.line << "]\n";
+    lock = std::unique_lock { gMutex };
+    return *pOutput;
+}
+
+void Logger::log_src(std::ostream& os, const Span& span) {
+    const u32 begin = SourceManager::line(span.begin);
+    const u32 end = std::max(begin, SourceManager::line(span.end));
+    u32 line_len = std::to_string(begin).length();
+
+    os << std::string(line_len + 2, ' ') << "┌─[" << 
+        SourceManager::file(span.begin).absolute() << ':' << begin << "]\n";
+
+    u32 line_n = begin;
+    while (line_n <= end) {
+        std::string_view line = SourceManager::line_source(span.begin, line_n);
 
-    u32 line_n = span.begin.line;
-    for (auto line : source(span)) {
-        
         if (Logger::color)
-            *pOutput << "\e[38;5;240m" << line_n++ << "\033[0m" << 
+            os << "\e[38;5;240m" << line_n++ << "\033[0m" << 
                 std::string(line_len + 2 - std::to_string(line_n).length(), ' ') 
                     << "│ " << line << '\n';
         else
-            *pOutput << line_n++ << ' ' << line << '\n';
+            os << line_n++ << ' ' << line << '\n';
     }
 
-    *pOutput << std::string(line_len + 2, ' ') << "╰──\n";
+    os << std::string(line_len + 2, ' ') << "╰──\n";
 }
 
 void Logger::init(std::ostream& output) {
@@ -54,6 +60,30 @@ void Logger::init(std::ostream& output) {
     Logger::color = pOutput == &std::cout || pOutput == &std::cerr;
 }
 
+void Logger::capture(Buffer& buffer, const std::function<void()>& fn) {
+    Buffer* prev = gCapture;
+    gCapture = &buffer;
+
+    try {
+        fn();
+    } catch (const CaptureAbort&) {
+        buffer.m_failed = true;
+    }
+
+    gCapture = prev;
+}
+
+void Logger::Buffer::flush() {
+    if (pOutput) {
+        std::lock_guard lock { gMutex };
+        *pOutput << m_stream.str() << std::flush;
+    }
+
+    m_stream.str("");
+    if (m_failed)
+        std::exit(EXIT_FAILURE);
+}
+
 void Logger::log(Severity severity, const std::string& msg) {
     if (!pOutput) return;
     
@@ -83,86 +113,103 @@ void Logger::log(Severity severity, const std::string& msg, const Span& span) {
 void Logger::info(const std::string& msg) {
     if (!pOutput) return;
 
-    *pOutput << "stmc: ";
+    std::unique_lock<std::mutex> lock;
+    std::ostream& os = stream(lock);
+
+    os << "stmc: ";
     
     if (Logger::color)
-        *pOutput << "\033[1;35minfo:\033[0m ";
+        os << "\033[1;35minfo:\033[0m ";
     else
-        *pOutput << "info: ";
+        os << "info: ";
 
-    *pOutput << msg << '\n';
+    os << msg << '\n';
 }
 
 void Logger::info(const std::string& msg, const Span& span) {
     if (!pOutput) return;
 
+    std::unique_lock<std::mutex> lock;
+    std::ostream& os = stream(lock);
+
     if (Logger::color)
-        *pOutput << "\033[1;35m !\033[0m ";
+        os << "\033[1;35m !\033[0m ";
     else
-        *pOutput << " ! ";
+        os << " ! ";
 
-    const SourceLocation& begin = span.begin;
-    InputFile& file = begin.file;
-    *pOutput << msg << '\n';
-    log_src(span);
+    os << msg << '\n';
+    log_src(os, span);
 }
 
 void Logger::warn(const std::string& msg) {
     if (!pOutput) return;
 
-    *pOutput << "stmc: ";
+    std::unique_lock<std::mutex> lock;
+    std::ostream& os = stream(lock);
+
+    os << "stmc: ";
     
     if (Logger::color)
-        *pOutput << "\033[1;33mwarning:\033[0m ";
+        os << "\033[1;33mwarning:\033[0m ";
     else
-        *pOutput << "warning: ";
+        os << "warning: ";
 
-    *pOutput << msg << '\n';
+    os << msg << '\n';
 }
 
 void Logger::warn(const std::string& msg, const Span &span) {
     if (!pOutput) return;
 
+    std::unique_lock<std::mutex> lock;
+    std::ostream& os = stream(lock);
+
     if (Logger::color)
-        *pOutput << "\033[1;33m ⚠︎\033[0m ";
+        os << "\033[1;33m ⚠︎\033[0m ";
     else
-        *pOutput << " ⚠︎ ";
+        os << " ⚠︎ ";
 
-    const SourceLocation& begin = span.begin;
-    InputFile& file = begin.file;
-    *pOutput << msg << '\n';
-    log_src(span);
+    os << msg << '\n';
+    log_src(os, span);
 }
 
 __attribute__((noreturn))
 void Logger::fatal(const std::string& msg) {
     if (pOutput) {
-        *pOutput << "stmc: ";
+        std::unique_lock<std::mutex> lock;
+        std::ostream& os = stream(lock);
+        os << "stmc: ";
         
         if (Logger::color)
-            *pOutput << "\033[1;31mfatal:\033[0m ";
+            os << "\033[1;31mfatal:\033[0m ";
         else
-            *pOutput << "fatal: ";
+            os << "fatal: ";
 
-        *pOutput << msg << std::endl;
+        os << msg << std::endl;
     }
 
+    if (gCapture)
+        throw CaptureAbort();
+
     std::exit(EXIT_FAILURE);
 }
 
 __attribute__((noreturn))
 void Logger::fatal(const std::string& msg, const Span &span) {
     if (pOutput) {
+        std::unique_lock<std::mutex> lock;
+        std::ostream& os = stream(lock);
+        
         if (Logger::color)
-            *pOutput << "\033[1;31m ˣ\033[0m ";
+            os << "\033[1;31m ˣ\033[0m ";
         else
-            *pOutput << " ˣ ";
+            os << " ˣ ";
         
-        const SourceLocation& begin = span.begin;
-        InputFile& file = begin.file;
-        *pOutput << msg << '\n';
-        log_src(span);
+        os << msg << '\n';
+        log_src(os, span);
     }
 
+    if (gCapture)
+        throw CaptureAbort();
+
     std::exit(EXIT_FAILURE);
 }
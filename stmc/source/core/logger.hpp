@@ -4,26 +4,62 @@
 #include "types/source_location.hpp"
 #include "types/types.hpp"
 
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
 
 namespace stm {
 
+/// The global compiler diagnostics logger.
+///
+/// Logging is safe from any thread. Diagnostics are written out one message
+/// at a time, unless the logging thread is capturing into a buffer, in which
+/// case they are held until the buffer is flushed.
 class Logger final {
     static std::ostream*    pOutput;
     static bool             color;
 
-    static void log_src(const Span& span);
+    static void log_src(std::ostream& os, const Span& span);
+
+    /// Returns the stream that a message from the calling thread should be
+    /// written to. If it is the logger output, |lock| is made to hold it for
+    /// as long as the message is being written.
+    static std::ostream& stream(std::unique_lock<std::mutex>& lock);
 
 public:
     enum class Severity : u8 {
         Info, Warning, Fatal,
     };
 
+    /// The diagnostics logged by a single task, such as the parsing of one
+    /// translation unit. Flushing buffers in a fixed order keeps the output
+    /// of concurrent tasks deterministic.
+    class Buffer final {
+        std::ostringstream  m_stream;
+        bool                m_failed = false;
+
+        friend class Logger;
+
+    public:
+        /// Returns true if a fatal diagnostic was captured into this buffer.
+        bool failed() const { return m_failed; }
+
+        /// Write out the diagnostics in this buffer, and exit if any of them
+        /// were fatal.
+        void flush();
+    };
+
     Logger() = delete;
 
     static void init(std::ostream& output = std::cerr);
 
+    /// Run |fn|, capturing all diagnostics logged by the calling thread into
+    /// |buffer|. A fatal diagnostic stops |fn| early instead of exiting, and
+    /// marks |buffer| as failed.
+    static void capture(Buffer& buffer, const std::function<void()>& fn);
+
     static void log(Severity severity, const std::string& msg);
     static void log(Severity severity, const std::string& msg, const Span& span);
 
@@ -0,0 +1,323 @@
+#include "core/scan.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+using namespace stm;
+
+static bool is_whitespace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool is_identifier(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || is_digit(c)
+        || c == '_';
+}
+
+/// Scalar scanning routines, used for the tails of buffers that are too short
+/// for a full vector and on hosts without vector support.
+namespace scalar {
+
+static u32 skip_whitespace(const char* buf, u32 pos, u32 size) {
+    while (pos < size && is_whitespace(buf[pos]))
+        pos++;
+
+    return pos;
+}
+
+static u32 skip_identifier(const char* buf, u32 pos, u32 size) {
+    while (pos < size && is_identifier(buf[pos]))
+        pos++;
+
+    return pos;
+}
+
+static u32 skip_digits(const char* buf, u32 pos, u32 size) {
+    while (pos < size && is_digit(buf[pos]))
+        pos++;
+
+    return pos;
+}
+
+static u32 find(const char* buf, u32 pos, u32 size, char c) {
+    while (pos < size && buf[pos] != c)
+        pos++;
+
+    return pos;
+}
+
+static u32 find_either(const char* buf, u32 pos, u32 size, char a, char b) {
+    while (pos < size && buf[pos] != a && buf[pos] != b)
+        pos++;
+
+    return pos;
+}
+
+} // namespace scalar
+
+#if defined(__x86_64__)
+
+/// Scanning routines over 16 bytes at a time. SSE2 is part of the x86-64
+/// baseline, so these are always available.
+namespace sse2 {
+
+static inline __m128i load(const char* ptr) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+/// Returns a mask of the bytes in |v| that are within [lo, hi]. Only valid for
+/// ASCII bounds, since the comparisons are signed.
+static inline __m128i in_range(__m128i v, char lo, char hi) {
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+        _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), v));
+}
+
+static u32 skip_whitespace(const char* buf, u32 pos, u32 size) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = load(buf + pos);
+        __m128i in = _mm_or_si128(
+            _mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab));
+        u32 stop = ~_mm_movemask_epi8(in) & 0xFFFF;
+        if (stop)
+            return pos + __builtin_ctz(stop);
+    }
+
+    return scalar::skip_whitespace(buf, pos, size);
+}
+
+static u32 skip_identifier(const char* buf, u32 pos, u32 size) {
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i under = _mm_set1_epi8('_');
+
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = load(buf + pos);
+        __m128i in = _mm_or_si128(
+            _mm_or_si128(
+                in_range(_mm_or_si128(v, lower), 'a', 'z'),
+                in_range(v, '0', '9')),
+            _mm_cmpeq_epi8(v, under));
+        u32 stop = ~_mm_movemask_epi8(in) & 0xFFFF;
+        if (stop)
+            return pos + __builtin_ctz(stop);
+    }
+
+    return scalar::skip_identifier(buf, pos, size);
+}
+
+static u32 skip_digits(const char* buf, u32 pos, u32 size) {
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = load(buf + pos);
+        u32 stop = ~_mm_movemask_epi8(in_range(v, '0', '9')) & 0xFFFF;
+        if (stop)
+            return pos + __builtin_ctz(stop);
+    }
+
+    return scalar::skip_digits(buf, pos, size);
+}
+
+static u32 find(const char* buf, u32 pos, u32 size, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = load(buf + pos);
+        u32 hit = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if (hit)
+            return pos + __builtin_ctz(hit);
+    }
+
+    return scalar::find(buf, pos, size, c);
+}
+
+static u32 find_either(const char* buf, u32 pos, u32 size, char a, char b) {
+    const __m128i na = _mm_set1_epi8(a);
+    const __m128i nb = _mm_set1_epi8(b);
+
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = load(buf + pos);
+        u32 hit = _mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, na), _mm_cmpeq_epi8(v, nb)));
+        if (hit)
+            return pos + __builtin_ctz(hit);
+    }
+
+    return scalar::find_either(buf, pos, size, a, b);
+}
+
+} // namespace sse2
+
+/// Scanning routines over 32 bytes at a time, only used once the host has
+/// been found to support AVX2.
+namespace avx2 {
+
+__attribute__((target("avx2")))
+static inline __m256i load(const char* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i in_range(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+}
+
+__attribute__((target("avx2")))
+static u32 skip_whitespace(const char* buf, u32 pos, u32 size) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i v = load(buf + pos);
+        __m256i in = _mm256_or_si256(
+            _mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab));
+        u32 stop = ~static_cast<u32>(_mm256_movemask_epi8(in));
+        if (stop)
+            return pos + __builtin_ctz(stop);
+    }
+
+    return sse2::skip_whitespace(buf, pos, size);
+}
+
+__attribute__((target("avx2")))
+static u32 skip_identifier(const char* buf, u32 pos, u32 size) {
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i under = _mm256_set1_epi8('_');
+
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i v = load(buf + pos);
+        __m256i in = _mm256_or_si256(
+            _mm256_or_si256(
+                in_range(_mm256_or_si256(v, lower), 'a', 'z'),
+                in_range(v, '0', '9')),
+            _mm256_cmpeq_epi8(v, under));
+        u32 stop = ~static_cast<u32>(_mm256_movemask_epi8(in));
+        if (stop)
+            return pos + __builtin_ctz(stop);
+    }
+
+    return sse2::skip_identifier(buf, pos, size);
+}
+
+__attribute__((target("avx2")))
+static u32 skip_digits(const char* buf, u32 pos, u32 size) {
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i v = load(buf + pos);
+        u32 stop = ~static_cast<u32>(
+            _mm256_movemask_epi8(in_range(v, '0', '9')));
+        if (stop)
+            return pos + __builtin_ctz(stop);
+    }
+
+    return sse2::skip_digits(buf, pos, size);
+}
+
+__attribute__((target("avx2")))
+static u32 find(const char* buf, u32 pos, u32 size, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i v = load(buf + pos);
+        u32 hit = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle));
+        if (hit)
+            return pos + __builtin_ctz(hit);
+    }
+
+    return sse2::find(buf, pos, size, c);
+}
+
+__attribute__((target("avx2")))
+static u32 find_either(const char* buf, u32 pos, u32 size, char a, char b) {
+    const __m256i na = _mm256_set1_epi8(a);
+    const __m256i nb = _mm256_set1_epi8(b);
+
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i v = load(buf + pos);
+        u32 hit = _mm256_movemask_epi8(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, na), _mm256_cmpeq_epi8(v, nb)));
+        if (hit)
+            return pos + __builtin_ctz(hit);
+    }
+
+    return sse2::find_either(buf, pos, size, a, b);
+}
+
+} // namespace avx2
+
+#endif // __x86_64__
+
+namespace {
+
+/// The set of scanning routines chosen for the host.
+struct Routines final {
+    u32 (*skip_whitespace)(const char*, u32, u32);
+    u32 (*skip_identifier)(const char*, u32, u32);
+    u32 (*skip_digits)(const char*, u32, u32);
+    u32 (*find)(const char*, u32, u32, char);
+    u32 (*find_either)(const char*, u32, u32, char, char);
+    const char* isa;
+};
+
+} // namespace
+
+static Routines select_routines() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    
+    if (__builtin_cpu_supports("avx2")) {
+        return Routines {
+            avx2::skip_whitespace, avx2::skip_identifier, avx2::skip_digits,
+            avx2::find, avx2::find_either, "avx2"
+        };
+    }
+
+    return Routines {
+        sse2::skip_whitespace, sse2::skip_identifier, sse2::skip_digits,
+        sse2::find, sse2::find_either, "sse2"
+    };
+#else
+    return Routines {
+        scalar::skip_whitespace, scalar::skip_identifier, scalar::skip_digits,
+        scalar::find, scalar::find_either, "scalar"
+    };
+#endif // __x86_64__
+}
+
+/// Returns the scanning routines for the host, selected on first use.
+static const Routines& routines() {
+    static const Routines selected = select_routines();
+    return selected;
+}
+
+u32 scan::skip_whitespace(const char* buf, u32 pos, u32 size) {
+    return routines().skip_whitespace(buf, pos, size);
+}
+
+u32 scan::skip_identifier(const char* buf, u32 pos, u32 size) {
+    return routines().skip_identifier(buf, pos, size);
+}
+
+u32 scan::skip_digits(const char* buf, u32 pos, u32 size) {
+    return routines().skip_digits(buf, pos, size);
+}
+
+u32 scan::find(const char* buf, u32 pos, u32 size, char c) {
+    return routines().find(buf, pos, size, c);
+}
+
+u32 scan::find_either(const char* buf, u32 pos, u32 size, char a, char b) {
+    return routines().find_either(buf, pos, size, a, b);
+}
+
+const char* scan::isa() {
+    return routines().isa;
+}
@@ -0,0 +1,39 @@
+#ifndef STATIM_SCAN_HPP_
+#define STATIM_SCAN_HPP_
+
+#include "types/types.hpp"
+
+namespace stm {
+
+/// Vectorized scanning routines used by the lexer to skip over runs of
+/// characters. Each routine takes a buffer |buf| of |size| bytes and a
+/// starting position |pos|, and returns the position of the first character
+/// at or after |pos| that ends the run, or |size| if there is none.
+///
+/// SSE2 is used as a baseline on x86-64, and AVX2 is used if the host CPU
+/// supports it, as determined once at runtime.
+namespace scan {
+
+/// Skip a run of spaces and tabs.
+u32 skip_whitespace(const char* buf, u32 pos, u32 size);
+
+/// Skip a run of identifier characters, i.e. [A-Za-z0-9_].
+u32 skip_identifier(const char* buf, u32 pos, u32 size);
+
+/// Skip a run of decimal digits.
+u32 skip_digits(const char* buf, u32 pos, u32 size);
+
+/// Find the first occurrence of |c|.
+u32 find(const char* buf, u32 pos, u32 size, char c);
+
+/// Find the first occurrence of either |a| or |b|.
+u32 find_either(const char* buf, u32 pos, u32 size, char a, char b);
+
+/// Returns the name of the instruction set the scanning routines use.
+const char* isa();
+
+} // namespace scan
+
+} // namespace stm
+
+#endif // STATIM_SCAN_HPP_
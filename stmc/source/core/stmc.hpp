@@ -3,4 +3,7 @@
 
 #define STMC_LLVM_SUPPORT
 
+/// The version of the compiler.
+#define STMC_VERSION "1.0.0"
+
 #endif // STATIM_H_
@@ -0,0 +1,200 @@
+#include "core/thread_pool.hpp"
+#include "core/timer.hpp"
+
+#include <algorithm>
+
+using namespace stm;
+
+/// The pool that the current thread is a worker of, and its queue index.
+static thread_local const ThreadPool* gPool = nullptr;
+static thread_local u32 gQueue = 0;
+
+ThreadPool::ThreadPool(u32 threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (threads == 1)
+        return;
+
+    m_queues.reserve(threads);
+    for (u32 idx = 0; idx != threads; ++idx)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    m_workers.reserve(threads);
+    for (u32 idx = 0; idx != threads; ++idx)
+        m_workers.emplace_back(&ThreadPool::work, this, idx);
+}
+
+ThreadPool::~ThreadPool() {
+    if (m_workers.empty())
+        return;
+
+    wait();
+
+    {
+        std::lock_guard lock { m_mutex };
+        m_stop = true;
+    }
+
+    m_ready.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+ThreadPool::Task ThreadPool::take(u32 home) {
+    if (m_queued.load(std::memory_order_acquire) == 0)
+        return {};
+
+    {
+        Queue& queue = *m_queues[home];
+        std::lock_guard lock { queue.mutex };
+        if (!queue.tasks.empty()) {
+            Task task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    for (u32 off = 1; off != m_queues.size(); ++off) {
+        Queue& queue = *m_queues[(home + off) % m_queues.size()];
+        std::lock_guard lock { queue.mutex };
+        if (!queue.tasks.empty()) {
+            Task task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    return {};
+}
+
+void ThreadPool::finish() {
+    std::lock_guard lock { m_mutex };
+    if (--m_pending == 0)
+        m_idle.notify_all();
+}
+
+void ThreadPool::work(u32 idx) {
+    gPool = this;
+    gQueue = idx;
+
+    for (;;) {
+        if (Task task = take(idx)) {
+            task();
+            finish();
+            continue;
+        }
+
+        std::unique_lock lock { m_mutex };
+        m_ready.wait(lock, [this] { 
+            return m_stop || m_queued.load(std::memory_order_acquire) != 0; 
+        });
+
+        if (m_stop && m_queued.load() == 0)
+            return;
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    // Tasks are timed as part of the phase that submitted them, no matter
+    // which thread ends up running them.
+    if (Timer::enabled()) {
+        task = [task = std::move(task), record = Timer::current()] {
+            TimeRecord* parent = Timer::current();
+            Timer::set_current(record);
+            task();
+            Timer::set_current(parent);
+        };
+    }
+
+    if (m_workers.empty()) {
+        m_inline_tasks.push_back(std::move(task));
+        if (m_inline)
+            return;
+
+        m_inline = true;
+        while (!m_inline_tasks.empty()) {
+            Task next = std::move(m_inline_tasks.front());
+            m_inline_tasks.pop_front();
+            next();
+        }
+
+        m_inline = false;
+        return;
+    }
+
+    // Workers keep their own tasks close, and others are spread out.
+    const u32 idx = gPool == this 
+        ? gQueue 
+        : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    {
+        std::lock_guard lock { m_mutex };
+        m_pending++;
+    }
+
+    {
+        Queue& queue = *m_queues[idx];
+        std::lock_guard lock { queue.mutex };
+        queue.tasks.push_back(std::move(task));
+        m_queued.fetch_add(1, std::memory_order_release);
+    }
+
+    // Take the pool lock so that a worker cannot miss the new task between
+    // checking the queues and going to sleep.
+    { std::lock_guard lock { m_mutex }; }
+    m_ready.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock { m_mutex };
+    m_idle.wait(lock, [this] { return m_pending == 0; });
+}
+
+void ThreadPool::parallel_for(u32 count, const std::function<void(u32)>& fn) {
+    if (m_workers.empty() || count <= 1) {
+        for (u32 idx = 0; idx != count; ++idx)
+            fn(idx);
+
+        return;
+    }
+
+    // The count of calls left is only touched under its lock, so that once
+    // the caller sees it reach zero no task will touch this frame again.
+    u32 remaining = count;
+    std::mutex mutex;
+    std::condition_variable done;
+
+    for (u32 idx = 0; idx != count; ++idx) {
+        submit([&, idx] {
+            fn(idx);
+
+            std::lock_guard lock { mutex };
+            if (--remaining == 0)
+                done.notify_all();
+        });
+    }
+
+    // Help with the queued tasks rather than sleeping on them. Once there are
+    // none left to take, the rest are already running elsewhere.
+    const u32 home = gPool == this ? gQueue : 0;
+    for (;;) {
+        {
+            std::lock_guard lock { mutex };
+            if (remaining == 0)
+                return;
+        }
+
+        if (Task task = take(home)) {
+            task();
+            finish();
+            continue;
+        }
+
+        std::unique_lock lock { mutex };
+        done.wait(lock, [&] { return remaining == 0; });
+        return;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef STATIM_THREAD_POOL_HPP_
+#define STATIM_THREAD_POOL_HPP_
+
+#include "types/types.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stm {
+
+/// A fixed set of worker threads that run submitted tasks.
+///
+/// Each worker has its own queue of tasks. Tasks submitted by a worker go to
+/// the back of its own queue and are taken from there first, so that related
+/// work stays on the same thread, while idle workers steal from the front of
+/// the other queues.
+///
+/// A pool of a single thread spawns no workers at all, and instead runs each
+/// task on the calling thread as it is submitted, so that a serial build does
+/// not pay for any synchronization. Tasks submitted by a task that is already
+/// running inline are run after it, rather than nested inside of it.
+class ThreadPool final {
+    using Task = std::function<void()>;
+
+    /// The queue of tasks owned by one worker.
+    struct Queue final {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> m_workers = {};
+    std::vector<std::unique_ptr<Queue>> m_queues = {};
+    std::deque<Task> m_inline_tasks = {};
+    std::atomic<u32> m_queued = 0;
+    std::atomic<u32> m_next = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::condition_variable m_idle;
+    u32 m_pending = 0;
+    bool m_stop = false;
+    bool m_inline = false;
+
+    /// The loop run by the worker with queue |idx|.
+    void work(u32 idx);
+
+    /// Take a task, preferring the back of queue |home| and otherwise
+    /// stealing from the front of the others. Returns an empty task if there
+    /// is none to take.
+    Task take(u32 home);
+
+    /// Mark a task taken from the queues as finished.
+    void finish();
+
+public:
+    /// Create a new pool with |threads| workers. A count of 0 uses one worker
+    /// per hardware thread.
+    explicit ThreadPool(u32 threads);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    /// Waits for all pending tasks and joins the workers.
+    ~ThreadPool();
+
+    /// Returns the number of threads that tasks in this pool may run on.
+    u32 size() const { return m_workers.empty() ? 1 : m_workers.size(); }
+
+    /// Queue |task| to be run by a worker.
+    void submit(Task task);
+
+    /// Block until every task submitted so far has finished. This must not be
+    /// called from a task.
+    void wait();
+
+    /// Call |fn| with each index in [0, |count|) across the workers, and block
+    /// until all of the calls have returned. The calling thread runs queued
+    /// tasks while it waits, so this may be called from a task.
+    void parallel_for(u32 count, const std::function<void(u32)>& fn);
+};
+
+} // namespace stm
+
+#endif // STATIM_THREAD_POOL_HPP_
@@ -0,0 +1,242 @@
+#include "core/timer.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <sys/resource.h>
+#include <time.h>
+
+using namespace stm;
+
+std::unique_ptr<TimeRecord> Timer::pRoot = nullptr;
+
+/// The record that phases begun by this thread are nested in.
+static thread_local TimeRecord* gCurrent = nullptr;
+
+/// A complete event in the trace.
+struct TraceEvent final {
+    const TimeRecord* record;
+    std::string detail;
+    u64 begin;
+    u64 wall;
+};
+
+/// The events recorded by a single thread.
+struct TraceBuffer final {
+    u32 tid;
+    std::vector<TraceEvent> events = {};
+};
+
+/// The steady clock time that tracing was enabled at, or 0 if it is not.
+static std::atomic<u64> gTraceStart = 0;
+
+/// The buffers of every thread that has recorded an event. Buffers are only
+/// ever added, and live until exit, so a thread may keep its own buffer after
+/// it is registered.
+static std::mutex gTraceMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> gTraceBuffers = {};
+static thread_local TraceBuffer* gTraceBuffer = nullptr;
+
+/// Returns the wall time in nanoseconds.
+static u64 wall_time() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Returns the CPU time of the calling thread in nanoseconds.
+static u64 cpu_time() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return u64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/// Returns the peak resident set size of the process in kilobytes.
+static i64 peak_rss() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+TimeRecord* TimeRecord::child(std::string_view name) {
+    std::lock_guard lock { m_mutex };
+    for (auto& child : m_children)
+        if (child->name() == name) return child.get();
+
+    m_children.push_back(std::make_unique<TimeRecord>(name));
+    return m_children.back().get();
+}
+
+void TimeRecord::add(u64 wall, u64 cpu, i64 rss) {
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_wall.fetch_add(wall, std::memory_order_relaxed);
+    m_cpu.fetch_add(cpu, std::memory_order_relaxed);
+    m_rss.fetch_add(rss, std::memory_order_relaxed);
+}
+
+void Timer::enable(std::string_view name) {
+    pRoot = std::make_unique<TimeRecord>(name);
+}
+
+TimeRecord* Timer::current() {
+    return gCurrent ? gCurrent : pRoot.get();
+}
+
+void Timer::set_current(TimeRecord* record) {
+    gCurrent = record;
+}
+
+static void print_record(std::ostream& os, const TimeRecord& record,
+                         u32 depth) {
+    os << std::setw(12) << record.wall() / 1e6 <<
+        std::setw(12) << record.cpu() / 1e6 <<
+        std::setw(12) << record.rss() <<
+        std::setw(8) << record.count() << "  " <<
+        std::string(depth * 2, ' ') << record.name() << '\n';
+
+    for (auto& child : record.children())
+        print_record(os, *child, depth + 1);
+}
+
+void Timer::print(std::ostream& os) {
+    if (!pRoot)
+        return;
+
+    os << std::fixed << std::setprecision(2);
+    os << std::setw(12) << "wall (ms)" << std::setw(12) << "cpu (ms)" <<
+        std::setw(12) << "rss (kB)" << std::setw(8) << "runs" <<
+        "  phase\n";
+
+    print_record(os, *pRoot, 0);
+}
+
+/// Write |str| to |os| as a JSON string.
+static void print_json_string(std::ostream& os, const std::string& str) {
+    static constexpr char digits[] = "0123456789abcdef";
+
+    os << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<u8>(c) < 0x20) {
+            os << "\\u00" << digits[c >> 4] << digits[c & 0xF];
+        } else {
+            os << c;
+        }
+    }
+
+    os << '"';
+}
+
+static void print_record_json(std::ostream& os, const TimeRecord& record) {
+    os << "{\"name\":";
+    print_json_string(os, record.name());
+    os << ",\"wall_ms\":" << record.wall() / 1e6 <<
+        ",\"cpu_ms\":" << record.cpu() / 1e6 <<
+        ",\"rss_kb\":" << record.rss() <<
+        ",\"runs\":" << record.count() <<
+        ",\"children\":[";
+
+    for (u32 idx = 0; idx != record.children().size(); ++idx) {
+        if (idx != 0)
+            os << ',';
+
+        print_record_json(os, *record.children()[idx]);
+    }
+
+    os << "]}";
+}
+
+void Timer::print_json(std::ostream& os) {
+    if (!pRoot)
+        return;
+
+    os << std::fixed << std::setprecision(3);
+    print_record_json(os, *pRoot);
+    os << '\n';
+}
+
+void Trace::enable() {
+    gTraceStart.store(wall_time());
+}
+
+bool Trace::enabled() {
+    return gTraceStart.load(std::memory_order_relaxed) != 0;
+}
+
+void Trace::add(const TimeRecord* record, std::string_view detail, u64 begin,
+                u64 wall) {
+    if (!gTraceBuffer) {
+        std::lock_guard lock { gTraceMutex };
+        gTraceBuffers.push_back(std::make_unique<TraceBuffer>());
+        gTraceBuffer = gTraceBuffers.back().get();
+        gTraceBuffer->tid = gTraceBuffers.size();
+    }
+
+    gTraceBuffer->events.push_back({ 
+        record, std::string(detail), begin, wall });
+}
+
+void Trace::write(std::ostream& os) {
+    const u64 start = gTraceStart.load();
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    std::lock_guard lock { gTraceMutex };
+    for (auto& buffer : gTraceBuffers) {
+        for (const TraceEvent& event : buffer->events) {
+            os << (first ? "\n" : ",\n") << "{\"name\":";
+            print_json_string(os, event.record->name());
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid <<
+                ",\"ts\":" << (event.begin - start) / 1e3 <<
+                ",\"dur\":" << event.wall / 1e3;
+
+            if (!event.detail.empty()) {
+                os << ",\"args\":{\"detail\":";
+                print_json_string(os, event.detail);
+                os << '}';
+            }
+
+            os << '}';
+            first = false;
+        }
+    }
+
+    os << "\n]}\n";
+}
+
+TimeScope::TimeScope(std::string_view name, std::string_view detail) 
+        : m_detail(detail) {
+    if (TimeRecord* parent = Timer::current())
+        begin(parent->child(name));
+}
+
+TimeScope::TimeScope(TimeRecord* record) {
+    if (record)
+        begin(record);
+}
+
+void TimeScope::begin(TimeRecord* record) {
+    m_record = record;
+    m_parent = Timer::current();
+    Timer::set_current(record);
+
+    m_rss = peak_rss();
+    m_cpu = cpu_time();
+    m_wall = wall_time();
+}
+
+void TimeScope::stop() {
+    if (!m_record)
+        return;
+
+    const u64 wall = wall_time() - m_wall;
+    const u64 cpu = cpu_time() - m_cpu;
+    m_record->add(wall, cpu, peak_rss() - m_rss);
+    if (Trace::enabled())
+        Trace::add(m_record, m_detail, m_wall, wall);
+
+    Timer::set_current(m_parent);
+    m_record = nullptr;
+}
@@ -0,0 +1,175 @@
+#ifndef STATIM_TIMER_HPP_
+#define STATIM_TIMER_HPP_
+
+#include "types/types.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace stm {
+
+/// A phase of compilation in the report of the -t option, along with the
+/// phases nested in it.
+///
+/// A record accumulates every run of its phase, so that a step run once per
+/// function is reported as one entry with the sum of all of its runs. Runs may
+/// be added from any thread.
+class TimeRecord final {
+    std::string m_name;
+    std::atomic<u64> m_count = 0;
+    std::atomic<u64> m_wall = 0;
+    std::atomic<u64> m_cpu = 0;
+    std::atomic<i64> m_rss = 0;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<TimeRecord>> m_children = {};
+
+public:
+    TimeRecord(std::string_view name) : m_name(name) {}
+
+    TimeRecord(const TimeRecord&) = delete;
+    TimeRecord& operator = (const TimeRecord&) = delete;
+
+    /// Returns the name of the phase of this record.
+    const std::string& name() const { return m_name; }
+
+    /// Returns the nested phase of this record named |name|, creating it if
+    /// it does not exist yet. Phases are kept in the order they first ran.
+    TimeRecord* child(std::string_view name);
+
+    /// Returns the nested phases of this record. This must not be called while
+    /// phases may still be added.
+    const std::vector<std::unique_ptr<TimeRecord>>& children() const {
+        return m_children;
+    }
+
+    /// Add a run of this phase that took |wall| and |cpu| nanoseconds and
+    /// grew the peak resident set size of the process by |rss| kilobytes.
+    void add(u64 wall, u64 cpu, i64 rss);
+
+    /// Returns the number of runs of this phase.
+    u64 count() const { return m_count.load(); }
+
+    /// Returns the wall and CPU time of all runs of this phase in nanoseconds.
+    u64 wall() const { return m_wall.load(); }
+    u64 cpu() const { return m_cpu.load(); }
+
+    /// Returns how many kilobytes all runs of this phase grew the peak
+    /// resident set size of the process by.
+    i64 rss() const { return m_rss.load(); }
+};
+
+/// The global timer of compilation phases.
+///
+/// Each thread has a current record, which the phases that it begins are
+/// nested in. Tasks submitted to a thread pool inherit the current record of
+/// the thread that submitted them, so work that is spread over a pool is
+/// still reported under the phase that spread it out.
+class Timer final {
+    static std::unique_ptr<TimeRecord> pRoot;
+
+public:
+    Timer() = delete;
+
+    /// Enable timing, with all phases nested in a record named |name|. Until
+    /// this is called, scopes time nothing.
+    static void enable(std::string_view name);
+
+    /// Returns true if timing has been enabled.
+    static bool enabled() { return pRoot != nullptr; }
+
+    /// Returns the record that all others are nested in, or null if timing is
+    /// not enabled.
+    static TimeRecord* root() { return pRoot.get(); }
+
+    /// Returns the record that phases begun by the calling thread are nested
+    /// in, or null if timing is not enabled.
+    static TimeRecord* current();
+
+    /// Set the record that phases begun by the calling thread are nested in.
+    static void set_current(TimeRecord* record);
+
+    /// Print the tree of records to |os| as a table.
+    static void print(std::ostream& os);
+
+    /// Print the tree of records to |os| as JSON.
+    static void print_json(std::ostream& os);
+};
+
+/// The global trace of compilation phases, written out in the trace event
+/// format of Chrome and Perfetto.
+///
+/// Every run of a phase timed by a scope becomes a complete event on the
+/// thread that ran it. Events are buffered per thread, so that recording one
+/// never waits on another thread.
+class Trace final {
+public:
+    Trace() = delete;
+
+    /// Enable tracing. Until this is called, no events are recorded.
+    static void enable();
+
+    /// Returns true if tracing has been enabled.
+    static bool enabled();
+
+    /// Record an event for a run of |record| on the calling thread, which
+    /// began at |begin| nanoseconds of steady clock time and lasted |wall|.
+    /// The event is labelled with |detail| if it is not empty.
+    static void add(const TimeRecord* record, std::string_view detail, 
+                    u64 begin, u64 wall);
+
+    /// Write all events recorded so far to |os| as a JSON trace. This must
+    /// not be called while events may still be recorded.
+    static void write(std::ostream& os);
+};
+
+/// Times a single run of a phase, from construction to destruction or until
+/// it is stopped, and adds it to the record of the phase and to the trace.
+///
+/// CPU time is that of the thread which runs the scope. The work of other
+/// threads is only counted by the scopes that they run themselves.
+class TimeScope final {
+    TimeRecord* m_record = nullptr;
+    TimeRecord* m_parent = nullptr;
+    std::string_view m_detail = {};
+    u64 m_wall = 0;
+    u64 m_cpu = 0;
+    i64 m_rss = 0;
+
+    void begin(TimeRecord* record);
+
+public:
+    /// Time a run of the phase |name|, nested in the current record. The run
+    /// is labelled with |detail| in the trace, i.e. with the name of the 
+    /// function that it processed. |detail| must outlive the scope.
+    TimeScope(std::string_view name, std::string_view detail = {});
+
+    /// Time a run of the phase |record|. A null record times nothing.
+    TimeScope(TimeRecord* record);
+
+    TimeScope(const TimeScope&) = delete;
+    TimeScope& operator = (const TimeScope&) = delete;
+
+    ~TimeScope() { stop(); }
+
+    /// Stop this scope early, adding its run to its record.
+    void stop();
+};
+
+} // namespace stm
+
+#define STM_TIME_SCOPE_CONCAT_(a, b) a##b
+#define STM_TIME_SCOPE_VAR_(line) STM_TIME_SCOPE_CONCAT_(time_scope_, line)
+
+/// Time the rest of the enclosing block as a run of a phase, with the same
+/// arguments as a TimeScope. When timing is disabled this costs no more than
+/// reading a thread-local pointer.
+#define STM_TIME_SCOPE(...) \
+    ::stm::TimeScope STM_TIME_SCOPE_VAR_(__LINE__) { __VA_ARGS__ }
+
+#endif // STATIM_TIMER_HPP_
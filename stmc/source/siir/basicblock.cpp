@@ -1,4 +1,5 @@
 #include "siir/basicblock.hpp"
+#include "siir/cfg.hpp"
 #include "siir/function.hpp"
 #include "siir/instruction.hpp"
 
@@ -10,6 +11,10 @@ BasicBlock::BasicBlock(Function* parent) : m_parent(parent) {
         parent->push_back(this);
 }
 
+void* BasicBlock::operator new(size_t size, CFG& cfg) {
+    return cfg.allocate(size, alignof(BasicBlock));
+}
+
 BasicBlock::~BasicBlock() {
     Instruction* curr = m_front;
     while (curr) {
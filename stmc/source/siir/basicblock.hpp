@@ -11,6 +11,7 @@
 namespace stm {
 namespace siir {
 
+class CFG;
 class Function;
 
 /// The BasicBlock type is implemented as a node in a linked list, managed by
@@ -37,6 +38,12 @@ public:
     
     ~BasicBlock();
 
+    /// Basic blocks are allocated in the arena of the graph |cfg| that they
+    /// belong to, and their memory is only released with the graph.
+    static void* operator new(size_t size, CFG& cfg);
+    static void operator delete(void* ptr, CFG& cfg) {}
+    static void operator delete(void* ptr) {}
+
     /// Returns the parent function of this basic block.
     const Function* get_parent() const { return m_parent; }
     Function* get_parent() { return m_parent; }
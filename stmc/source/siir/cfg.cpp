@@ -14,15 +14,35 @@ CFG::CFG(InputFile& file, Target& target) : m_file(file), m_target(target) {
     m_types_floats[FloatType::TY_Float32] = new FloatType(FloatType::TY_Float32);
     m_types_floats[FloatType::TY_Float64] = new FloatType(FloatType::TY_Float64);
 
-    m_int1_zero = new ConstantInt(0, m_types_ints[IntegerType::TY_Int1]);
-    m_int1_one = new ConstantInt(1, m_types_ints[IntegerType::TY_Int1]);
+    m_int1_zero = new (*this) ConstantInt(
+        0, m_types_ints[IntegerType::TY_Int1]);
+    m_int1_one = new (*this) ConstantInt(
+        1, m_types_ints[IntegerType::TY_Int1]);
 }
 
 CFG::~CFG() {
-    for (auto [ name, global ] : m_globals) delete global;
+    // Everything below only destroys the values of the graph, since their
+    // memory belongs to the arena, which is released all at once afterwards.
+    //
+    // Drop every use edge in the graph before deleting any of it, so that no
+    // value is deleted while some use of it in another function, or in a
+    // block deleted later, still points to it.
+    m_functions.for_each([](Symbol name, Function* function) {
+        for (auto blk = function->front(); blk; blk = blk->next())
+            for (auto inst = blk->front(); inst; inst = inst->next())
+                inst->drop_operands();
+    });
+
+    m_globals.for_each([](Symbol name, Global* global) { 
+        global->drop_operands(); 
+    });
+
+    m_globals.for_each([](Symbol name, Global* global) { delete global; });
     m_globals.clear();
 
-    for (auto [ name, function ] : m_functions) delete function;
+    m_functions.for_each([](Symbol name, Function* function) { 
+        delete function; 
+    });
     m_functions.clear();
 
     for (auto [ kind, type ] : m_types_ints) delete type;
@@ -40,10 +60,12 @@ CFG::~CFG() {
 
     m_types_arrays.clear();
 
-    for (auto [ pointee, type ] : m_types_ptrs) delete type;
+    m_types_ptrs.for_each([](const Type* pointee, PointerType* type) { 
+        delete type; 
+    });
     m_types_ptrs.clear();
 
-    for (auto [ name, type ] : m_types_structs) delete type;
+    m_types_structs.for_each([](Symbol name, StructType* type) { delete type; });
     m_types_structs.clear();
 
     for (auto type : m_types_fns) delete type;
@@ -59,111 +81,109 @@ CFG::~CFG() {
         m_int1_one = nullptr;
     }
 
-    for (auto [ value, constant ] : m_pool_int8) delete constant;
+    m_pool_int8.for_each([](i8 value, ConstantInt* constant) { 
+        delete constant; 
+    });
     m_pool_int8.clear();
 
-    for (auto [ value, constant ] : m_pool_int16) delete constant;
+    m_pool_int16.for_each([](i16 value, ConstantInt* constant) { 
+        delete constant; 
+    });
     m_pool_int16.clear();
 
-    for (auto [ value, constant ] : m_pool_int32) delete constant;
+    m_pool_int32.for_each([](i32 value, ConstantInt* constant) { 
+        delete constant; 
+    });
     m_pool_int32.clear();
 
-    for (auto [ value, constant ] : m_pool_int64) delete constant;
+    m_pool_int64.for_each([](i64 value, ConstantInt* constant) { 
+        delete constant; 
+    });
     m_pool_int64.clear();
 
-    for (auto [ value, constant ] : m_pool_fp32) delete constant;
+    m_pool_fp32.for_each([](f32 value, ConstantFP* constant) { 
+        delete constant; 
+    });
     m_pool_fp32.clear();
 
-    for (auto [ value, constant ] : m_pool_fp64) delete constant;
+    m_pool_fp64.for_each([](f64 value, ConstantFP* constant) { 
+        delete constant; 
+    });
     m_pool_fp64.clear();
 
-    for (auto [ type, null ] : m_pool_null) delete null;
+    m_pool_null.for_each([](const Type* type, ConstantNull* null) { 
+        delete null; 
+    });
     m_pool_null.clear();
 
-    for (auto [ block, addr ] : m_pool_baddr) delete addr;
+    m_pool_baddr.for_each([](const BasicBlock* block, BlockAddress* addr) { 
+        delete addr; 
+    });
     m_pool_baddr.clear();
 
-    for (auto incoming : m_pool_incomings) delete incoming;
-    m_pool_incomings.clear();
+    m_pool_str.for_each([](const std::string& value, ConstantString* str) { 
+        delete str; 
+    });
+    m_pool_str.clear();
 }
 
 std::vector<StructType*> CFG::structs() const {
-    std::vector<StructType*> structs;
-    structs.reserve(m_types_structs.size());
-    for (auto& [name, type] : m_types_structs)
-        structs.push_back(type);
-
-    return structs;
+    std::shared_lock<std::shared_mutex> lock { m_types_structs_mutex };
+    return m_types_structs.sorted();
 }
 
 std::vector<Global*> CFG::globals() const {
-    std::vector<Global*> globals;
-    globals.reserve(m_globals.size());
-    for (auto& [name, global] : m_globals)
-        globals.push_back(global);
-
-    return globals;
+    return m_globals.sorted();
 }
 
-const Global* CFG::get_global(const std::string& name) const {
-    auto it = m_globals.find(name);
-    if (it != m_globals.end())
-        return it->second;
-
-    return nullptr;
+const Global* CFG::get_global(Symbol name) const {
+    Global* const* global = m_globals.find(name);
+    return global ? *global : nullptr;
 }
 
 void CFG::add_global(Global* glb) {
     assert(glb);
-    assert(!get_global(glb->get_name()) && !get_function(glb->get_name())
+    assert(!get_global(glb->get_symbol()) && !get_function(glb->get_symbol())
         && "global has name conflicts with existing graph symbol");
 
-    m_globals.emplace(glb->get_name(), glb);
+    m_globals.insert(glb->get_symbol(), glb);
     glb->set_parent(this);
 }
 
 void CFG::remove_global(Global* glb) {
-    auto it = m_globals.find(glb->get_name());
-    if (it != m_globals.end()) {
-        assert(it->second == glb);
+    Global* const* it = m_globals.find(glb->get_symbol());
+    if (it) {
+        assert(*it == glb);
         assert(glb->get_parent() == this);
 
-        m_globals.erase(it);
+        m_globals.erase(glb->get_symbol());
     }
 }
 
 std::vector<Function*> CFG::functions() const {
-    std::vector<Function*> functions;
-    functions.reserve(m_functions.size());
-    for (auto& [name, function] : m_functions)
-        functions.push_back(function);
-
-    return functions;
+    return m_functions.sorted();
 }
 
-const Function* CFG::get_function(const std::string& name) const {
-    auto it = m_functions.find(name);
-    if (it != m_functions.end())
-        return it->second;
-
-    return nullptr;
+const Function* CFG::get_function(Symbol name) const {
+    Function* const* function = m_functions.find(name);
+    return function ? *function : nullptr;
 }
 
 void CFG::add_function(Function* fn) {
     assert(fn);
-    assert(!get_global(fn->get_name()) && !get_function(fn->get_name())
+    assert(!get_global(fn->get_symbol()) && !get_function(fn->get_symbol())
         && "function has name conflicts with existing graph symbol");
 
-    m_functions.emplace(fn->get_name(), fn);
+    m_functions.insert(fn->get_symbol(), fn);
     fn->set_parent(this);
 }
 
 void CFG::remove_function(Function* fn) {
-    auto it = m_functions.find(fn->get_name());
-    if (it != m_functions.end()) {
-        assert(it->second == fn);
+    Function* const* it = m_functions.find(fn->get_symbol());
+    if (it) {
+        assert(*it == fn);
         assert(fn->get_parent() == this);
 
-        m_functions.erase(it);
+        m_functions.erase(fn->get_symbol());
     }
 }
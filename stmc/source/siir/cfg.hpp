@@ -6,11 +6,16 @@
 #include "siir/function.hpp"
 #include "siir/global.hpp"
 #include "siir/type.hpp"
+#include "types/arena.hpp"
 #include "types/input_file.hpp"
+#include "types/sharded_map.hpp"
+#include "types/symbol_map.hpp"
 #include "types/types.hpp"
 
-#include <map>
+#include <atomic>
+#include <mutex>
 #include <ostream>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -20,6 +25,13 @@ namespace siir {
 class Target;
 
 /// The top-level SIIR control flow graph.
+///
+/// Types, constants and definition ids can be requested from many threads at
+/// once, so that passes can process the functions in a graph concurrently.
+/// Everything else must only be mutated by one thread at a time.
+///
+/// Every value, use and basic block in a graph is allocated in its arena, and
+/// the memory of all of them is released at once when the graph is destroyed.
 class CFG final {
     friend class Type;
     friend class ArrayType;
@@ -31,39 +43,43 @@ class CFG final {
     friend class ConstantNull;
     friend class BlockAddress;
     friend class ConstantString;
-    friend class Instruction;
+
+    /// The arena that everything in this graph is allocated in. This must
+    /// outlive all other members, since they may point into it. Passes running
+    /// on different functions allocate at the same time, so it is locked.
+    std::mutex m_arena_mutex = {};
+    Arena m_arena = {};
 
     /// Top-level graph items.
     InputFile& m_file;
     Target& m_target;
-    u32 m_def_id = 1;
-    std::map<std::string, Global*> m_globals = {};
-    std::map<std::string, Function*> m_functions = {};
+    std::atomic<u32> m_def_id = 1;
+    SymbolMap<Global*> m_globals = {};
+    SymbolMap<Function*> m_functions = {};
 
-    /// Type pooling.
+    /// Type pooling. The integer and float types are all created with the
+    /// graph and never change afterwards, so they can be read without locks.
     std::unordered_map<IntegerType::Kind, IntegerType*> m_types_ints = {};
     std::unordered_map<FloatType::Kind, FloatType*> m_types_floats = {};
     std::unordered_map<const Type*, 
         std::unordered_map<u32, ArrayType*>> m_types_arrays = {};
-    std::unordered_map<const Type*, PointerType*> m_types_ptrs = {};
-    std::map<std::string, StructType*> m_types_structs = {};
+    ShardedMap<const Type*, PointerType*> m_types_ptrs = {};
+    mutable std::shared_mutex m_types_structs_mutex = {};
+    SymbolMap<StructType*> m_types_structs = {};
+    std::mutex m_types_fns_mutex = {};
     std::vector<FunctionType*> m_types_fns = {}; 
 
     /// Constant pooling.
     ConstantInt *m_int1_zero, *m_int1_one;
-    std::unordered_map<i8, ConstantInt*> m_pool_int8 = {};
-    std::unordered_map<i16, ConstantInt*> m_pool_int16 = {};
-    std::unordered_map<i32, ConstantInt*> m_pool_int32 = {};
-    std::unordered_map<i64, ConstantInt*> m_pool_int64 = {};
-    std::unordered_map<f32, ConstantFP*> m_pool_fp32 = {};
-    std::unordered_map<f64, ConstantFP*> m_pool_fp64 = {};
-    std::unordered_map<const Type*, ConstantNull*> m_pool_null = {};
-    std::unordered_map<const BasicBlock*, BlockAddress*> m_pool_baddr = {};
-    std::unordered_map<std::string, ConstantString*> m_pool_str = {};
-
-    /// PHI operand pooling. This is only here because the memory cannot be 
-    /// appropriately managed by the individual instructions 
-    std::vector<PhiOperand*> m_pool_incomings = {};
+    ShardedMap<i8, ConstantInt*> m_pool_int8 = {};
+    ShardedMap<i16, ConstantInt*> m_pool_int16 = {};
+    ShardedMap<i32, ConstantInt*> m_pool_int32 = {};
+    ShardedMap<i64, ConstantInt*> m_pool_int64 = {};
+    ShardedMap<f32, ConstantFP*> m_pool_fp32 = {};
+    ShardedMap<f64, ConstantFP*> m_pool_fp64 = {};
+    ShardedMap<const Type*, ConstantNull*> m_pool_null = {};
+    ShardedMap<const BasicBlock*, BlockAddress*> m_pool_baddr = {};
+    ShardedMap<std::string, ConstantString*> m_pool_str = {};
 
 public:
     /// Create a new control flow graph, representing |file| with the given
@@ -79,24 +95,41 @@ public:
     const InputFile& get_file() const { return m_file; }
     InputFile& get_file() { return m_file; }
 
-    /// Set the file that this graph represents to |file|.
-    void set_file(InputFile& file) { m_file = file; }
-
     /// Returns the target of this control flow graph.
     const Target& get_target() const { return m_target; }
     Target& get_target() { return m_target; }
 
+    /// Returns |size| bytes of uninitialized memory aligned to |align| from
+    /// the arena of this graph. The memory lives for as long as this graph
+    /// does, and whatever is created in it must be destroyed by its owner.
+    void* allocate(u64 size, u64 align) {
+        std::lock_guard<std::mutex> lock { m_arena_mutex };
+        return m_arena.allocate(size, align);
+    }
+
+    /// Create a new object of type T in this graph with |args|. Unlike memory
+    /// from allocate(), the object is destroyed along with this graph, and so
+    /// must not be destroyed by anything else.
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        std::lock_guard<std::mutex> lock { m_arena_mutex };
+        return m_arena.create<T>(std::forward<Args>(args)...);
+    }
+
+    /// Returns the arena that everything in this graph is allocated in.
+    const Arena& arena() const { return m_arena; }
+
     /// Return a list of all the structure types in this graph, in order of
-    /// creation.
+    /// name.
     std::vector<StructType*> structs() const;
 
-    /// Returns a list of all functions in this graph, in order of addition.
+    /// Returns a list of all globals in this graph, in order of name.
     std::vector<Global*> globals() const;
 
     /// Returns the global in this graph with the provided name, if it exists, 
     /// and null otherwise. 
-    const Global* get_global(const std::string& name) const;
-    Global* get_global(const std::string& name) {
+    const Global* get_global(Symbol name) const;
+    Global* get_global(Symbol name) {
         return const_cast<Global*>(
             static_cast<const CFG*>(this)->get_global(name));
     }
@@ -108,13 +141,13 @@ public:
     /// Remove |glb| if it exists in this graph.
     void remove_global(Global* glb);
 
-    /// Returns a list of all functions in this graph, in order of addition.
+    /// Returns a list of all functions in this graph, in order of name.
     std::vector<Function*> functions() const;
 
     /// Returns the function in this graph with the provided name if it exists, 
     /// and null otherwise.
-    const Function* get_function(const std::string& name) const;
-    Function* get_function(const std::string& name) {
+    const Function* get_function(Symbol name) const;
+    Function* get_function(Symbol name) {
         return const_cast<Function*>(
             static_cast<const CFG*>(this)->get_function(name));
     }
@@ -126,8 +159,12 @@ public:
     /// Remove |fn| if it exists in this graph.
     void remove_function(Function* fn);
 
-    /// Return a new unique definition id to create an instruction with.
-    u32 get_def_id() { return m_def_id++; }
+    /// Return a new unique definition id to create an instruction with. Ids
+    /// are unique across threads, but are only handed out in order when the
+    /// graph is built by a single thread.
+    u32 get_def_id() { 
+        return m_def_id.fetch_add(1, std::memory_order_relaxed); 
+    }
 
     /// Print this graph in a reproducible plaintext format to the output
     /// stream |os|.
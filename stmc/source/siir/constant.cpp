@@ -30,43 +30,27 @@ Constant* ConstantInt::get(CFG& cfg, const Type* type, i64 value) {
             return value == 0 ? cfg.m_int1_zero : cfg.m_int1_one;
 
         case IntegerType::TY_Int8: {
-            auto it = cfg.m_pool_int8.find(value);
-            if (it != cfg.m_pool_int8.end())
-                return it->second;
-
-            ConstantInt* cint = new ConstantInt(value, type);
-            cfg.m_pool_int8.emplace(value, cint);
-            return cint;
+            return cfg.m_pool_int8.get_or_create(value, [&]() {
+                return new (cfg) ConstantInt(value, type);
+            });
         }
             
         case IntegerType::TY_Int16: {
-            auto it = cfg.m_pool_int16.find(value);
-            if (it != cfg.m_pool_int16.end())
-                return it->second;
-
-            ConstantInt* cint = new ConstantInt(value, type);
-            cfg.m_pool_int16.emplace(value, cint);
-            return cint;
+            return cfg.m_pool_int16.get_or_create(value, [&]() {
+                return new (cfg) ConstantInt(value, type);
+            });
         }
         
         case IntegerType::TY_Int32: {
-            auto it = cfg.m_pool_int32.find(value);
-            if (it != cfg.m_pool_int32.end())
-                return it->second;
-
-            ConstantInt* cint = new ConstantInt(value, type);
-            cfg.m_pool_int32.emplace(value, cint);
-            return cint;
+            return cfg.m_pool_int32.get_or_create(value, [&]() {
+                return new (cfg) ConstantInt(value, type);
+            });
         }
         
         case IntegerType::TY_Int64: {
-            auto it = cfg.m_pool_int64.find(value);
-            if (it != cfg.m_pool_int64.end())
-                return it->second;
-
-            ConstantInt* cint = new ConstantInt(value, type);
-            cfg.m_pool_int64.emplace(value, cint);
-            return cint;
+            return cfg.m_pool_int64.get_or_create(value, [&]() {
+                return new (cfg) ConstantInt(value, type);
+            });
         }
     }
 }
@@ -85,23 +69,15 @@ Constant* ConstantFP::get(CFG& cfg, const Type* type, f64 value) {
 
     switch (static_cast<const FloatType*>(type)->get_kind()) {
         case FloatType::TY_Float32: {
-            auto it = cfg.m_pool_fp32.find(value);
-            if (it != cfg.m_pool_fp32.end())
-                return it->second;
-
-            ConstantFP* cfp = new ConstantFP(value, type);
-            cfg.m_pool_fp32.emplace(value, cfp);
-            return cfp;
+            return cfg.m_pool_fp32.get_or_create(value, [&]() {
+                return new (cfg) ConstantFP(value, type);
+            });
         }
 
         case FloatType::TY_Float64: {
-            auto it = cfg.m_pool_fp64.find(value);
-            if (it != cfg.m_pool_fp64.end())
-                return it->second;
-
-            ConstantFP* cfp = new ConstantFP(value, type);
-            cfg.m_pool_fp64.emplace(value, cfp);
-            return cfp;
+            return cfg.m_pool_fp64.get_or_create(value, [&]() {
+                return new (cfg) ConstantFP(value, type);
+            });
         }
     }
 }
@@ -109,37 +85,25 @@ Constant* ConstantFP::get(CFG& cfg, const Type* type, f64 value) {
 Constant* ConstantNull::get(CFG& cfg, const Type* type) {
     assert(type);
 
-    auto it = cfg.m_pool_null.find(type);
-    if (it != cfg.m_pool_null.end())
-        return it->second;
-
-    ConstantNull* null = new ConstantNull(type);
-    cfg.m_pool_null.emplace(type, null);
-    return null;
+    return cfg.m_pool_null.get_or_create(type, [&]() {
+        return new (cfg) ConstantNull(type);
+    });
 }
 
 Constant* BlockAddress::get(CFG& cfg, BasicBlock* blk) {
     assert(blk);
 
-    auto it = cfg.m_pool_baddr.find(blk);
-    if (it != cfg.m_pool_baddr.end())
-        return it->second;
-
-    BlockAddress* null = new BlockAddress(blk);
-    cfg.m_pool_baddr.emplace(blk, null);
-    return null;
+    return cfg.m_pool_baddr.get_or_create(blk, [&]() {
+        return new (cfg) BlockAddress(blk);
+    });
 }
 
 ConstantString* ConstantString::get(CFG& cfg, const std::string& string) {
-    auto it = cfg.m_pool_str.find(string);
-    if (it != cfg.m_pool_str.end())
-        return it->second;
-
-    ConstantString* str = new ConstantString(
-        string, 
-        PointerType::get(cfg, Type::get_i8_type(cfg)));
+    // Get the type before locking the pool, since it may need to be created.
+    const Type* type = PointerType::get(cfg, Type::get_i8_type(cfg));
         //ArrayType::get(cfg, Type::get_i8_type(cfg), string.size() + 1));
 
-    cfg.m_pool_str.emplace(string, str);
-    return str;
+    return cfg.m_pool_str.get_or_create(string, [&]() {
+        return new (cfg) ConstantString(string, type);
+    });
 }
@@ -18,17 +18,25 @@ class CFG;
 /// are comprised of constant operands.
 class Constant : public User {
 protected:
-    Constant() = default;
+    Constant(Kind kind) : User(kind) {}
 
-    Constant(std::initializer_list<Value*> ops, const Type* type) 
-        : User(ops, type) {}
+    Constant(Kind kind, const Type* type) : User(kind, type) {}
+
+    Constant(Kind kind, CFG& cfg, std::initializer_list<Value*> ops, 
+             const Type* type) : User(kind, cfg, ops, type) {}
 
 public:
     virtual ~Constant() = default;
 
     bool is_constant() const override { return true; }
 
+    bool has_shared_uses() const override { return true; }
+
     virtual bool is_aggregate() const { return false; }
+
+    static bool classof(const Value* value) {
+        return value->get_kind() >= VK_ConstantInt;
+    }
 };
 
 /// A constant integer literal.
@@ -40,7 +48,7 @@ class ConstantInt final : public Constant {
 
     /// Private constructor. To be used by the graph context for pooling.
     ConstantInt(i64 value, const Type* type)
-        : Constant({}, type), m_value(value) {}
+        : Constant(VK_ConstantInt, type), m_value(value) {}
 
 public:
     ConstantInt(const ConstantInt&) = delete;
@@ -65,6 +73,10 @@ public:
     i64 get_value() const { return m_value; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_ConstantInt;
+    }
 };
 
 /// A constant floating-point literal.
@@ -76,7 +88,7 @@ class ConstantFP final : public Constant {
 
     /// Private constructor. To be used by the graph context for pooling.
     ConstantFP(f64 value, const Type* type) 
-        : Constant({}, type), m_value(value) {}
+        : Constant(VK_ConstantFP, type), m_value(value) {}
 
 public:
     ConstantFP(const ConstantFP&) = delete;
@@ -95,6 +107,10 @@ public:
     f64 get_value() const { return m_value; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_ConstantFP;
+    }
 };
 
 /// A constant null pointer literal.
@@ -102,7 +118,7 @@ class ConstantNull final : public Constant {
     friend class CFG;
     
     /// Private constructor. To be used by the graph context for pooling.
-    ConstantNull(const Type* type) : Constant({}, type) {}
+    ConstantNull(const Type* type) : Constant(VK_ConstantNull, type) {}
 
 public:
     ConstantNull(const ConstantNull&) = delete;
@@ -112,6 +128,10 @@ public:
     static Constant* get(CFG& cfg, const Type* type);
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_ConstantNull;
+    }
 };
 
 /// A constant block address, used for branching destinations.
@@ -122,7 +142,7 @@ class BlockAddress final : public Constant {
     BasicBlock* m_block;
 
     /// Private constructor. To be used by the graph context for pooling.
-    BlockAddress(BasicBlock* blk) : Constant(), m_block(blk) {}
+    BlockAddress(BasicBlock* blk) : Constant(VK_BlockAddress), m_block(blk) {}
 
 public:
     /// Get the block address for the given block.
@@ -133,17 +153,24 @@ public:
     BasicBlock* get_block() { return m_block; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_BlockAddress;
+    }
 };
 
 class ConstantAggregate : public Constant {
 public:
-    ConstantAggregate(std::initializer_list<Value*> ops, const Type* type)
-        : Constant(ops, type) {}
+    ConstantAggregate(Kind kind, const Type* type) : Constant(kind, type) {}
 
     ConstantAggregate(const ConstantAggregate&) = delete;
     ConstantAggregate& operator = (const ConstantAggregate&) = delete;
 
     bool is_aggregate() const override { return true; }
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_ConstantString;
+    }
 };
 
 class ConstantString final : public ConstantAggregate {
@@ -154,7 +181,7 @@ class ConstantString final : public ConstantAggregate {
 
     /// Private constructor. To be used by the graph context for pooling.
     ConstantString(const std::string& value, const Type* type) 
-        : ConstantAggregate({}, type), m_value(value) {}
+        : ConstantAggregate(VK_ConstantString, type), m_value(value) {}
 
 public:
     ConstantString(const ConstantString&) = delete;
@@ -167,6 +194,10 @@ public:
     const std::string& get_value() const { return m_value; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_ConstantString;
+    }
 };
 
 } // namespace siir
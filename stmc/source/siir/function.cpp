@@ -5,13 +5,15 @@
 using namespace stm;
 using namespace stm::siir;
 
-Argument::Argument(const Type* type, const std::string& name, u32 number, 
+Argument::Argument(const Type* type, Symbol name, u32 number, 
                    Function* parent)
-    : Value(type), m_name(name), m_number(number), m_parent(parent) {}
+    : Value(VK_Argument, type), m_name(name), m_number(number), 
+      m_parent(parent) {}
 
 Function::Function(CFG& cfg, LinkageType linkage, const FunctionType* type,
-                   const std::string& name, const std::vector<Argument*>& args)
-    : Value(type), m_linkage(linkage), m_name(name), m_args(args) {
+                   Symbol name, const std::vector<Argument*>& args)
+    : Value(VK_Function, type), m_linkage(linkage), m_name(name), 
+      m_args(args) {
 
     for (u32 idx = 0, e = args.size(); idx != e; ++idx) {
         args[idx]->set_number(idx);
@@ -25,7 +27,7 @@ Function::~Function() {
     for (auto arg : m_args) delete arg;
     m_args.clear();
 
-    for (auto [ name, local ] : m_locals) delete local;
+    m_locals.for_each([](Symbol name, Local* local) { delete local; });
     m_locals.clear();
 
     BasicBlock* curr = m_front;
@@ -61,30 +63,23 @@ void Function::set_arg(u32 i, Argument* arg) {
     arg->set_parent(this);
 }
 
-const Local* Function::get_local(const std::string& name) const {
-    auto it = m_locals.find(name);
-    if (it != m_locals.end())
-        return it->second;
-
-    return nullptr;
+const Local* Function::get_local(Symbol name) const {
+    Local* const* local = m_locals.find(name);
+    return local ? *local : nullptr;
 }
 
 void Function::add_local(Local* local) {
-    assert(!get_local(local->get_name()) &&
+    assert(!get_local(local->get_symbol()) &&
         "local with name already exists in function");
     
-    m_locals.emplace(local->get_name(), local);
+    m_locals.insert(local->get_symbol(), local);
     local->set_parent(this);
 }
 
 void Function::remove_local(Local* local) {
     assert(local && "local cannot be null");
 
-    auto it = m_locals.find(local->get_name());
-    if (it == m_locals.end())
-        return;
-
-    m_locals.erase(it);
+    m_locals.erase(local->get_symbol());
 }
 
 void Function::push_front(BasicBlock* blk) {
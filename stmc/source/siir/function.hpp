@@ -5,9 +5,9 @@
 #include "siir/local.hpp"
 #include "siir/type.hpp"
 #include "siir/value.hpp"
+#include "types/symbol_map.hpp"
 
 #include <cassert>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -22,14 +22,14 @@ class Argument final : public Value {
     Function* m_parent;
 
     /// The name of this argument.
-    std::string m_name;
+    Symbol m_name;
 
     /// The position of this argument in its parent function.
     u32 m_number;
 
 public:
     /// Create a new argument for position |number| in function |parent|. 
-    Argument(const Type* type, const std::string& name, u32 number, 
+    Argument(const Type* type, Symbol name, u32 number, 
              Function* parent = nullptr);
 
     Argument(const Argument&) = delete;
@@ -46,10 +46,10 @@ public:
     void set_parent(Function* parent) { m_parent = parent; }
 
     /// Get the name of this argument.
-    const std::string& get_name() const { return m_name; }
+    const std::string& get_name() const { return m_name.str(); }
 
     /// Rename this argument to |name|.
-    void rename(const std::string& name) { m_name = name; }
+    void rename(Symbol name) { m_name = name; }
 
     /// Returns the number of this argument in its parent function.
     u32 get_number() const { return m_number; }
@@ -58,6 +58,10 @@ public:
     void set_number(u32 number) { m_number = number; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_Argument;
+    }
 };
  
 /// A function routine consisting of basic blocks.
@@ -74,13 +78,13 @@ private:
     CFG* m_parent;
 
     /// The name of this function.
-    std::string m_name;
+    Symbol m_name;
 
     /// The list of arguments that this function uses.
     std::vector<Argument*> m_args;
 
     /// The stack-based locals of this function.
-    std::map<std::string, Local*> m_locals = {};
+    SymbolMap<Local*> m_locals = {};
 
     /// Links to the first and last basic blocks of this function.
     BasicBlock* m_front = nullptr;
@@ -93,13 +97,15 @@ public:
     /// Create a new function. Providing |parent| does not automatically add
     /// the new function to the given graph.
     Function(CFG& cfg, LinkageType linkage, const FunctionType* type, 
-             const std::string& name, const std::vector<Argument*>& args);
+             Symbol name, const std::vector<Argument*>& args);
 
     Function(const Function&) = delete;
     Function& operator = (const Function&) = delete;
 
     ~Function() override;
 
+    bool has_shared_uses() const override { return true; }
+
     /// Get the linkage type of this function.
     LinkageType get_linkage() const { return m_linkage; }
     
@@ -117,10 +123,13 @@ public:
     }
 
     /// Get the name of this function.
-    const std::string& get_name() const { return m_name; }
+    const std::string& get_name() const { return m_name.str(); }
+
+    /// Get the interned name of this function.
+    Symbol get_symbol() const { return m_name; }
 
     /// Rename this function to |name|.
-    void rename(const std::string& name) { m_name = name; }
+    void rename(Symbol name) { m_name = name; }
 
     /// Get the parent graph of this function.
     const CFG* get_parent() const { return m_parent; }
@@ -161,13 +170,15 @@ public:
     /// Append |arg| to this functions' argument list.
     void append_arg(Argument* arg) { m_args.push_back(arg); }
 
-    /// Returns the locals in this function.
-    const std::map<std::string, Local*>& locals() const { return m_locals; }
-    std::map<std::string, Local*>& locals() { return m_locals; }
+    /// Returns the locals in this function, in order of name.
+    std::vector<Local*> locals() const { return m_locals.sorted(); }
+
+    /// Returns true if this function has any locals.
+    bool has_locals() const { return !m_locals.empty(); }
 
     /// Returns the local in this function by name if one exists.
-    const Local* get_local(const std::string& name) const;
-    Local* get_local(const std::string& name) {
+    const Local* get_local(Symbol name) const;
+    Local* get_local(Symbol name) {
         return const_cast<Local*>(
             static_cast<const Function*>(this)->get_local(name));
     }
@@ -211,6 +222,10 @@ public:
 
     void print(std::ostream& os) const override;
 
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_Function;
+    }
+
     struct iterator {
         using iterator_category = std::bidirectional_iterator_tag;
         using value_type = BasicBlock;
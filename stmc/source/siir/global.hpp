@@ -2,6 +2,7 @@
 #define STATIM_SIIR_GLOBAL_HPP_
 
 #include "siir/constant.hpp"
+#include "types/symbol.hpp"
 
 namespace stm {
 namespace siir {
@@ -22,7 +23,7 @@ private:
     CFG* m_parent;
 
     /// The name of this global variable.
-    std::string m_name;
+    Symbol m_name;
 
     /// The optional, constant initializer of this data.
     Constant* m_init;
@@ -39,7 +40,7 @@ public:
     /// no mutations can occur to the new global. If |read_only| is true, then
     /// the |init| argument must also be provided.
     Global(CFG& cfg, const Type* type, LinkageType linkage, bool read_only, 
-           const std::string& name, Constant* init = nullptr);
+           Symbol name, Constant* init = nullptr);
 
     Global(const Global&) = delete;
     Global& operator = (const Global&) = delete;
@@ -57,10 +58,13 @@ public:
     void set_parent(CFG* parent) { m_parent = parent; }
 
     /// Get the name of this global variable.
-    const std::string& get_name() const { return m_name; }
+    const std::string& get_name() const { return m_name.str(); }
+
+    /// Get the interned name of this global variable.
+    Symbol get_symbol() const { return m_name; }
 
     /// Set the name of this global to variable to |name|.
-    void set_name(const std::string& name) { m_name = name; }
+    void set_name(Symbol name) { m_name = name; }
 
     /// Returns the constant initializer of this data, if it exists.
     Constant* get_initializer() const { return m_init; }
@@ -84,6 +88,10 @@ public:
     void set_read_only(bool value = true) { m_read_only = value; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_Global;
+    }
 };
 
 } // namespace siir
@@ -13,7 +13,7 @@ class InlineAsm final : public Value {
 public:
     InlineAsm(const FunctionType* type, const std::string& iasm, 
               const std::vector<std::string>& constraints, bool side_effects)
-        : Value(type), m_iasm(iasm), m_constraints(constraints), 
+        : Value(VK_InlineAsm, type), m_iasm(iasm), m_constraints(constraints), 
           m_side_effects(side_effects) {}
 
     InlineAsm(const InlineAsm&) = delete;
@@ -31,6 +31,10 @@ public:
     bool has_side_effects() const { return m_side_effects; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_InlineAsm;
+    }
 };
 
 } // namespace stm::siir
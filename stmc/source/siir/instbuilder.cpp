@@ -22,7 +22,8 @@ void InstBuilder::insert(Instruction* inst) {
 
 Instruction* InstBuilder::insert(Opcode op, u32 result, const Type* type, 
                                  const std::vector<Value*>& operands) {
-    Instruction* inst = new Instruction(result, type, op, nullptr, operands);
+    Instruction* inst = new (m_cfg) Instruction(
+        m_cfg, result, type, op, nullptr, operands);
     insert(inst);
     return inst;
 }
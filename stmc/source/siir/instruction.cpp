@@ -8,7 +8,7 @@ using namespace stm;
 using namespace stm::siir;
 
 PhiOperand::PhiOperand(Value* value, BasicBlock* pred) 
-    : Value(value->get_type()), m_value(value), m_pred(pred) {}
+    : Value(VK_PhiOperand, value->get_type()), m_value(value), m_pred(pred) {}
 
 std::string stm::siir::opcode_to_string(Opcode op) {
     switch (op) {
@@ -155,20 +155,19 @@ std::string stm::siir::opcode_to_string(Opcode op) {
     }
 }
 
-Instruction::Instruction(Opcode opcode, BasicBlock* parent,
+Instruction::Instruction(CFG& cfg, Opcode opcode, BasicBlock* parent,
                          const std::vector<Value*>& operands)
-    : User(operands, nullptr), m_result(0), m_opcode(opcode), 
-      m_parent(parent) {}
+    : User(VK_Instruction, cfg, operands, nullptr), m_result(0), 
+      m_opcode(opcode), m_parent(parent) {}
 
-Instruction::Instruction(u32 result, const Type* type, Opcode opcode, 
-                         BasicBlock* parent, 
+Instruction::Instruction(CFG& cfg, u32 result, const Type* type, 
+                         Opcode opcode, BasicBlock* parent, 
                          const std::vector<Value*>& operands)
-    : User(operands, type), m_result(result), m_opcode(opcode), 
-      m_parent(parent) {}
+    : User(VK_Instruction, cfg, operands, type), m_result(result), 
+      m_opcode(opcode), m_parent(parent) {}
 
 const Value* Instruction::get_operand(u32 i) const {
-    assert(i <= num_operands());
-    return m_operands[i]->get_value();
+    return User::get_operand(i)->get_value();
 }
 
 void Instruction::prepend_to(BasicBlock* blk) {
@@ -361,9 +360,9 @@ bool Instruction::operates_on_floats() const {
 }
 
 void Instruction::add_incoming(CFG& cfg, Value* value, BasicBlock* pred) {
-    PhiOperand* incoming = new PhiOperand(value, pred);
-    cfg.m_pool_incomings.push_back(incoming);
-    User::add_operand(incoming);
+    // Incoming edges are never deleted on their own, so they are left to be
+    // destroyed with the graph.
+    User::add_operand(cfg, cfg.create<PhiOperand>(value, pred));
 }
 
 bool Instruction::is_trivially_dead() const {
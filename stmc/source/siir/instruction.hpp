@@ -32,11 +32,19 @@ public:
     const Value* get_value() const { return m_value; }
     Value* get_value() { return m_value; }
 
+    /// Set the value of this incoming phi edge to |value|. This does not move
+    /// the use of the edge over, see Use::set_value for that.
+    void set_value(Value* value) { m_value = value; }
+
     /// Returns the predecessor basic block of this incoming phi edge.
     const BasicBlock* get_pred() const { return m_pred; }
     BasicBlock* get_pred() { return m_pred; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_PhiOperand;
+    }
 };
 
 /// Potential opcodes for an IR instruction.
@@ -150,14 +158,14 @@ class Instruction final : public User {
     /// Create a new non-defining instruction.
     ///
     /// Private constructor to be used by the InstBuilder class.
-    Instruction(Opcode opcode, BasicBlock* parent, 
+    Instruction(CFG& cfg, Opcode opcode, BasicBlock* parent, 
                 const std::vector<Value*>& operands = {});
     
     /// Create a new defining instruction.
     ///
     /// Private construtor to be used by the InstBuilder class.
-    Instruction(u32 result, const Type* type, Opcode opcode, BasicBlock* parent,
-                const std::vector<Value*>& operands = {});
+    Instruction(CFG& cfg, u32 result, const Type* type, Opcode opcode, 
+                BasicBlock* parent, const std::vector<Value*>& operands = {});
 
 public:
     Instruction(const Instruction&) = delete;
@@ -296,6 +304,10 @@ public:
     bool is_trivially_dead() const;
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_Instruction;
+    }
 };
 
 } // namespace siir
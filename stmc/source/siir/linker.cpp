@@ -0,0 +1,562 @@
+#include "siir/linker.hpp"
+#include "core/logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <elf.h>
+#include <map>
+#include <unordered_map>
+
+using namespace stm;
+using namespace stm::siir;
+
+namespace {
+
+/// The sections of an executable, in the order they are laid out in.
+enum OutputKind : u32 {
+    OUTPUT_RODATA,
+    OUTPUT_TEXT,
+    OUTPUT_GOT,
+    OUTPUT_DATA,
+    OUTPUT_BSS,
+    OUTPUT_COUNT,
+};
+
+/// A section of an executable, made up of the input sections of its kind.
+struct OutputSection final {
+    const char* name;
+    u32 type;
+    u64 flags;
+    u64 align = 1;
+    u64 size = 0;
+    u64 address = 0;
+    u64 offset = 0;
+    std::vector<u8> data = {};
+};
+
+/// Where an input section ends up in the executable.
+struct Placement final {
+    /// The output section, or OUTPUT_COUNT if the section was discarded.
+    u32 output = OUTPUT_COUNT;
+
+    /// The offset of the input section in its output section.
+    u64 offset = 0;
+};
+
+/// A resolved symbol, as the index of the object that defines it and the
+/// index of the symbol in that object.
+struct Definition final {
+    static constexpr u32 NONE = ~0u;
+
+    /// The defining object, or NONE for an undefined weak symbol.
+    u32 object = NONE;
+    u32 symbol = 0;
+
+    bool operator == (const Definition& other) const = default;
+
+    bool operator < (const Definition& other) const {
+        return object != other.object
+            ? object < other.object : symbol < other.symbol;
+    }
+};
+
+} // namespace
+
+/// Returns |value| rounded up to a multiple of |align|.
+static u64 align_up(u64 value, u64 align) {
+    if (align <= 1)
+        return value;
+
+    return (value + align - 1) / align * align;
+}
+
+/// Appends the raw bytes of |value| to |bytes|.
+template<typename T>
+static void append(std::vector<u8>& bytes, const T& value) {
+    const u8* raw = reinterpret_cast<const u8*>(&value);
+    bytes.insert(bytes.end(), raw, raw + sizeof(T));
+}
+
+/// Appends |str| to the string table |table| and returns its offset in it.
+static u32 add_string(std::vector<u8>& table, const std::string& str) {
+    if (str.empty())
+        return 0;
+
+    u32 offset = table.size();
+    table.insert(table.end(), str.begin(), str.end());
+    table.push_back('\0');
+    return offset;
+}
+
+/// Returns the output section that |section| is merged into.
+static u32 classify(const ObjectSection& section, const ObjectFile& object) {
+    // Sections that are not loaded, like comments and the stack note, have no
+    // place in the image.
+    if (!(section.flags & SHF_ALLOC))
+        return OUTPUT_COUNT;
+
+    // Unwind tables and notes are of no use without an unwinder or loader to
+    // read them.
+    if (section.type == SHT_NOTE || section.type == SHT_X86_64_UNWIND ||
+      section.name == ".eh_frame")
+        return OUTPUT_COUNT;
+
+    if (section.flags & SHF_TLS) {
+        Logger::fatal("thread-local section '" + section.name +
+            "' is unsupported in '" + object.filename() + "'");
+    }
+
+    if (section.type == SHT_NOBITS)
+        return OUTPUT_BSS;
+    else if (section.flags & SHF_WRITE)
+        return OUTPUT_DATA;
+    else if (section.flags & SHF_EXECINSTR)
+        return OUTPUT_TEXT;
+
+    return OUTPUT_RODATA;
+}
+
+/// Returns true if |type| refers to the global offset table entry of a
+/// symbol, rather than the symbol itself.
+static bool is_got_relocation(u32 type) {
+    return type == R_X86_64_GOTPCREL || type == R_X86_64_GOTPCRELX ||
+        type == R_X86_64_REX_GOTPCRELX;
+}
+
+void Linker::add(const ObjectFile& object) {
+    if (object.machine() != EM_X86_64) {
+        Logger::fatal("cannot link object for a machine other than x86-64: '" +
+            object.filename() + "'");
+    }
+
+    m_objects.push_back(&object);
+}
+
+void Linker::run(std::ostream& os, const std::string& entry) const {
+    // Resolve every global symbol to a single definition. Strong definitions
+    // override weak ones, but two strong definitions conflict.
+    std::unordered_map<std::string, Definition> globals = {};
+    for (u32 idx = 0, e = m_objects.size(); idx != e; ++idx) {
+        const std::vector<ObjectSymbol>& symbols = m_objects[idx]->symbols();
+        for (u32 sym = 0, e = symbols.size(); sym != e; ++sym) {
+            const ObjectSymbol& symbol = symbols[sym];
+            if (symbol.binding == STB_LOCAL || !symbol.is_defined())
+                continue;
+
+            auto [it, inserted] = globals.emplace(
+                symbol.name, Definition { idx, sym });
+            if (inserted)
+                continue;
+
+            const Definition prev = it->second;
+            const ObjectFile* prev_obj = m_objects[prev.object];
+            if (prev_obj->symbols()[prev.symbol].binding == STB_WEAK) {
+                if (symbol.binding != STB_WEAK)
+                    it->second = { idx, sym };
+            } else if (symbol.binding != STB_WEAK) {
+                Logger::fatal("duplicate symbol '" + symbol.name + "' in '" +
+                    prev_obj->filename() + "' and '" +
+                    m_objects[idx]->filename() + "'");
+            }
+        }
+    }
+
+    auto resolve = [&](u32 object, u32 sym) -> Definition {
+        const ObjectSymbol& symbol = m_objects[object]->symbols()[sym];
+        if (symbol.binding == STB_LOCAL)
+            return { object, sym };
+
+        auto it = globals.find(symbol.name);
+        if (it != globals.end())
+            return it->second;
+        else if (symbol.binding == STB_WEAK)
+            return {};
+
+        Logger::fatal("undefined reference to '" + symbol.name + "' in '" +
+            m_objects[object]->filename() + "'");
+    };
+
+    std::vector<OutputSection> outputs = {
+        { ".rodata", SHT_PROGBITS, SHF_ALLOC },
+        { ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR },
+        { ".got", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 8 },
+        { ".data", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE },
+        { ".bss", SHT_NOBITS, SHF_ALLOC | SHF_WRITE },
+    };
+
+    // Merge each input section into the end of its output section, in the
+    // order that the objects were added in.
+    std::vector<std::vector<Placement>> placements(m_objects.size());
+    for (u32 idx = 0, e = m_objects.size(); idx != e; ++idx) {
+        const std::vector<ObjectSection>& sections =
+            m_objects[idx]->sections();
+
+        placements[idx].resize(sections.size());
+        for (u32 sec = 0, e = sections.size(); sec != e; ++sec) {
+            const ObjectSection& section = sections[sec];
+            const u32 kind = classify(section, *m_objects[idx]);
+            if (kind == OUTPUT_COUNT)
+                continue;
+
+            OutputSection& output = outputs[kind];
+            output.align = std::max(output.align, section.align);
+            output.size = align_up(output.size, section.align);
+            placements[idx][sec] = { kind, output.size };
+            output.size += section.data.size();
+        }
+    }
+
+    // Static executables have no dynamic loader to fill in a global offset
+    // table, so each entry is filled in by the linker with the address of
+    // its symbol.
+    std::vector<Definition> got = {};
+    std::map<Definition, u32> got_slots = {};
+    for (u32 idx = 0, e = m_objects.size(); idx != e; ++idx) {
+        const std::vector<ObjectSection>& sections =
+            m_objects[idx]->sections();
+
+        for (u32 sec = 0, e = sections.size(); sec != e; ++sec) {
+            if (placements[idx][sec].output == OUTPUT_COUNT)
+                continue;
+
+            for (const ObjectRelocation& reloc : sections[sec].relocs) {
+                if (!is_got_relocation(reloc.type))
+                    continue;
+
+                const Definition def = resolve(idx, reloc.symbol);
+                if (got_slots.emplace(def, got.size()).second)
+                    got.push_back(def);
+            }
+        }
+    }
+
+    outputs[OUTPUT_GOT].size = got.size() * 8;
+
+    // Lay out the executable as a read-only segment for the headers and
+    // constants, an executable segment for code, and a writable segment
+    // for everything else. Each segment starts on a new page, and is loaded
+    // at the same offset from the base address as it is in the file.
+    const bool has_text = outputs[OUTPUT_TEXT].size != 0;
+    const bool has_data = outputs[OUTPUT_GOT].size != 0 ||
+        outputs[OUTPUT_DATA].size != 0 || outputs[OUTPUT_BSS].size != 0;
+    const u32 num_segments = 1 + has_text + has_data;
+
+    std::vector<Elf64_Phdr> segments = {};
+    u64 offset = sizeof(Elf64_Ehdr) + num_segments * sizeof(Elf64_Phdr);
+    u64 segment_start = 0;
+
+    auto place = [&](u32 kind) {
+        OutputSection& output = outputs[kind];
+        offset = align_up(offset, output.align);
+        output.offset = offset;
+        output.address = BASE_ADDRESS + offset;
+        if (output.type != SHT_NOBITS)
+            offset += output.size;
+    };
+
+    auto end_segment = [&](u32 flags, u64 mem_end) {
+        Elf64_Phdr phdr = {};
+        phdr.p_type = PT_LOAD;
+        phdr.p_flags = flags;
+        phdr.p_offset = segment_start;
+        phdr.p_vaddr = BASE_ADDRESS + segment_start;
+        phdr.p_paddr = phdr.p_vaddr;
+        phdr.p_filesz = offset - segment_start;
+        phdr.p_memsz = mem_end - phdr.p_vaddr;
+        phdr.p_align = PAGE_SIZE;
+        segments.push_back(phdr);
+    };
+
+    place(OUTPUT_RODATA);
+    end_segment(PF_R, BASE_ADDRESS + offset);
+
+    if (has_text) {
+        offset = segment_start = align_up(offset, PAGE_SIZE);
+        place(OUTPUT_TEXT);
+        end_segment(PF_R | PF_X, BASE_ADDRESS + offset);
+    }
+
+    if (has_data) {
+        offset = segment_start = align_up(offset, PAGE_SIZE);
+        place(OUTPUT_GOT);
+        place(OUTPUT_DATA);
+        place(OUTPUT_BSS);
+
+        const OutputSection& bss = outputs[OUTPUT_BSS];
+        end_segment(PF_R | PF_W, bss.address + bss.size);
+    }
+
+    auto address_of = [&](const Definition& def) -> u64 {
+        if (def.object == Definition::NONE)
+            return 0;
+
+        const ObjectFile& object = *m_objects[def.object];
+        const ObjectSymbol& symbol = object.symbols()[def.symbol];
+        const Placement& placement = placements[def.object][symbol.section];
+        if (placement.output == OUTPUT_COUNT) {
+            Logger::fatal("reference to discarded section '" +
+                object.sections()[symbol.section].name + "' in '" +
+                object.filename() + "'");
+        }
+
+        return outputs[placement.output].address + placement.offset +
+            symbol.value;
+    };
+
+    for (u32 kind = 0; kind != OUTPUT_COUNT; ++kind)
+        if (outputs[kind].type != SHT_NOBITS)
+            outputs[kind].data.resize(outputs[kind].size, 0);
+
+    for (u32 idx = 0, e = got.size(); idx != e; ++idx) {
+        const u64 address = address_of(got[idx]);
+        std::memcpy(&outputs[OUTPUT_GOT].data[idx * 8], &address, 8);
+    }
+
+    // Copy the contents of each input section into place and apply its
+    // relocations there.
+    for (u32 idx = 0, e = m_objects.size(); idx != e; ++idx) {
+        const ObjectFile& object = *m_objects[idx];
+        const std::vector<ObjectSection>& sections = object.sections();
+
+        for (u32 sec = 0, e = sections.size(); sec != e; ++sec) {
+            const ObjectSection& section = sections[sec];
+            const Placement& placement = placements[idx][sec];
+            if (placement.output == OUTPUT_COUNT)
+                continue;
+
+            OutputSection& output = outputs[placement.output];
+            if (output.type == SHT_NOBITS) {
+                if (!section.relocs.empty()) {
+                    Logger::fatal("relocations in section '" + section.name +
+                        "' without contents in '" + object.filename() + "'");
+                }
+
+                continue;
+            }
+
+            std::copy(section.data.begin(), section.data.end(),
+                output.data.begin() + placement.offset);
+
+            for (const ObjectRelocation& reloc : section.relocs) {
+                const Definition def = resolve(idx, reloc.symbol);
+                const u64 S = address_of(def);
+                const i64 A = reloc.addend;
+                const u64 P = output.address + placement.offset + reloc.offset;
+
+                u64 value = 0;
+                u32 size = 4;
+                bool is_signed = true;
+                switch (reloc.type) {
+                case R_X86_64_NONE:
+                    continue;
+                case R_X86_64_64:
+                    value = S + A;
+                    size = 8;
+                    break;
+                case R_X86_64_PC64:
+                    value = S + A - P;
+                    size = 8;
+                    break;
+                case R_X86_64_PC32:
+                case R_X86_64_PLT32:
+                    value = S + A - P;
+                    break;
+                case R_X86_64_32:
+                    value = S + A;
+                    is_signed = false;
+                    break;
+                case R_X86_64_32S:
+                    value = S + A;
+                    break;
+                case R_X86_64_GOTPCREL:
+                case R_X86_64_GOTPCRELX:
+                case R_X86_64_REX_GOTPCRELX:
+                    value = outputs[OUTPUT_GOT].address +
+                        got_slots.at(def) * 8 + A - P;
+                    break;
+                default:
+                    Logger::fatal("unsupported relocation type " +
+                        std::to_string(reloc.type) + " in '" +
+                        object.filename() + "'");
+                }
+
+                if (reloc.offset > section.data.size() ||
+                  section.data.size() - reloc.offset < size) {
+                    Logger::fatal("relocation out of bounds of section '" +
+                        section.name + "' in '" + object.filename() + "'");
+                }
+
+                if (size == 4 && (is_signed
+                  ? static_cast<i64>(value) != static_cast<i32>(value)
+                  : value != static_cast<u32>(value))) {
+                    Logger::fatal("relocation truncated to fit in section '" +
+                        section.name + "' in '" + object.filename() + "'");
+                }
+
+                std::memcpy(&output.data[placement.offset + reloc.offset],
+                    &value, size);
+            }
+        }
+    }
+
+    u64 entry_address = outputs[OUTPUT_TEXT].address;
+    auto entry_it = globals.find(entry);
+    if (entry_it != globals.end()) {
+        entry_address = address_of(entry_it->second);
+    } else {
+        Logger::warn("cannot find entry symbol '" + entry +
+            "', defaulting to the start of .text");
+    }
+
+    // Keep a section header and symbol table so the executable can still be
+    // inspected and debugged. Only the non-empty output sections are kept.
+    std::vector<u32> header_of(OUTPUT_COUNT, SHN_UNDEF);
+    std::vector<Elf64_Shdr> headers(1, Elf64_Shdr {});
+    std::vector<u8> shstrtab = { '\0' };
+    for (u32 kind = 0; kind != OUTPUT_COUNT; ++kind) {
+        const OutputSection& output = outputs[kind];
+        if (output.size == 0)
+            continue;
+
+        Elf64_Shdr header = {};
+        header.sh_name = add_string(shstrtab, output.name);
+        header.sh_type = output.type;
+        header.sh_flags = output.flags;
+        header.sh_addr = output.address;
+        header.sh_offset = output.offset;
+        header.sh_size = output.size;
+        header.sh_addralign = output.align;
+        header_of[kind] = headers.size();
+        headers.push_back(header);
+    }
+
+    std::vector<u8> strtab = { '\0' };
+    std::vector<u8> symtab = {};
+    append(symtab, Elf64_Sym {});
+
+    auto add_symbol = [&](const Definition& def, u8 binding) {
+        const ObjectSymbol& symbol =
+            m_objects[def.object]->symbols()[def.symbol];
+        const u32 output = placements[def.object][symbol.section].output;
+        if (symbol.name.empty() || symbol.type == STT_SECTION ||
+          output == OUTPUT_COUNT)
+            return;
+
+        Elf64_Sym sym = {};
+        sym.st_name = add_string(strtab, symbol.name);
+        sym.st_info = ELF64_ST_INFO(binding, symbol.type);
+        sym.st_shndx = header_of[output];
+        sym.st_value = address_of(def);
+        sym.st_size = symbol.size;
+        append(symtab, sym);
+    };
+
+    // Local symbols have to come before the globals in the symbol table.
+    u32 first_global = 0;
+    for (u32 pass = 0; pass != 2; ++pass) {
+        if (pass == 1)
+            first_global = symtab.size() / sizeof(Elf64_Sym);
+
+        for (u32 idx = 0, e = m_objects.size(); idx != e; ++idx) {
+            const std::vector<ObjectSymbol>& symbols =
+                m_objects[idx]->symbols();
+
+            for (u32 sym = 0, e = symbols.size(); sym != e; ++sym) {
+                const ObjectSymbol& symbol = symbols[sym];
+                if (!symbol.is_defined() ||
+                  (symbol.binding == STB_LOCAL) != (pass == 0))
+                    continue;
+
+                // Only the chosen definition of a global is kept.
+                const Definition def = { idx, sym };
+                if (pass == 1 && resolve(idx, sym) != def)
+                    continue;
+
+                add_symbol(def, symbol.binding);
+            }
+        }
+    }
+
+    offset = align_up(offset, 8);
+    const u32 symtab_idx = headers.size();
+
+    Elf64_Shdr symtab_header = {};
+    symtab_header.sh_name = add_string(shstrtab, ".symtab");
+    symtab_header.sh_type = SHT_SYMTAB;
+    symtab_header.sh_offset = offset;
+    symtab_header.sh_size = symtab.size();
+    symtab_header.sh_link = symtab_idx + 1;
+    symtab_header.sh_info = first_global;
+    symtab_header.sh_addralign = 8;
+    symtab_header.sh_entsize = sizeof(Elf64_Sym);
+    headers.push_back(symtab_header);
+    offset += symtab.size();
+
+    Elf64_Shdr strtab_header = {};
+    strtab_header.sh_name = add_string(shstrtab, ".strtab");
+    strtab_header.sh_type = SHT_STRTAB;
+    strtab_header.sh_offset = offset;
+    strtab_header.sh_size = strtab.size();
+    strtab_header.sh_addralign = 1;
+    headers.push_back(strtab_header);
+    offset += strtab.size();
+
+    Elf64_Shdr shstrtab_header = {};
+    shstrtab_header.sh_name = add_string(shstrtab, ".shstrtab");
+    shstrtab_header.sh_type = SHT_STRTAB;
+    shstrtab_header.sh_offset = offset;
+    shstrtab_header.sh_size = shstrtab.size();
+    shstrtab_header.sh_addralign = 1;
+    headers.push_back(shstrtab_header);
+    offset += shstrtab.size();
+
+    const u64 shoff = align_up(offset, 8);
+
+    Elf64_Ehdr ehdr = {};
+    ehdr.e_ident[EI_MAG0] = ELFMAG0;
+    ehdr.e_ident[EI_MAG1] = ELFMAG1;
+    ehdr.e_ident[EI_MAG2] = ELFMAG2;
+    ehdr.e_ident[EI_MAG3] = ELFMAG3;
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr.e_type = ET_EXEC;
+    ehdr.e_machine = EM_X86_64;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_entry = entry_address;
+    ehdr.e_phoff = sizeof(Elf64_Ehdr);
+    ehdr.e_shoff = shoff;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_phentsize = sizeof(Elf64_Phdr);
+    ehdr.e_phnum = segments.size();
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = headers.size();
+    ehdr.e_shstrndx = headers.size() - 1;
+
+    // Write everything out in the order it was laid out in, padding with
+    // zeroes up to the offset of each part.
+    u64 written = 0;
+    auto write_at = [&](u64 at, const void* data, u64 size) {
+        assert(at >= written && "executable parts laid out out of order!");
+        for (; written != at; ++written)
+            os.put('\0');
+
+        os.write(static_cast<const char*>(data), size);
+        written += size;
+    };
+
+    write_at(0, &ehdr, sizeof(ehdr));
+    write_at(sizeof(ehdr), segments.data(),
+        segments.size() * sizeof(Elf64_Phdr));
+
+    for (const OutputSection& output : outputs)
+        if (output.type != SHT_NOBITS && output.size != 0)
+            write_at(output.offset, output.data.data(), output.data.size());
+
+    write_at(symtab_header.sh_offset, symtab.data(), symtab.size());
+    write_at(strtab_header.sh_offset, strtab.data(), strtab.size());
+    write_at(shstrtab_header.sh_offset, shstrtab.data(), shstrtab.size());
+    write_at(shoff, headers.data(), headers.size() * sizeof(Elf64_Shdr));
+}
@@ -0,0 +1,44 @@
+#ifndef STATIM_SIIR_LINKER_HPP_
+#define STATIM_SIIR_LINKER_HPP_
+
+#include "siir/object_file.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stm::siir {
+
+/// A static linker for x86-64 ELF objects.
+///
+/// The linker resolves the global symbols between its objects, merges their
+/// allocated sections into text, read-only and writable segments, applies
+/// their relocations and writes out a static ELF executable. It does not
+/// handle shared objects, thread-local storage or unwind tables, none of which
+/// the objects of stmc and its runtime make use of.
+class Linker final {
+    std::vector<const ObjectFile*> m_objects = {};
+
+public:
+    /// The address that the first segment of an executable is loaded at.
+    static constexpr u64 BASE_ADDRESS = 0x400000;
+
+    /// The alignment of each segment in an executable.
+    static constexpr u64 PAGE_SIZE = 0x1000;
+
+    Linker() = default;
+
+    Linker(const Linker&) = delete;
+    Linker& operator = (const Linker&) = delete;
+
+    /// Add |object| to be linked. The object must outlive this linker.
+    void add(const ObjectFile& object);
+
+    /// Link every object added so far into an executable which starts at the
+    /// symbol |entry|, and write it to |os|.
+    void run(std::ostream& os, const std::string& entry = "_start") const;
+};
+
+} // namespace stm::siir
+
+#endif // STATIM_SIIR_LINKER_HPP_
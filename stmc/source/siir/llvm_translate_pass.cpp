@@ -1,6 +1,7 @@
 #include "core/stmc.hpp"
 
 #ifdef STMC_LLVM_SUPPORT
+#include "core/timer.hpp"
 #include "siir/llvm_translate_pass.hpp"
 #include "siir/constant.hpp"
 #include "siir/function.hpp"
@@ -33,6 +34,7 @@ using namespace stm;
 using namespace stm::siir;
 
 void LLVMTranslatePass::run() {
+    STM_TIME_SCOPE(name());
     m_builder = std::make_unique<llvm::IRBuilder<>>(*m_context);
 
     std::vector<StructType*> structs = m_cfg.structs();
@@ -178,18 +180,18 @@ llvm::Value* LLVMTranslatePass::translate(Instruction* inst) {
 }
 
 llvm::Constant* LLVMTranslatePass::translate(Constant* constant) {
-    if (auto CI = dynamic_cast<ConstantInt*>(constant)) {
+    if (auto CI = dyn_cast<ConstantInt>(constant)) {
         return llvm::ConstantInt::get(
             translate(CI->get_type()), CI->get_value());
-    } else if (auto CFP = dynamic_cast<ConstantFP*>(constant)) {
+    } else if (auto CFP = dyn_cast<ConstantFP>(constant)) {
         return llvm::ConstantFP::get(
             translate(CFP->get_type()), CFP->get_value());
-    } else if (auto CN = dynamic_cast<ConstantNull*>(constant)) {
+    } else if (auto CN = dyn_cast<ConstantNull>(constant)) {
         return llvm::ConstantPointerNull::get(
             llvm::dyn_cast<llvm::PointerType>(translate(CN->get_type())));
-    } else if (auto BA = dynamic_cast<BlockAddress*>(constant)) {
+    } else if (auto BA = dyn_cast<BlockAddress>(constant)) {
         return llvm::BlockAddress::get(translate(BA->get_block()));
-    } else if (auto G = dynamic_cast<Global*>(constant)) {
+    } else if (auto G = dyn_cast<Global>(constant)) {
         return translate(G);
     }
 
@@ -202,17 +204,17 @@ llvm::InlineAsm* LLVMTranslatePass::translate(InlineAsm* iasm) {
 }
 
 llvm::Value* LLVMTranslatePass::translate(Value* value) {
-    if (auto A = dynamic_cast<Argument*>(value)) {
+    if (auto A = dyn_cast<Argument>(value)) {
         return translate(A);
-    } else if (auto C = dynamic_cast<Constant*>(value)) {
+    } else if (auto C = dyn_cast<Constant>(value)) {
         return translate(C);
-    } else if (auto F = dynamic_cast<Function*>(value)) {
+    } else if (auto F = dyn_cast<Function>(value)) {
         return translate(F);
-    } else if (auto I = dynamic_cast<Instruction*>(value)) {
+    } else if (auto I = dyn_cast<Instruction>(value)) {
         return translate(I);
-    } else if (auto IA = dynamic_cast<InlineAsm*>(value)) {
+    } else if (auto IA = dyn_cast<InlineAsm>(value)) {
         return translate(IA);
-    } else if (auto L = dynamic_cast<Local*>(value)) {
+    } else if (auto L = dyn_cast<Local>(value)) {
         return translate(L);
     }
 
@@ -271,10 +273,10 @@ void LLVMTranslatePass::convert(Function* fn) {
         m_blocks.emplace(curr, BB);
     }
 
-    for (auto& [name, local] : fn->locals()) {
+    for (auto local : fn->locals()) {
         m_builder->SetInsertPoint(&F->front());
         llvm::AllocaInst* alloca = m_builder->CreateAlloca(
-            translate(local->get_allocated_type()), nullptr, '_' + name);
+            translate(local->get_allocated_type()), nullptr, '_' + local->get_name());
         m_locals.emplace(local, alloca);
     }
 
@@ -284,8 +286,7 @@ void LLVMTranslatePass::convert(Function* fn) {
 
     for (auto& [og, phi] : m_delayed_phis) {
         for (auto& incoming : og->get_operand_list()) {
-            auto phiop = dynamic_cast<PhiOperand*>(incoming->get_value());
-            assert(phiop);
+            auto phiop = cast<PhiOperand>(incoming.get_value());
 
             phi->addIncoming(
                 translate(phiop->get_value()), translate(phiop->get_pred()));
@@ -400,7 +401,7 @@ void LLVMTranslatePass::convert(Instruction* inst) {
     }
     
     case INST_OP_CALL: {
-        if (InlineAsm* iasm = dynamic_cast<InlineAsm*>(inst->get_operand(0))) {
+        if (InlineAsm* iasm = dyn_cast<InlineAsm>(inst->get_operand(0))) {
             std::string string = iasm->string();
             std::string constraints = "";
 
@@ -417,8 +418,7 @@ void LLVMTranslatePass::convert(Instruction* inst) {
             }
 
             const siir::FunctionType* siir_type = 
-                dynamic_cast<const siir::FunctionType*>(iasm->get_type());
-            assert(siir_type);
+                cast<siir::FunctionType>(iasm->get_type());
 
             llvm::Type* return_type = nullptr;
             if (siir_type->has_return_type()) {
@@ -66,6 +66,8 @@ public:
         m_context = &m_module.getContext();
     }
 
+    const char* name() const override { return "llvm translate"; }
+
     void run() override;
 };
 
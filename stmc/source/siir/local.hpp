@@ -2,6 +2,7 @@
 #define STATIM_SIIR_LOCAL_HPP_
 
 #include "siir/value.hpp"
+#include "types/symbol.hpp"
 
 namespace stm {
 namespace siir {
@@ -18,7 +19,7 @@ class Local final : public Value {
     Function* m_parent;
 
     /// The name of this local.
-    std::string m_name;
+    Symbol m_name;
 
     /// The type allocated for this local.
     const Type* m_alloc_type;
@@ -28,7 +29,7 @@ class Local final : public Value {
 
 public:
     /// Create a new local, allocated for |type| with alignment |align|.
-    Local(CFG& cfg, const Type* type, u32 align, const std::string& name, 
+    Local(CFG& cfg, const Type* type, u32 align, Symbol name, 
           Function* parent);
 
     /// Get the parent function this local is contained in.
@@ -47,10 +48,13 @@ public:
     void detach_from_parent();
 
     /// Returns the name of this local.
-    const std::string& get_name() const { return m_name; }
+    const std::string& get_name() const { return m_name.str(); }
+
+    /// Returns the interned name of this local.
+    Symbol get_symbol() const { return m_name; }
 
     /// Set the name of this local to |name|.
-    void set_name(const std::string& name) { m_name = name; }
+    void set_name(Symbol name) { m_name = name; }
 
     /// Returns the type this local is allocated for.
     const Type* get_allocated_type() const { return m_alloc_type; }
@@ -62,6 +66,10 @@ public:
     void set_alignment(u32 align) { m_align = align; }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Value* value) {
+        return value->get_kind() == VK_Local;
+    }
 };
 
 } // namespace siir
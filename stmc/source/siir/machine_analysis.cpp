@@ -1,3 +1,5 @@
+#include "core/thread_pool.hpp"
+#include "core/timer.hpp"
 #include "siir/allocator.hpp"
 #include "siir/cfg.hpp"
 #include "siir/function.hpp"
@@ -6,7 +8,9 @@
 #include "siir/machine_function.hpp"
 #include "siir/machine_object.hpp"
 #include "x64/x64.hpp"
+
 #include <iostream>
+#include <vector>
 
 using namespace stm;
 using namespace stm::siir;
@@ -154,9 +158,15 @@ public:
     }
 };
 
-CFGMachineAnalysis::CFGMachineAnalysis(CFG& cfg) : m_cfg(cfg) {}
+CFGMachineAnalysis::CFGMachineAnalysis(CFG& cfg, ThreadPool* pool) 
+    : m_cfg(cfg), m_pool(pool) {}
 
 void CFGMachineAnalysis::run(MachineObject& obj) {
+    STM_TIME_SCOPE("isel");
+
+    // Create the machine functions up front so that the object is not changed
+    // while instructions are being selected.
+    std::vector<MachineFunction*> functions;
     for (const auto& function : m_cfg.functions()) {
         // Empty functions should not be lowered, they should either be
         // resolved at link time or with some library.
@@ -169,9 +179,13 @@ void CFGMachineAnalysis::run(MachineObject& obj) {
         for (auto curr = function->front(); curr; curr = curr->next())
             new MachineBasicBlock(curr, mf);
 
+        functions.push_back(mf);
+    }
+
+    auto select = [&](u32 idx) {
         switch (obj.get_target()->arch()) {
         case Target::x64: {
-            x64::X64InstSelection isel { mf };
+            x64::X64InstSelection isel { functions[idx] };
             isel.run();
             break;
         }
@@ -179,18 +193,36 @@ void CFGMachineAnalysis::run(MachineObject& obj) {
         default:
             assert(false && "unsupported architecture!");
         }
+    };
+
+    if (m_pool) {
+        m_pool->parallel_for(functions.size(), select);
+    } else {
+        for (u32 idx = 0; idx != functions.size(); ++idx)
+            select(idx);
     }
 }
 
-FunctionRegisterAnalysis::FunctionRegisterAnalysis(MachineObject& obj)
-    : m_obj(obj) {}
+FunctionRegisterAnalysis::FunctionRegisterAnalysis(MachineObject& obj, 
+                                                   ThreadPool* pool)
+    : m_obj(obj), m_pool(pool) {}
 
 void FunctionRegisterAnalysis::run() {
-    for (const auto& [name, function] : m_obj.functions()) {
+    STM_TIME_SCOPE("regalloc");
+
+    std::vector<MachineFunction*> functions;
+    functions.reserve(m_obj.functions().size());
+    for (const auto& [name, function] : m_obj.functions())
+        functions.push_back(function);
+
+    auto allocate = [&](u32 idx) {
+        MachineFunction* function = functions[idx];
         std::vector<LiveRange> ranges;
         
+        TimeScope liveness { "liveness", function->get_name() };
         LinearScan linscan { *function, ranges };
         linscan.run();
+        liveness.stop();
 
         TargetRegisters tregs;
         switch (m_obj.get_target()->arch()) {
@@ -203,7 +235,7 @@ void FunctionRegisterAnalysis::run() {
         }
 
 #ifdef DEBUG_PRINT_RANGES
-        std::cerr << "Function '" << name << "' ranges:\n";
+        std::cerr << "Function '" << function->get_name() << "' ranges:\n";
         for (auto& range : ranges) {
             if (range.reg.is_virtual()) {
                 std::cerr << 'v' << range.reg.id() - MachineRegister::VirtualBarrier;
@@ -216,6 +248,7 @@ void FunctionRegisterAnalysis::run() {
         }
 #endif // DEBUG_PRINT_RANGES
 
+        TimeScope allocation { "allocation", function->get_name() };
         RegisterAllocator allocator { *function, tregs, ranges };
         allocator.run();
 
@@ -228,12 +261,22 @@ void FunctionRegisterAnalysis::run() {
             regi.vregs[reg.id()].alloc = range.alloc;
         }
 
+        allocation.stop();
+
         /// TODO: Implement callsite analysis at this point, saving caller-
         /// saved registers that are live around callsites, and managing the
         /// spills that come with it.
 
+        STM_TIME_SCOPE("callsite analysis", function->get_name());
         CallsiteAnalysis CAN { *function, ranges };
         CAN.run();
+    };
+
+    if (m_pool) {
+        m_pool->parallel_for(functions.size(), allocate);
+    } else {
+        for (u32 idx = 0; idx != functions.size(); ++idx)
+            allocate(idx);
     }
 }
 
@@ -252,13 +295,14 @@ void MachineObjectPrinter::run(std::ostream& os) {
     }
 }
 
-MachineObjectAsmWriter::MachineObjectAsmWriter(MachineObject& obj) 
-    : m_obj(obj) {}
+MachineObjectAsmWriter::MachineObjectAsmWriter(MachineObject& obj, 
+                                               ThreadPool* pool) 
+    : m_obj(obj), m_pool(pool) {}
 
 void MachineObjectAsmWriter::run(std::ostream& os) {
     switch (m_obj.get_target()->arch()) {
     case Target::x64: {
-        x64::X64AsmWriter writer { m_obj };
+        x64::X64AsmWriter writer { m_obj, m_pool };
         writer.run(os);
         break;
     }
@@ -267,3 +311,19 @@ void MachineObjectAsmWriter::run(std::ostream& os) {
         assert(false && "unsupported architecture!");
     }
 }
+
+MachineObjectWriter::MachineObjectWriter(MachineObject& obj, ThreadPool* pool)
+    : m_obj(obj), m_pool(pool) {}
+
+void MachineObjectWriter::run(ObjectFile& file) {
+    switch (m_obj.get_target()->arch()) {
+    case Target::x64: {
+        x64::X64ObjectWriter writer { m_obj, m_pool };
+        writer.run(file);
+        break;
+    }
+
+    default:
+        assert(false && "unsupported architecture!");
+    }
+}
@@ -3,15 +3,25 @@
 
 #include "siir/cfg.hpp"
 #include "siir/machine_object.hpp"
+#include "siir/object_file.hpp"
+
+namespace stm {
+
+class ThreadPool;
+
+} // namespace stm
 
 namespace stm::siir {
 
 /// Analysis pass to lower an SIIR graph to a target-dependent representation.
 class CFGMachineAnalysis final {
     CFG& m_cfg;
+    ThreadPool* m_pool;
 
 public:
-    CFGMachineAnalysis(CFG& cfg);
+    /// Create a new analysis over |cfg|. If |pool| is provided, instructions
+    /// are selected for each function on it concurrently.
+    CFGMachineAnalysis(CFG& cfg, ThreadPool* pool = nullptr);
 
     CFGMachineAnalysis(const CFGMachineAnalysis&) = delete;
     CFGMachineAnalysis& operator = (const CFGMachineAnalysis&) = delete;
@@ -22,9 +32,12 @@ public:
 /// Machine analysis pass to do liveness analysis, register allocation, etc.
 class FunctionRegisterAnalysis final {
     MachineObject& m_obj;
+    ThreadPool* m_pool;
 
 public:
-    FunctionRegisterAnalysis(MachineObject& obj);
+    /// Create a new analysis over |obj|. If |pool| is provided, registers are
+    /// allocated for each function on it concurrently.
+    FunctionRegisterAnalysis(MachineObject& obj, ThreadPool* pool = nullptr);
     
     FunctionRegisterAnalysis(const FunctionRegisterAnalysis&) = delete;
     FunctionRegisterAnalysis& operator = (const FunctionRegisterAnalysis&) = delete;
@@ -48,9 +61,12 @@ public:
 /// Machine pass to emit final assembly code.
 class MachineObjectAsmWriter final {
     MachineObject& m_obj;
+    ThreadPool* m_pool;
 
 public:
-    MachineObjectAsmWriter(MachineObject& obj);
+    /// Create a new writer for |obj|. If |pool| is provided, functions are
+    /// emitted on it concurrently.
+    MachineObjectAsmWriter(MachineObject& obj, ThreadPool* pool = nullptr);
     
     MachineObjectAsmWriter(const MachineObjectAsmWriter&) = delete;
     MachineObjectAsmWriter& operator = (const MachineObjectAsmWriter&) = delete;
@@ -58,6 +74,22 @@ public:
     void run(std::ostream& os);
 };
 
+/// Machine pass to encode final machine code into a relocatable object.
+class MachineObjectWriter final {
+    MachineObject& m_obj;
+    ThreadPool* m_pool;
+
+public:
+    /// Create a new writer for |obj|. If |pool| is provided, functions are
+    /// encoded on it concurrently.
+    MachineObjectWriter(MachineObject& obj, ThreadPool* pool = nullptr);
+
+    MachineObjectWriter(const MachineObjectWriter&) = delete;
+    MachineObjectWriter& operator = (const MachineObjectWriter&) = delete;
+
+    void run(ObjectFile& file);
+};
+
 } // namespace stm::siir
 
 #endif // STATIM_SIIR_MACHINE_ANALYSIS_H_
@@ -0,0 +1,470 @@
+#include "siir/object_file.hpp"
+#include "core/logger.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <elf.h>
+
+using namespace stm;
+using namespace stm::siir;
+
+/// Returns |value| rounded up to a multiple of |align|.
+static u64 align_up(u64 value, u64 align) {
+    if (align <= 1)
+        return value;
+
+    return (value + align - 1) / align * align;
+}
+
+/// Appends the raw bytes of |value| to |bytes|.
+template<typename T>
+static void append(std::vector<u8>& bytes, const T& value) {
+    const u8* raw = reinterpret_cast<const u8*>(&value);
+    bytes.insert(bytes.end(), raw, raw + sizeof(T));
+}
+
+/// Appends |str| to the string table |table| and returns its offset in it.
+static u32 add_string(std::vector<u8>& table, const std::string& str) {
+    if (str.empty())
+        return 0;
+
+    u32 offset = table.size();
+    table.insert(table.end(), str.begin(), str.end());
+    table.push_back('\0');
+    return offset;
+}
+
+/// Fail on the malformed object file |filename|.
+__attribute__((noreturn))
+static void malformed(const std::string& filename) {
+    Logger::fatal("malformed object file: '" + filename + "'");
+}
+
+/// Returns a copy of the |T| at |offset| in the |size| bytes at |data| of the
+/// object file |filename|, checking that it lies within them.
+template<typename T>
+static T load(const std::string& filename, const u8* data, u64 size,
+              u64 offset) {
+    if (offset > size || size - offset < sizeof(T))
+        malformed(filename);
+
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+void ObjectSection::align_to(u64 align, u8 fill) {
+    if (align > this->align)
+        this->align = align;
+
+    data.resize(align_up(data.size(), align), fill);
+}
+
+u32 ObjectFile::add_section(const std::string& name, u32 type, u64 flags,
+                            u64 align, u64 entsize) {
+    m_sections.push_back({ name, type, flags, align, entsize });
+    return m_sections.size() - 1;
+}
+
+u32 ObjectFile::add_symbol(const ObjectSymbol& symbol) {
+    m_symbols.push_back(symbol);
+    if (symbol.binding != STB_LOCAL)
+        m_symbol_indices.emplace(symbol.name, m_symbols.size() - 1);
+
+    return m_symbols.size() - 1;
+}
+
+u32 ObjectFile::get_symbol(const std::string& name) {
+    auto it = m_symbol_indices.find(name);
+    if (it != m_symbol_indices.end())
+        return it->second;
+
+    m_symbols.push_back({
+        name, ObjectSymbol::UNDEFINED, 0, 0, STT_NOTYPE, STB_GLOBAL });
+    m_symbol_indices.emplace(name, m_symbols.size() - 1);
+    return m_symbols.size() - 1;
+}
+
+void ObjectFile::define_symbol(u32 index, u32 section, u64 value, u64 size,
+                               u8 type, u8 binding) {
+    assert(index < m_symbols.size() && "symbol index out of range!");
+    assert(section < m_sections.size() && "section index out of range!");
+
+    ObjectSymbol& symbol = m_symbols[index];
+    symbol.section = section;
+    symbol.value = value;
+    symbol.size = size;
+    symbol.type = type;
+    symbol.binding = binding;
+}
+
+u32 ObjectFile::get_section_symbol(u32 section) {
+    assert(section < m_sections.size() && "section index out of range!");
+
+    m_section_symbols.resize(m_sections.size(), ObjectSymbol::UNDEFINED);
+    if (m_section_symbols[section] == ObjectSymbol::UNDEFINED) {
+        m_symbols.push_back({ "", section, 0, 0, STT_SECTION, STB_LOCAL });
+        m_section_symbols[section] = m_symbols.size() - 1;
+    }
+
+    return m_section_symbols[section];
+}
+
+void ObjectFile::write(std::ostream& os) const {
+    // The section header table is laid out as the null section, then every
+    // content section in order, followed by their relocation sections and
+    // lastly the symbol and string tables.
+    std::vector<u32> rela_of(m_sections.size(), 0);
+    u32 num_sections = m_sections.size() + 1;
+    for (u32 idx = 0, e = m_sections.size(); idx != e; ++idx)
+        if (!m_sections[idx].relocs.empty())
+            rela_of[idx] = num_sections++;
+
+    const u32 symtab_idx = num_sections++;
+    const u32 strtab_idx = num_sections++;
+    const u32 shstrtab_idx = num_sections++;
+
+    // ELF requires local symbols to come before any others in the symbol
+    // table, so symbols are renumbered with the locals first. The first
+    // locals are the source file and the symbol of each section.
+    std::vector<u8> strtab = { '\0' };
+    std::vector<u8> symtab;
+    append(symtab, Elf64_Sym {});
+
+    Elf64_Sym file_sym = {};
+    file_sym.st_name = add_string(strtab, m_filename);
+    file_sym.st_info = ELF64_ST_INFO(STB_LOCAL, STT_FILE);
+    file_sym.st_shndx = SHN_ABS;
+    append(symtab, file_sym);
+
+    for (u32 idx = 0, e = m_sections.size(); idx != e; ++idx) {
+        Elf64_Sym sym = {};
+        sym.st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+        sym.st_shndx = idx + 1;
+        append(symtab, sym);
+    }
+
+    std::vector<u32> renumbered(m_symbols.size(), 0);
+    u32 num_symbols = m_sections.size() + 2;
+    u32 first_global = 0;
+    for (u32 pass = 0; pass != 2; ++pass) {
+        if (pass == 1)
+            first_global = num_symbols;
+
+        for (u32 idx = 0, e = m_symbols.size(); idx != e; ++idx) {
+            const ObjectSymbol& symbol = m_symbols[idx];
+            if ((symbol.binding == STB_LOCAL) != (pass == 0))
+                continue;
+
+            // Section symbols are already in the table.
+            if (symbol.type == STT_SECTION) {
+                renumbered[idx] = symbol.section + 2;
+                continue;
+            }
+
+            Elf64_Sym sym = {};
+            sym.st_name = add_string(strtab, symbol.name);
+            sym.st_info = ELF64_ST_INFO(symbol.binding, symbol.type);
+            sym.st_other = STV_DEFAULT;
+            sym.st_shndx = symbol.is_defined()
+                ? symbol.section + 1 : SHN_UNDEF;
+            sym.st_value = symbol.value;
+            sym.st_size = symbol.size;
+            append(symtab, sym);
+            renumbered[idx] = num_symbols++;
+        }
+    }
+
+    std::vector<Elf64_Shdr> headers(num_sections, Elf64_Shdr {});
+    std::vector<u8> shstrtab = { '\0' };
+    std::vector<std::vector<u8>> relas(m_sections.size());
+    u64 offset = sizeof(Elf64_Ehdr);
+
+    for (u32 idx = 0, e = m_sections.size(); idx != e; ++idx) {
+        const ObjectSection& section = m_sections[idx];
+        Elf64_Shdr& header = headers[idx + 1];
+        offset = align_up(offset, section.align);
+
+        header.sh_name = add_string(shstrtab, section.name);
+        header.sh_type = section.type;
+        header.sh_flags = section.flags;
+        header.sh_offset = offset;
+        header.sh_size = section.data.size();
+        header.sh_addralign = section.align;
+        header.sh_entsize = section.entsize;
+
+        if (section.type != SHT_NOBITS)
+            offset += section.data.size();
+    }
+
+    for (u32 idx = 0, e = m_sections.size(); idx != e; ++idx) {
+        const ObjectSection& section = m_sections[idx];
+        if (section.relocs.empty())
+            continue;
+
+        for (const ObjectRelocation& reloc : section.relocs) {
+            Elf64_Rela rela = {};
+            rela.r_offset = reloc.offset;
+            rela.r_info = ELF64_R_INFO(renumbered[reloc.symbol], reloc.type);
+            rela.r_addend = reloc.addend;
+            append(relas[idx], rela);
+        }
+
+        offset = align_up(offset, 8);
+
+        Elf64_Shdr& header = headers[rela_of[idx]];
+        header.sh_name = add_string(shstrtab, ".rela" + section.name);
+        header.sh_type = SHT_RELA;
+        header.sh_flags = SHF_INFO_LINK;
+        header.sh_offset = offset;
+        header.sh_size = relas[idx].size();
+        header.sh_link = symtab_idx;
+        header.sh_info = idx + 1;
+        header.sh_addralign = 8;
+        header.sh_entsize = sizeof(Elf64_Rela);
+        offset += relas[idx].size();
+    }
+
+    offset = align_up(offset, 8);
+
+    Elf64_Shdr& symtab_header = headers[symtab_idx];
+    symtab_header.sh_name = add_string(shstrtab, ".symtab");
+    symtab_header.sh_type = SHT_SYMTAB;
+    symtab_header.sh_offset = offset;
+    symtab_header.sh_size = symtab.size();
+    symtab_header.sh_link = strtab_idx;
+    symtab_header.sh_info = first_global;
+    symtab_header.sh_addralign = 8;
+    symtab_header.sh_entsize = sizeof(Elf64_Sym);
+    offset += symtab.size();
+
+    Elf64_Shdr& strtab_header = headers[strtab_idx];
+    strtab_header.sh_name = add_string(shstrtab, ".strtab");
+    strtab_header.sh_type = SHT_STRTAB;
+    strtab_header.sh_offset = offset;
+    strtab_header.sh_size = strtab.size();
+    strtab_header.sh_addralign = 1;
+    offset += strtab.size();
+
+    Elf64_Shdr& shstrtab_header = headers[shstrtab_idx];
+    shstrtab_header.sh_name = add_string(shstrtab, ".shstrtab");
+    shstrtab_header.sh_type = SHT_STRTAB;
+    shstrtab_header.sh_offset = offset;
+    shstrtab_header.sh_size = shstrtab.size();
+    shstrtab_header.sh_addralign = 1;
+    offset += shstrtab.size();
+
+    const u64 shoff = align_up(offset, 8);
+
+    Elf64_Ehdr ehdr = {};
+    ehdr.e_ident[EI_MAG0] = ELFMAG0;
+    ehdr.e_ident[EI_MAG1] = ELFMAG1;
+    ehdr.e_ident[EI_MAG2] = ELFMAG2;
+    ehdr.e_ident[EI_MAG3] = ELFMAG3;
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr.e_type = ET_REL;
+    ehdr.e_machine = m_machine;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_shoff = shoff;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = num_sections;
+    ehdr.e_shstrndx = shstrtab_idx;
+
+    // Write everything out in the order it was laid out in, padding with
+    // zeroes up to the offset of each part.
+    u64 written = 0;
+    auto write_at = [&](u64 at, const void* data, u64 size) {
+        assert(at >= written && "object parts laid out out of order!");
+        for (; written != at; ++written)
+            os.put('\0');
+
+        os.write(static_cast<const char*>(data), size);
+        written += size;
+    };
+
+    write_at(0, &ehdr, sizeof(ehdr));
+
+    for (u32 idx = 0, e = m_sections.size(); idx != e; ++idx) {
+        const ObjectSection& section = m_sections[idx];
+        if (section.type != SHT_NOBITS) {
+            write_at(headers[idx + 1].sh_offset, section.data.data(),
+                section.data.size());
+        }
+    }
+
+    for (u32 idx = 0, e = m_sections.size(); idx != e; ++idx) {
+        if (!relas[idx].empty()) {
+            write_at(headers[rela_of[idx]].sh_offset, relas[idx].data(),
+                relas[idx].size());
+        }
+    }
+
+    write_at(symtab_header.sh_offset, symtab.data(), symtab.size());
+    write_at(strtab_header.sh_offset, strtab.data(), strtab.size());
+    write_at(shstrtab_header.sh_offset, shstrtab.data(), shstrtab.size());
+    write_at(shoff, headers.data(), headers.size() * sizeof(Elf64_Shdr));
+}
+
+ObjectFile ObjectFile::read(const std::string& filename, const u8* data,
+                            u64 size) {
+    const Elf64_Ehdr ehdr = load<Elf64_Ehdr>(filename, data, size, 0);
+    if (std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 ||
+      ehdr.e_ident[EI_CLASS] != ELFCLASS64 ||
+      ehdr.e_ident[EI_DATA] != ELFDATA2LSB)
+        Logger::fatal("not an ELF64 object file: '" + filename + "'");
+
+    if (ehdr.e_type != ET_REL)
+        Logger::fatal("not a relocatable object file: '" + filename + "'");
+
+    if (ehdr.e_shentsize != sizeof(Elf64_Shdr) || ehdr.e_shstrndx == SHN_UNDEF
+      || ehdr.e_shstrndx >= ehdr.e_shnum)
+        malformed(filename);
+
+    std::vector<Elf64_Shdr> headers;
+    headers.reserve(ehdr.e_shnum);
+    for (u32 idx = 0; idx != ehdr.e_shnum; ++idx) {
+        headers.push_back(load<Elf64_Shdr>(filename, data, size, 
+            ehdr.e_shoff + idx * sizeof(Elf64_Shdr)));
+
+        const Elf64_Shdr& header = headers.back();
+        if (header.sh_type != SHT_NOBITS && (header.sh_offset > size ||
+          size - header.sh_offset < header.sh_size))
+            malformed(filename);
+    }
+
+    // Returns the string at |offset| in the string table section |table|.
+    auto string_at = [&](u32 table, u64 offset) -> std::string {
+        if (table >= headers.size() || offset >= headers[table].sh_size)
+            malformed(filename);
+
+        const char* str = reinterpret_cast<const char*>(
+            data + headers[table].sh_offset + offset);
+        return std::string(str, strnlen(str, headers[table].sh_size - offset));
+    };
+
+    ObjectFile file { filename };
+    file.set_machine(ehdr.e_machine);
+
+    // Allocated sections are all that make it into a program, so the rest,
+    // like comments and debug info, are left behind.
+    std::vector<u32> section_of(headers.size(), ObjectSymbol::UNDEFINED);
+    u32 symtab = 0;
+    for (u32 idx = 1, e = headers.size(); idx != e; ++idx) {
+        const Elf64_Shdr& header = headers[idx];
+        if (header.sh_type == SHT_SYMTAB)
+            symtab = idx;
+
+        if (!(header.sh_flags & SHF_ALLOC) || header.sh_type == SHT_GROUP)
+            continue;
+
+        section_of[idx] = file.add_section(
+            string_at(ehdr.e_shstrndx, header.sh_name), header.sh_type,
+            header.sh_flags, header.sh_addralign, header.sh_entsize);
+
+        std::vector<u8>& contents = file.m_sections.back().data;
+        if (header.sh_type == SHT_NOBITS) {
+            contents.resize(header.sh_size, 0);
+        } else {
+            contents.assign(data + header.sh_offset,
+                data + header.sh_offset + header.sh_size);
+        }
+    }
+
+    // Symbols in sections that were left behind are dropped, along with the
+    // file symbol, and so cannot be the target of a relocation.
+    std::vector<u32> symbol_of = {};
+    if (symtab != 0) {
+        const Elf64_Shdr& header = headers[symtab];
+        if (header.sh_entsize != sizeof(Elf64_Sym))
+            malformed(filename);
+
+        symbol_of.resize(header.sh_size / sizeof(Elf64_Sym),
+            ObjectSymbol::UNDEFINED);
+        for (u32 idx = 1, e = symbol_of.size(); idx != e; ++idx) {
+            const Elf64_Sym sym = load<Elf64_Sym>(filename, data, size, 
+                header.sh_offset + idx * sizeof(Elf64_Sym));
+
+            const u8 type = ELF64_ST_TYPE(sym.st_info);
+            const u8 binding = ELF64_ST_BIND(sym.st_info);
+            if (type == STT_FILE)
+                continue;
+
+            ObjectSymbol symbol = {
+                string_at(header.sh_link, sym.st_name),
+                ObjectSymbol::UNDEFINED, sym.st_value, sym.st_size, type,
+                binding
+            };
+
+            if (sym.st_shndx == SHN_COMMON) {
+                // Common symbols are given space at the end of the .bss of
+                // this object, aligned to the value of the symbol.
+                u32 bss = ObjectSymbol::UNDEFINED;
+                for (u32 sec = 0, e = file.m_sections.size(); sec != e; ++sec)
+                    if (file.m_sections[sec].name == ".bss")
+                        bss = sec;
+
+                if (bss == ObjectSymbol::UNDEFINED) {
+                    bss = file.add_section(
+                        ".bss", SHT_NOBITS, SHF_ALLOC | SHF_WRITE, 1);
+                }
+
+                ObjectSection& section = file.m_sections[bss];
+                section.align_to(sym.st_value);
+                symbol.section = bss;
+                symbol.value = section.data.size();
+                section.data.resize(section.data.size() + sym.st_size, 0);
+            } else if (sym.st_shndx == SHN_ABS) {
+                Logger::fatal("absolute symbol '" + symbol.name + 
+                    "' is unsupported in '" + filename + "'");
+            } else if (sym.st_shndx != SHN_UNDEF) {
+                if (sym.st_shndx >= section_of.size())
+                    malformed(filename);
+
+                symbol.section = section_of[sym.st_shndx];
+                if (!symbol.is_defined())
+                    continue;
+            }
+
+            symbol_of[idx] = type == STT_SECTION
+                ? file.get_section_symbol(symbol.section)
+                : file.add_symbol(symbol);
+        }
+    }
+
+    for (u32 idx = 1, e = headers.size(); idx != e; ++idx) {
+        const Elf64_Shdr& header = headers[idx];
+        if (header.sh_type == SHT_REL) {
+            Logger::fatal("implicit addend relocations are unsupported in '" + 
+                filename + "'");
+        }
+
+        if (header.sh_type != SHT_RELA || header.sh_info >= section_of.size()
+          || section_of[header.sh_info] == ObjectSymbol::UNDEFINED)
+            continue;
+
+        if (header.sh_link != symtab || header.sh_entsize != sizeof(Elf64_Rela))
+            malformed(filename);
+
+        ObjectSection& section = file.m_sections[section_of[header.sh_info]];
+        for (u64 offset = 0; offset < header.sh_size; 
+          offset += sizeof(Elf64_Rela)) {
+            const Elf64_Rela rela = load<Elf64_Rela>(filename, data, size, 
+                header.sh_offset + offset);
+
+            const u32 sym = ELF64_R_SYM(rela.r_info);
+            if (sym >= symbol_of.size() || 
+              symbol_of[sym] == ObjectSymbol::UNDEFINED)
+                malformed(filename);
+
+            section.relocs.push_back({ 
+                rela.r_offset, symbol_of[sym], 
+                static_cast<u32>(ELF64_R_TYPE(rela.r_info)), rela.r_addend });
+        }
+    }
+
+    return file;
+}
@@ -0,0 +1,147 @@
+#ifndef STATIM_SIIR_OBJECT_FILE_HPP_
+#define STATIM_SIIR_OBJECT_FILE_HPP_
+
+#include "types/types.hpp"
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stm::siir {
+
+/// A relocation to apply to the data of an object section.
+struct ObjectRelocation final {
+    /// The offset of the patched bytes in their section.
+    u64 offset;
+
+    /// The index of the symbol that the relocation refers to.
+    u32 symbol;
+
+    /// The target-specific type of this relocation, i.e. R_X86_64_PC32.
+    u32 type;
+
+    /// The constant added to the value of the symbol.
+    i64 addend;
+};
+
+/// A section of a relocatable object.
+struct ObjectSection final {
+    std::string name;
+
+    /// The ELF section type and flags, i.e. SHT_PROGBITS and SHF_ALLOC.
+    u32 type;
+    u64 flags;
+
+    /// The alignment of this section in bytes.
+    u64 align;
+
+    /// The size of each entry for sections of fixed-size entries, or 0.
+    u64 entsize = 0;
+
+    /// The contents of this section.
+    std::vector<u8> data = {};
+
+    /// The relocations to apply to the contents of this section.
+    std::vector<ObjectRelocation> relocs = {};
+
+    /// Pad the contents of this section with |fill| up to a multiple of
+    /// |align| bytes, and raise the alignment of the section to match.
+    void align_to(u64 align, u8 fill = 0);
+};
+
+/// A symbol defined or referenced by a relocatable object.
+struct ObjectSymbol final {
+    std::string name;
+
+    /// The index of the section that defines this symbol, or UNDEFINED if the
+    /// symbol is only referenced.
+    u32 section;
+
+    /// The offset of this symbol in its section, and its size in bytes.
+    u64 value;
+    u64 size;
+
+    /// The ELF symbol type and binding, i.e. STT_FUNC and STB_GLOBAL.
+    u8 type;
+    u8 binding;
+
+    static constexpr u32 UNDEFINED = ~0u;
+
+    /// Returns true if this symbol is defined by the object.
+    bool is_defined() const { return section != UNDEFINED; }
+};
+
+/// A relocatable object file, built up in memory by a backend and written out
+/// in the ELF64 format.
+class ObjectFile final {
+    std::string m_filename;
+    u16 m_machine = 0;
+    std::vector<ObjectSection> m_sections = {};
+    std::vector<ObjectSymbol> m_symbols = {};
+    std::unordered_map<std::string, u32> m_symbol_indices = {};
+
+    /// The symbol of each section, if one has been made for it yet.
+    std::vector<u32> m_section_symbols = {};
+
+public:
+    /// Create a new, empty object for the source file |filename|.
+    ObjectFile(const std::string& filename) : m_filename(filename) {}
+
+    ObjectFile(const ObjectFile&) = delete;
+    ObjectFile& operator = (const ObjectFile&) = delete;
+
+    ObjectFile(ObjectFile&&) = default;
+    ObjectFile& operator = (ObjectFile&&) = default;
+
+    /// Returns the name of the source file this object was compiled from.
+    const std::string& filename() const { return m_filename; }
+
+    /// Returns the ELF machine this object targets, i.e. EM_X86_64.
+    u16 machine() const { return m_machine; }
+
+    /// Set the ELF machine this object targets to |machine|.
+    void set_machine(u16 machine) { m_machine = machine; }
+
+    /// Returns the sections of this object.
+    const std::vector<ObjectSection>& sections() const { return m_sections; }
+    std::vector<ObjectSection>& sections() { return m_sections; }
+
+    /// Returns the symbols of this object.
+    const std::vector<ObjectSymbol>& symbols() const { return m_symbols; }
+
+    /// Add a new, empty section to this object and return its index.
+    u32 add_section(const std::string& name, u32 type, u64 flags, u64 align,
+                    u64 entsize = 0);
+
+    /// Add |symbol| to this object and return its index. Unlike get_symbol,
+    /// local symbols are never merged with existing symbols of the same name.
+    u32 add_symbol(const ObjectSymbol& symbol);
+
+    /// Returns the index of the symbol named |name|. If this object does not
+    /// have one yet, it is added as an undefined, global reference.
+    u32 get_symbol(const std::string& name);
+
+    /// Define the symbol at |index| to be |size| bytes at |value| in the
+    /// section at index |section|.
+    void define_symbol(u32 index, u32 section, u64 value, u64 size, u8 type,
+                       u8 binding);
+
+    /// Returns the index of the symbol of the section at index |section|,
+    /// which relocations can use to refer to data in the section that has no
+    /// name of its own.
+    u32 get_section_symbol(u32 section);
+
+    /// Write this object to |os| as an ELF64 relocatable file.
+    void write(std::ostream& os) const;
+
+    /// Read the ELF64 relocatable file of |size| bytes at |data| back into an
+    /// object, named |filename| in diagnostics. Only allocated sections, and
+    /// the symbols and relocations that refer to them, are kept.
+    static ObjectFile read(const std::string& filename, const u8* data,
+                           u64 size);
+};
+
+} // namespace stm::siir
+
+#endif // STATIM_SIIR_OBJECT_FILE_HPP_
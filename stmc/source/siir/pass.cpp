@@ -0,0 +1,28 @@
+#include "core/thread_pool.hpp"
+#include "core/timer.hpp"
+#include "siir/function.hpp"
+#include "siir/pass.hpp"
+
+#include <vector>
+
+using namespace stm;
+using namespace stm::siir;
+
+void FunctionPass::run() {
+    STM_TIME_SCOPE(name());
+    std::vector<Function*> functions = m_cfg.functions();
+
+    if (!m_pool || m_pool->size() == 1 || functions.size() < 2) {
+        for (auto fn : functions) {
+            STM_TIME_SCOPE("function", fn->get_name());
+            process(fn);
+        }
+
+        return;
+    }
+
+    m_pool->parallel_for(functions.size(), [&](u32 idx) {
+        STM_TIME_SCOPE("function", functions[idx]->get_name());
+        fork()->process(functions[idx]);
+    });
+}
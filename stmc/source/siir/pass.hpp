@@ -3,7 +3,12 @@
 
 #include "siir/cfg.hpp"
 
+#include <memory>
+
 namespace stm {
+
+class ThreadPool;
+
 namespace siir {
      
 class Pass {
@@ -18,9 +23,36 @@ public:
 
     virtual ~Pass() = default;
 
+    /// Returns the name of this pass, as it is reported in timings and
+    /// traces. Each pass times its run under this name with STM_TIME_SCOPE.
+    virtual const char* name() const = 0;
+
     virtual void run() = 0;
 };
 
+/// A pass that processes each function of a graph on its own, and does not 
+/// look at or change any function other than the one it is processing.
+///
+/// If the pass is given a thread pool, functions are processed concurrently,
+/// each by its own copy of the pass so that per-function state can be kept in
+/// members. Types and constants of the graph can still be used freely.
+class FunctionPass : public Pass {
+    ThreadPool* m_pool;
+
+protected:
+    FunctionPass(CFG& cfg, ThreadPool* pool) : Pass(cfg), m_pool(pool) {}
+
+    /// Process the function |fn|.
+    virtual void process(Function* fn) = 0;
+
+    /// Returns a new copy of this pass to process a function with on another
+    /// thread.
+    virtual std::unique_ptr<FunctionPass> fork() const = 0;
+
+public:
+    void run() override;
+};
+
 } // namespace siir
 } // namespace stm
 
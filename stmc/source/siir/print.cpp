@@ -161,8 +161,8 @@ static void print_function(std::ostream& os, Function* function) {
         os << " {\n";
     }
 
-    if (!function->locals().empty()) {
-        for (auto [ name, local ] : function->locals()) {
+    if (function->has_locals()) {
+        for (auto local : function->locals()) {
             os << "    ";
             print_local(os, local);
         }
@@ -181,8 +181,8 @@ static void print_function(std::ostream& os, Function* function) {
 
 void CFG::print(std::ostream& os) const {
     if (!m_types_structs.empty()) {
-        for (auto [ name, type ] : m_types_structs) {
-            os << name << " :: {\n";
+        for (auto type : structs()) {
+            os << type->get_name() << " :: {\n";
 
             for (u32 idx = 0, e = type->fields().size(); idx != e; ++idx) {
                 os << "    " << type->get_field(idx)->to_string();
@@ -197,7 +197,7 @@ void CFG::print(std::ostream& os) const {
     }
 
     if (!m_globals.empty()) {
-        for (auto& [ name, global ] : m_globals)
+        for (auto global : globals())
             print_global(os, global);
 
         os << '\n';
@@ -205,7 +205,7 @@ void CFG::print(std::ostream& os) const {
 
     if (!m_functions.empty()) {
         u32 idx = 0, e = m_functions.size();
-        for (auto& [ name, function ] : m_functions) {
+        for (auto function : functions()) {
             print_function(os, function);
             if (++idx != e)
                 os << '\n';
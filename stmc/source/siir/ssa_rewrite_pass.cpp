@@ -36,18 +36,13 @@ static void compute_rpo(Function* fn, std::vector<BasicBlock*>& rpo) {
     rpo.assign(order.rbegin(), order.rend());
 }
 
-SSARewritePass::SSARewritePass(CFG& cfg) : Pass(cfg), m_builder(cfg) {}
-
-void SSARewritePass::run() {
+SSARewritePass::SSARewritePass(CFG& cfg, ThreadPool* pool) 
+    : FunctionPass(cfg, pool), m_builder(cfg) {
     m_builder.set_insert_mode(InstBuilder::Prepend);
-
-    for (auto& fn : m_cfg.functions())
-        process(fn);
 }
 
 void SSARewritePass::process(Function* fn) {
-    auto locals_copy = fn->locals();
-    for (auto& [name, local] : locals_copy) {
+    for (auto local : fn->locals()) {
         promote_local(fn, local);
     }
 }
@@ -195,9 +190,8 @@ Value* SSARewritePass::try_remove_trivial_phi(Instruction* phi) {
     // A phi can also be considered trivial if it merges less than two unique
     // values.
     Value* same = nullptr;
-    for (auto op : phi->get_operand_list()) {
-        PhiOperand* phi_op = dynamic_cast<PhiOperand*>(op->get_value());
-        assert(phi_op && "non phi-compatible operand in phi operand list");
+    for (auto& op : phi->get_operand_list()) {
+        PhiOperand* phi_op = cast<PhiOperand>(op.get_value());
 
         if (phi_op->get_value() == same || phi_op->get_value() == phi) {
             // This is a reference to one of the phi's operands or a reference
@@ -216,7 +210,7 @@ Value* SSARewritePass::try_remove_trivial_phi(Instruction* phi) {
     assert(same);
 
     std::vector<User*> phi_users;
-    for (auto* use : phi->uses())
+    for (auto* use = phi->use_front(); use; use = use->next())
         if (use->get_user() != phi)
             phi_users.push_back(use->get_user());
 
@@ -231,7 +225,7 @@ Value* SSARewritePass::try_remove_trivial_phi(Instruction* phi) {
     delete phi;
 
     for (auto& user : phi_users)
-        if (auto* instr = dynamic_cast<Instruction*>(user))
+        if (auto* instr = dyn_cast<Instruction>(user))
             if (instr->is_phi())
                 try_remove_trivial_phi(instr);
 
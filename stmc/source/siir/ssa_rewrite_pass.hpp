@@ -21,7 +21,7 @@ class Local;
 ///
 /// This pass implements some of the algorithms outlined by Braun et al.
 /// See: https://link.springer.com/chapter/10.1007/978-3-642-37051-9_6
-class SSARewritePass final : public Pass {
+class SSARewritePass final : public FunctionPass {
     using BlockDefs = std::unordered_map<Local*,
         std::unordered_map<BasicBlock*, Value*>>;
 
@@ -42,7 +42,11 @@ class SSARewritePass final : public Pass {
     std::vector<BasicBlock*> m_sealed = {};
 
     /// Process a function in the target graph.
-    void process(Function* fn);
+    void process(Function* fn) override;
+
+    std::unique_ptr<FunctionPass> fork() const override {
+        return std::make_unique<SSARewritePass>(m_cfg);
+    }
 
     void promote_local(Function* fn, Local* local);
 
@@ -67,9 +71,11 @@ class SSARewritePass final : public Pass {
     void seal_block(BasicBlock* blk);
 
 public:
-    SSARewritePass(CFG& cfg);
+    /// Create a new pass over |cfg|, that processes functions on |pool| if it
+    /// is provided.
+    SSARewritePass(CFG& cfg, ThreadPool* pool = nullptr);
 
-    void run() override;
+    const char* name() const override { return "ssa rewrite"; }
 };
 
 } // namespace siir
@@ -3,11 +3,6 @@
 using namespace stm;
 using namespace stm::siir;
 
-void TrivialDCEPass::run() {
-    for (auto fn : m_cfg.functions())
-        process(fn);
-}
-
 void TrivialDCEPass::process(Function* fn) {
     for (auto blk = fn->front(); blk; blk = blk->next()) {
         for (auto inst = blk->front(); inst; inst = inst->next()) {
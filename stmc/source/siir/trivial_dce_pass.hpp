@@ -9,15 +9,22 @@
 namespace stm {
 namespace siir {
 
-class TrivialDCEPass final : public Pass {
-    void process(Function* fn);
+class TrivialDCEPass final : public FunctionPass {
+    void process(Function* fn) override;
+
+    std::unique_ptr<FunctionPass> fork() const override {
+        return std::make_unique<TrivialDCEPass>(m_cfg);
+    }
 
     std::vector<Instruction*> m_to_remove = {};
 
 public:
-    TrivialDCEPass(CFG& cfg) : Pass(cfg) {}
+    /// Create a new pass over |cfg|, that processes functions on |pool| if it
+    /// is provided.
+    TrivialDCEPass(CFG& cfg, ThreadPool* pool = nullptr) 
+        : FunctionPass(cfg, pool) {}
 
-    void run() override;
+    const char* name() const override { return "trivial dce"; }
 };
 
 } // namespace siir
@@ -5,34 +5,34 @@
 using namespace stm;
 using namespace stm::siir;
 
-u32 Type::s_id_iter = 0;
+std::atomic<u32> Type::s_id_iter = 0;
 
 const Type* Type::get_i1_type(CFG& cfg) {
-    return cfg.m_types_ints[IntegerType::TY_Int1];
+    return cfg.m_types_ints.at(IntegerType::TY_Int1);
 }
 
 const Type* Type::get_i8_type(CFG& cfg) {
-    return cfg.m_types_ints[IntegerType::TY_Int8];
+    return cfg.m_types_ints.at(IntegerType::TY_Int8);
 }
 
 const Type* Type::get_i16_type(CFG& cfg) {
-    return cfg.m_types_ints[IntegerType::TY_Int16];
+    return cfg.m_types_ints.at(IntegerType::TY_Int16);
 }
 
 const Type* Type::get_i32_type(CFG& cfg) {
-    return cfg.m_types_ints[IntegerType::TY_Int32];
+    return cfg.m_types_ints.at(IntegerType::TY_Int32);
 }
 
 const Type* Type::get_i64_type(CFG& cfg) {
-    return cfg.m_types_ints[IntegerType::TY_Int64];
+    return cfg.m_types_ints.at(IntegerType::TY_Int64);
 }
 
 const Type* Type::get_f32_type(CFG& cfg) {
-    return cfg.m_types_floats[FloatType::TY_Float32];
+    return cfg.m_types_floats.at(FloatType::TY_Float32);
 }
 
 const Type* Type::get_f64_type(CFG& cfg) {
-    return cfg.m_types_floats[FloatType::TY_Float64];
+    return cfg.m_types_floats.at(FloatType::TY_Float64);
 }
 
 static const IntegerType* get(CFG& cfg, u32 width) {
@@ -109,6 +109,7 @@ const FunctionType*
 FunctionType::get(CFG& cfg, const std::vector<const Type*>& args, 
                   const Type* ret) {
     FunctionType* type = new FunctionType(args, ret);
+    std::lock_guard<std::mutex> lock { cfg.m_types_fns_mutex };
     cfg.m_types_fns.push_back(type);
     return type;
 }
@@ -129,13 +130,9 @@ std::string FunctionType::to_string() const {
 }
 
 const PointerType* PointerType::get(CFG& cfg, const Type* pointee) {
-    auto it = cfg.m_types_ptrs.find(pointee);
-    if (it != cfg.m_types_ptrs.end())
-        return it->second;
-
-    PointerType* type = new PointerType(pointee);
-    cfg.m_types_ptrs.emplace(pointee, type);
-    return type;
+    return cfg.m_types_ptrs.get_or_create(pointee, [&]() {
+        return new PointerType(pointee);
+    });
 }
 
 std::string PointerType::to_string() const {
@@ -149,23 +146,22 @@ std::string PointerType::to_string() const {
     return str;
 }
 
-StructType* StructType::get(CFG& cfg, const std::string& name) {
-    auto it = cfg.m_types_structs.find(name);
-    if (it != cfg.m_types_structs.end())
-        return it->second;
-
-    return nullptr;
+StructType* StructType::get(CFG& cfg, Symbol name) {
+    std::shared_lock<std::shared_mutex> lock { cfg.m_types_structs_mutex };
+    StructType* const* type = cfg.m_types_structs.find(name);
+    return type ? *type : nullptr;
 }
 
 StructType* 
-StructType::create(CFG& cfg, const std::string& name,
+StructType::create(CFG& cfg, Symbol name,
                    const std::vector<const Type*> &fields) {
     assert(!get(cfg, name) && 
         "struct type with name already exists");
 
     StructType* type = new StructType(name, fields);
     assert(type);
-    cfg.m_types_structs.emplace(name, type);
+    std::unique_lock<std::shared_mutex> lock { cfg.m_types_structs_mutex };
+    cfg.m_types_structs.insert(name, type);
     return type;
 }
 
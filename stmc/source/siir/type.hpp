@@ -1,8 +1,11 @@
 #ifndef STATIM_SIIR_TYPE_HPP_
 #define STATIM_SIIR_TYPE_HPP_
 
+#include "types/casting.hpp"
+#include "types/symbol.hpp"
 #include "types/types.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <string>
 #include <vector>
@@ -33,8 +36,9 @@ public:
     };
 
 private:
-    /// Private id counter used during type ctor.
-    static u32 s_id_iter;
+    /// Private id counter used during type ctor. Types may be created by many
+    /// threads at once.
+    static std::atomic<u32> s_id_iter;
 
 protected:
     /// The unique id of this type.
@@ -143,6 +147,10 @@ public:
     }
 
     std::string to_string() const override;
+
+    static bool classof(const Type* type) {
+        return type->get_kind() >= TK_Int1 && type->get_kind() <= TK_Int64;
+    }
 };
 
 /// Types that represent floating point values of varying bit widths.
@@ -187,6 +195,10 @@ public:
     }
 
     std::string to_string() const override;
+
+    static bool classof(const Type* type) {
+        return type->get_kind() == TK_Float32 || type->get_kind() == TK_Float64;
+    }
 };
 
 /// Represents the type used for aggregates with one element of varying size.
@@ -216,6 +228,10 @@ public:
     bool is_array_type() const override { return true; }
 
     std::string to_string() const override;
+
+    static bool classof(const Type* type) {
+        return type->get_kind() == TK_Array;
+    }
 };
 
 /// Represents the type defined by a function signature. Primarily used for
@@ -263,6 +279,10 @@ public:
     bool is_function_type() const override { return true; }
 
     std::string to_string() const override;
+
+    static bool classof(const Type* type) {
+        return type->get_kind() == TK_Function;
+    }
 };
 
 /// Represents a pointer type, composed over a pointee type.
@@ -285,6 +305,10 @@ public:
     bool is_pointer_type() const override { return true; }
 
     std::string to_string() const override;
+
+    static bool classof(const Type* type) {
+        return type->get_kind() == TK_Pointer;
+    }
 };
 
 /// Represents named aggregate types.
@@ -293,27 +317,27 @@ class StructType final : public Type {
 
     /// The name of the struct. This is used both as an identifier and
     /// response to `to_string`.
-    std::string m_name;
+    Symbol m_name;
 
     /// The fields of this structure type.
     std::vector<const Type*> m_fields;
 
     /// Private constructor. To be used by the graph context.
-    StructType(const std::string& name, const std::vector<const Type*>& fields)
+    StructType(Symbol name, const std::vector<const Type*>& fields)
         : Type(TK_Struct), m_name(name), m_fields(fields) {}
 
 public:
     /// Get an existing struct type with the provided name. Returns null if a
     /// structure with the name does not exist.
-    static StructType* get(CFG& cfg, const std::string& name);
+    static StructType* get(CFG& cfg, Symbol name);
 
     /// Create a new struct type with the provided name and field types. Fails
     /// if there already exists a struct type with the name.
-    static StructType* create(CFG& cfg, const std::string& name,
+    static StructType* create(CFG& cfg, Symbol name,
                               const std::vector<const Type*> &fields);
 
     /// Returns the name of this struct type.
-    const std::string& get_name() const { return m_name; }
+    const std::string& get_name() const { return m_name.str(); }
 
     /// Returns the fields of this struct type.
     const std::vector<const Type*>& fields() const { return m_fields; }
@@ -344,6 +368,10 @@ public:
     bool is_struct_type() const override { return true; }
 
     std::string to_string() const override;
+
+    static bool classof(const Type* type) {
+        return type->get_kind() == TK_Struct;
+    }
 };
 
 } // namespace siir
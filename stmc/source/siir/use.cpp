@@ -4,18 +4,41 @@
 using namespace stm;
 using namespace siir;
 
+/// Returns the value whose use list a use of |value| belongs in. Uses of phi
+/// operands are uses of the value that comes in along the edge.
+static Value* used_value(Value* value) {
+    if (auto* phi_op = dyn_cast<PhiOperand>(value))
+        return phi_op->get_value();
+
+    return value;
+}
+
 Use::Use(Value* value, User* user) : m_value(value), m_user(user) {
     assert(value);
     assert(user);
 
-    if (auto* phi_op = dynamic_cast<PhiOperand*>(value))
-        phi_op->get_value()->add_use(this);
-    else
-        value->add_use(this);
+    used_value(value)->add_use(this);
 }
 
 Use::~Use() {
-    m_value->del_use(this);
+    used_value(m_value)->del_use(this);
     m_value = nullptr;
     m_user = nullptr;
 }
+
+void Use::set_value(Value* value) {
+    assert(m_value);
+    assert(value);
+
+    Value* used = used_value(m_value);
+    if (used == value)
+        return;
+
+    used->del_use(this);
+    if (auto* phi_op = dyn_cast<PhiOperand>(m_value))
+        phi_op->set_value(value);
+    else
+        m_value = value;
+
+    value->add_use(this);
+}
@@ -9,17 +9,33 @@ namespace siir {
 class User;
 
 /// Represents a use; the edge between a value and a user of it.
+///
+/// Each use is also a node in the intrusive use list of the value it uses, so
+/// that it can be added, removed or moved to another value in constant time.
+/// Uses are stored inline in the operand list of their user, and so are never
+/// created on their own.
 class Use final {
+    friend class Value;
+
     /// The value being used.
     Value* m_value;
 
     /// The value/user that is using the value in the edge.
     User* m_user;
 
+    /// The next use in the use list of the value, and the link that points to
+    /// this use, which is either the head of the list or the next link of the
+    /// use before it.
+    Use* m_next = nullptr;
+    Use** m_prev = nullptr;
+
 public:
     /// Create a new use edge between a value and a user.
     Use(Value* value, User* user);
 
+    Use(const Use&) = delete;
+    Use& operator = (const Use&) = delete;
+
     ~Use();
 
     operator Value*() { return m_value; }
@@ -32,22 +48,17 @@ public:
     const Value* get_value() const { return m_value; }
     Value* get_value() { return m_value; }
 
-    /// Set the value of this use to |value|.
-    void set_value(Value* value) {
-        assert(m_value);
-        assert(value);
-
-        if (m_value == value) 
-            return;
-
-        m_value->del_use(this);
-        m_value = value;
-        m_value->add_use(this);
-    }
+    /// Set the value of this use to |value|. For the incoming edges of a phi
+    /// node, this changes the value that comes in along the edge.
+    void set_value(Value* value);
 
     /// Get the user of this use.
     const User* get_user() const { return m_user; }
     User* get_user() { return m_user; }
+
+    /// Returns the next use of the same value, if there is one.
+    const Use* next() const { return m_next; }
+    Use* next() { return m_next; }
 };
 
 } // namespace siir
@@ -0,0 +1,52 @@
+#include "siir/cfg.hpp"
+#include "siir/user.hpp"
+
+#include <algorithm>
+
+using namespace stm;
+using namespace stm::siir;
+
+User::User(Kind kind, CFG& cfg, const std::vector<Value*>& ops, 
+           const Type* type) : Value(kind, type) {
+    u32 count = std::count_if(
+        ops.begin(), ops.end(), [](Value* v) { return v != nullptr; });
+    if (count == 0)
+        return;
+
+    reserve_operands(cfg, count);
+    for (auto& v : ops) {
+        if (v)
+            new (&m_operands[m_num_operands++]) Use(v, this);
+    }
+}
+
+void User::reserve_operands(CFG& cfg, u32 capacity) {
+    Use* operands = static_cast<Use*>(
+        cfg.allocate(capacity * sizeof(Use), alignof(Use)));
+
+    // Uses are linked into the lists of the values they use by address, so
+    // each one is remade in its new place rather than copied over. The old 
+    // array is left to the arena.
+    for (u32 idx = 0; idx != m_num_operands; ++idx) {
+        Value* value = m_operands[idx].get_value();
+        m_operands[idx].~Use();
+        new (&operands[idx]) Use(value, this);
+    }
+
+    m_operands = operands;
+    m_capacity = capacity;
+}
+
+void User::add_operand(CFG& cfg, Value* value) {
+    if (m_num_operands == m_capacity)
+        reserve_operands(cfg, std::max(4u, m_capacity * 2));
+
+    new (&m_operands[m_num_operands++]) Use(value, this);
+}
+
+void User::drop_operands() {
+    for (u32 idx = 0; idx != m_num_operands; ++idx)
+        m_operands[idx].~Use();
+
+    m_num_operands = 0;
+}
@@ -4,51 +4,66 @@
 #include "siir/use.hpp"
 #include "siir/value.hpp"
 
+#include <span>
+#include <vector>
+
 namespace stm {
 namespace siir {
 
 /// A value that uses other values.
 class User : public Value {
-protected:
     /// The operands of this user, or "use" edges - value, user pairs that
-    /// model the use-def chain.
-    std::vector<Use*> m_operands = {};
-
-    User() = default;
-    User(const std::vector<Value*>& ops, const Type* type) : Value(type) {
-        for (auto& v : ops) {
-            if (v)
-                m_operands.emplace_back(new Use(v, this));
-        }
-    }
+    /// model the use-def chain. These are kept inline in one array in the
+    /// arena of the graph, which is only replaced when a phi node outgrows it.
+    Use* m_operands = nullptr;
+    u32 m_num_operands = 0;
+    u32 m_capacity = 0;
+
+    /// Move the operands of this user to a new array in |cfg| that fits at
+    /// least |capacity| of them.
+    void reserve_operands(CFG& cfg, u32 capacity);
+
+protected:
+    User(Kind kind) : Value(kind) {}
+    User(Kind kind, const Type* type) : Value(kind, type) {}
+    User(Kind kind, CFG& cfg, const std::vector<Value*>& ops, 
+         const Type* type);
 
 public:
-    ~User() {
-        for (auto& use : m_operands) delete use;
-        m_operands.clear();
-    }
+    ~User() { drop_operands(); }
 
     /// Get the operand list of this user.
-    const std::vector<Use*>& get_operand_list() const { return m_operands; }
-    std::vector<Use*>& get_operand_list() { return m_operands; }
+    std::span<const Use> get_operand_list() const { 
+        return { m_operands, m_num_operands }; 
+    }
+
+    std::span<Use> get_operand_list() { 
+        return { m_operands, m_num_operands }; 
+    }
 
     /// Get the operand at position |i| of this user.
     const Use* get_operand(u32 i) const {
-        assert(i <= num_operands());
-        return m_operands[i];
+        assert(i < num_operands());
+        return &m_operands[i];
     }
     
     Use* get_operand(u32 i) {
-        assert(i <= num_operands());
-        return m_operands[i];
+        assert(i < num_operands());
+        return &m_operands[i];
     }
 
     /// Returns the number of operands this user has.
-    u32 num_operands() const { return m_operands.size(); }
+    u32 num_operands() const { return m_num_operands; }
+
+    /// Add a new operand |value| to this user, growing its operands in |cfg|
+    /// if they are full.
+    void add_operand(CFG& cfg, Value* value);
+
+    /// Remove every operand of this user, dropping its uses of other values.
+    void drop_operands();
 
-    /// Add a new operand |op| to this user.
-    void add_operand(Value* value) {
-        m_operands.push_back(new Use(value, this));
+    static bool classof(const Value* value) {
+        return value->get_kind() >= VK_Instruction;
     }
 };
 
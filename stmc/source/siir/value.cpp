@@ -1,24 +1,59 @@
+#include "siir/cfg.hpp"
 #include "siir/use.hpp"
 #include "siir/value.hpp"
 
-#include <algorithm>
+#include <mutex>
 
 using namespace stm;
 using namespace stm::siir;
 
+/// Locks for the use lists of values that may be shared between functions,
+/// picked by the address of the value.
+static std::mutex gUseLocks[32];
+
+static std::unique_lock<std::mutex> lock_uses(const Value* value) {
+    if (!value->has_shared_uses())
+        return {};
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(value);
+    return std::unique_lock<std::mutex> { gUseLocks[(addr >> 6) % 32] };
+}
+
+void* Value::operator new(size_t size, CFG& cfg) {
+    return cfg.allocate(size, alignof(std::max_align_t));
+}
+
 void Value::add_use(Use* use) {
-    m_uses.push_back(use);
+    assert(!use->m_prev && "use is already in a use list!");
+
+    auto lock = lock_uses(this);
+    use->m_next = m_uses;
+    use->m_prev = &m_uses;
+    if (m_uses)
+        m_uses->m_prev = &use->m_next;
+
+    m_uses = use;
+    m_num_uses++;
 }
 
 void Value::del_use(Use* use) {
-    auto it = std::find(m_uses.begin(), m_uses.end(), use);
-    if (it != m_uses.end())
-        m_uses.erase(it);
+    assert(use->m_prev && "use is not in a use list!");
+
+    auto lock = lock_uses(this);
+    *use->m_prev = use->m_next;
+    if (use->m_next)
+        use->m_next->m_prev = use->m_prev;
+
+    use->m_next = nullptr;
+    use->m_prev = nullptr;
+    m_num_uses--;
 }
 
 void Value::replace_all_uses_with(Value* value) {
-    std::vector<Use*> uses_copy = m_uses;
-    for (Use* use : uses_copy) {
-        use->set_value(value);
-    }
+    if (value == this)
+        return;
+
+    // Each use leaves this list as it is moved over to |value|.
+    while (m_uses)
+        m_uses->set_value(value);
 }
@@ -4,26 +4,62 @@
 #include "siir/type.hpp"
 
 #include <ostream>
-#include <vector>
 
 namespace stm {
 namespace siir {
 
+class CFG;
 class Use;
 class User;
 
 /// A value in the intermediate representation.
 class Value {
+public:
+    /// The kinds of values, one for each class of value that can be created.
+    /// The subclasses of each abstract class are kept in one range, so that
+    /// isa<> and friends can tell them apart with a single range check.
+    enum Kind : u8 {
+        VK_Argument,
+        VK_Function,
+        VK_InlineAsm,
+        VK_Local,
+        VK_PhiOperand,
+        VK_Instruction,
+        VK_ConstantInt,
+        VK_ConstantFP,
+        VK_ConstantNull,
+        VK_BlockAddress,
+        VK_ConstantString,
+        VK_Global,
+    };
+
 protected:
-    const Type* m_type;
-    std::vector<Use*> m_uses = {};
+    const Type* m_type = nullptr;
+
+    /// The head of the intrusive list of uses of this value, linked through
+    /// the uses themselves, and its length.
+    Use* m_uses = nullptr;
+    u32 m_num_uses = 0;
 
-    Value() = default;
-    Value(const Type* type) : m_type(type) {}
+    /// The kind of this value, which is fixed at creation.
+    const Kind m_kind;
+
+    Value(Kind kind) : m_kind(kind) {}
+    Value(Kind kind, const Type* type) : m_type(type), m_kind(kind) {}
 
 public:
     virtual ~Value() = default;
 
+    /// Values are allocated in the arena of the graph |cfg| that they belong
+    /// to. Deleting a value destroys it, but its memory is only released with
+    /// the graph.
+    static void* operator new(size_t size, CFG& cfg);
+    static void operator delete(void* ptr, CFG& cfg) {}
+    static void operator delete(void* ptr) {}
+
+    /// Returns the kind of this value.
+    Kind get_kind() const { return m_kind; }
+
     /// Returns the type of this value.
     const Type* get_type() const { return m_type; }
 
@@ -33,31 +69,25 @@ public:
     /// Returns true if this value has a type.
     bool has_type() const { return m_type != nullptr; }
 
-    /// Get all uses of this value.
-    const std::vector<Use*>& uses() const { return m_uses; }
-    std::vector<Use*>& uses() { return m_uses; }
-
-    /// Returns the first use of this value, if it exists.
-    const Use* use_front() const { return m_uses.front(); }
-    Use* use_front() { return m_uses.front(); }
-
-    /// Returns the latest use of this value, if it exists.
-    const Use* use_back() const { return m_uses.back(); }
-    Use* use_back() { return m_uses.back(); }
+    /// Returns the first use of this value, or null if it is unused. The rest
+    /// of the uses follow from it by Use::next(), in no particular order.
+    const Use* use_front() const { return m_uses; }
+    Use* use_front() { return m_uses; }
 
     /// Returns the number of times this value is used.
-    u32 num_uses() const { return m_uses.size(); }
+    u32 num_uses() const { return m_num_uses; }
 
     /// Returns true if this value has atleast one use.
-    bool used() const { return !m_uses.empty(); }
+    bool used() const { return m_uses != nullptr; }
 
     /// Returns true if this value has exactly one use.
-    bool has_one_use() const { return m_uses.size() == 1; }
+    bool has_one_use() const { return m_num_uses == 1; }
 
-    /// Add |use| to the uses of this value.
+    /// Link |use| into the uses of this value. The use must not be in the
+    /// use list of any value.
     void add_use(Use* use);
 
-    /// Removes the edge |use| from this value, if it exists.
+    /// Unlink |use| from the uses of this value, which it must be in.
     void del_use(Use* use);
 
     /// Replace all uses of this value with |value|.
@@ -66,6 +96,11 @@ public:
     /// Returns true if this value is a constant.
     virtual bool is_constant() const { return false; }
 
+    /// Returns true if this value may be used by more than one function, like
+    /// constants and functions themselves. Uses of such values can be added
+    /// and removed by many threads at once, so edits to them are locked.
+    virtual bool has_shared_uses() const { return false; }
+
     /// Print this value in a reproducible plaintext format to the output
     /// stream |os|.
     virtual void print(std::ostream& os) const = 0;
@@ -1,11 +1,17 @@
 #include "core/stmc.hpp"
+#include "core/cache.hpp"
 #include "core/logger.hpp"
+#include "core/thread_pool.hpp"
+#include "core/timer.hpp"
 #include "siir/cfg.hpp"
+#include "siir/linker.hpp"
 #include "siir/machine_analysis.hpp"
 #include "siir/machine_object.hpp"
 #include "siir/ssa_rewrite_pass.hpp"
 #include "siir/target.hpp"
 #include "siir/trivial_dce_pass.hpp"
+#include "tree/decl.hpp"
+#include "tree/interface.hpp"
 #include "tree/parser.hpp"
 #include "tree/type.hpp"
 #include "tree/visitor.hpp"
@@ -38,137 +44,620 @@
 #endif // STMC_LIVE_SUPPORT
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+/// Returns the path of the interface kept for the source file |source|,
+/// which is where uses of the file look for it once it is compiled.
+static std::string interface_path(const std::string& source) {
+    return source + stm::ModuleInterface::EXTENSION;
+}
 
-static stm::TranslationUnit* 
-resolve_use(stm::UseDecl* use, stm::InputFile& req,
-            const std::vector<std::unique_ptr<stm::TranslationUnit>>& units) {
-    std::string path = use->path();
+/// Returns the path of the object kept for the source file |source|, which
+/// sits beside its interface.
+static std::string object_path(const std::string& source) {
+    return source + ".o";
+}
 
-    if (path.size() < 4 || path.substr(path.size() - 4) != ".stm")
-        path += ".stm";
+/// Returns the path of the assembly kept for the source file |source|, which
+/// sits beside its object.
+static std::string assembly_path(const std::string& source) {
+    return source + ".s";
+}
 
-    std::filesystem::path req_path(req.absolute());
-    std::filesystem::path resolved = req_path.parent_path() / path;
+/// A module used by the units being compiled that was compiled beforehand, and
+/// whose declarations are loaded from its interface rather than its source.
+struct Module final {
+    /// The canonical path of the interface of this module.
+    std::string path;
+
+    /// The path of the object of this module, which is linked in its place.
+    std::string object;
+
+    std::unique_ptr<stm::InputFile> file;
+    std::unique_ptr<stm::TranslationUnit> unit;
+};
+
+/// Resolves the uses of a set of translation units to the units or compiled
+/// modules that they name, and links the exports of each used unit into the
+/// trees that use it.
+///
+/// Each path is only canonicalized once, and units are looked up by their
+/// canonical path, so resolution is linear in the number of units and uses.
+class ImportResolver final {
+    /// The state of a unit in the search over the use graph. A unit is grey
+    /// while the units it uses are being resolved, so reaching a grey unit
+    /// again means the uses are cyclic.
+    enum class Color : stm::u8 { White, Grey, Black };
+
+    const std::vector<std::unique_ptr<stm::TranslationUnit>>& m_units;
+    std::vector<std::unique_ptr<Module>>& m_modules;
+
+    /// The units and loaded modules, by canonical path.
+    std::unordered_map<std::string, stm::TranslationUnit*> m_paths = {};
+
+    /// The units that each requested path resolved to, so that a path used by
+    /// many units only touches the filesystem once.
+    std::unordered_map<std::string, stm::TranslationUnit*> m_resolved = {};
+
+    std::unordered_map<const stm::TranslationUnit*, Color> m_colors = {};
+
+    /// The declarations already imported into each unit.
+    std::unordered_map<const stm::TranslationUnit*, 
+                       std::unordered_set<const stm::Decl*>> m_imported = {};
+
+    /// Returns the canonical form of |path|, or an empty string if there is no
+    /// file at |path|.
+    static std::string canonical(const std::filesystem::path& path) {
+        std::error_code err;
+        std::filesystem::path absol = std::filesystem::canonical(path, err);
+        return err ? std::string() : absol.string();
+    }
 
-    std::error_code err;
-    std::filesystem::path absol = std::filesystem::canonical(resolved, err);
-    if (err) 
-        return nullptr;
+    /// Returns the unit or module that |use| in |req| names, loading the
+    /// interface of a compiled module if no unit matches, or null if there
+    /// is neither.
+    stm::TranslationUnit* resolve(stm::UseDecl* use, stm::InputFile& req) {
+        std::string path = use->path();
+
+        if (path.size() < 4 || path.substr(path.size() - 4) != ".stm")
+            path += ".stm";
+
+        std::filesystem::path resolved = std::filesystem::path(
+            req.absolute()).parent_path() / path;
+        resolved = resolved.lexically_normal();
+
+        auto [it, inserted] = m_resolved.emplace(resolved.string(), nullptr);
+        if (!inserted)
+            return it->second;
+
+        auto unit = m_paths.find(canonical(resolved));
+        if (unit != m_paths.end())
+            return it->second = unit->second;
+
+        // Fall back to the interface of the module if it was compiled already.
+        const std::string absol = canonical(interface_path(resolved.string()));
+        if (absol.empty())
+            return nullptr;
+
+        unit = m_paths.find(absol);
+        if (unit != m_paths.end())
+            return it->second = unit->second;
+
+        std::unique_ptr<Module> module = std::make_unique<Module>();
+        module->path = absol;
+        module->object = object_path(resolved.string());
+        module->file = std::make_unique<stm::InputFile>(module->path.c_str());
+        module->unit = std::make_unique<stm::TranslationUnit>(*module->file);
+        module->unit->set_root(std::make_unique<stm::Root>(*module->file));
+        stm::ModuleInterface::read(module->path, module->unit->get_root());
+
+        m_paths.emplace(absol, module->unit.get());
+        m_modules.push_back(std::move(module));
+        return it->second = m_modules.back()->unit.get();
+    }
 
-    for (auto& unit : units) {
-        if (unit->get_file().absolute() == absol.string())
-            return unit.get();
+    /// Takes all the public symbols which are in the file used by |use| and
+    /// imports them to the translation unit |dst|.
+    void link_imports(stm::UseDecl* use, stm::TranslationUnit* dst) {
+        assert(use && "use cannot be null!");
+        assert(use->resolved() && "use must be resolved!");
+
+        stm::Root& dst_root = dst->get_root();
+        std::vector<stm::Decl*>& dst_imps = dst_root.imports();
+        std::unordered_set<const stm::Decl*>& imported = m_imported[dst];
+
+        for (auto& exp : use->unit()->get_root().exports()) {
+            // Prevent duplicate imports.
+            if (!imported.insert(exp).second)
+                continue;
+            
+            dst_imps.push_back(exp);
+            
+            if (!dst_root.get_scope()->add(exp)) {
+                stm::Logger::fatal(
+                    "cannot import '" + exp->get_name() + 
+                        "' since a symbol with the same name already exists",
+                    use->get_span());
+            }
+
+            if (use->has_decorator(stm::Rune::Public))
+                dst_imps.push_back(exp);
+
+            if (auto ET = stm::dyn_cast<stm::EnumDecl>(exp)) {
+                for (auto& value : ET->get_values())
+                    dst_root.get_scope()->add(value);
+            }
+        }
     }
 
-    return nullptr;
-}
+    /// Resolve the uses of |unit| and the units it uses, depth first.
+    void visit(stm::TranslationUnit* unit) {
+        m_colors[unit] = Color::Grey;
+
+        for (auto& use : unit->get_root().uses()) {
+            stm::TranslationUnit* dep = resolve(use, unit->get_file());
+            if (!dep) {
+                stm::Logger::fatal(
+                    "unresolved source file: '" + use->path() + "'", 
+                    use->get_span());
+            }
+
+            use->resolve(dep);
 
-/// Takes all the public symbols which are in the file used by |use| and
-/// imports them to the translation unit |dst|.
-static void link_imports(stm::UseDecl* use, stm::TranslationUnit* dst) {
-    assert(use && "use cannot be null!");
-    assert(use->resolved() && "use must be resolved!");
-
-    stm::Root& src_root = use->unit()->get_root();
-    stm::Root& dst_root = dst->get_root();
-
-    std::vector<stm::Decl*> src_imps = src_root.imports();
-    stm::Scope* scope = dst_root.get_scope();
-    stm::TypeContext& ctx = dst_root.context();
-
-    std::vector<stm::Decl*>& dst_imps = dst_root.imports();
-    for (auto& exp : use->unit()->get_root().exports()) {
-        // Prevent duplicate imports.
-        if (std::find(dst_imps.begin(), dst_imps.end(), exp) != dst_imps.end())
-            continue;
-        
-        dst_imps.push_back(exp);
-        
-        if (!dst_root.get_scope()->add(exp)) {
-            stm::Logger::fatal(
-                "cannot import '" + exp->get_name() + 
-                    "' since a symbol with the same name already exists",
-                use->get_span());
+            Color& color = m_colors[dep];
+            if (color == Color::Grey) {
+                stm::Logger::fatal(
+                    "cannot recursively use source files", use->get_span());
+            } else if (color == Color::White) {
+                visit(dep);
+            }
+
+            link_imports(use, unit);
         }
 
-        if (use->has_decorator(stm::Rune::Public))
-            dst_imps.push_back(exp);
+        m_colors[unit] = Color::Black;
+    }
 
-        if (auto ST = dynamic_cast<stm::StructDecl*>(exp)) {
-            
-        } else if (auto ET = dynamic_cast<stm::EnumDecl*>(exp)) {
-            for (auto& value : ET->get_values())
-                dst_root.get_scope()->add(value);
+public:
+    ImportResolver(
+            const std::vector<std::unique_ptr<stm::TranslationUnit>>& units,
+            std::vector<std::unique_ptr<Module>>& modules)
+        : m_units(units), m_modules(modules) {
+        for (auto& unit : m_units) {
+            const std::string& absol = unit->get_file().absolute();
+            const std::string path = canonical(absol);
+            m_paths.emplace(path.empty() ? absol : path, unit.get());
+        }
+
+        for (auto& module : m_modules)
+            m_paths.emplace(module->path, module->unit.get());
+    }
 
+    /// Resolve the uses of every unit, loading the compiled modules that they
+    /// use into the list of modules.
+    void run() {
+        for (auto& unit : m_units) {
+            if (m_colors[unit.get()] == Color::White)
+                visit(unit.get());
         }
     }
+};
+
+/// Mix the interface that |unit| exports to the units that use it into
+/// |hash|. Only the signatures of exported declarations are part of it, so
+/// that changing the body of a function does not affect the units that use
+/// it.
+static void hash_interface(const stm::TranslationUnit& unit, 
+                           stm::ContentHash& hash) {
+    for (const stm::Decl* decl : unit.get_root().exports()) {
+        hash.update(decl->get_name());
+
+        if (auto FD = stm::dyn_cast<stm::FunctionDecl>(decl)) {
+            hash.update(stm::u64(0));
+            hash.update(FD->get_type()->to_string());
+        } else if (auto VD = stm::dyn_cast<stm::VariableDecl>(decl)) {
+            hash.update(stm::u64(1));
+            hash.update(VD->get_type()->to_string());
+        } else if (auto SD = stm::dyn_cast<stm::StructDecl>(decl)) {
+            hash.update(stm::u64(2));
+            for (const stm::FieldDecl* field : SD->get_fields()) {
+                hash.update(field->get_name());
+                hash.update(field->get_type()->to_string());
+            }
+        } else if (auto ED = stm::dyn_cast<stm::EnumDecl>(decl)) {
+            hash.update(stm::u64(3));
+            hash.update(ED->get_type()->to_string());
+            for (const stm::EnumValueDecl* value : ED->get_values()) {
+                hash.update(value->get_name());
+                hash.update(stm::u64(value->get_value()));
+            }
+        }
+    }
+}
+
+/// Returns the key of the object of |unit| in the cache. The key covers all
+/// that the object depends on: the source of the unit, the interfaces of the
+/// units it uses directly or indirectly, the options of |opts| that affect
+/// code generation and the version of the compiler.
+static std::string cache_key(const stm::Options& opts, 
+                             const stm::TranslationUnit& unit) {
+    stm::ContentHash hash;
+    hash.update(STMC_VERSION);
+    hash.update(stm::u64(opts.opt_level));
+    hash.update(stm::u64(opts.llvm));
+    hash.update(stm::u64(opts.debug));
+    hash.update(unit.get_file().absolute());
+    hash.update(unit.get_file().source());
+
+    std::vector<const stm::TranslationUnit*> deps = { &unit };
+    for (stm::u32 idx = 0; idx != deps.size(); ++idx) {
+        for (const stm::UseDecl* use : deps[idx]->get_root().uses()) {
+            const stm::TranslationUnit* dep = use->unit();
+            if (std::find(deps.begin(), deps.end(), dep) != deps.end())
+                continue;
+
+            deps.push_back(dep);
+            hash_interface(*dep, hash);
+        }
+    }
+
+    return hash.hex();
 }
 
-/// Resolve the uses for the provided translation unit. Returns true if any
-/// cyclical imports were found.
-static bool 
-resolve_uses(stm::TranslationUnit* unit, 
-             std::vector<stm::TranslationUnit*> visited, 
-             std::vector<stm::TranslationUnit*> stack,
-             const std::vector<std::unique_ptr<stm::TranslationUnit>>& units) {
+/// Returns the record that the phases of |unit| are timed in, or null if
+/// timing is disabled.
+static stm::TimeRecord* unit_record(const stm::TranslationUnit& unit) {
+    if (!stm::Timer::enabled())
+        return nullptr;
 
-    if (std::find(visited.begin(), visited.end(), unit) != visited.end()) {
-        if (!stack.empty())
-            stack.pop_back();
+    return stm::Timer::root()->child(unit.get_file().filename());
+}
 
-        return false;
+/// How much of a translation unit needs to be analyzed.
+enum class Analysis : stm::u8 {
+    /// The unit is not analyzed at all, as its object was cached and no unit
+    /// that uses it is analyzed either.
+    None,
+
+    /// The unit is only checked, as its object was cached but a unit that uses
+    /// it needs its declarations to be analyzed.
+    Interface,
+
+    /// The unit is analyzed and lowered to SIIR.
+    Full,
+};
+
+/// The time spent in each phase of analyzing a single translation unit.
+struct UnitTimes final {
+    using Clock = std::chrono::steady_clock;
+    using Millis = std::chrono::duration<double, std::milli>;
+
+    Clock::time_point start = {};
+    Clock::time_point end = {};
+    Millis syma = {};
+    Millis sema = {};
+    Millis codegen = {};
+    Millis siir = {};
+};
+
+/// Run symbol and semantic analysis over |unit|, lower it to SIIR and run any
+/// SIIR passes enabled by |opts| over its functions on |pool|, recording the 
+/// time of each phase in |times|. Lowering is skipped unless |lower| is set.
+static void analyze_unit(stm::Options& opts, stm::siir::Target& target,
+                         stm::TranslationUnit& unit, stm::ThreadPool& pool,
+                         UnitTimes& times, bool lower) {
+    stm::Root& root = unit.get_root();
+
+    times.start = UnitTimes::Clock::now();
+
+    {
+        stm::TimeScope scope { "syma" };
+        stm::SymbolAnalysis syma { opts, root };
+        root.accept(syma);
     }
 
-    visited.push_back(unit);
-    stack.push_back(unit);
-
-    for (auto& use : unit->get_root().uses()) {
-        stm::TranslationUnit* dep = resolve_use(
-            use, unit->get_file(), units);
-        
-        if (!dep) {
-            stm::Logger::fatal(
-                "unresolved source file: '" + use->path() + "'", 
-                use->get_span());
-        }
+    UnitTimes::Clock::time_point mark = UnitTimes::Clock::now();
+    times.syma = mark - times.start;
+
+    {
+        stm::TimeScope scope { "sema" };
+        stm::SemanticAnalysis sema { opts, root };
+        root.accept(sema);
+    }
+
+    times.sema = UnitTimes::Clock::now() - mark;
+    mark = UnitTimes::Clock::now();
+
+    if (!lower) {
+        times.end = mark;
+        return;
+    }
+
+    std::unique_ptr<stm::siir::CFG> graph =
+        std::make_unique<stm::siir::CFG>(unit.get_file(), target);
+
+    {
+        stm::TimeScope scope { "codegen" };
+        stm::Codegen cgn { opts, root, *graph };
+        root.accept(cgn);
+    }
+
+    times.codegen = UnitTimes::Clock::now() - mark;
+    mark = UnitTimes::Clock::now();
+
+    // Skip SIIR optimization passes if desired or if the LLVM backend is 
+    // being targetted.
+    if (!opts.llvm && opts.opt_level >= 1) {
+        // Run O1+ optimizations.
+
+        stm::siir::SSARewritePass SSAR { *graph, &pool };
+        SSAR.run();
+
+        stm::siir::TrivialDCEPass TDCE { *graph, &pool };
+        TDCE.run();
+    }
 
-        use->resolve(dep);
+    if (!opts.llvm && opts.opt_level >= 2) {
+        // Run O2+ optimizations.
+    }
+
+    if (!opts.llvm && opts.opt_level >= 3) {
+        // Run O3+ optimizations.
+    }
+
+    unit.set_graph(std::move(graph));
+
+    times.end = UnitTimes::Clock::now();
+    times.siir = times.end - mark;
+}
 
-        if (std::find(stack.begin(), stack.end(), dep) != stack.end()) {
-            stm::Logger::fatal(
-                "cannot recursively use source files", use->get_span());
+/// Analyze each of |units| on |pool|, in an order that respects the use
+/// dependencies between them. A unit is only analyzed once every unit it uses
+/// has been, so units that do not depend on each other run concurrently. The
+/// diagnostics of each unit are captured into its buffer in |logs|, and units
+/// that use a unit which failed are skipped. Each unit is only analyzed as far
+/// as its entry in |analysis| asks for.
+static void 
+analyze_units(stm::Options& opts, stm::siir::Target& target,
+              const std::vector<std::unique_ptr<stm::TranslationUnit>>& units,
+              stm::ThreadPool& pool, std::vector<stm::Logger::Buffer>& logs,
+              std::vector<UnitTimes>& times,
+              const std::vector<Analysis>& analysis) {
+    const stm::u32 count = units.size();
+    
+    std::unordered_map<const stm::TranslationUnit*, stm::u32> indices;
+    for (stm::u32 idx = 0; idx != count; ++idx)
+        indices.emplace(units[idx].get(), idx);
+
+    // Build the dependency graph from the resolved uses of each unit.
+    std::vector<std::vector<stm::u32>> deps(count);
+    std::vector<std::vector<stm::u32>> dependents(count);
+    std::vector<std::atomic<stm::u32>> waiting(count);
+    for (stm::u32 idx = 0; idx != count; ++idx) {
+        // Modules were compiled beforehand, so there is no need to wait on
+        // them.
+        for (stm::UseDecl* use : units[idx]->get_root().uses()) {
+            auto it = indices.find(use->unit());
+            if (it != indices.end())
+                deps[idx].push_back(it->second);
         }
 
-        resolve_uses(dep, visited, stack, units);
-        link_imports(use, unit);
+        std::sort(deps[idx].begin(), deps[idx].end());
+        deps[idx].erase(
+            std::unique(deps[idx].begin(), deps[idx].end()), deps[idx].end());
+
+        waiting[idx].store(deps[idx].size());
+        for (stm::u32 dep : deps[idx])
+            dependents[dep].push_back(idx);
     }
 
-    stack.pop_back();    
-    return false;
+    std::vector<bool> failed(count, false);
+    std::mutex failed_mutex;
+
+    std::function<void(stm::u32)> schedule = [&](stm::u32 idx) {
+        pool.submit([&, idx] {
+            bool skip = false;
+            {
+                std::lock_guard lock { failed_mutex };
+                for (stm::u32 dep : deps[idx])
+                    skip |= failed[dep];
+            }
+
+            if (analysis[idx] == Analysis::None) {
+                times[idx].start = times[idx].end = UnitTimes::Clock::now();
+            } else if (!skip) {
+                stm::TimeScope scope { unit_record(*units[idx]) };
+                stm::Logger::capture(logs[idx], [&] {
+                    analyze_unit(opts, target, *units[idx], pool, times[idx],
+                        analysis[idx] == Analysis::Full);
+                });
+            }
+
+            {
+                std::lock_guard lock { failed_mutex };
+                failed[idx] = skip || logs[idx].failed();
+            }
+
+            for (stm::u32 dependent : dependents[idx]) {
+                if (waiting[dependent].fetch_sub(1) == 1)
+                    schedule(dependent);
+            }
+        });
+    };
+
+    for (stm::u32 idx = 0; idx != count; ++idx) {
+        if (deps[idx].empty())
+            schedule(idx);
+    }
+
+    pool.wait();
 }
 
+/// Print the analysis times of |units| to |os|, along with the critical path
+/// through their dependencies and how much of the analysis ran in parallel.
 static void 
-link_trees(const std::vector<std::unique_ptr<stm::TranslationUnit>>& units) {
-    std::vector<stm::TranslationUnit*> visited = {};
-    std::vector<stm::TranslationUnit*> stack = {};
+print_unit_times(std::ostream& os, 
+                 const std::vector<std::unique_ptr<stm::TranslationUnit>>& units,
+                 const std::vector<UnitTimes>& times, 
+                 UnitTimes::Clock::time_point start) {
+    const UnitTimes::Millis wall = UnitTimes::Clock::now() - start;
+
+    std::unordered_map<const stm::TranslationUnit*, stm::u32> indices;
+    for (stm::u32 idx = 0; idx != units.size(); ++idx)
+        indices.emplace(units[idx].get(), idx);
+
+    // The longest chain of analysis time ending at each unit. Units are
+    // visited in the order they finished, which is always after their uses.
+    std::vector<stm::u32> order(units.size());
+    for (stm::u32 idx = 0; idx != order.size(); ++idx)
+        order[idx] = idx;
+
+    std::sort(order.begin(), order.end(), [&](stm::u32 lhs, stm::u32 rhs) {
+        return times[lhs].end < times[rhs].end;
+    });
 
-    for (auto& unit : units) {
-        if (std::find(visited.begin(), visited.end(), unit.get()) == visited.end())
-            resolve_uses(unit.get(), visited, stack, units);
+    std::vector<UnitTimes::Millis> paths(units.size());
+    UnitTimes::Millis critical = {};
+    UnitTimes::Millis busy = {};
+    for (stm::u32 idx : order) {
+        UnitTimes::Millis longest = {};
+        for (stm::UseDecl* use : units[idx]->get_root().uses()) {
+            auto it = indices.find(use->unit());
+            if (it != indices.end())
+                longest = std::max(longest, paths[it->second]);
+        }
+
+        paths[idx] = longest + (times[idx].end - times[idx].start);
+        critical = std::max(critical, paths[idx]);
+        busy += times[idx].end - times[idx].start;
+    }
+
+    os << std::fixed << std::setprecision(2);
+    os << "analysis: " << wall.count() << " ms wall, " << busy.count() << 
+        " ms busy, " << critical.count() << " ms critical path, " << 
+        (wall.count() > 0 ? busy / wall : 0.0) << "x parallel\n";
+
+    os << std::setw(10) << "start" << std::setw(10) << "syma" << 
+        std::setw(10) << "sema" << std::setw(10) << "codegen" << 
+        std::setw(10) << "siir" << std::setw(10) << "path" << "  unit\n";
+
+    for (stm::u32 idx = 0; idx != units.size(); ++idx) {
+        const UnitTimes& unit = times[idx];
+        os << std::setw(10) << UnitTimes::Millis(unit.start - start).count() << 
+            std::setw(10) << unit.syma.count() << 
+            std::setw(10) << unit.sema.count() << 
+            std::setw(10) << unit.codegen.count() << 
+            std::setw(10) << unit.siir.count() << 
+            std::setw(10) << paths[idx].count() << "  " << 
+            units[idx]->get_file().filename() << '\n';
     }
 }
 
+/// Write the object |object| out to the file |filename|.
+static void write_object(const stm::siir::ObjectFile& object,
+                         const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        stm::Logger::fatal("could not open object file for writing: '" +
+            filename + "'");
+
+    object.write(file);
+}
+
+/// Write the |bytes| of an object file out to the file |filename|.
+static void write_object(const std::vector<stm::u8>& bytes,
+                         const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        stm::Logger::fatal("could not open object file for writing: '" +
+            filename + "'");
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+/// Write the interface of |unit| out to the file |filename|.
+static void write_interface(const stm::TranslationUnit& unit,
+                            const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        stm::Logger::fatal("could not open module interface for writing: '" +
+            filename + "'");
+
+    stm::ModuleInterface::write(unit.get_root(), file);
+}
+
+/// Read the object file |filename|, which is needed to link the output.
+static stm::siir::ObjectFile read_object(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        stm::Logger::fatal("could not open object file: '" + filename + "'");
+
+    std::vector<stm::u8> bytes {
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>() };
+    return stm::siir::ObjectFile::read(filename, bytes.data(), bytes.size());
+}
+
+/// Link |objects| into the executable output of |opts|, along with the
+/// objects of the used |modules| and the runtime unless it is disabled.
+static void 
+link_executable(const stm::Options& opts,
+                const std::vector<stm::siir::ObjectFile>& objects,
+                const std::vector<std::unique_ptr<Module>>& modules) {
+    stm::TimeScope scope { "link" };
+
+    // TODO: Adjust depending on expected std installation path.
+    std::vector<stm::siir::ObjectFile> extern_objects = {};
+    if (!opts.nostd)
+        extern_objects.push_back(read_object("std/rt.o"));
+
+    for (const auto& module : modules)
+        extern_objects.push_back(read_object(module->object));
+
+    stm::siir::Linker linker {};
+    for (const auto& object : extern_objects)
+        linker.add(object);
+
+    for (const auto& object : objects)
+        linker.add(object);
+
+    const std::string output = opts.output;
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        stm::Logger::fatal("could not open executable for writing: '" + 
+            output + "'");
+
+    linker.run(file);
+    file.close();
+
+    using std::filesystem::perms;
+    std::filesystem::permissions(output, perms::owner_all | 
+        perms::group_read | perms::group_exec | perms::others_read | 
+        perms::others_exec);
+}
+
 #ifdef STMC_LLVM_SUPPORT
 static void emit_module(const stm::Options& opts, 
                         llvm::CodeGenFileType file_type,
-                        llvm::Module& module, llvm::TargetMachine* TM) {
+                        llvm::Module& module, llvm::TargetMachine* TM,
+                        llvm::raw_pwrite_stream& os) {
     if (module.empty() && module.global_empty())
         return;
 
+    stm::TimeScope scope { "llvm emit" };
+
     llvm::PassBuilder PB { TM };
     llvm::LoopAnalysisManager LAM;
     llvm::FunctionAnalysisManager FAM;
@@ -198,33 +687,12 @@ static void emit_module(const stm::Options& opts,
     MPM.addPass(llvm::createModuleToFunctionPassAdaptor(
         llvm::SimplifyCFGPass()));
 
-    std::string ofile;
-    switch (file_type) {
-    case llvm::CodeGenFileType::AssemblyFile:
-        ofile = module.getSourceFileName() + ".s";
-        break;
-    case llvm::CodeGenFileType::ObjectFile:
-        ofile = module.getSourceFileName() + ".o";
-        break;
-    case llvm::CodeGenFileType::Null:
-        assert(false && "cannot emit null LLVM file type!");
-    }
-
-    llvm::sys::fs::OpenFlags flags = llvm::sys::fs::OF_None;
-    if (file_type == llvm::CodeGenFileType::AssemblyFile)
-        flags = llvm::sys::fs::OF_Text;
-
-    std::error_code EC;
-    llvm::ToolOutputFile* output = new llvm::ToolOutputFile(ofile, EC, flags);
-    assert(!EC && "error occured creating LLVM output file!");
-
     llvm::legacy::PassManager LPM;
-    assert(!TM->addPassesToEmitFile(LPM, output->os(), nullptr, file_type) &&
+    assert(!TM->addPassesToEmitFile(LPM, os, nullptr, file_type) &&
         "unable to add passes in order to emit LLVM module!");
 
     MPM.run(module, MAM);
     LPM.run(module);
-    output->keep();
 }
 #endif // STMC_LLVM_SUPPORT
 
@@ -234,6 +702,8 @@ stm::i32 main(stm::i32 argc, char** argv) {
     stm::Options options {};
     options.output = "main";
     options.opt_level = 0;
+    options.jobs = 1;
+    options.cache_dir = nullptr;
     options.debug = false;
     options.devel = false;
     options.dump_ast = false;
@@ -246,9 +716,12 @@ stm::i32 main(stm::i32 argc, char** argv) {
     options.llvm = false;
     options.nostd = false;
     options.time = false;
+    options.time_json = false;
+    options.trace = nullptr;
 
     std::vector<std::unique_ptr<stm::InputFile>> files = {};
     std::vector<std::unique_ptr<stm::TranslationUnit>> units = {};
+    std::vector<std::unique_ptr<Module>> used_modules = {};
 
     // Parse any command-line arguments into compiler options.
     for (stm::u32 i = 1; i < argc; ++i) {
@@ -266,6 +739,21 @@ stm::i32 main(stm::i32 argc, char** argv) {
             options.opt_level = 2;
         } else if (arg == "-O3") {
             options.opt_level = 3;
+        } else if (arg.rfind("-j", 0) == 0) {
+            std::string jobs = arg.substr(2);
+            if (jobs.empty() && ++i < argc)
+                jobs = argv[i];
+
+            if (jobs.empty() || jobs.size() > 4 ||
+              jobs.find_first_not_of("0123456789") != std::string::npos)
+                stm::Logger::fatal("expected number of jobs after '-j' argument");
+            
+            options.jobs = std::stoul(jobs);
+        } else if (arg == "-cache-dir") {
+            if (++i >= argc)
+                stm::Logger::fatal("expected directory after '-cache-dir' argument");
+
+            options.cache_dir = argv[i];
         } else if (arg == "-g") {
             options.debug = true;
         } else if (arg == "-d") {
@@ -289,6 +777,14 @@ stm::i32 main(stm::i32 argc, char** argv) {
             options.nostd = true;
         } else if (arg == "-t") {
             options.time = true;
+        } else if (arg == "-t=json") {
+            options.time = true;
+            options.time_json = true;
+        } else if (arg.rfind("-ftrace=", 0) == 0) {
+            if (arg.size() == 8)
+                stm::Logger::fatal("expected filename after '-ftrace=' argument");
+
+            options.trace = argv[i] + 8;
         } else if (arg[0] == '-') {
             stm::Logger::fatal("unrecognized argument: '" + arg + "'");
         } else {
@@ -300,34 +796,59 @@ stm::i32 main(stm::i32 argc, char** argv) {
         stm::Logger::fatal("no input files");
 
     units.reserve(files.size());
-    
-    // For each input file, create a new translation unit and attempt to
-    // parse a syntax tree from the file contents.
-    for (auto& file : files) {
-        std::unique_ptr<stm::TranslationUnit> unit =
-            std::make_unique<stm::TranslationUnit>(*file);
-            
-        stm::Parser parser { *file };
-        parser.parse(*unit);
+    for (auto& file : files)
+        units.push_back(std::make_unique<stm::TranslationUnit>(*file));
 
-        units.push_back(std::move(unit));
-    }
+    // The phases of the whole compilation are timed in one record, with one
+    // record for each unit in the order they were given. A trace is made of
+    // the same phases, so tracing needs timing too.
+    if (options.time || options.trace)
+        stm::Timer::enable("stmc");
 
-    link_trees(units);
+    if (options.trace)
+        stm::Trace::enable();
 
+    stm::TimeScope total { stm::Timer::root() };
     for (auto& unit : units)
-        unit->get_root().validate();
-
-    link_trees(units);
+        unit_record(*unit);
+
+    stm::ThreadPool pool { options.jobs };
+
+    // For each translation unit, attempt to parse a syntax tree from the file
+    // contents. Units are parsed concurrently, but their diagnostics are held
+    // and flushed in input order, so that the output does not depend on the
+    // number of jobs.
+    std::vector<stm::Logger::Buffer> logs(units.size());
+    for (stm::u32 idx = 0; idx != units.size(); ++idx) {
+        pool.submit([&units, &logs, idx] {
+            stm::TimeScope scope { unit_record(*units[idx]) };
+            stm::Logger::capture(logs[idx], [&units, idx] {
+                {
+                    stm::TimeScope scope { "read" };
+                    units[idx]->get_file().source();
+                }
+
+                stm::TimeScope scope { "parse" };
+                stm::Parser parser { units[idx]->get_file() };
+                parser.parse(*units[idx]);
+            });
+        });
+    }
 
-    for (auto& unit : units) {
-        stm::Root& root = unit->get_root();
+    pool.wait();
+    for (auto& log : logs)
+        log.flush();
 
-        stm::SymbolAnalysis syma { options, root };
-        root.accept(syma);
+    {
+        stm::TimeScope scope { "resolve uses" };
+        ImportResolver resolver { units, used_modules };
+        resolver.run();
+    }
 
-        stm::SemanticAnalysis sema { options, root };
-        root.accept(sema);
+    for (auto& unit : units) {
+        stm::TimeScope scope { unit_record(*unit) };
+        stm::TimeScope validate { "validate" };
+        unit->get_root().validate();
     }
 
     stm::siir::Target target { 
@@ -336,39 +857,67 @@ stm::i32 main(stm::i32 argc, char** argv) {
         stm::siir::Target::Linux 
     };
 
-    for (auto& unit : units) {
-        std::unique_ptr<stm::siir::CFG> graph =
-            std::make_unique<stm::siir::CFG>(unit->get_file(), target);
-
-        stm::Codegen cgn { options, unit->get_root(), *graph };
-        unit->get_root().accept(cgn);
-
-        // Skip SIIR optimization passes if desired or if the LLVM backend is 
-        // being targetted.
-        if (options.llvm || options.opt_level == 0) {
-            unit->set_graph(std::move(graph));
-            continue;
+    // Look up the object of each unit in the cache, if there is one. Units
+    // with a cached object are not lowered, but are still checked if a unit
+    // that uses them is, since it needs their declarations to be analyzed, or
+    // if their interface is to be written out.
+    // Assembly and machine IR can only come from compiling a unit, so objects
+    // are not reused when either is asked for.
+    std::unique_ptr<stm::ObjectCache> cache = nullptr;
+    std::vector<std::string> keys(units.size());
+    std::vector<std::vector<stm::u8>> cached(units.size());
+    std::vector<Analysis> analysis(units.size(), Analysis::Full);
+    if (options.cache_dir) {
+        stm::TimeScope scope { "cache lookup" };
+        cache = std::make_unique<stm::ObjectCache>(options.cache_dir);
+        const bool reuse = !options.keep_asm && !options.dump_machine_ir;
+
+        std::unordered_map<const stm::TranslationUnit*, stm::u32> indices;
+        for (stm::u32 idx = 0; idx != units.size(); ++idx) {
+            indices.emplace(units[idx].get(), idx);
+            keys[idx] = cache_key(options, *units[idx]);
+            if (reuse && cache->load(keys[idx], cached[idx])) {
+                analysis[idx] = options.keep_obj ? Analysis::Interface :
+                    Analysis::None;
+            }
         }
 
-        if (options.opt_level >= 1) {
-            // Run O1+ optimizations.
-
-            stm::siir::SSARewritePass SSAR { *graph };
-            SSAR.run();
-
-            stm::siir::TrivialDCEPass TDCE { *graph };
-            TDCE.run();
+        std::vector<stm::u32> worklist = {};
+        for (stm::u32 idx = 0; idx != units.size(); ++idx)
+            if (analysis[idx] != Analysis::None)
+                worklist.push_back(idx);
+
+        while (!worklist.empty()) {
+            const stm::u32 idx = worklist.back();
+            worklist.pop_back();
+
+            for (const stm::UseDecl* use : units[idx]->get_root().uses()) {
+                auto it = indices.find(use->unit());
+                if (it == indices.end())
+                    continue;
+
+                const stm::u32 dep = it->second;
+                if (analysis[dep] == Analysis::None) {
+                    analysis[dep] = Analysis::Interface;
+                    worklist.push_back(dep);
+                }
+            }
         }
+    }
 
-        if (options.opt_level >= 2) {
-            // Run O2+ optimizations.
-        }
+    std::vector<UnitTimes> times(units.size());
+    const UnitTimes::Clock::time_point analysis_start = UnitTimes::Clock::now();
+    analyze_units(options, target, units, pool, logs, times, analysis);
 
-        if (options.opt_level >= 3) {
-            // Run O3+ optimizations.
-        }
+    for (auto& log : logs)
+        log.flush();
 
-        unit->set_graph(std::move(graph));
+    if (options.time && !options.time_json)
+        print_unit_times(std::cerr, units, times, analysis_start);
+
+    if (options.time && !options.time_json && cache) {
+        std::cerr << "cache: " << cache->hits() << " hits, " << 
+            cache->misses() << " misses in '" << cache->dir() << "'\n";
     }
 
     if (options.llvm) {
@@ -428,10 +977,29 @@ stm::i32 main(stm::i32 argc, char** argv) {
 
         std::vector<std::unique_ptr<llvm::LLVMContext>> contexts;
         std::vector<std::unique_ptr<llvm::Module>> modules;
+        std::vector<stm::siir::ObjectFile> objects;
         contexts.reserve(units.size());
         modules.reserve(units.size());
+        objects.reserve(units.size());
+
+        for (stm::u32 idx = 0; idx != units.size(); ++idx) {
+            auto& unit = units[idx];
+            if (analysis[idx] != Analysis::Full) {
+                const std::string& filename = unit->get_file().absolute();
+                if (options.keep_obj) {
+                    write_object(cached[idx], object_path(filename));
+                    write_interface(*unit, interface_path(filename));
+                }
+
+                if (!cached[idx].empty()) {
+                    objects.push_back(stm::siir::ObjectFile::read(
+                        filename, cached[idx].data(), cached[idx].size()));
+                }
+
+                continue;
+            }
 
-        for (auto& unit : units) {
+            stm::TimeScope scope { unit_record(*unit) };
             stm::siir::CFG& graph = unit->get_graph();
             std::unique_ptr<llvm::LLVMContext> context =
                 std::make_unique<llvm::LLVMContext>();
@@ -446,46 +1014,83 @@ stm::i32 main(stm::i32 argc, char** argv) {
 
             module->print(llvm::outs(), nullptr);
 
+            const std::string& filename = module->getSourceFileName();
+            std::error_code EC;
+            llvm::ToolOutputFile assembly_file {
+                assembly_path(filename), EC, llvm::sys::fs::OF_Text };
+            assert(!EC && "error occured creating LLVM output file!");
+
             emit_module(
                 options, 
                 llvm::CodeGenFileType::AssemblyFile, 
                 *module,
-                target_mc);
-
+                target_mc,
+                assembly_file.os());
+            assembly_file.keep();
+
+            // Objects are emitted into memory and read back for the linker,
+            // and only written out if they are to be kept.
+            llvm::SmallVector<char, 0> buffer;
+            llvm::raw_svector_ostream object_os { buffer };
             emit_module(
                 options, 
                 llvm::CodeGenFileType::ObjectFile, 
                 *module,
-                target_mc);
+                target_mc,
+                object_os);
+
+            const std::vector<stm::u8> bytes { buffer.begin(), buffer.end() };
+            if (cache)
+                cache->store(keys[idx], bytes);
+
+            if (!bytes.empty()) {
+                objects.push_back(stm::siir::ObjectFile::read(
+                    filename, bytes.data(), bytes.size()));
+
+                if (options.keep_obj) {
+                    write_object(bytes, object_path(filename));
+                    write_interface(*unit, interface_path(filename));
+                }
+            }
 
             contexts.push_back(std::move(context));
             modules.push_back(std::move(module));
         }
 
-        std::string ld = "ld -nostdlib -o " + 
-            std::string(options.output) + " std/rt.o ";
-        for (const auto& module : modules)
-            ld += module->getSourceFileName() + ".o ";
-
-        std::system(ld.c_str());
+        if (options.link)
+            link_executable(options, objects, used_modules);
 #else
     assert(false && 
         "LLVM backend unsupported! recompile with STMC_LLVM_SUPPORT");
 #endif // STMC_LLVM_SUPPORT
     } else {
-        std::vector<std::unique_ptr<stm::siir::MachineObject>> objs = {};
-        objs.reserve(units.size());
+        std::vector<stm::siir::ObjectFile> objects = {};
+        objects.reserve(units.size());
 
-        for (auto& unit : units) {
+        for (stm::u32 idx = 0; idx != units.size(); ++idx) {
+            auto& unit = units[idx];
             const std::string& filename = unit->get_file().filename();
+            const std::string& source = unit->get_file().absolute();
+            if (analysis[idx] != Analysis::Full) {
+                if (options.keep_obj) {
+                    write_object(cached[idx], object_path(source));
+                    write_interface(*unit, interface_path(source));
+                }
+
+                objects.push_back(stm::siir::ObjectFile::read(
+                    filename, cached[idx].data(), cached[idx].size()));
+                continue;
+            }
+
+            stm::TimeScope scope { unit_record(*unit) };
             stm::siir::CFG& graph = unit->get_graph();
             std::unique_ptr<stm::siir::MachineObject> obj =
                 std::make_unique<stm::siir::MachineObject>(&graph, &target); 
             
-            stm::siir::CFGMachineAnalysis CMA { graph };
+            stm::siir::CFGMachineAnalysis CMA { graph, &pool };
             CMA.run(*obj);
 
-            stm::siir::FunctionRegisterAnalysis FRA { *obj };
+            stm::siir::FunctionRegisterAnalysis FRA { *obj, &pool };
             FRA.run();
 
             if (options.dump_machine_ir) {
@@ -493,44 +1098,55 @@ stm::i32 main(stm::i32 argc, char** argv) {
                 printer.run(std::cout);
             }
 
-            const std::string assembly_filename = filename + ".s";
-            std::ofstream assembly_file(assembly_filename);
-            assert(assembly_file.is_open() &&
-                "could not open assembly file for writing!");
+            if (options.keep_asm) {
+                std::ofstream assembly_file(assembly_path(source));
+                assert(assembly_file.is_open() &&
+                    "could not open assembly file for writing!");
 
-            stm::siir::MachineObjectAsmWriter assembly_writer { *obj };
-            assembly_writer.run(assembly_file);
-            assembly_file.close();
+                stm::siir::MachineObjectAsmWriter assembly_writer {
+                    *obj, &pool };
+                assembly_writer.run(assembly_file);
+                assembly_file.close();
+            }
 
-            std::system(("as -o " + filename + ".o " + assembly_filename).c_str());
-        }
+            // Encode the object in-process rather than assembling the output
+            // of the assembly writer.
+            stm::siir::ObjectFile object { filename };
+            stm::siir::MachineObjectWriter object_writer { *obj, &pool };
+            object_writer.run(object);
 
-        if (options.link) {
-            // Setup the linker command to create the final executable.
-            std::string ld = "ld -nostdlib -o " + std::string(options.output);
-                
-            // TODO: Adjust depending on expected std installation path.
-            if (!options.nostd)
-                ld += " std/rt.o ";
-            
-            // Add the object of each unit into the linker command.
-            for (const auto& unit : units)
-                ld += unit->get_graph().get_file().filename() + ".o ";
+            if (options.keep_obj) {
+                write_object(object, object_path(source));
+                write_interface(*unit, interface_path(source));
+            }
 
-            std::system(ld.c_str());
-        }
+            if (cache) {
+                std::ostringstream os;
+                object.write(os);
+                const std::string bytes = os.str();
+                cache->store(keys[idx], { bytes.begin(), bytes.end() });
+            }
 
-        // For each translation unit, remove (or don't) the emitted assembly
-        // and object files depending on options.
-        for (const auto& unit : units) {
-            const std::string filename = unit->get_file().filename();
+            objects.push_back(std::move(object));
+        }
 
-            if (!options.keep_asm)
-                std::remove((filename + ".s").c_str());
+        if (options.link)
+            link_executable(options, objects, used_modules);
+    }
 
-            if (!options.keep_obj)
-                std::remove((filename + ".o").c_str());
-        }
+    total.stop();
+    if (options.time_json)
+        stm::Timer::print_json(std::cerr);
+    else if (options.time)
+        stm::Timer::print(std::cerr);
+
+    if (options.trace) {
+        std::ofstream trace_file(options.trace);
+        if (trace_file.is_open())
+            stm::Trace::write(trace_file);
+        else
+            stm::Logger::warn("could not open trace file: '" + 
+                std::string(options.trace) + "'");
     }
 
     return 0;
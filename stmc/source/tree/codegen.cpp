@@ -14,6 +14,8 @@
 #include "tree/rune.hpp"
 #include "tree/stmt.hpp"
 #include "tree/visitor.hpp"
+#include "types/input_file.hpp"
+#include "types/source_manager.hpp"
 
 #include <llvm/IR/GlobalVariable.h>
 #include <string>
@@ -23,12 +25,12 @@ using namespace stm;
 Codegen::Codegen(Options& opts, Root& root, siir::CFG& cfg)
     : m_opts(opts), m_root(root), m_cfg(cfg), m_builder(cfg) {}
 
-const std::string& Codegen::mangle(const Decl* decl) {
+Symbol Codegen::mangle(const Decl* decl) {
     auto it = m_mangled.find(decl);
     if (it != m_mangled.end())
         return it->second;
 
-    return decl->get_name();
+    return decl->get_symbol();
 }
 
 siir::Function* Codegen::fetch_runtime_fn(const std::string& name,
@@ -42,7 +44,7 @@ siir::Function* Codegen::fetch_runtime_fn(const std::string& name,
     const siir::FunctionType* type =
         siir::FunctionType::get(m_cfg, params, ret);
 
-    return new siir::Function(
+    return new (m_cfg) siir::Function(
         m_cfg, siir::Function::LINKAGE_EXTERNAL, type, name, {});                       
 }
 
@@ -56,7 +58,7 @@ const siir::Type* Codegen::lower_type(const Type* type) {
         return siir::StructType::get(m_cfg, type->as_struct()->to_string());
     } else if (type->is_enum()) {
         return lower_type(type->as_enum()->get_underlying());
-    } else if (auto blt = dynamic_cast<const BuiltinType*>(type)) {
+    } else if (auto blt = dyn_cast<BuiltinType>(type)) {
         switch (blt->kind()) {
         case BuiltinType::Kind::Void:
             return nullptr;
@@ -113,7 +115,7 @@ void Codegen::lower_function(const FunctionDecl& decl) {
     for (auto& param : decl.get_params()) {
         const siir::Type* atype = lower_type(param->get_type());
         arg_types.push_back(atype);
-        siir::Argument* arg = new siir::Argument(
+        siir::Argument* arg = new (m_cfg) siir::Argument(
             atype, param->get_name(), args.size(), nullptr);
         args.push_back(arg);
     }
@@ -121,7 +123,7 @@ void Codegen::lower_function(const FunctionDecl& decl) {
     auto type = siir::FunctionType::get(
         m_cfg, arg_types, lower_type(decl.get_return_type()));
     
-    siir::Function* function = new siir::Function(
+    siir::Function* function = new (m_cfg) siir::Function(
         m_cfg, linkage, type, mangle(&decl), args);
 }
 
@@ -134,22 +136,22 @@ void Codegen::impl_function(const FunctionDecl& decl) {
 
     for (u32 idx = 0, e = decl.num_params(); idx != e; ++idx) {
         const siir::Type* arg_type = fn->get_type()->get_arg(idx);
-        siir::Local* local = new siir::Local(
+        siir::Local* local = new (m_cfg) siir::Local(
             m_cfg, 
             arg_type, 
             m_cfg.get_target().get_type_align(arg_type), 
-            decl.get_param(idx)->get_name(),
+            decl.get_param(idx)->get_symbol(),
             fn);
     }
 
-    siir::BasicBlock* entry = new siir::BasicBlock(fn);
+    siir::BasicBlock* entry = new (m_cfg) siir::BasicBlock(fn);
     m_builder.set_insert(entry);
 
     for (u32 idx = 0, e = decl.num_params(); idx != e; ++idx) {
         siir::Argument* arg = fn->get_arg(idx);
         const ParameterDecl* param = decl.get_param(idx);
 
-        siir::Local* arg_local = fn->get_local(arg->get_name());
+        siir::Local* arg_local = fn->get_local(param->get_symbol());
         assert(arg_local);
 
         m_builder.build_store(arg, arg_local);
@@ -171,7 +173,7 @@ void Codegen::impl_function(const FunctionDecl& decl) {
 }
 
 void Codegen::lower_structure(const StructDecl& decl) {
-    siir::StructType* type = siir::StructType::get(m_cfg, decl.get_name());
+    siir::StructType* type = siir::StructType::get(m_cfg, decl.get_symbol());
     assert(type && "structure shell type not created!");
 
     for (auto& field : decl.get_fields()) {
@@ -184,16 +186,16 @@ void Codegen::lower_structure(const StructDecl& decl) {
 
 void Codegen::visit(Root& node) {
     for (auto& import : node.imports()) {
-        if (auto structure = dynamic_cast<StructDecl*>(import)) {
+        if (auto structure = dyn_cast<StructDecl>(import)) {
             siir::StructType* type = siir::StructType::create(
-                m_cfg, structure->get_name(), {});
+                m_cfg, structure->get_symbol(), {});
         }
     }
 
     for (auto& decl : node.decls()) {
-        if (auto structure = dynamic_cast<StructDecl*>(decl)) {
+        if (auto structure = dyn_cast<StructDecl>(decl)) {
             siir::StructType* type = siir::StructType::create(
-                m_cfg, structure->get_name(), {});
+                m_cfg, structure->get_symbol(), {});
         }
     }
 
@@ -230,7 +232,7 @@ void Codegen::visit(VariableDecl& node) {
             if (node.has_decorator(Rune::Public))
                 linkage = siir::Global::LINKAGE_EXTERNAL;
 
-            siir::Global* G = new siir::Global(
+            siir::Global* G = new (m_cfg) siir::Global(
                 m_cfg, type, linkage, false, mangle(&node), nullptr);
         } else if (m_phase == PH_Define) {
             siir::Global* G = m_cfg.get_global(mangle(&node));
@@ -239,17 +241,16 @@ void Codegen::visit(VariableDecl& node) {
             m_vctx = RValue;
             node.get_init()->accept(*this);
             assert(m_tmp && "global initializer does not produce a value!");
-            siir::Constant* init = dynamic_cast<siir::Constant*>(m_tmp);
-            assert(init && "global initializer is not a constant value!");
+            siir::Constant* init = cast<siir::Constant>(m_tmp);
 
             G->set_initializer(init);
         }
     } else {
-        siir::Local* local = new siir::Local(
+        siir::Local* local = new (m_cfg) siir::Local(
             m_cfg,
             type, 
             m_cfg.get_target().get_type_align(type),
-            node.get_name(), 
+            node.get_symbol(), 
             m_func);
             
         if (node.has_init()) {
@@ -331,7 +332,9 @@ void Codegen::visit(AsmStmt& node) {
     const siir::FunctionType* type = siir::FunctionType::get(
         m_cfg, operand_types, nullptr);
 
-    siir::InlineAsm* iasm = new siir::InlineAsm(
+    // Nothing owns inline assembly, so it is left to be destroyed with the
+    // graph.
+    siir::InlineAsm* iasm = m_cfg.create<siir::InlineAsm>(
         type,
         string,
         constraints,
@@ -370,12 +373,12 @@ void Codegen::visit(IfStmt& node) {
     node.pCond->accept(*this);
     assert(m_tmp);
 
-    siir::BasicBlock* then_bb = new siir::BasicBlock(m_func);
+    siir::BasicBlock* then_bb = new (m_cfg) siir::BasicBlock(m_func);
     siir::BasicBlock* else_bb = nullptr;
-    siir::BasicBlock* merge_bb = new siir::BasicBlock();
+    siir::BasicBlock* merge_bb = new (m_cfg) siir::BasicBlock();
 
     if (node.has_else()) {
-        else_bb = new siir::BasicBlock();
+        else_bb = new (m_cfg) siir::BasicBlock();
         m_builder.build_brif(inject_bool_cmp(m_tmp), then_bb, else_bb);
     } else {
         m_builder.build_brif( inject_bool_cmp(m_tmp), then_bb, merge_bb);
@@ -404,9 +407,9 @@ void Codegen::visit(IfStmt& node) {
 }
 
 void Codegen::visit(WhileStmt& node) {
-    siir::BasicBlock* cond_bb = new siir::BasicBlock(m_func);
-    siir::BasicBlock* body_bb = new siir::BasicBlock();
-    siir::BasicBlock* merge_bb = new siir::BasicBlock();
+    siir::BasicBlock* cond_bb = new (m_cfg) siir::BasicBlock(m_func);
+    siir::BasicBlock* body_bb = new (m_cfg) siir::BasicBlock();
+    siir::BasicBlock* merge_bb = new (m_cfg) siir::BasicBlock();
 
     m_builder.build_jmp(cond_bb);
 
@@ -469,8 +472,8 @@ void Codegen::codegen_rune_assert(const RuneStmt& node) {
     assert(m_tmp && "assert rune expression does not produce a value!");
     m_tmp = inject_bool_cmp(m_tmp);
 
-    siir::BasicBlock* fail = new siir::BasicBlock(m_func);
-    siir::BasicBlock* okay = new siir::BasicBlock(m_func);
+    siir::BasicBlock* fail = new (m_cfg) siir::BasicBlock(m_func);
+    siir::BasicBlock* okay = new (m_cfg) siir::BasicBlock(m_func);
 
     m_builder.build_brif(m_tmp, okay, fail);
 
@@ -480,8 +483,9 @@ void Codegen::codegen_rune_assert(const RuneStmt& node) {
     });
 
     const SourceLocation& loc = node.rune()->args().front()->get_span().begin;
-    std::string msg = loc.file.filename() + ':' + std::to_string(loc.line) + 
-        ':' + std::to_string(loc.column) + ": assertion failed\n";
+    std::string msg = SourceManager::file(loc).filename() + ':' + 
+        std::to_string(SourceManager::line(loc)) + ':' + 
+        std::to_string(SourceManager::column(loc)) + ": assertion failed\n";
         
     m_builder.set_insert(fail);
     siir::Instruction* string = m_builder.build_string(
@@ -515,7 +519,7 @@ void Codegen::codegen_rune_write(const RuneStmt& node) {
     }
 
     u32 string_idx = is_print ? 0 : 1;
-    StringLiteral* strlit = dynamic_cast<StringLiteral*>(rune->args().at(string_idx));
+    StringLiteral* strlit = dyn_cast<StringLiteral>(rune->args().at(string_idx));
     if (!strlit) {
         Logger::fatal(
             "expected first argument to '$print' to be a string literal",
@@ -1455,8 +1459,8 @@ void Codegen::codegen_binary_bitwise_xor_assign(const BinaryExpr& node) {
 }
 
 void Codegen::codegen_binary_logical_and(const BinaryExpr& node) {
-    siir::BasicBlock* right_bb = new siir::BasicBlock();
-    siir::BasicBlock* merge_bb = new siir::BasicBlock();
+    siir::BasicBlock* right_bb = new (m_cfg) siir::BasicBlock();
+    siir::BasicBlock* merge_bb = new (m_cfg) siir::BasicBlock();
 
     m_vctx = RValue;
     node.pLeft->accept(*this);
@@ -1487,8 +1491,8 @@ void Codegen::codegen_binary_logical_and(const BinaryExpr& node) {
 }
 
 void Codegen::codegen_binary_logical_or(const BinaryExpr& node) {
-    siir::BasicBlock* right_bb = new siir::BasicBlock();
-    siir::BasicBlock* merge_bb = new siir::BasicBlock();
+    siir::BasicBlock* right_bb = new (m_cfg) siir::BasicBlock();
+    siir::BasicBlock* merge_bb = new (m_cfg) siir::BasicBlock();
 
     m_vctx = RValue;
     node.pLeft->accept(*this);
@@ -1679,14 +1683,14 @@ void Codegen::codegen_unary_negate(const UnaryExpr& node) {
     if (m_tmp->get_type()->is_integer_type()
       || m_tmp->get_type()->is_pointer_type()) {
 
-        if (auto constant = dynamic_cast<const siir::ConstantInt*>(m_tmp)) {
+        if (auto constant = dyn_cast<siir::ConstantInt>(m_tmp)) {
             m_tmp = siir::ConstantInt::get(
                 m_cfg, constant->get_type(), -constant->get_value());
         } else {
             m_tmp = m_builder.build_ineg(m_tmp);
         }
     } else if (m_tmp->get_type()->is_floating_point_type()) {
-        if (auto constant = dynamic_cast<const siir::ConstantFP*>(m_tmp)) {
+        if (auto constant = dyn_cast<siir::ConstantFP>(m_tmp)) {
             m_tmp = siir::ConstantFP::get(
                 m_cfg, constant->get_type(), -constant->get_value());
         } else {
@@ -1728,7 +1732,7 @@ void Codegen::codegen_unary_bitwise_not(const UnaryExpr& node) {
     assert(m_tmp);
 
     if (m_tmp->get_type()->is_integer_type()) {
-        if (auto constant = dynamic_cast<const siir::ConstantInt*>(m_tmp)) {
+        if (auto constant = dyn_cast<siir::ConstantInt>(m_tmp)) {
             m_tmp = siir::ConstantInt::get(
                 m_cfg, constant->get_type(), ~constant->get_value());
         } else {
@@ -1765,7 +1769,7 @@ void Codegen::visit(CastExpr& node) {
             return;
 
         // Fold possible constants here if possible.
-        if (auto constant = dynamic_cast<siir::ConstantInt*>(m_tmp))
+        if (auto constant = dyn_cast<siir::ConstantInt>(m_tmp))
             m_tmp = siir::ConstantInt::get(
                 m_cfg, dst_type, constant->get_value());
         else if (src_sz > dst_sz)
@@ -1781,7 +1785,7 @@ void Codegen::visit(CastExpr& node) {
             return;
 
         // Fold possible constants here if possible.
-        if (auto constant = dynamic_cast<siir::ConstantFP*>(m_tmp))
+        if (auto constant = dyn_cast<siir::ConstantFP>(m_tmp))
             m_tmp = siir::ConstantFP::get(
                 m_cfg, dst_type, constant->get_value());
         else if (src_sz > dst_sz) // Downcasting.
@@ -1792,7 +1796,7 @@ void Codegen::visit(CastExpr& node) {
       && dst_type->is_floating_point_type()) {
         // Integer -> Floating point conversions.
 
-        if (auto constant = dynamic_cast<siir::ConstantInt*>(m_tmp))
+        if (auto constant = dyn_cast<siir::ConstantInt>(m_tmp))
             m_tmp = siir::ConstantFP::get(m_cfg, dst_type, constant->get_value());
         else if (node.get_expr()->get_type()->is_signed_int())
             m_tmp = m_builder.build_si2fp(dst_type, m_tmp);
@@ -1802,7 +1806,7 @@ void Codegen::visit(CastExpr& node) {
       && dst_type->is_integer_type()) {
         // Floating point -> Integer conversions.
 
-        if (auto constant = dynamic_cast<siir::ConstantFP*>(m_tmp))
+        if (auto constant = dyn_cast<siir::ConstantFP>(m_tmp))
             m_tmp = siir::ConstantInt::get(m_cfg, dst_type, constant->get_value());
         else if (node.get_type()->is_signed_int())
             m_tmp = m_builder.build_fp2si(dst_type, m_tmp);
@@ -1812,7 +1816,7 @@ void Codegen::visit(CastExpr& node) {
       && dst_type->is_pointer_type()) {
         // Pointer -> Pointer reinterpretations.
         
-        if (dynamic_cast<siir::ConstantNull*>(m_tmp)) {
+        if (isa<siir::ConstantNull>(m_tmp)) {
             m_tmp = siir::ConstantNull::get(m_cfg, dst_type);
         } else {
             m_tmp = m_builder.build_reint(dst_type, m_tmp);
@@ -1872,7 +1876,7 @@ void Codegen::visit(SubscriptExpr& node) {
 }
 
 void Codegen::visit(ReferenceExpr& node) {
-    if (auto value = dynamic_cast<const EnumValueDecl*>(node.get_decl())) {
+    if (auto value = dyn_cast<EnumValueDecl>(node.get_decl())) {
         // If the referenced declaration is an enum value, then it can
         // resolved at this point to it's integer value.
         m_tmp = siir::ConstantInt::get(
@@ -1880,7 +1884,7 @@ void Codegen::visit(ReferenceExpr& node) {
         return;
     }
 
-    auto var = dynamic_cast<const VariableDecl*>(node.get_decl());
+    auto var = dyn_cast<VariableDecl>(node.get_decl());
     if (var && var->is_global()) {
         siir::Global* global = m_cfg.get_global(mangle(node.get_decl()));
         assert(global && "unresolved reference to global!");
@@ -1891,7 +1895,7 @@ void Codegen::visit(ReferenceExpr& node) {
             m_tmp = m_builder.build_load(lower_type(node.get_type()), global);
     } else {
         // Resolve the referenced local in the current function.
-        siir::Local* local = m_func->get_local(node.get_name());
+        siir::Local* local = m_func->get_local(node.get_symbol());
         assert(local && "unresolved reference to local!");
 
         m_tmp = local;
@@ -4,9 +4,10 @@
 
 using namespace stm;
 
-Decl::Decl(const Span& span, const std::string& name, 
-           const std::vector<Rune*>& decorators)
-    : span(span), name(name), decorators(decorators) {}
+Decl::Decl(Kind kind, const Span& span, Symbol name, 
+           ArenaVector<Rune*> decorators)
+    : m_kind(kind), span(span), name(name),
+      decorators(std::move(decorators)) {}
 
 bool Decl::has_decorator(Rune::Kind kind) const {
     for (auto& dec : decorators)
@@ -16,75 +17,58 @@ bool Decl::has_decorator(Rune::Kind kind) const {
     return false;
 }
 
-UseDecl::UseDecl(const Span& span, const std::string& path,
-                 const std::vector<Rune*>& decorators)
-    : Decl(span, path, decorators) {}
+UseDecl::UseDecl(const Span& span, Symbol path,
+                 ArenaVector<Rune*> decorators)
+    : Decl(Kind::UseDecl, span, path, std::move(decorators)) {}
 
 stm::FunctionDecl::FunctionDecl(
         const Span& span, 
-        const std::string& name, 
-        const std::vector<Rune*>& decorators, 
+        Symbol name, 
+        ArenaVector<Rune*> decorators, 
         const FunctionType* pType, 
-        const std::vector<ParameterDecl*>& params,
+        ArenaVector<ParameterDecl*> params,
         Scope* pScope,
         Stmt* pBody)
-    : Decl(span, name, decorators), pType(pType), params(params), pScope(pScope), pBody(pBody) {}
-
-stm::FunctionDecl::~FunctionDecl() {
-    for (auto param : params) delete param;
-    params.clear();
-    
-    delete pScope;
-    pScope = nullptr;
-
-    delete pBody;
-    pBody = nullptr;
-}
+    : Decl(Kind::FunctionDecl, span, name, std::move(decorators)),
+      pType(pType), params(std::move(params)), pScope(pScope), pBody(pBody) {}
 
 stm::ParameterDecl::ParameterDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& decorators,
+        Symbol name,
+        ArenaVector<Rune*> decorators,
         const Type* pType)
-    : Decl(span, name, decorators), pType(pType) {}
+    : Decl(Kind::ParameterDecl, span, name, std::move(decorators)),
+      pType(pType) {}
 
-VariableDecl::VariableDecl(const Span& span, const std::string& name,
-                           const std::vector<Rune*>& decorators, const Type* ty,
+VariableDecl::VariableDecl(const Span& span, Symbol name,
+                           ArenaVector<Rune*> decorators, const Type* ty,
                            Expr* init, bool global)
-    : Decl(span, name, decorators), m_type(ty), m_init(init), 
-      m_global(global) {}
-
-stm::VariableDecl::~VariableDecl() {
-    if (has_init())
-        delete m_init;
-}
+    : Decl(Kind::VariableDecl, span, name, std::move(decorators)),
+      m_type(ty), m_init(init), m_global(global) {}
 
 stm::FieldDecl::FieldDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const Type* type,
         const StructDecl* parent,
         u32 index)
-    : Decl(span, name, runes), m_type(type), m_parent(parent), m_index(index) {}
+    : Decl(Kind::FieldDecl, span, name, std::move(runes)), m_type(type),
+      m_parent(parent), m_index(index) {}
 
 stm::StructDecl::StructDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const StructType* type,
-        const std::vector<FieldDecl*>& fields)
-    : Decl(span, name, runes), m_type(type), m_fields(fields) {
-    for (auto field : fields) field->set_parent(this);
-}
-
-stm::StructDecl::~StructDecl() {
-    for (auto field : m_fields) delete field;
-    m_fields.clear();
+        ArenaVector<FieldDecl*> fields)
+    : Decl(Kind::StructDecl, span, name, std::move(runes)), m_type(type),
+      m_fields(std::move(fields)) {
+    for (auto field : m_fields) field->set_parent(this);
 }
 
 bool stm::StructDecl::append_field(FieldDecl* field) {
-    if (get_field(field->get_name())) 
+    if (get_field(field->get_symbol())) 
         return false;
     
     field->set_parent(this);
@@ -95,27 +79,24 @@ bool stm::StructDecl::append_field(FieldDecl* field) {
 
 stm::EnumValueDecl::EnumValueDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const Type* type,
         i64 value)
-    : Decl(span, name, runes), m_type(type), m_value(value) {}
+    : Decl(Kind::EnumValueDecl, span, name, std::move(runes)), m_type(type),
+      m_value(value) {}
 
 stm::EnumDecl::EnumDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const EnumType* type,
-        const std::vector<EnumValueDecl*>& values)
-    : Decl(span, name, runes), m_type(type), m_values(values) {}
-
-stm::EnumDecl::~EnumDecl() {
-    for (auto value : m_values) delete value;
-    m_values.clear();
-}
+        ArenaVector<EnumValueDecl*> values)
+    : Decl(Kind::EnumDecl, span, name, std::move(runes)), m_type(type),
+      m_values(std::move(values)) {}
 
 bool stm::EnumDecl::append_value(EnumValueDecl* value) {
-    if (get_value(value->get_name()))
+    if (get_value(value->get_symbol()))
         return false;
 
     m_values.push_back(value);
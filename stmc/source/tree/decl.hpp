@@ -4,7 +4,9 @@
 #include "tree/rune.hpp"
 #include "tree/type.hpp"
 #include "tree/visitor.hpp"
+#include "types/arena.hpp"
 #include "types/source_location.hpp"
+#include "types/symbol.hpp"
 
 #include <string>
 #include <vector>
@@ -15,17 +17,26 @@ class Decl {
     friend class SymbolAnalysis;
     friend class SemanticAnalysis;
     friend class Codegen;
+
+public:
+    /// The kinds of declarations, used by isa<>, cast<> and dyn_cast<>.
+    enum class Kind : u8 {
+        UseDecl, FunctionDecl, ParameterDecl, VariableDecl,
+        FieldDecl, StructDecl, EnumValueDecl, EnumDecl,
+    };
     
 protected:
+    const Kind          m_kind;
     Span                span;
-    std::string         name;
-    std::vector<Rune*>  decorators;
+    Symbol              name;
+    ArenaVector<Rune*>  decorators;
 
 public:
     Decl(
+        Kind kind,
         const Span& span, 
-        const std::string& name, 
-        const std::vector<Rune*>& decorators);
+        Symbol name, 
+        ArenaVector<Rune*> decorators);
 
     virtual ~Decl() = default;
 
@@ -33,6 +44,9 @@ public:
 
     virtual void print(std::ostream& os) const = 0;
 
+    /// \returns The kind of this declaration.
+    Kind get_kind() const { return m_kind; }
+
     /// \returns The span of source code this declaration covers.
     Span& get_span() { return span; }
 
@@ -40,9 +54,12 @@ public:
     const Span& get_span() const { return span; }
 
     /// \returns The name of this declaration, if it is named.
-    const std::string& get_name() const { return name; }
+    const std::string& get_name() const { return name.str(); }
 
-    const std::vector<Rune*>& get_decorators() const { return decorators; }
+    /// \returns The interned name of this declaration.
+    Symbol get_symbol() const { return name; }
+
+    const ArenaVector<Rune*>& get_decorators() const { return decorators; }
 
     /// Returns true if this declaration carries a rune of the given kind.
     bool has_decorator(Rune::Kind kind) const;
@@ -63,14 +80,14 @@ class UseDecl final : public Decl {
 public:
     UseDecl(
         const Span& span,
-        const std::string& path,
-        const std::vector<Rune*>& decorators);
+        Symbol path,
+        ArenaVector<Rune*> decorators);
 
     UseDecl(const UseDecl&) = delete;
     UseDecl& operator = (const UseDecl&) = delete;
 
     /// Returns the path specified in this use declaration.
-    const std::string& path() const { return name; }
+    const std::string& path() const { return name.str(); }
 
     /// Returns the unit this use declaration references, if it has been
     /// resolved.
@@ -88,6 +105,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::UseDecl;
+    }
 };
 
 class FunctionDecl final : public Decl {
@@ -96,27 +117,25 @@ class FunctionDecl final : public Decl {
     friend class Codegen;
 
     const FunctionType*         pType;
-    std::vector<ParameterDecl*> params; 
+    ArenaVector<ParameterDecl*> params; 
     Scope*                      pScope;
     Stmt*                       pBody;
 
 public:
     FunctionDecl(
         const Span& span, 
-        const std::string& name, 
-        const std::vector<Rune*>& decorators, 
+        Symbol name, 
+        ArenaVector<Rune*> decorators, 
         const FunctionType* pType, 
-        const std::vector<ParameterDecl*>& params,
+        ArenaVector<ParameterDecl*> params,
         Scope* pScope,
         Stmt* pBody);
 
-    ~FunctionDecl() override;
-
     const FunctionType* get_type() const { return pType; }
 
     const Type* get_return_type() const { return pType->get_return_type(); }
 
-    const std::vector<ParameterDecl*>& get_params() const { return params; }
+    const ArenaVector<ParameterDecl*>& get_params() const { return params; }
 
     const ParameterDecl* get_param(u32 idx) const { return params.at(idx); }
     ParameterDecl* get_param(u32 idx) { return params.at(idx); }
@@ -138,6 +157,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::FunctionDecl;
+    }
 };
 
 class ParameterDecl final : public Decl {
@@ -150,8 +173,8 @@ class ParameterDecl final : public Decl {
 public:
     ParameterDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& decorators,
+        Symbol name,
+        ArenaVector<Rune*> decorators,
         const Type* pType);
 
     const Type* get_type() const { return pType; }
@@ -161,6 +184,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::ParameterDecl;
+    }
 };
 
 class VariableDecl final : public Decl {
@@ -173,15 +200,13 @@ class VariableDecl final : public Decl {
     bool m_global;
 
 public:
-    VariableDecl(const Span& span, const std::string& name,
-                 const std::vector<Rune*>& decorators, const Type* ty,
+    VariableDecl(const Span& span, Symbol name,
+                 ArenaVector<Rune*> decorators, const Type* ty,
                  Expr* init = nullptr, bool global = false);
 
     VariableDecl(const VariableDecl&) = delete;
     VariableDecl& operator = (const VariableDecl&) = delete;
 
-    ~VariableDecl() override;
-
     /// Returns the type of this variable declaration.
     const Type* get_type() const { return m_type; }
 
@@ -202,6 +227,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::VariableDecl;
+    }
 };
 
 /// Represents the declaration of a field within a structure.
@@ -217,8 +246,8 @@ class FieldDecl final : public Decl {
 public:
     FieldDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const Type* type,
         const StructDecl* parent,
         u32 index);
@@ -243,6 +272,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::FieldDecl;
+    }
 };
 
 /// Represents the declaration of a structure.
@@ -252,17 +285,15 @@ class StructDecl final : public Decl {
     friend class Codegen;
 
     const StructType* m_type;
-    std::vector<FieldDecl*> m_fields;
+    ArenaVector<FieldDecl*> m_fields;
 
 public:
     StructDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const StructType* type,
-        const std::vector<FieldDecl*>& fields);
-
-    ~StructDecl() override;
+        ArenaVector<FieldDecl*> fields);
 
     /// \returns The type of this structure.
     const StructType* get_type() const { return m_type; }
@@ -271,20 +302,20 @@ public:
     void set_type(const StructType* type) { m_type = type; }
 
     /// \returns The fields of this structure.
-    const std::vector<FieldDecl*>& get_fields() const { return m_fields; }
+    const ArenaVector<FieldDecl*>& get_fields() const { return m_fields; }
 
     /// \returns A field of this structure by name, if it exists.
-    FieldDecl* get_field(const std::string& name) {
+    FieldDecl* get_field(Symbol name) {
         for (auto field : m_fields)
-            if (field->get_name() == name) return field;
+            if (field->get_symbol() == name) return field;
     
         return nullptr;
     }
 
     /// \returns A field of this structure by name, if it exists.
-    const FieldDecl* get_field(const std::string& name) const {
+    const FieldDecl* get_field(Symbol name) const {
         for (auto field : m_fields)
-            if (field->get_name() == name) return field;
+            if (field->get_symbol() == name) return field;
     
         return nullptr;
     }
@@ -301,6 +332,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::StructDecl;
+    }
 };
 
 /// Represents a valued variant of an enumeration. 
@@ -315,8 +350,8 @@ class EnumValueDecl final : public Decl {
 public:
     EnumValueDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const Type* type,
         i64 value);
 
@@ -331,6 +366,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::EnumValueDecl;
+    }
 };
 
 /// Represents the declaration of an enum and its variants.
@@ -340,17 +379,15 @@ class EnumDecl final : public Decl {
     friend class Codegen;
 
     const EnumType* m_type;
-    std::vector<EnumValueDecl*> m_values;
+    ArenaVector<EnumValueDecl*> m_values;
 
 public:
     EnumDecl(
         const Span& span,
-        const std::string& name,
-        const std::vector<Rune*>& runes,
+        Symbol name,
+        ArenaVector<Rune*> runes,
         const EnumType* type,
-        const std::vector<EnumValueDecl*>& values);
-
-    ~EnumDecl() override;
+        ArenaVector<EnumValueDecl*> values);
 
     /// \returns The type defined by this enum declaration.
     const EnumType* get_type() const { return m_type; }
@@ -359,20 +396,20 @@ public:
     void set_type(const EnumType* type) { m_type = type; }
 
     /// \returns All the variants of this enum.
-    const std::vector<EnumValueDecl*>& get_values() const { return m_values; }
+    const ArenaVector<EnumValueDecl*>& get_values() const { return m_values; }
 
     /// \returns A variant of this enum by name, if it exists.
-    EnumValueDecl* get_value(const std::string& name) {
+    EnumValueDecl* get_value(Symbol name) {
         for (auto value : m_values)
-            if (value->get_name() == name) return value;
+            if (value->get_symbol() == name) return value;
     
         return nullptr;
     }
 
     /// \returns A variant of this enum by name, if it exists.
-    const EnumValueDecl* get_value(const std::string& name) const {
+    const EnumValueDecl* get_value(Symbol name) const {
         for (auto value : m_values)
-            if (value->get_name() == name) return value;
+            if (value->get_symbol() == name) return value;
     
         return nullptr;
     }
@@ -389,6 +426,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Decl* decl) {
+        return decl->get_kind() == Kind::EnumDecl;
+    }
 };
 
 } // namespace stm
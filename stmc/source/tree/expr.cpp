@@ -1,7 +1,7 @@
 #include "tree/expr.hpp"
 
-stm::Expr::Expr(const Span& span, const Type* pType)   
-    : Stmt(span), pType(pType) {}
+stm::Expr::Expr(Kind kind, const Span& span, const Type* pType)   
+    : Stmt(kind, span), pType(pType) {}
 
 stm::BinaryExpr::BinaryExpr(
         const Span& span, 
@@ -9,21 +9,9 @@ stm::BinaryExpr::BinaryExpr(
         Operator op, 
         Expr* pLeft, 
         Expr* pRight)
-    : Expr(span, pType), op(op), pLeft(pLeft), 
+    : Expr(Kind::BinaryExpr, span, pType), op(op), pLeft(pLeft), 
         pRight(pRight) {};
 
-stm::BinaryExpr::~BinaryExpr() {
-    if (pLeft != nullptr) {
-        delete pLeft;
-        pLeft = nullptr;
-    }
-
-    if (pRight != nullptr) {
-        delete pRight;
-        pRight = nullptr;
-    }
-}
-
 bool stm::BinaryExpr::is_comparison(Operator op) {
     switch (op) {
     case Operator::Equals:
@@ -87,14 +75,9 @@ stm::UnaryExpr::UnaryExpr(
         Operator op, 
         Expr* pExpr, 
         bool postfix)
-    : Expr(span, pType), op(op), pExpr(pExpr), postfix(postfix) {};
+    : Expr(Kind::UnaryExpr, span, pType), op(op), pExpr(pExpr),
+      postfix(postfix) {};
     
-stm::UnaryExpr::~UnaryExpr() {
-    if (pExpr != nullptr) {
-        delete pExpr;
-        pExpr = nullptr;
-    }
-}
 
 bool stm::UnaryExpr::is_constant() const {
     if (op == Operator::Address_Of)
@@ -107,82 +90,50 @@ stm::CastExpr::CastExpr(
         const Span& span, 
         const Type* pType, 
         Expr* pExpr)
-    : Expr(span, pType), pExpr(pExpr) {};
-
-stm::CastExpr::~CastExpr() {
-    if (pExpr != nullptr) {
-        delete pExpr;
-        pExpr = nullptr;
-    }
-}
+    : Expr(Kind::CastExpr, span, pType), pExpr(pExpr) {};
 
 stm::ParenExpr::ParenExpr(
         const Span& span,
         Expr* pExpr)
-    : Expr(span, pExpr->get_type()), pExpr(pExpr) {};
-
-stm::ParenExpr::~ParenExpr() {
-    if (pExpr != nullptr) {
-        delete pExpr;
-        pExpr = nullptr;
-    }
-}
+    : Expr(Kind::ParenExpr, span, pExpr->get_type()), pExpr(pExpr) {};
 
 stm::SizeofExpr::SizeofExpr(
         const Span& span,
         const Type* pType,
         const Type* pTarget)
-    : Expr(span, pType), pTarget(pTarget) {};
+    : Expr(Kind::SizeofExpr, span, pType), pTarget(pTarget) {};
 
 stm::SubscriptExpr::SubscriptExpr(
         const Span& span, 
         const Type* pType,
         Expr* pBase, 
         Expr* pIndex)
-    : Expr(span, pType), pBase(pBase), pIndex(pIndex) {};
+    : Expr(Kind::SubscriptExpr, span, pType), pBase(pBase), pIndex(pIndex) {};
 
-stm::SubscriptExpr::~SubscriptExpr() {
-    if (pBase != nullptr) {
-        delete pBase;
-        pBase = nullptr;
-    }
-
-    if (pIndex != nullptr) {
-        delete pIndex;
-        pIndex = nullptr;
-    }
-}
+stm::ReferenceExpr::ReferenceExpr(
+        Kind kind,
+        const Span& span, 
+        const Type* pType, 
+        Symbol name)
+    : Expr(kind, span, pType), name(name), pDecl(nullptr) {};
 
 stm::ReferenceExpr::ReferenceExpr(
         const Span& span, 
         const Type* pType, 
-        const std::string& name)
-    : Expr(span, pType), name(name) {};
+        Symbol name)
+    : ReferenceExpr(Kind::ReferenceExpr, span, pType, name) {};
 
 stm::MemberExpr::MemberExpr(
         const Span& span, 
         const Type* pType, 
-        const std::string& member, 
+        Symbol member, 
         Expr* pBase)
-    : ReferenceExpr(span, pType, member), pBase(pBase) {};
-
-stm::MemberExpr::~MemberExpr() {
-    if (pBase != nullptr) {
-        delete pBase;
-        pBase = nullptr;
-    }
-}
+    : ReferenceExpr(Kind::MemberExpr, span, pType, member), pBase(pBase) {};
 
 stm::CallExpr::CallExpr(
         const Span& span, 
         const Type* pType, 
-        const std::string& callee, 
-        const std::vector<Expr*>& args)
-    : ReferenceExpr(span, pType, callee), args(args) {};
-
-stm::CallExpr::~CallExpr() {
-    for (Expr* arg : args)
-        delete arg;
-
-    args.clear();
-}
+        Symbol callee, 
+        ArenaVector<Expr*> args)
+    : ReferenceExpr(Kind::CallExpr, span, pType, callee),
+      args(std::move(args)) {};
@@ -15,7 +15,7 @@ protected:
     const Type* pType;
 
 public:
-    Expr(const Span& span, const Type* pType);
+    Expr(Kind kind, const Span& span, const Type* pType);
 
     virtual ~Expr() = default;
 
@@ -29,6 +29,10 @@ public:
     virtual void print(std::ostream& os) const = 0;
 
     const Type* get_type() const { return pType; }
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() >= Kind::BoolLiteral;
+    }
 };
 
 class BoolLiteral final : public Expr {
@@ -40,7 +44,7 @@ class BoolLiteral final : public Expr {
 
 public:
     BoolLiteral(const Span& span, const Type* pType, bool value)
-        : Expr(span, pType), value(value) {};
+        : Expr(Kind::BoolLiteral, span, pType), value(value) {};
 
     bool get_value() const { return value; }
 
@@ -49,6 +53,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::BoolLiteral;
+    }
 };
 
 class IntegerLiteral final : public Expr {
@@ -60,7 +68,7 @@ class IntegerLiteral final : public Expr {
 
 public:
     IntegerLiteral(const Span& span, const Type* pType, i64 value)
-        : Expr(span, pType), value(value) {};
+        : Expr(Kind::IntegerLiteral, span, pType), value(value) {};
     
     i64 get_value() const { return value; }
 
@@ -69,6 +77,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::IntegerLiteral;
+    }
 };
 
 class FloatLiteral final : public Expr {
@@ -80,7 +92,7 @@ class FloatLiteral final : public Expr {
 
 public:
     FloatLiteral(const Span& span, const Type* pType, f64 value)
-        : Expr(span, pType), value(value) {};
+        : Expr(Kind::FloatLiteral, span, pType), value(value) {};
 
     f64 get_value() const { return value; }
 
@@ -89,6 +101,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::FloatLiteral;
+    }
 };
 
 class CharLiteral final : public Expr {
@@ -100,7 +116,7 @@ class CharLiteral final : public Expr {
 
 public:
     CharLiteral(const Span& span, const Type* pType, char value) 
-        : Expr(span, pType), value(value) {};
+        : Expr(Kind::CharLiteral, span, pType), value(value) {};
 
     char get_value() const { return value; }
 
@@ -109,6 +125,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::CharLiteral;
+    }
 };
 
 class StringLiteral final : public Expr {
@@ -120,7 +140,7 @@ class StringLiteral final : public Expr {
 
 public:
     StringLiteral(const Span& span, const Type* pType, const std::string& value) 
-        : Expr(span, pType), value(value) {};
+        : Expr(Kind::StringLiteral, span, pType), value(value) {};
 
     const std::string& get_value() const { return value; }
 
@@ -129,6 +149,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::StringLiteral;
+    }
 };
 
 class NullLiteral final : public Expr {
@@ -137,13 +161,18 @@ class NullLiteral final : public Expr {
     friend class Codegen;
 
 public:
-    NullLiteral(const Span& span, const Type* pType) : Expr(span, pType) {};
+    NullLiteral(const Span& span, const Type* pType)
+        : Expr(Kind::NullLiteral, span, pType) {};
 
     void accept(Visitor& visitor) override {
         visitor.visit(*this);
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::NullLiteral;
+    }
 };
 
 class BinaryExpr final : public Expr {
@@ -193,8 +222,6 @@ public:
         Expr* pLeft, 
         Expr* pRight);
 
-    ~BinaryExpr() override;
-
     bool is_constant() const override 
     { return pLeft->is_constant() && pRight->is_constant(); }
 
@@ -209,6 +236,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::BinaryExpr;
+    }
 };
 
 class UnaryExpr final : public Expr {
@@ -249,7 +280,6 @@ public:
         Expr* pExpr, 
         bool postfix);
     
-    ~UnaryExpr() override;
 
     bool is_constant() const override;
 
@@ -268,6 +298,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::UnaryExpr;
+    }
 };
 
 class CastExpr final : public Expr {
@@ -283,8 +317,6 @@ public:
         const Type* pType, 
         Expr* pExpr);
 
-    ~CastExpr() override;
-
     bool is_constant() const override { return pExpr->is_constant(); }
 
     const Expr* get_expr() const { return pExpr; }
@@ -294,6 +326,10 @@ public:
     }
     
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::CastExpr;
+    }
 };
 
 class ParenExpr final : public Expr {
@@ -308,8 +344,6 @@ public:
         const Span& span, 
         Expr* pExpr);
 
-    ~ParenExpr() override;
-
     bool is_constant() const override { return pExpr->is_constant(); }
 
     const Expr* get_expr() const { return pExpr; }
@@ -319,6 +353,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::ParenExpr;
+    }
 };
 
 class SizeofExpr final : public Expr {
@@ -341,6 +379,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::SizeofExpr;
+    }
 };
 
 class SubscriptExpr final : public Expr {
@@ -358,7 +400,6 @@ public:
         Expr* pBase, 
         Expr* pIndex);
     
-    ~SubscriptExpr() override;
 
     bool is_constant() const override 
     { return pBase->is_constant() && pIndex->is_constant(); }
@@ -374,6 +415,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::SubscriptExpr;
+    }
 };
 
 class ReferenceExpr : public Expr {
@@ -382,30 +427,49 @@ class ReferenceExpr : public Expr {
     friend class Codegen;
 
 protected:
-    std::string name;
+    Symbol name;
     const Decl* pDecl;
 
+    ReferenceExpr(
+        Kind kind,
+        const Span& span, 
+        const Type* pType, 
+        Symbol name);
+
 public:
     ReferenceExpr(
         const Span& span, 
         const Type* pType, 
-        const std::string& name);
+        Symbol name);
     
     bool is_constant() const override { return false; }
 
     bool is_lvalue() const override{ return true; }
 
-    const std::string& get_name() const { return name; }
+    const std::string& get_name() const { return name.str(); }
 
+    /// \returns The interned name this expression references.
+    Symbol get_symbol() const { return name; }
+
+    /// \returns The declaration this expression resolved to, or null if it
+    /// has not been resolved yet.
     const Decl* get_decl() const { return pDecl; }
 
+    /// Cache \p pDecl as the resolved target of this expression.
     void set_decl(const Decl* pDecl) { this->pDecl = pDecl; }
 
+    /// \returns `true` if this expression was already resolved.
+    bool is_resolved() const { return pDecl != nullptr; }
+
     void accept(Visitor& visitor) override {
         visitor.visit(*this);
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() >= Kind::ReferenceExpr;
+    }
 };
 
 class MemberExpr final : public ReferenceExpr {
@@ -419,11 +483,9 @@ public:
     MemberExpr(
         const Span& span, 
         const Type* pType, 
-        const std::string& member, 
+        Symbol member, 
         Expr* pBase);
 
-    ~MemberExpr() override;
-
     bool is_constant() const override { return false; }
 
     bool is_lvalue() const override{ return true; }
@@ -435,6 +497,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::MemberExpr;
+    }
 };
 
 class CallExpr final : public ReferenceExpr {
@@ -442,20 +508,18 @@ class CallExpr final : public ReferenceExpr {
     friend class SemanticAnalysis;
     friend class Codegen;
 
-    std::vector<Expr*> args;
+    ArenaVector<Expr*> args;
 
 public:
     CallExpr(
         const Span& span, 
         const Type* pType, 
-        const std::string& callee, 
-        const std::vector<Expr*> &args);
-
-    ~CallExpr() override;
+        Symbol callee, 
+        ArenaVector<Expr*> args);
 
     bool is_constant() const override { return false; }
 
-    const std::vector<Expr*>& get_args() const { return args; }
+    const ArenaVector<Expr*>& get_args() const { return args; }
 
     u32 num_args() const { return args.size(); }
 
@@ -464,6 +528,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::CallExpr;
+    }
 };
 
 } // namespace stm
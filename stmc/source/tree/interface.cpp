@@ -0,0 +1,445 @@
+#include "core/logger.hpp"
+#include "tree/decl.hpp"
+#include "tree/interface.hpp"
+#include "tree/rune.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace stm;
+
+/// The magic number and format version at the start of every interface.
+static constexpr char gMagic[4] = { 'S', 'T', 'M', 'I' };
+static constexpr u32 gVersion = 1;
+
+/// The index of a type record for declarations that have no type.
+static constexpr u32 gNoType = ~0u;
+
+/// The header of an interface. It is followed by the type records, then the
+/// declaration records, then a blob of null-terminated strings that the
+/// records refer to by offset.
+struct Header final {
+    char magic[4];
+    u32 version;
+    u32 num_types;
+    u32 num_decls;
+    u32 strings_size;
+};
+
+/// A type as it is named in source: a base type name behind some levels of
+/// pointer indirection.
+struct TypeRecord final {
+    u32 base;
+    u32 indirection;
+    u32 mut;
+
+    bool operator == (const TypeRecord& other) const {
+        return base == other.base && indirection == other.indirection &&
+            mut == other.mut;
+    }
+};
+
+/// The kinds of declaration records. The children of a declaration, i.e. the
+/// parameters of a function or the fields of a struct, immediately follow
+/// its record.
+enum DeclKind : u8 {
+    DK_Function, DK_Parameter, DK_Variable,
+    DK_Struct, DK_Field,
+    DK_Enum, DK_EnumValue,
+};
+
+/// A single declaration. The meaning of |type| depends on the kind: it is the
+/// return type of functions and the underlying type of enums.
+struct DeclRecord final {
+    u8 kind;
+    u8 pad[3];
+    u32 name;
+    u32 type;
+    u32 num_children;
+    u64 runes;
+    i64 value;
+};
+
+namespace {
+
+/// Builds the records and string blob of an interface.
+class InterfaceWriter final {
+    std::vector<TypeRecord> m_types = {};
+    std::vector<DeclRecord> m_decls = {};
+    std::string m_strings = {};
+    std::unordered_map<std::string, u32> m_offsets = {};
+
+    u32 intern(const std::string& str) {
+        auto it = m_offsets.find(str);
+        if (it != m_offsets.end())
+            return it->second;
+
+        const u32 offset = m_strings.size();
+        m_strings.append(str);
+        m_strings.push_back('\0');
+        m_offsets.emplace(str, offset);
+        return offset;
+    }
+
+    u32 add_type(const Type* type) {
+        TypeRecord record { 0, 0, type->is_mut() };
+
+        // Peel away pointers down to the named base of the type. A deferred
+        // type may show up at any level if it was resolved to a pointer.
+        for (;;) {
+            if (type->is_deferred()) {
+                const DeferredType::Context& ctx =
+                    type->as_deferred()->get_context();
+                record.base = intern(ctx.base.str());
+                record.indirection += ctx.indirection;
+                record.mut |= ctx.mut;
+                break;
+            } else if (type->is_pointer()) {
+                type = type->as_pointer()->get_pointee();
+                record.indirection++;
+            } else if (type->is_builtin()) {
+                record.base = intern(
+                    BuiltinType::get_name(type->as_builtin()->kind()));
+                break;
+            } else if (type->is_struct()) {
+                record.base = intern(
+                    type->as_struct()->get_decl()->get_name());
+                break;
+            } else if (type->is_enum()) {
+                record.base = intern(type->as_enum()->get_decl()->get_name());
+                break;
+            } else {
+                Logger::fatal("cannot export type: " + type->to_string());
+            }
+        }
+
+        for (u32 idx = 0; idx != m_types.size(); ++idx)
+            if (m_types[idx] == record) return idx;
+
+        m_types.push_back(record);
+        return m_types.size() - 1;
+    }
+
+    void add_decl(DeclKind kind, const Decl* decl, const Type* type,
+                  u32 num_children = 0, i64 value = 0) {
+        DeclRecord record = {};
+        record.kind = kind;
+        record.name = intern(decl->get_name());
+        record.type = type ? add_type(type) : gNoType;
+        record.num_children = num_children;
+        record.value = value;
+
+        // Only plain decorators carry over; runes with arguments would need
+        // their expressions, which interfaces do not keep.
+        for (const Rune* rune : decl->get_decorators())
+            if (!rune->has_args() && rune->kind() < 64)
+                record.runes |= u64(1) << rune->kind();
+
+        m_decls.push_back(record);
+    }
+
+public:
+    void add(const Decl* decl) {
+        if (auto FD = dyn_cast<FunctionDecl>(decl)) {
+            add_decl(DK_Function, FD, FD->get_return_type(), FD->num_params());
+            for (const ParameterDecl* param : FD->get_params())
+                add_decl(DK_Parameter, param, param->get_type());
+        } else if (auto VD = dyn_cast<VariableDecl>(decl)) {
+            add_decl(DK_Variable, VD, VD->get_type());
+        } else if (auto SD = dyn_cast<StructDecl>(decl)) {
+            add_decl(DK_Struct, SD, nullptr, SD->num_fields());
+            for (const FieldDecl* field : SD->get_fields())
+                add_decl(DK_Field, field, field->get_type());
+        } else if (auto ED = dyn_cast<EnumDecl>(decl)) {
+            add_decl(DK_Enum, ED, ED->get_type()->get_underlying(),
+                ED->num_values());
+            for (const EnumValueDecl* value : ED->get_values())
+                add_decl(DK_EnumValue, value, nullptr, 0, value->get_value());
+        } else if (auto EVD = dyn_cast<EnumValueDecl>(decl)) {
+            add_decl(DK_EnumValue, EVD, EVD->get_type(), 0,
+                EVD->get_value());
+        }
+    }
+
+    void write(std::ostream& os) const {
+        Header header = {};
+        std::memcpy(header.magic, gMagic, sizeof(gMagic));
+        header.version = gVersion;
+        header.num_types = m_types.size();
+        header.num_decls = m_decls.size();
+        header.strings_size = m_strings.size();
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(m_types.data()),
+            m_types.size() * sizeof(TypeRecord));
+        os.write(reinterpret_cast<const char*>(m_decls.data()),
+            m_decls.size() * sizeof(DeclRecord));
+        os.write(m_strings.data(), m_strings.size());
+    }
+};
+
+/// Recreates declarations from the records of a mapped interface.
+class InterfaceReader final {
+    const std::string& m_path;
+    Root& m_root;
+    const u8* m_data;
+    u64 m_size;
+    Header m_header = {};
+    const char* m_strings = nullptr;
+    std::vector<const Type*> m_types = {};
+    u32 m_next = 0;
+
+    [[noreturn]] void malformed() const {
+        Logger::fatal("invalid module interface: '" + m_path + "'");
+    }
+
+    Symbol string(u32 offset) const {
+        if (offset >= m_header.strings_size)
+            malformed();
+
+        const char* str = m_strings + offset;
+        if (!std::memchr(str, '\0', m_header.strings_size - offset))
+            malformed();
+
+        return Symbol(str);
+    }
+
+    const Type* type(u32 idx) const {
+        if (idx >= m_types.size())
+            malformed();
+
+        return m_types[idx];
+    }
+
+    DeclRecord next_record() {
+        if (m_next >= m_header.num_decls)
+            malformed();
+
+        DeclRecord record;
+        std::memcpy(&record, m_data + sizeof(Header) +
+            m_header.num_types * sizeof(TypeRecord) +
+            m_next++ * sizeof(DeclRecord), sizeof(record));
+        return record;
+    }
+
+    ArenaVector<Rune*> runes(const DeclRecord& record) {
+        ArenaVector<Rune*> runes = m_root.list<Rune*>();
+        for (u32 kind = 0; kind != 64; ++kind)
+            if (record.runes & (u64(1) << kind))
+                runes.push_back(m_root.create<Rune>(Rune::Kind(kind)));
+
+        return runes;
+    }
+
+    DeclRecord child(DeclKind kind) {
+        DeclRecord record = next_record();
+        if (record.kind != kind)
+            malformed();
+
+        return record;
+    }
+
+    Decl* read_function(const DeclRecord& record) {
+        Scope* scope = m_root.create<Scope>(m_root.get_scope());
+        ArenaVector<ParameterDecl*> params = m_root.list<ParameterDecl*>();
+        std::vector<const Type*> param_types = {};
+        for (u32 idx = 0; idx != record.num_children; ++idx) {
+            const DeclRecord param = child(DK_Parameter);
+            params.push_back(m_root.create<ParameterDecl>(
+                Span(SourceLocation()),
+                string(param.name),
+                runes(param),
+                type(param.type)));
+            param_types.push_back(params.back()->get_type());
+            scope->add(params.back());
+        }
+
+        return m_root.create<FunctionDecl>(
+            Span(SourceLocation()),
+            string(record.name),
+            runes(record),
+            FunctionType::get(m_root, type(record.type), param_types),
+            std::move(params),
+            scope,
+            nullptr);
+    }
+
+    Decl* read_struct(const DeclRecord& record) {
+        ArenaVector<FieldDecl*> fields = m_root.list<FieldDecl*>();
+        std::vector<const Type*> field_types = {};
+        for (u32 idx = 0; idx != record.num_children; ++idx) {
+            const DeclRecord field = child(DK_Field);
+            fields.push_back(m_root.create<FieldDecl>(
+                Span(SourceLocation()),
+                string(field.name),
+                runes(field),
+                type(field.type),
+                nullptr,
+                idx));
+            field_types.push_back(fields.back()->get_type());
+        }
+
+        StructDecl* decl = m_root.create<StructDecl>(
+            Span(SourceLocation()),
+            string(record.name),
+            runes(record),
+            nullptr,
+            std::move(fields));
+        decl->set_type(StructType::create(m_root, field_types, decl));
+        return decl;
+    }
+
+    Decl* read_enum(const DeclRecord& record) {
+        EnumDecl* decl = m_root.create<EnumDecl>(
+            Span(SourceLocation()),
+            string(record.name),
+            runes(record),
+            nullptr,
+            m_root.list<EnumValueDecl*>());
+
+        const EnumType* type = EnumType::create(
+            m_root, this->type(record.type), decl);
+        decl->set_type(type);
+
+        for (u32 idx = 0; idx != record.num_children; ++idx) {
+            const DeclRecord value = child(DK_EnumValue);
+            EnumValueDecl* value_decl = m_root.create<EnumValueDecl>(
+                Span(SourceLocation()),
+                string(value.name),
+                runes(value),
+                type,
+                value.value);
+
+            m_root.get_scope()->add(value_decl);
+            decl->append_value(value_decl);
+        }
+
+        return decl;
+    }
+
+public:
+    InterfaceReader(const std::string& path, Root& root, const u8* data,
+                    u64 size)
+        : m_path(path), m_root(root), m_data(data), m_size(size) {}
+
+    void read() {
+        if (m_size < sizeof(Header))
+            malformed();
+
+        std::memcpy(&m_header, m_data, sizeof(Header));
+        if (std::memcmp(m_header.magic, gMagic, sizeof(gMagic)) != 0 ||
+          m_header.version != gVersion)
+            malformed();
+
+        const u64 records = sizeof(Header) +
+            u64(m_header.num_types) * sizeof(TypeRecord) +
+            u64(m_header.num_decls) * sizeof(DeclRecord);
+        if (records + m_header.strings_size != m_size)
+            malformed();
+
+        m_strings = reinterpret_cast<const char*>(m_data + records);
+
+        // Every type is deferred as if it had been parsed at global scope, and
+        // resolved once the declarations that may name it are all loaded.
+        m_types.reserve(m_header.num_types);
+        for (u32 idx = 0; idx != m_header.num_types; ++idx) {
+            TypeRecord record;
+            std::memcpy(&record, m_data + sizeof(Header) +
+                idx * sizeof(TypeRecord), sizeof(record));
+
+            m_types.push_back(DeferredType::get(m_root, {
+                string(record.base),
+                SourceLocation(),
+                m_root.get_scope(),
+                record.indirection,
+                record.mut != 0 }));
+        }
+
+        while (m_next != m_header.num_decls) {
+            const DeclRecord record = next_record();
+
+            Decl* decl = nullptr;
+            switch (record.kind) {
+            case DK_Function:
+                decl = read_function(record);
+                break;
+            case DK_Variable:
+                decl = m_root.create<VariableDecl>(
+                    Span(SourceLocation()),
+                    string(record.name),
+                    runes(record),
+                    type(record.type),
+                    nullptr,
+                    true);
+                break;
+            case DK_Struct:
+                decl = read_struct(record);
+                break;
+            case DK_Enum:
+                decl = read_enum(record);
+                break;
+            case DK_EnumValue:
+                decl = m_root.create<EnumValueDecl>(
+                    Span(SourceLocation()),
+                    string(record.name),
+                    runes(record),
+                    type(record.type),
+                    record.value);
+                break;
+            default:
+                malformed();
+            }
+
+            if (!m_root.get_scope()->add(decl))
+                malformed();
+
+            m_root.add_decl(decl);
+            m_root.exports().push_back(decl);
+        }
+    }
+};
+
+} // namespace
+
+void ModuleInterface::write(const Root& root, std::ostream& os) {
+    InterfaceWriter writer {};
+    for (const Decl* decl : root.exports())
+        writer.add(decl);
+
+    writer.write(os);
+}
+
+void ModuleInterface::read(const std::string& path, Root& root) {
+    i32 fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        Logger::fatal("failed to open module interface: '" + path + "'");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        Logger::fatal("failed to read module interface: '" + path + "'");
+    }
+
+    if (st.st_size == 0) {
+        ::close(fd);
+        Logger::fatal("invalid module interface: '" + path + "'");
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        Logger::fatal("failed to map module interface: '" + path + "'");
+
+    // The records are copied out of the mapping as they are read, so that it
+    // can be released before the types are resolved.
+    InterfaceReader reader {
+        path, root, static_cast<const u8*>(map), u64(st.st_size) };
+    reader.read();
+    ::munmap(map, st.st_size);
+
+    root.validate();
+}
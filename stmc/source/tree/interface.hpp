@@ -0,0 +1,39 @@
+#ifndef STATIM_TREE_INTERFACE_HPP_
+#define STATIM_TREE_INTERFACE_HPP_
+
+#include "tree/root.hpp"
+
+#include <ostream>
+#include <string>
+
+namespace stm {
+
+/// Binary interfaces of compiled modules.
+///
+/// An interface holds the declarations that a translation unit exports, that
+/// is everything in Root::exports(), without any function bodies or variable
+/// initializers. Types are written out as they were named in the source, and
+/// are deferred and resolved again when the interface is loaded, just as if
+/// the declarations had been parsed.
+///
+/// A unit that uses a compiled module loads its interface in place of parsing
+/// and validating the module's source.
+class ModuleInterface final {
+public:
+    ModuleInterface() = delete;
+
+    /// The file extension of interfaces, appended to the source filename.
+    static constexpr const char* EXTENSION = "i";
+
+    /// Write the exports of |root| to |os| as an interface.
+    static void write(const Root& root, std::ostream& os);
+
+    /// Map the interface file at |path| into memory and load its declarations
+    /// into |root| as exports. The types of the declarations are resolved
+    /// against |root| once they are all loaded.
+    static void read(const std::string& path, Root& root);
+};
+
+} // namespace stm
+
+#endif // STATIM_TREE_INTERFACE_HPP_
@@ -17,7 +17,9 @@ Parser::Parser(InputFile& file) : file(file), lexer(file), runes() {
 }
 
 void Parser::parse(TranslationUnit& unit) {
-    root = std::make_unique<Root>(file, enter_scope());
+    root = std::make_unique<Root>(file);
+    runes = root->list<Rune*>();
+    pScope = root->get_scope();
 
     while (!lexer.is_eof()) {
         Decl* decl = parse_decl();
@@ -37,11 +39,6 @@ bool Parser::match(TokenKind kind) const {
     return lexer.last().kind == kind;
 }
     
-bool Parser::match(const char* kw) const {
-    const Token& tk = lexer.last();
-    return (tk.kind == TOKEN_KIND_IDENTIFIER && tk.value == kw);
-}
-
 void Parser::next() {
     lexer.lex();
 }
@@ -55,7 +52,7 @@ Span Parser::since(const SourceLocation& loc) {
 }
 
 Scope* Parser::enter_scope() {
-    pScope = new Scope(pScope);
+    pScope = root->create<Scope>(pScope);
     return pScope;
 }
 
@@ -197,21 +194,22 @@ UnaryExpr::Operator Parser::unop(TokenKind kind) const {
 }
 
 Rune* Parser::parse_rune() {
-    if (!match(TOKEN_KIND_IDENTIFIER)) {
+    // Some runes share their name with a keyword, i.e. $public or $if.
+    if (!match(TOKEN_KIND_IDENTIFIER) && !is_keyword(lexer.last().kind)) {
         Logger::info(token_kind_to_string(lexer.last().kind));
         Logger::fatal(
                 "expected rune identifier after '$'", since(lexer.last().loc));
     }
 
-    Rune::Kind kind = Rune::from_string(lexer.last().value);
+    Rune::Kind kind = Rune::from_string(std::string(lexer.last().value));
     if (kind == Rune::Unknown) {
         Logger::fatal(
-            "unrecognized rune: '$" + lexer.last().value + "'",
+            "unrecognized rune: '$" + std::string(lexer.last().value) + "'",
             since(lexer.last().loc));
     }
 
     next(); // identifier
-    std::vector<Expr*> args = {};
+    ArenaVector<Expr*> args = root->list<Expr*>();
     if (match(TOKEN_KIND_SET_PAREN)) {
         next(); // '('
 
@@ -241,11 +239,11 @@ Rune* Parser::parse_rune() {
             since(lexer.last().loc)); 
     }
 
-    return new Rune(kind, args);
+    return root->create<Rune>(kind, std::move(args));
 }
 
 void Parser::parse_rune_decorators() {
-    runes.clear();
+    runes = root->list<Rune*>();
 
     if (!match(TOKEN_KIND_SIGN))
         return;
@@ -294,7 +292,7 @@ const Type* Parser::parse_type() {
     DeferredType::Context context {
         .meta = lexer.last().loc,
         .pScope = pScope,
-        .mut = match("mut"),
+        .mut = match(TOKEN_KIND_MUT),
     };
 
     if (context.mut)
@@ -308,7 +306,7 @@ const Type* Parser::parse_type() {
     if (!match(TOKEN_KIND_IDENTIFIER))
         Logger::fatal("expected type identifier");
 
-    context.base = lexer.last().value;
+    context.base = lexer.last().symbol;
     next(); // identifier
 
     return DeferredType::get(*root, context);
@@ -317,18 +315,19 @@ const Type* Parser::parse_type() {
 Decl* Parser::parse_decl() { 
     parse_rune_decorators();
 
-    if (!match(TOKEN_KIND_IDENTIFIER)) {
-        Logger::fatal(
-            "expected declaration name identifier",
-            Span(lexer.last().loc));
-    }
-
-    if (match("use"))
+    switch (lexer.last().kind) {
+    case TOKEN_KIND_USE:
         return parse_use();
-    else if (match("enum")) {
+    case TOKEN_KIND_ENUM:
         next(); // 'enum'
         parse_unnamed_enum();
         return nullptr;
+    case TOKEN_KIND_IDENTIFIER:
+        break;
+    default:
+        Logger::fatal(
+            "expected declaration name identifier",
+            Span(lexer.last().loc));
     }
 
     const Token name = lexer.last();
@@ -342,15 +341,16 @@ Decl* Parser::parse_decl() {
 
     next(); // '::'
 
-    if (match("struct")) {
+    switch (lexer.last().kind) {
+    case TOKEN_KIND_STRUCT:
         next(); // 'struct'
         return parse_struct(name);
-    } else if (match("enum")) {
+    case TOKEN_KIND_ENUM:
         next(); // 'enum'
         return parse_enum(name);
-    } else if (match(TOKEN_KIND_SET_PAREN)) {
+    case TOKEN_KIND_SET_PAREN:
         return parse_function(name);
-    } else {
+    default:
         return parse_global_variable(name);
     }
     //    Logger::fatal(
@@ -362,7 +362,7 @@ UseDecl* Parser::parse_use() {
     SourceLocation loc = lexer.last().loc;
     next(); // 'use'
 
-    std::vector<Rune*> use_runes = this->runes;
+    ArenaVector<Rune*> use_runes = std::move(runes);
     this->runes.clear();
 
     if (!match(TOKEN_KIND_STRING)) {
@@ -371,7 +371,7 @@ UseDecl* Parser::parse_use() {
             since(lexer.last().loc));
     }
 
-    std::string path = lexer.last().value;
+    std::string path(lexer.last().value);
     next(); // "path"
 
     if (!match(TOKEN_KIND_SEMICOLON)) {
@@ -380,17 +380,17 @@ UseDecl* Parser::parse_use() {
 
     next(); // ';'
 
-    return new UseDecl(since(loc), path, use_runes);
+    return root->create<UseDecl>(since(loc), path, std::move(use_runes));
 }
 
 FunctionDecl* Parser::parse_function(const Token& name) {
     next(); // '('
 
-    std::vector<Rune*> function_runes = runes;
+    ArenaVector<Rune*> function_runes = std::move(runes);
     runes.clear();
     Scope* scope = enter_scope();
     Stmt* body = nullptr;
-    std::vector<ParameterDecl*> params {};
+    ArenaVector<ParameterDecl*> params = root->list<ParameterDecl*>();
 
     while (!match(TOKEN_KIND_END_PAREN)) {
         if (!match(TOKEN_KIND_IDENTIFIER)) {
@@ -411,17 +411,17 @@ FunctionDecl* Parser::parse_function(const Token& name) {
         next(); // ':'
 
         const Type* type = parse_type();
-        ParameterDecl* param = new ParameterDecl(
+        ParameterDecl* param = root->create<ParameterDecl>(
             Span(pname.loc, lexer.last(1).loc),
-            pname.value,
-            {},
+            pname.symbol,
+            root->list<Rune*>(),
             type
         );
 
         if (!pScope->add(param)) {
             Logger::fatal(
                 "function parameter reuses existing name in scope: '" + 
-                    pname.value + "'",
+                    std::string(pname.value) + "'",
                 since(name.loc));
         }
 
@@ -466,19 +466,20 @@ FunctionDecl* Parser::parse_function(const Token& name) {
     }
 
     exit_scope();
-    FunctionDecl* function = new FunctionDecl(
+    FunctionDecl* function = root->create<FunctionDecl>(
         Span(name.loc, body != nullptr ? body->get_span().end : name.loc),
-        name.value,
-        function_runes,
+        name.symbol,
+        std::move(function_runes),
         type,
-        params,
+        std::move(params),
         scope,
         body
     );
 
     if (!pScope->add(function)) {
         Logger::fatal(
-            "function reuses existing name in scope: '" + name.value + "'",
+            "function reuses existing name in scope: '" +
+                std::string(name.value) + "'",
             since(name.loc));
     }
 
@@ -486,7 +487,7 @@ FunctionDecl* Parser::parse_function(const Token& name) {
 }
 
 VariableDecl* Parser::parse_global_variable(const Token& name) {
-    std::vector<Rune*> var_runes = runes;
+    ArenaVector<Rune*> var_runes = std::move(runes);
     runes.clear();
     const Type* ty = parse_type();
     Expr* init = nullptr;
@@ -508,17 +509,18 @@ VariableDecl* Parser::parse_global_variable(const Token& name) {
     while (match(TOKEN_KIND_SEMICOLON))
         next(); // ';'
 
-    VariableDecl* decl = new VariableDecl(
+    VariableDecl* decl = root->create<VariableDecl>(
         since(name.loc),
-        name.value,
-        var_runes,
+        name.symbol,
+        std::move(var_runes),
         ty,
         init,
         true);
 
     if (!pScope->add(decl)) {
         Logger::fatal(
-            "variable reuses existing name in scope: '" + name.value + "'",
+            "variable reuses existing name in scope: '" +
+                std::string(name.value) + "'",
             since(name.loc));
     }
 
@@ -532,7 +534,7 @@ VariableDecl* Parser::parse_variable() {
     if (!match(TOKEN_KIND_IDENTIFIER))
         Logger::fatal("expected variable name after 'let'", since(begin));
 
-    std::string name = lexer.last().value;
+    Symbol name = lexer.last().symbol;
     const Type* type = nullptr;
     Expr* init = nullptr;
 
@@ -558,10 +560,10 @@ VariableDecl* Parser::parse_variable() {
     if (!match(TOKEN_KIND_SEMICOLON))
         Logger::fatal("expected ';' after variable declaration", since(begin));
 
-    VariableDecl* var = new VariableDecl(
+    VariableDecl* var = root->create<VariableDecl>(
         Span(begin, end),
         name,
-        {},
+        root->list<Rune*>(),
         type,
         init);
 
@@ -572,24 +574,25 @@ VariableDecl* Parser::parse_variable() {
 StructDecl* Parser::parse_struct(const Token& name) {
     next(); // '{'
 
-    std::vector<Rune*> struct_runes = runes;
+    ArenaVector<Rune*> struct_runes = std::move(runes);
     runes.clear();
 
-    std::vector<FieldDecl*> fields;
+    ArenaVector<FieldDecl*> fields = root->list<FieldDecl*>();
     bool private_mod = false;
 
     while (!match(TOKEN_KIND_END_BRACE)) {
         parse_rune_decorators();
-        std::vector<Rune*> field_runes = runes;
+        ArenaVector<Rune*> field_runes = std::move(runes);
         runes.clear();
 
-        if (!match(TOKEN_KIND_IDENTIFIER)) {
+        if (!match(TOKEN_KIND_IDENTIFIER) && !match(TOKEN_KIND_PUBLIC) 
+          && !match(TOKEN_KIND_PRIVATE)) {
             Logger::fatal(
                 "expected field name identifier",
                 since(name.loc));
         }
 
-        if (match("public")) {
+        if (match(TOKEN_KIND_PUBLIC)) {
             private_mod = false;
             next(); // public
 
@@ -598,7 +601,7 @@ StructDecl* Parser::parse_struct(const Token& name) {
                     "expected ':' after 'public' modifier", lexer.last().loc);
             
             next(); // ':'
-        } else if (match("private")) {
+        } else if (match(TOKEN_KIND_PRIVATE)) {
             private_mod = true;
             next(); // private
 
@@ -610,9 +613,9 @@ StructDecl* Parser::parse_struct(const Token& name) {
         }
 
         if (private_mod) {
-            field_runes.push_back(new Rune(Rune::Private));
+            field_runes.push_back(root->create<Rune>(Rune::Private));
         } else {
-            field_runes.push_back(new Rune(Rune::Public));
+            field_runes.push_back(root->create<Rune>(Rune::Public));
         }
 
         const Token fname = lexer.last();
@@ -628,10 +631,10 @@ StructDecl* Parser::parse_struct(const Token& name) {
         next(); // ':'
         ftype = parse_type();
 
-        fields.push_back(new FieldDecl(
+        fields.push_back(root->create<FieldDecl>(
             since(fname.loc),
-            fname.value,
-            field_runes,
+            fname.symbol,
+            std::move(field_runes),
             ftype,
             nullptr,
             fields.size()));
@@ -650,22 +653,24 @@ StructDecl* Parser::parse_struct(const Token& name) {
     SourceLocation end = lexer.last().loc;
     next(); // '}'
 
-    StructDecl* decl = new StructDecl(
+    StructDecl* decl = root->create<StructDecl>(
         Span(name.loc, end),
-        name.value,
-        struct_runes,
+        name.symbol,
+        std::move(struct_runes),
         nullptr,
-        fields);
+        std::move(fields));
 
-    std::vector<const Type*> field_types { fields.size() };
-    for (auto field : fields) field_types.push_back(field->get_type());
+    std::vector<const Type*> field_types { decl->get_fields().size() };
+    for (auto field : decl->get_fields()) 
+        field_types.push_back(field->get_type());
 
     const StructType* type = StructType::create(*root, field_types, decl);
     decl->set_type(type);
 
     if (!pScope->add(decl)) {
         Logger::fatal(
-            "structure reuses existing name in scope: '" + name.value + "'",
+            "structure reuses existing name in scope: '" +
+                std::string(name.value) + "'",
             since(name.loc));
     }
 
@@ -673,7 +678,7 @@ StructDecl* Parser::parse_struct(const Token& name) {
 }
 
 EnumDecl* Parser::parse_enum(const Token& name) {
-    std::vector<Rune*> enum_runes = this->runes;
+    ArenaVector<Rune*> enum_runes = std::move(runes);
     runes.clear();
     const Type* underlying = parse_type();
 
@@ -685,19 +690,20 @@ EnumDecl* Parser::parse_enum(const Token& name) {
 
     next(); // '{'
 
-    EnumDecl* decl = new EnumDecl(
+    EnumDecl* decl = root->create<EnumDecl>(
         since(name.loc),
-        name.value,
-        enum_runes,
+        name.symbol,
+        std::move(enum_runes),
         nullptr,
-        {});
+        root->list<EnumValueDecl*>());
 
     const EnumType* type = EnumType::create(*root, underlying, decl);
     decl->set_type(type);
     
     if (!pScope->add(decl)) {
         Logger::fatal(
-            "enum reuses existing name in scope: '" + name.value + "'",
+            "enum reuses existing name in scope: '" +
+                std::string(name.value) + "'",
             since(name.loc));
     }
 
@@ -723,23 +729,24 @@ EnumDecl* Parser::parse_enum(const Token& name) {
                     since(vname.loc));
             }
 
-            value = std::stol(lexer.last().value);
+            value = std::stol(std::string(lexer.last().value));
             current_value = value + 1;
             next(); // value
         } else {
             current_value++;
         }
 
-        EnumValueDecl* value_decl = new EnumValueDecl(
+        EnumValueDecl* value_decl = root->create<EnumValueDecl>(
             Span(vname.loc),
-            vname.value,
-            {},
+            vname.symbol,
+            root->list<Rune*>(),
             type,
             value);
 
         if (!pScope->add(value_decl)) {
             Logger::fatal(
-                "enum value reuses existing name in scope: '" + vname.value + "'",
+                "enum value reuses existing name in scope: '" +
+                    std::string(vname.value) + "'",
                 since(vname.loc));
         }
 
@@ -763,7 +770,7 @@ EnumDecl* Parser::parse_enum(const Token& name) {
 }
 
 void Parser::parse_unnamed_enum() {
-    std::vector<Rune*> enum_runes = this->runes;
+    ArenaVector<Rune*> enum_runes = std::move(runes);
     runes.clear();
     const Type* underlying = parse_type();
 
@@ -794,24 +801,25 @@ void Parser::parse_unnamed_enum() {
                     since(vname.loc));
             }
 
-            value = std::stol(lexer.last().value);
+            value = std::stol(std::string(lexer.last().value));
             current_value = value + 1;
             next(); // value
         } else {
             current_value++;
         }
 
-        EnumValueDecl* value_decl = new EnumValueDecl(
+        EnumValueDecl* value_decl = root->create<EnumValueDecl>(
             Span(vname.loc),
-            vname.value,
-            enum_runes,
+            vname.symbol,
+            // Each value takes its own copy of the runes of the enum.
+            ArenaVector<Rune*>(enum_runes, enum_runes.get_allocator()),
             underlying,
             value);
 
         if (!pScope->add(value_decl)) {
             Logger::fatal(
                 "enum value reuses existing name in scope: '" + 
-                    vname.value + "'",
+                    std::string(vname.value) + "'",
                 since(vname.loc));
         }
 
@@ -836,26 +844,28 @@ void Parser::parse_unnamed_enum() {
 }
 
 Stmt* Parser::parse_stmt() {
-    if (match(TOKEN_KIND_SET_BRACE))
+    switch (lexer.last().kind) {
+    case TOKEN_KIND_SET_BRACE:
         return parse_block();
-    else if (match(TOKEN_KIND_SIGN))
+    case TOKEN_KIND_SIGN:
         return parse_rune_stmt();
-    else if (match("__asm__"))
+    case TOKEN_KIND_ASM:
         return parse_asm();
-    else if (match("break"))
+    case TOKEN_KIND_BREAK:
         return parse_break();
-    else if (match("continue"))
+    case TOKEN_KIND_CONTINUE:
         return parse_continue();
-    else if (match("let"))
+    case TOKEN_KIND_LET:
         return parse_decl_stmt();
-    else if (match("if"))
+    case TOKEN_KIND_IF:
         return parse_if();
-    else if (match("while"))
+    case TOKEN_KIND_WHILE:
         return parse_while();
-    else if (match("ret"))
+    case TOKEN_KIND_RET:
         return parse_ret();
-    else
+    default:
         return parse_expr();
+    }
 }
 
 AsmStmt* Parser::parse_asm() {
@@ -863,7 +873,7 @@ AsmStmt* Parser::parse_asm() {
     next(); // 'asm'
 
     bool is_volatile = false;
-    if (match("volatile")) {
+    if (match(TOKEN_KIND_VOLATILE)) {
         is_volatile = true;
         next(); // 'volatile'
     }
@@ -876,7 +886,7 @@ AsmStmt* Parser::parse_asm() {
     std::string iasm = "";    
     std::vector<std::string> outputs = {};
     std::vector<std::string> inputs = {};
-    std::vector<Expr*> exprs = {};
+    ArenaVector<Expr*> exprs = root->list<Expr*>();
     std::vector<std::string> clobbers = {};
 
     while (!match(TOKEN_KIND_COLON)) {
@@ -905,7 +915,7 @@ AsmStmt* Parser::parse_asm() {
                 lexer.last().loc);
         }
 
-        outputs.push_back(lexer.last().value);
+        outputs.push_back(std::string(lexer.last().value));
         next(); // "constraint"
 
         if (!match(TOKEN_KIND_SET_PAREN)) {
@@ -950,7 +960,7 @@ AsmStmt* Parser::parse_asm() {
                 lexer.last().loc);
         }
 
-        inputs.push_back(lexer.last().value);
+        inputs.push_back(std::string(lexer.last().value));
         next(); // "constraint"
 
         if (!match(TOKEN_KIND_SET_PAREN)) {
@@ -995,7 +1005,7 @@ AsmStmt* Parser::parse_asm() {
                 lexer.last().loc);
         }
 
-        clobbers.push_back(lexer.last().value);
+        clobbers.push_back(std::string(lexer.last().value));
         next(); // "clobber"
 
         if (match(TOKEN_KIND_END_PAREN))
@@ -1013,8 +1023,9 @@ AsmStmt* Parser::parse_asm() {
     const SourceLocation end = lexer.last().loc;
     next(); // ')'
 
-    return new AsmStmt(
-        Span(begin, end), iasm, inputs, outputs, exprs, clobbers, is_volatile);
+    return root->create<AsmStmt>(
+        Span(begin, end), iasm, inputs, outputs, std::move(exprs), clobbers,
+        is_volatile);
 }
 
 BlockStmt* Parser::parse_block() {
@@ -1022,7 +1033,7 @@ BlockStmt* Parser::parse_block() {
 
     SourceLocation begin = lexer.last().loc;
     Scope* scope = enter_scope();
-    std::vector<Stmt*> stmts;
+    ArenaVector<Stmt*> stmts = root->list<Stmt*>();
     next(); // '{'
 
     while (!match(TOKEN_KIND_END_BRACE)) {
@@ -1038,10 +1049,10 @@ BlockStmt* Parser::parse_block() {
     SourceLocation end = lexer.last().loc;
     next(); // '}'
     exit_scope();
-    return new BlockStmt(
+    return root->create<BlockStmt>(
         Span(begin, end),
-        {},
-        stmts,
+        root->list<Rune*>(),
+        std::move(stmts),
         scope);
 }
 
@@ -1049,14 +1060,14 @@ BreakStmt* Parser::parse_break() {
     SourceLocation loc = lexer.last().loc;
     next(); // 'break'
 
-    return new BreakStmt(Span(loc));
+    return root->create<BreakStmt>(Span(loc));
 }
 
 ContinueStmt* Parser::parse_continue() {
     SourceLocation loc = lexer.last().loc;
     next(); // 'continue'
 
-    return new ContinueStmt(Span(loc));
+    return root->create<ContinueStmt>(Span(loc));
 }
 
 DeclStmt* Parser::parse_decl_stmt() {
@@ -1066,7 +1077,7 @@ DeclStmt* Parser::parse_decl_stmt() {
     if (match(TOKEN_KIND_SEMICOLON))
         next(); // ';'
 
-    return new DeclStmt(decl->get_span(), decl);
+    return root->create<DeclStmt>(decl->get_span(), decl);
 }
 
 IfStmt* Parser::parse_if() {
@@ -1083,13 +1094,13 @@ IfStmt* Parser::parse_if() {
     then_body = parse_stmt();
     assert(then_body && "could not parse 'if' then body");
 
-    if (match("else")) {
+    if (match(TOKEN_KIND_ELSE)) {
         next(); // 'else'
         else_body = parse_stmt();
         assert(else_body && "could not parse 'if' else body");
     }
 
-    return new IfStmt(since(begin), condition, then_body, else_body);
+    return root->create<IfStmt>(since(begin), condition, then_body, else_body);
 }
 
 WhileStmt* Parser::parse_while() {
@@ -1105,7 +1116,7 @@ WhileStmt* Parser::parse_while() {
     body = parse_stmt();
     assert(body && "could not parse 'while' body");
 
-    return new WhileStmt(since(begin), cond, body);
+    return root->create<WhileStmt>(since(begin), cond, body);
 }
 
 RetStmt* Parser::parse_ret() {
@@ -1124,7 +1135,7 @@ RetStmt* Parser::parse_ret() {
 
     SourceLocation end = lexer.last().loc;
     next(); // ';'
-    return new RetStmt(Span(begin, end), expr);
+    return root->create<RetStmt>(Span(begin, end), expr);
 }
 
 Stmt* Parser::parse_rune_stmt() {
@@ -1132,9 +1143,9 @@ Stmt* Parser::parse_rune_stmt() {
     SourceLocation loc = lexer.last().loc;
     Rune* rune = parse_rune();
     if (Rune::is_value(rune->kind())) {
-        return new RuneExpr(loc, nullptr, rune);
+        return root->create<RuneExpr>(loc, nullptr, rune);
     } else if (Rune::is_statement(rune->kind())) {
-        return new RuneStmt(loc, rune);
+        return root->create<RuneStmt>(loc, rune);
     }
 
     Logger::fatal("cannot use decorator rune as a statement", loc);
@@ -1147,34 +1158,36 @@ Expr* Parser::parse_expr() {
 }
 
 Expr* Parser::parse_primary() {
-    if (match(TOKEN_KIND_IDENTIFIER))
+    switch (lexer.last().kind) {
+    case TOKEN_KIND_IDENTIFIER:
         return parse_identifier();
-    else if (match(TOKEN_KIND_SET_PAREN))
+    case TOKEN_KIND_CAST:
+        return parse_cast();
+    case TOKEN_KIND_NULL:
+        return parse_null();
+    case TOKEN_KIND_TRUE:
+    case TOKEN_KIND_FALSE:
+        return parse_bool();
+    case TOKEN_KIND_SIZEOF:
+        return parse_sizeof();
+    case TOKEN_KIND_SET_PAREN:
         return parse_paren();
-    else if (match(TOKEN_KIND_INTEGER))
+    case TOKEN_KIND_INTEGER:
         return parse_integer();
-    else if (match(TOKEN_KIND_FLOAT))
+    case TOKEN_KIND_FLOAT:
         return parse_float();
-    else if (match(TOKEN_KIND_CHARACTER))
+    case TOKEN_KIND_CHARACTER:
         return parse_char();
-    else if (match(TOKEN_KIND_STRING))
+    case TOKEN_KIND_STRING:
         return parse_string();
-    else if (match(TOKEN_KIND_SIGN))
+    case TOKEN_KIND_SIGN:
         return parse_rune_expr();
-    else
+    default:
         return nullptr;
+    }
 }
 
 Expr* Parser::parse_identifier() {
-    if (match("cast"))
-        return parse_cast();
-    else if (match("null"))
-        return parse_null();
-    else if (match("true") || match("false"))
-        return parse_bool();
-    else if (match("sizeof"))
-        return parse_sizeof();
-    
     next(); // identifier
 
     if (match(TOKEN_KIND_SET_PAREN))
@@ -1203,7 +1216,7 @@ Expr* Parser::parse_binary(Expr* pBase, i32 precedence) {
             assert(right && "could not parse secondary binary right operand");
         }
 
-        pBase = new BinaryExpr(
+        pBase = root->create<BinaryExpr>(
             Span(pBase->get_span().begin, right->get_span().end),
             nullptr,
             op,
@@ -1223,7 +1236,7 @@ Expr* Parser::parse_unary_prefix() {
         Expr* base = parse_unary_prefix();
         assert(base && "could not parse prefix unary operand");
 
-        return new UnaryExpr(
+        return root->create<UnaryExpr>(
             Span(begin, base->get_span().end),
             nullptr,
             op,
@@ -1243,7 +1256,7 @@ Expr* Parser::parse_unary_postfix() {
         UnaryExpr::Operator op = unop(lexer.last().kind);
         if (UnaryExpr::is_postfix(op)) {
             next(); // op
-            expr = new UnaryExpr(
+            expr = root->create<UnaryExpr>(
                 Span(begin),
                 nullptr,
                 op,
@@ -1260,7 +1273,7 @@ Expr* Parser::parse_unary_postfix() {
                 Logger::fatal("expected ']' after subscript expression", since(begin));
 
             next(); // ']'
-            expr = new SubscriptExpr(
+            expr = root->create<SubscriptExpr>(
                 since(begin),
                 nullptr,
                 expr,
@@ -1272,10 +1285,10 @@ Expr* Parser::parse_unary_postfix() {
             if (!match(TOKEN_KIND_IDENTIFIER))
                 Logger::fatal("expected struct member after '.' operator", since(begin));
 
-            std::string member = lexer.last().value;
+            Symbol member = lexer.last().symbol;
             next(); // identifier
 
-            expr = new MemberExpr(
+            expr = root->create<MemberExpr>(
                 since(begin),
                 nullptr,
                 member,
@@ -1289,37 +1302,37 @@ Expr* Parser::parse_unary_postfix() {
 }
 
 BoolLiteral* Parser::parse_bool() {
-    BoolLiteral* boolean = new BoolLiteral(
+    BoolLiteral* boolean = root->create<BoolLiteral>(
         Span(lexer.last().loc),
         root->get_bool_type(),
-        match("true")
+        match(TOKEN_KIND_TRUE)
     );
     next(); // 'true' | 'false'
     return boolean;
 }
 
 IntegerLiteral* Parser::parse_integer() {
-    IntegerLiteral* integer = new IntegerLiteral(
+    IntegerLiteral* integer = root->create<IntegerLiteral>(
         Span(lexer.last().loc),
         root->get_si64_type(),
-        std::stol(lexer.last().value, 0, 10)
+        std::stol(std::string(lexer.last().value), 0, 10)
     );
     next(); // integer
     return integer;
 }
 
 FloatLiteral* Parser::parse_float() {
-    FloatLiteral* fp = new FloatLiteral(
+    FloatLiteral* fp = root->create<FloatLiteral>(
         Span(lexer.last().loc),
         root->get_fp64_type(),
-        std::stod(lexer.last().value, 0)
+        std::stod(std::string(lexer.last().value), 0)
     );
     next(); // float
     return fp;
 }
 
 CharLiteral* Parser::parse_char() {
-    CharLiteral* character = new CharLiteral(
+    CharLiteral* character = root->create<CharLiteral>(
         Span(lexer.last().loc),
         root->get_char_type(),
         lexer.last().value[0]
@@ -1329,17 +1342,17 @@ CharLiteral* Parser::parse_char() {
 }
 
 StringLiteral* Parser::parse_string() {
-    StringLiteral* string = new StringLiteral(
+    StringLiteral* string = root->create<StringLiteral>(
         Span(lexer.last().loc),
         PointerType::get(*root, root->get_char_type()),
-        lexer.last().value
+        std::string(lexer.last().value)
     );
     next(); // "..."
     return string;
 }
 
 NullLiteral* Parser::parse_null() {
-    NullLiteral* null = new NullLiteral(
+    NullLiteral* null = root->create<NullLiteral>(
         Span(lexer.last().loc),
         PointerType::get(*root, root->get_void_type())
     );
@@ -1380,7 +1393,7 @@ CastExpr* Parser::parse_cast() {
     SourceLocation end = lexer.last().loc;
     next(); // ')'
 
-    return new CastExpr(
+    return root->create<CastExpr>(
         Span(begin, end), 
         type, 
         expr);
@@ -1400,7 +1413,7 @@ ParenExpr* Parser::parse_paren() {
     SourceLocation end = lexer.last().loc;
     next(); // ')'
 
-    return new ParenExpr(
+    return root->create<ParenExpr>(
         Span(begin, end),
         expr
     );
@@ -1423,7 +1436,7 @@ SizeofExpr* Parser::parse_sizeof() {
     SourceLocation end = lexer.last().loc;
     next(); // ')'
 
-    return new SizeofExpr(
+    return root->create<SizeofExpr>(
         Span(begin, end),
         root->get_ui64_type(),
         type
@@ -1432,18 +1445,17 @@ SizeofExpr* Parser::parse_sizeof() {
 
 ReferenceExpr* Parser::parse_ref() {
     const Token& name = lexer.last(1);
-    Decl* decl = pScope->get(name.value);
-    return new ReferenceExpr(
+    return root->create<ReferenceExpr>(
         Span(name.loc), 
         nullptr, 
-        name.value);
+        name.symbol);
 }
 
 CallExpr* Parser::parse_call() {
     const Token callee = lexer.last(1);
     next(); // '('
 
-    std::vector<Expr*> args;
+    ArenaVector<Expr*> args = root->list<Expr*>();
 
     while (!match(TOKEN_KIND_END_PAREN)) {
         Expr* arg = parse_expr();
@@ -1461,11 +1473,11 @@ CallExpr* Parser::parse_call() {
 
     SourceLocation end = lexer.last().loc;
     next(); // ')'
-    return new CallExpr(
+    return root->create<CallExpr>(
         Span(callee.loc, end), 
         nullptr, 
-        callee.value, 
-        args);
+        callee.symbol,
+        std::move(args));
 }
 
 RuneExpr* Parser::parse_rune_expr() {
@@ -1479,5 +1491,5 @@ RuneExpr* Parser::parse_rune_expr() {
             loc);
     }
 
-    return new RuneExpr(loc, nullptr, rune);
+    return root->create<RuneExpr>(loc, nullptr, rune);
 }
@@ -18,7 +18,7 @@ class Parser final {
     InputFile&              file;
     Lexer                   lexer;
     std::unique_ptr<Root>   root;
-    std::vector<Rune*>      runes;
+    ArenaVector<Rune*>      runes;
     Scope*                  pScope = nullptr;
 
 public:
@@ -28,8 +28,6 @@ public:
 
 private:
     bool match(TokenKind kind) const;
-    
-    bool match(const char* kw) const;
 
     void next();
 
@@ -4,6 +4,7 @@
 #include "tree/rune.hpp"
 #include "tree/stmt.hpp"
 #include "types/input_file.hpp"
+#include "types/source_manager.hpp"
 
 #include <cstring>
 #include <ostream>
@@ -29,10 +30,10 @@ static void print_piping(std::ostream& os) {
 }
 
 static std::string span_string(const Span& span) {
-    return '<' + std::to_string(span.begin.line) + ':' + 
-        std::to_string(span.begin.column) + "/" + 
-        std::to_string(span.end.line) + ':' + 
-        std::to_string(span.end.column) + '>';
+    return '<' + std::to_string(SourceManager::line(span.begin)) + ':' + 
+        std::to_string(SourceManager::column(span.begin)) + "/" + 
+        std::to_string(SourceManager::line(span.end)) + ':' + 
+        std::to_string(SourceManager::column(span.end)) + '>';
 }
 
 void Root::print(std::ostream& os) const {
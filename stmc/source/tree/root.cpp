@@ -4,12 +4,9 @@
 
 using namespace stm;
 
-const stm::Type* stm::TypeContext::get(const std::string& name) const {
-    auto it = types.find(name);
-    if (it != types.end())
-        return it->second;
-
-    return nullptr;
+const stm::Type* stm::TypeContext::get(Symbol name) const {
+    const Type* const* type = types.find(name);
+    return type ? *type : nullptr;
 }
 
 const stm::BuiltinType* stm::TypeContext::get(BuiltinType::Kind kind) const {
@@ -43,14 +40,14 @@ const stm::PointerType* stm::TypeContext::get(const Type* pPointee) {
 const stm::StructType* stm::TypeContext::create(
         const std::vector<const Type*>& fields, const StructDecl* decl) {
     StructType* type = new StructType(fields, decl);
-    types.emplace(decl->get_name(), type);
+    types.insert(decl->get_symbol(), type);
     structs.push_back(type);
     return type;
 }
 
 const stm::EnumType* stm::TypeContext::create(const Type* underlying, const EnumDecl* decl) {
     EnumType* type = new EnumType(underlying, decl);
-    types.emplace(decl->get_name(), type);
+    types.insert(decl->get_symbol(), type);
     enums.push_back(type);
     return type;
 }
@@ -61,7 +58,7 @@ stm::TypeContext::TypeContext() {
           kind = BuiltinType::Kind(u8(kind) + 1)) {
         BuiltinType* type = new BuiltinType(kind);
         builtins.emplace(kind, type);
-        types.emplace(BuiltinType::get_name(kind), type);
+        types.insert(BuiltinType::get_name(kind), type);
     }
 }
 
@@ -78,20 +75,24 @@ stm::TypeContext::~TypeContext() {
     for (auto [pointee, type] : pointers)
         delete type;
 
+    for (auto& type : structs)
+        delete type;
+
+    for (auto& type : enums)
+        delete type;
+
     builtins.clear();
     deferred.clear();
     functions.clear();
     pointers.clear();
+    structs.clear();
+    enums.clear();
 }
 
-Root::Root(InputFile& file, Scope* scope) : m_file(file), m_scope(scope) {}
+Root::Root(InputFile& file) : m_file(file), m_scope(create<Scope>()) {}
 
 stm::Root::~Root() {
-    delete m_scope;
-
-    for (auto& decl : decls()) 
-        delete decl;
-
+    // The nodes themselves are all released with the arena.
     m_decls.clear();
     m_imports.clear();
     m_exports.clear();
@@ -100,7 +101,7 @@ stm::Root::~Root() {
 std::vector<UseDecl*> Root::uses() const {
     std::vector<UseDecl*> uses = {};
     for (auto& decl : decls())
-        if (auto* use = dynamic_cast<UseDecl*>(decl))
+        if (auto* use = dyn_cast<UseDecl>(decl))
             uses.push_back(use);
 
     return uses;
@@ -112,10 +113,6 @@ void stm::Root::validate() {
     for (auto& deferred : m_context.deferred) {
         const DeferredType::Context& ctx = deferred->get_context();
 
-        if (ctx.meta.line == 201 && ctx.base == "u64") {
-            int x = 1;
-        }
-
         // Try to resolve the base of the type.
         const Type* type = m_context.get(ctx.base);
         if (!type)
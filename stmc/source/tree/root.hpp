@@ -3,6 +3,7 @@
 
 #include "tree/type.hpp"
 #include "tree/visitor.hpp"
+#include "types/arena.hpp"
 
 #include <string>
 #include <unordered_map>
@@ -17,7 +18,7 @@ class TypeContext final {
     friend class StructType;
     friend class EnumType;
 
-    std::unordered_map<std::string, const Type*> types {};
+    SymbolMap<const Type*> types {};
     std::unordered_map<BuiltinType::Kind, BuiltinType*> builtins {};
     std::unordered_map<const Type*, PointerType*> pointers {};
     std::vector<DeferredType*> deferred {};
@@ -25,7 +26,7 @@ class TypeContext final {
     std::vector<StructType*> structs {};
     std::vector<EnumType*> enums {};
 
-    const Type* get(const std::string& name) const;
+    const Type* get(Symbol name) const;
     const BuiltinType* get(BuiltinType::Kind kind) const;
     const PointerType* get(const Type* pPointee);
     const DeferredType* get(const DeferredType::Context& context);
@@ -49,6 +50,11 @@ class Root final {
     friend class Codegen;
 
     InputFile& m_file;
+
+    /// The arena that every node in this tree is allocated in. This must
+    /// outlive all other members, since they may point into it.
+    Arena m_arena = {};
+
     TypeContext m_context = {};
     Scope* m_scope;
     std::vector<Decl*> m_decls = {};
@@ -56,8 +62,8 @@ class Root final {
     std::vector<Decl*> m_exports = {};
 
 public:
-    /// Create a new root that represents |file| with the given scope.
-    Root(InputFile& file, Scope* scope);
+    /// Create a new root that represents |file|, with an empty global scope.
+    Root(InputFile& file);
     
     Root(const Root&) = delete;
     Root& operator = (const Root&) = delete;
@@ -68,6 +74,23 @@ public:
     const InputFile& file() const { return m_file; }
     InputFile& file() { return m_file; }
 
+    /// Create a new node of type T in this tree with |args|. The node lives
+    /// for as long as this tree does.
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        return m_arena.create<T>(std::forward<Args>(args)...);
+    }
+
+    /// Returns a new, empty list of T whose storage lives for as long as this
+    /// tree does, to hold the children of a node.
+    template<typename T>
+    ArenaVector<T> list() {
+        return ArenaVector<T>(ArenaAllocator<T>(m_arena));
+    }
+
+    /// Returns the arena that the nodes of this tree are allocated in.
+    const Arena& arena() const { return m_arena; }
+
     /// Returns the context used for typing in this tree.
     const TypeContext& context() const { return m_context; }
     TypeContext& context() { return m_context; }
@@ -148,24 +148,11 @@ std::string Rune::to_string(Rune::Kind kind) {
     }
 }
 
-Rune::Rune(Kind kind, const std::vector<Expr*>& args) 
-    : m_kind(kind), m_args(args) {}
-
-Rune::~Rune() {
-    for (auto* arg : m_args) delete arg;
-    m_args.clear();
-}
+Rune::Rune(Kind kind, ArenaVector<Expr*> args) 
+    : m_kind(kind), m_args(std::move(args)) {}
 
 RuneStmt::RuneStmt(const Span& span, Rune* rune)
-    : Stmt(span), m_rune(rune) {}
-
-RuneStmt::~RuneStmt() {
-    delete m_rune;
-};
+    : Stmt(Kind::RuneStmt, span), m_rune(rune) {}
 
 RuneExpr::RuneExpr(const Span& span, const Type* type, Rune* rune)
-    : Expr(span, type), m_rune(rune) {}
-
-RuneExpr::~RuneExpr() {
-    delete m_rune;
-}
+    : Expr(Kind::RuneExpr, span, type), m_rune(rune) {}
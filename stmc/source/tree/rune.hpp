@@ -72,22 +72,20 @@ public:
 
 private:
     Kind m_kind;
-    std::vector<Expr*> m_args;
+    ArenaVector<Expr*> m_args;
 
 public:
-    Rune(Kind kind, const std::vector<Expr*>& args = {});
+    Rune(Kind kind, ArenaVector<Expr*> args = {});
 
     Rune(const Rune&) = delete;
     Rune& operator = (const Rune&) = delete;
 
-    ~Rune();
-
     /// Returns the kind of rune this is.
     Kind kind() const { return m_kind; }
 
     /// Returns the arguments to this rune, if there are any.
-    const std::vector<Expr*>& args() const { return m_args; }
-    std::vector<Expr*>& args() { return m_args; }
+    const ArenaVector<Expr*>& args() const { return m_args; }
+    ArenaVector<Expr*>& args() { return m_args; }
 
     /// Returns the number of arguments in this rune.
     u32 num_args() const { return args().size(); }
@@ -113,8 +111,6 @@ public:
     RuneStmt(const RuneStmt&) = delete;
     RuneStmt& operator = (const RuneStmt&) = delete;
 
-    ~RuneStmt() override;
-
     /// Returns the rune embedded in this expression.
     const Rune* rune() const { return m_rune; }
     Rune* rune() { return m_rune; }
@@ -124,6 +120,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::RuneStmt;
+    }
 };
 
 /// Represents evaluable runes as expression nodes in the syntax tree.
@@ -140,7 +140,6 @@ public:
     RuneExpr(const RuneExpr&) = delete;
     RuneExpr& operator = (const RuneExpr&) = delete;
     
-    ~RuneExpr() override;
 
     bool is_constant() const override { return true; }
 
@@ -153,6 +152,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::RuneExpr;
+    }
 };
 
 } // namespace stm
@@ -1,12 +1,11 @@
 #include "tree/decl.hpp"
 #include "tree/scope.hpp"
 
-stm::Decl* stm::Scope::get(const std::string& name) const {
-    for (auto [ sym_name, sym ] : m_symbols)
-        if (sym_name == name) return sym;
-
-    if (m_parent != nullptr)
-        return m_parent->get(name);
+stm::Decl* stm::Scope::get(Symbol name) const {
+    for (const Scope* scope = this; scope; scope = scope->m_parent) {
+        if (Decl* const* decl = scope->m_symbols.find(name))
+            return *decl;
+    }
 
     return nullptr;
 }
@@ -14,9 +13,9 @@ stm::Decl* stm::Scope::get(const std::string& name) const {
 bool stm::Scope::add(Decl* decl) {
     assert(decl);
 
-    if (get(decl->get_name()) != nullptr)
+    if (get(decl->get_symbol()) != nullptr)
         return false;
 
-    m_symbols.emplace(decl->get_name(), decl);
+    m_symbols.insert(decl->get_symbol(), decl);
     return true;
 }
@@ -1,8 +1,8 @@
 #ifndef STATIM_SCOPE_HPP_
 #define STATIM_SCOPE_HPP_
 
-#include <string>
-#include <unordered_map>
+#include "types/symbol.hpp"
+#include "types/symbol_map.hpp"
 
 namespace stm {
      
@@ -11,7 +11,7 @@ class Decl;
 /// A scope tree containing named symbols.
 class Scope final {
     Scope* m_parent;
-    std::unordered_map<std::string, Decl*> m_symbols {};
+    SymbolMap<Decl*> m_symbols {};
 
 public:
     Scope(Scope* parent = nullptr) : m_parent(parent) {}
@@ -20,12 +20,10 @@ public:
     const Scope* get_parent() const { return m_parent; }
     Scope* get_parent() { return m_parent; }
 
-    const std::unordered_map<std::string, Decl*>& get_symbols() const { 
-        return m_symbols; 
-    }
+    const SymbolMap<Decl*>& get_symbols() const { return m_symbols; }
 
     /// \returns The declaration in scope with name \p name, if it exists.
-    Decl* get(const std::string& name) const;
+    Decl* get(Symbol name) const;
 
     /// Attempt to add \p decl to this scope.
     /// \returns `false` if the declaration has conflicts.
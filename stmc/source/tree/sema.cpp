@@ -142,7 +142,7 @@ void SemanticAnalysis::visit(VariableDecl& node) {
             TypeCheckMode::AllowImplicit);
 
         if (tc == TypeCheckResult::Cast) {
-            node.m_init = new CastExpr(
+            node.m_init = root.create<CastExpr>(
                 node.get_init()->get_span(),
                 node.get_type(),
                 node.get_init());
@@ -213,7 +213,7 @@ void SemanticAnalysis::visit(IfStmt& node) {
             node.get_cond()->get_span());
     }
 
-    if (dynamic_cast<const DeclStmt*>(node.get_then())) {
+    if (isa<DeclStmt>(node.get_then())) {
         Logger::fatal(
             "declaration must be within a block statement", 
             node.get_then()->get_span());
@@ -222,7 +222,7 @@ void SemanticAnalysis::visit(IfStmt& node) {
     node.pThen->accept(*this);
 
     if (node.has_else()) {
-        if (dynamic_cast<const DeclStmt*>(node.get_else())) {
+        if (isa<DeclStmt>(node.get_else())) {
             Logger::fatal(
                 "declaration must be witin a block statement", 
                 node.get_else()->get_span());
@@ -244,7 +244,7 @@ void SemanticAnalysis::visit(WhileStmt& node) {
             node.get_cond()->get_span());
     }
 
-    if (dynamic_cast<const DeclStmt*>(node.get_body())) {
+    if (isa<DeclStmt>(node.get_body())) {
         Logger::fatal(
             "declaration must be within a block statement", 
             node.get_body()->get_span());
@@ -274,7 +274,7 @@ void SemanticAnalysis::visit(RetStmt& node) {
             TypeCheckMode::AllowImplicit);
 
         if (tc == TypeCheckResult::Cast) {
-            node.pExpr = new CastExpr(
+            node.pExpr = root.create<CastExpr>(
                 node.get_expr()->get_span(),
                 pFunction->get_type()->get_return_type(),
                 node.pExpr);
@@ -321,7 +321,7 @@ void SemanticAnalysis::visit(BinaryExpr& node) {
         right_type, left_type, mode);
 
     if (tc == TypeCheckResult::Cast) {
-        node.pRight = new CastExpr(
+        node.pRight = root.create<CastExpr>(
             node.get_rhs()->get_span(),
             left_type,
             node.pRight);
@@ -404,7 +404,7 @@ void SemanticAnalysis::visit(CallExpr& node) {
             TypeCheckMode::AllowImplicit);
 
         if (tc == TypeCheckResult::Cast) {
-            node.args[idx] = new CastExpr(
+            node.args[idx] = root.create<CastExpr>(
                 arg->get_span(),
                 param->get_type(),
                 arg);
@@ -7,85 +7,30 @@ using namespace stm;
 AsmStmt::AsmStmt(const Span& span, const std::string& str,
                  const std::vector<std::string>& inputs,
                  const std::vector<std::string>& outputs,
-                 const std::vector<Expr*>& exprs,
+                 ArenaVector<Expr*> exprs,
                  const std::vector<std::string>& clobbers,
                  bool is_volatile)
-    : Stmt(span), m_asm(str), m_inputs(inputs), m_outputs(outputs), 
-      m_exprs(exprs), m_clobbers(clobbers), m_volatile(is_volatile) {}
-
-AsmStmt::~AsmStmt() {
-    for (auto& expr : m_exprs) 
-        delete expr;
-        
-    m_exprs.clear();
-}
+    : Stmt(Kind::AsmStmt, span), m_asm(str), m_inputs(inputs),
+      m_outputs(outputs), m_exprs(std::move(exprs)), m_clobbers(clobbers),
+      m_volatile(is_volatile) {}
 
 stm::BlockStmt::BlockStmt(
         const Span& span, 
-        const std::vector<Rune*>& runes, 
-        const std::vector<Stmt*>& stmts, 
+        ArenaVector<Rune*> runes, 
+        ArenaVector<Stmt*> stmts, 
         Scope* pScope)
-    : Stmt(span), runes(runes), stmts(stmts), pScope(pScope) {};
-
-stm::BlockStmt::~BlockStmt() {
-    for (Rune* rune : runes) delete rune;
-    runes.clear();
-    
-    for (Stmt* stmt : stmts) delete stmt;
-    stmts.clear();
-
-    delete pScope;
-    pScope = nullptr;
-}
+    : Stmt(Kind::BlockStmt, span), runes(std::move(runes)),
+      stmts(std::move(stmts)),
+      pScope(pScope) {};
 
-stm::DeclStmt::DeclStmt(const Span& span, Decl* pDecl) : Stmt(span), pDecl(pDecl) {}
-
-stm::DeclStmt::~DeclStmt() {
-    delete pDecl;
-    pDecl = nullptr;
-}
+stm::DeclStmt::DeclStmt(const Span& span, Decl* pDecl)
+    : Stmt(Kind::DeclStmt, span), pDecl(pDecl) {}
 
 stm::IfStmt::IfStmt(const Span& span, Expr* pCond, Stmt* pThen, Stmt* pElse)
-    : Stmt(span), pCond(pCond), pThen(pThen), pElse(pElse) {}
-
-stm::IfStmt::~IfStmt() {
-    if (pCond != nullptr) {
-        delete pCond;
-        pCond = nullptr;
-    }
-
-    if (pThen != nullptr) {
-        delete pThen;
-        pThen = nullptr;
-    }
-
-    if (pElse != nullptr) {
-        delete pElse;
-        pElse = nullptr;
-    }
-}
+    : Stmt(Kind::IfStmt, span), pCond(pCond), pThen(pThen), pElse(pElse) {}
 
 stm::WhileStmt::WhileStmt(const Span& span, Expr* pCond, Stmt* pBody) 
-    : Stmt(span), pCond(pCond), pBody(pBody) {}
-
-stm::WhileStmt::~WhileStmt() {
-    if (pCond != nullptr) {
-        delete pCond;
-        pCond = nullptr;
-    }
-
-    if (pBody != nullptr) {
-        delete pBody;
-        pBody = nullptr;
-    }
-}
+    : Stmt(Kind::WhileStmt, span), pCond(pCond), pBody(pBody) {}
 
 stm::RetStmt::RetStmt(const Span& span, Expr* pExpr) 
-    : Stmt(span), pExpr(pExpr) {}
-
-stm::RetStmt::~RetStmt() {
-    if (pExpr != nullptr) {
-        delete pExpr;
-        pExpr = nullptr;
-    }
-}
+    : Stmt(Kind::RetStmt, span), pExpr(pExpr) {}
@@ -1,6 +1,8 @@
 #ifndef STATIM_TREE_STMT_HPP_
 #define STATIM_TREE_STMT_HPP_
 
+#include "types/arena.hpp"
+#include "types/casting.hpp"
 #include "types/source_location.hpp"
 #include "tree/visitor.hpp"
 
@@ -15,14 +17,32 @@ class Stmt {
     friend class SemanticAnalysis;
     friend class Codegen;
 
+public:
+    /// The kinds of statements and expressions, used by isa<>, cast<> and
+    /// dyn_cast<>. Expressions follow all statements, and references precede
+    /// the member and call expressions that extend them, so that each can be
+    /// told apart with a single range check.
+    enum class Kind : u8 {
+        AsmStmt, BlockStmt, BreakStmt, ContinueStmt, DeclStmt, IfStmt,
+        WhileStmt, RetStmt, RuneStmt,
+        BoolLiteral, IntegerLiteral, FloatLiteral, CharLiteral,
+        StringLiteral, NullLiteral, BinaryExpr, UnaryExpr, CastExpr,
+        ParenExpr, SizeofExpr, SubscriptExpr, RuneExpr,
+        ReferenceExpr, MemberExpr, CallExpr,
+    };
+
 protected:
+    const Kind m_kind;
     Span span;
 
 public:
-    Stmt(const Span& span) : span(span) {};
+    Stmt(Kind kind, const Span& span) : m_kind(kind), span(span) {};
 
     virtual ~Stmt() = default;
 
+    /// Returns the kind of this statement.
+    Kind get_kind() const { return m_kind; }
+
     const Span& get_span() const { return span; }
 
     virtual void accept(Visitor& visitor) = 0;
@@ -38,7 +58,7 @@ class AsmStmt final : public Stmt {
     std::string m_asm;
     std::vector<std::string> m_inputs;
     std::vector<std::string> m_outputs;
-    std::vector<Expr*> m_exprs;
+    ArenaVector<Expr*> m_exprs;
     std::vector<std::string> m_clobbers;
     bool m_volatile;
 
@@ -46,15 +66,13 @@ public:
     AsmStmt(const Span& span, const std::string& str,
             const std::vector<std::string>& inputs,
             const std::vector<std::string>& outputs,
-            const std::vector<Expr*>& exprs,
+            ArenaVector<Expr*> exprs,
             const std::vector<std::string>& clobbers,
             bool is_volatile = false);
     
     AsmStmt(const AsmStmt&) = delete;
     AsmStmt& operator = (const AsmStmt&) = delete;
 
-    ~AsmStmt() override;
-
     /// Returns the assembly string as part of this inline assembly statement.
     const std::string& string() const { return m_asm; }
 
@@ -65,7 +83,7 @@ public:
     const std::vector<std::string>& outputs() const { return m_outputs; }
 
     /// Returns the list of expressions used in this inline assembly.
-    const std::vector<Expr*> exprs() const { return m_exprs; }
+    const ArenaVector<Expr*>& exprs() const { return m_exprs; }
 
     /// Returns the list of clobbers declared as part of this inline assembly.
     const std::vector<std::string>& clobbers() const { return m_clobbers; }
@@ -79,6 +97,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::AsmStmt;
+    }
 };
 
 class BlockStmt final : public Stmt {
@@ -86,22 +108,20 @@ class BlockStmt final : public Stmt {
     friend class SemanticAnalysis;
     friend class Codegen;
 
-    std::vector<Rune*>  runes;
-    std::vector<Stmt*>  stmts;
+    ArenaVector<Rune*>  runes;
+    ArenaVector<Stmt*>  stmts;
     Scope*              pScope;
     
 public:
     BlockStmt(
         const Span& span, 
-        const std::vector<Rune*>& runes, 
-        const std::vector<Stmt*>& stmts, 
+        ArenaVector<Rune*> runes, 
+        ArenaVector<Stmt*> stmts, 
         Scope* pScope);
 
-    ~BlockStmt() override;
+    const ArenaVector<Rune*>& get_runes() const { return runes; }
 
-    const std::vector<Rune*>& get_runes() const { return runes; }
-
-    const std::vector<Stmt*>& get_stmts() const { return stmts; }
+    const ArenaVector<Stmt*>& get_stmts() const { return stmts; }
 
     u32 size() const { return stmts.size(); }
 
@@ -114,6 +134,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::BlockStmt;
+    }
 };
 
 class BreakStmt final : public Stmt {
@@ -122,13 +146,17 @@ class BreakStmt final : public Stmt {
     friend class Codegen;
 
 public:
-    BreakStmt(const Span& span) : Stmt(span) {};
+    BreakStmt(const Span& span) : Stmt(Kind::BreakStmt, span) {};
 
     void accept(Visitor& visitor) override {
         visitor.visit(*this);
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::BreakStmt;
+    }
 };
 
 class ContinueStmt final : public Stmt {
@@ -137,13 +165,18 @@ class ContinueStmt final : public Stmt {
     friend class Codegen;
 
 public:
-    ContinueStmt(const Span& span) : Stmt(span) {};
+    ContinueStmt(const Span& span)
+        : Stmt(Kind::ContinueStmt, span) {};
 
     void accept(Visitor& visitor) override {
         visitor.visit(*this);
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::ContinueStmt;
+    }
 };
 
 class DeclStmt final : public Stmt {
@@ -155,7 +188,6 @@ class DeclStmt final : public Stmt {
 
 public:
     DeclStmt(const Span& span, Decl* pDecl);
-    ~DeclStmt() override;
 
     const Decl* get_decl() const { return pDecl; }
 
@@ -164,6 +196,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::DeclStmt;
+    }
 };
 
 class IfStmt final : public Stmt {
@@ -177,7 +213,6 @@ class IfStmt final : public Stmt {
 
 public:
     IfStmt(const Span& span, Expr* pCond, Stmt* pThen, Stmt* pElse);
-    ~IfStmt() override;
 
     const Expr* get_cond() const { return pCond; }
 
@@ -192,6 +227,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::IfStmt;
+    }
 };
 
 class WhileStmt final : public Stmt {
@@ -204,7 +243,6 @@ class WhileStmt final : public Stmt {
 
 public:
     WhileStmt(const Span& span, Expr* pCond, Stmt* pBody);
-    ~WhileStmt() override;
 
     const Expr* get_cond() const { return pCond; }
 
@@ -217,6 +255,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::WhileStmt;
+    }
 };
 
 class RetStmt final : public Stmt {
@@ -228,7 +270,6 @@ class RetStmt final : public Stmt {
 
 public:
     RetStmt(const Span& span, Expr* pExpr);
-    ~RetStmt() override;
 
     const Expr* get_expr() const { return pExpr; }
 
@@ -239,6 +280,10 @@ public:
     }
 
     void print(std::ostream& os) const override;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->get_kind() == Kind::RetStmt;
+    }
 };
 
 } // namespace stm
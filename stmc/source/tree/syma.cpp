@@ -145,15 +145,20 @@ void SymbolAnalysis::visit(SubscriptExpr& node) {
 }
 
 void SymbolAnalysis::visit(ReferenceExpr& node) {
-    Decl* decl = pScope->get(node.get_name());
+    // References only need to be looked up in the scope tree once, after
+    // which the resolved declaration is cached on the node.
+    if (node.is_resolved())
+        return;
+
+    Decl* decl = pScope->get(node.get_symbol());
     if (!decl)
         Logger::fatal("unresolved reference: '" + node.name + "'", node.span);
 
-    if (auto var = dynamic_cast<VariableDecl*>(decl)) {
+    if (auto var = dyn_cast<VariableDecl>(decl)) {
         node.pType = var->get_type();
-    } else if (auto param = dynamic_cast<ParameterDecl*>(decl)) {
+    } else if (auto param = dyn_cast<ParameterDecl>(decl)) {
         node.pType = param->get_type();
-    } else if (auto val = dynamic_cast<EnumValueDecl*>(decl)) {
+    } else if (auto val = dyn_cast<EnumValueDecl>(decl)) {
         node.pType = val->get_type();
     } else {
         Logger::fatal("unresolved reference: '" + node.name + "'", node.span);
@@ -172,7 +177,7 @@ void SymbolAnalysis::visit(MemberExpr& node) {
         st = base_type->as_struct();
     } else if (base_type->is_pointer()) {
         auto pointee = base_type->as_pointer()->get_pointee();
-        st = dynamic_cast<const StructType*>(pointee);
+        st = dyn_cast<StructType>(pointee);
         if (!st) {
             Logger::fatal(
                 "access operator '.' base is a pointer, but not to a struct",
@@ -186,7 +191,7 @@ void SymbolAnalysis::visit(MemberExpr& node) {
 
     // Try to resolve the targetted field within the structure.
     const StructDecl* decl = st->get_decl();
-    const FieldDecl* field = decl->get_field(node.get_name());
+    const FieldDecl* field = decl->get_field(node.get_symbol());
     if (!field) {
         Logger::fatal(
             "member '" + node.get_name() + "' does not exist in struct '" + 
@@ -202,15 +207,18 @@ void SymbolAnalysis::visit(CallExpr& node) {
     for (auto arg : node.args)
         arg->accept(*this);
 
+    if (node.is_resolved())
+        return;
+
     // Try to resolve the callee and ensure it's a function.
-    auto decl = pScope->get(node.get_name());
+    auto decl = pScope->get(node.get_symbol());
     if (!decl) {
         Logger::fatal(
             "unresolved reference: '" + node.get_name() + "'", 
             node.get_span());
     }
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     if (!function) {
         Logger::fatal(
             "reference exists, but is not a function: '" + 
@@ -193,12 +193,12 @@ std::string PointerType::to_string() const {
     return is_mut() ? "mut *" : "*" + get_pointee()->to_string();
 }
 
-const StructType* StructType::get(Root& root, const std::string& name) {
+const StructType* StructType::get(Root& root, Symbol name) {
     const Type* type = root.context().get(name);
     if (!type)
         return nullptr;
 
-    auto structure = dynamic_cast<const StructType*>(type);
+    auto structure = dyn_cast<StructType>(type);
     if (!structure)
         return nullptr;
 
@@ -223,19 +223,19 @@ bool StructType::compare(const Type* other) const {
     if (!other->is_struct())
         return false;
 
-    return get_decl()->get_name() == other->as_struct()->get_decl()->get_name();
+    return get_decl()->get_symbol() == other->as_struct()->get_decl()->get_symbol();
 }
 
 std::string StructType::to_string() const {
     return is_mut() ? "mut " : get_decl()->get_name();
 }
 
-const EnumType* EnumType::get(Root& root, const std::string& name) {
+const EnumType* EnumType::get(Root& root, Symbol name) {
     const Type* type = root.context().get(name);
     if (!type)
         return nullptr;
 
-    auto enumeration = dynamic_cast<const EnumType*>(type);
+    auto enumeration = dyn_cast<EnumType>(type);
     if (!enumeration)
         return nullptr;
 
@@ -259,7 +259,7 @@ bool EnumType::compare(const Type* other) const {
     if (!other->is_enum())
         return false;
 
-    return get_decl()->get_name() == other->as_enum()->get_decl()->get_name();
+    return get_decl()->get_symbol() == other->as_enum()->get_decl()->get_symbol();
 }
 
 std::string EnumType::to_string() const {
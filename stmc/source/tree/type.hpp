@@ -2,6 +2,7 @@
 #define STATIM_TREE_TYPE_HPP_
 
 #include "tree/scope.hpp"
+#include "types/casting.hpp"
 #include "types/source_location.hpp"
 #include "types/types.hpp"
 
@@ -25,6 +26,13 @@ class EnumType;
 
 /// Base class for all types which may represent values in the syntax tree.
 class Type {
+public:
+    /// The classes of types, used by isa<>, cast<> and dyn_cast<>.
+    enum class Class : u8 {
+        DeferredType, BuiltinType, FunctionType,
+        PointerType, StructType, EnumType,
+    };
+
 protected:
     friend class Root;
 
@@ -33,11 +41,17 @@ protected:
     /// immutable.
     bool mut;
 
+    /// The class of this type.
+    const Class m_class;
+
 public:
-    Type(bool mut = false) : mut(mut) {};
+    Type(Class cls, bool mut = false) : mut(mut), m_class(cls) {};
 
     virtual ~Type() = default;
 
+    /// Returns the class of this type.
+    Class get_class() const { return m_class; }
+
     /// Returns true if this type is mutable.
     bool is_mut() const { return mut; }
 
@@ -146,7 +160,7 @@ public:
     /// Contextual properties for a type reference, resolved during parsing.
     struct Context final {
         /// The base of this type, i.e. i8 in *i8.
-        std::string base;
+        Symbol base;
 
         /// The location that this type was parsed.
         SourceLocation meta;
@@ -169,9 +183,14 @@ private:
     const Type* m_resolved = nullptr;
 
     /// Private constructor for the type context.
-    DeferredType(const Context& context) : m_context(context) {};
+    DeferredType(const Context& context)
+        : Type(Class::DeferredType), m_context(context) {};
 
 public:
+    static bool classof(const Type* type) {
+        return type->get_class() == Class::DeferredType;
+    }
+
     /// Get a deferred type with properties |context|.
     static const DeferredType* get(Root& root, const Context& context);
 
@@ -305,9 +324,13 @@ private:
     Kind m_kind;
 
     /// Private constructor for the type context.
-    BuiltinType(Kind kind) : m_kind(kind) {}
+    BuiltinType(Kind kind) : Type(Class::BuiltinType), m_kind(kind) {}
 
 public:
+    static bool classof(const Type* type) {
+        return type->get_class() == Class::BuiltinType;
+    }
+
     /// Get the built-in type of the given kind.
     static const BuiltinType* get(Root& root, Kind kind);
 
@@ -359,9 +382,13 @@ class FunctionType final : public Type {
 
     /// Private constructor for the type context.
     FunctionType(const Type* ret, const std::vector<const Type*>& params)
-        : Type(false), m_ret(ret), m_params(params) {}
+        : Type(Class::FunctionType), m_ret(ret), m_params(params) {}
 
 public:
+    static bool classof(const Type* type) {
+        return type->get_class() == Class::FunctionType;
+    }
+
     /// Get the function type with return type |ret| and parameter list 
     /// |params|.
     static const FunctionType* get(Root& root, const Type *ret, 
@@ -398,9 +425,14 @@ class PointerType final : public Type {
     const Type* m_pointee;
 
     /// Private constructor for the type context.
-    PointerType(const Type* pointee) : m_pointee(pointee) {}
+    PointerType(const Type* pointee)
+        : Type(Class::PointerType), m_pointee(pointee) {}
 
 public:
+    static bool classof(const Type* type) {
+        return type->get_class() == Class::PointerType;
+    }
+
     /// Get the pointer type that encapsulates |pointee|.
     static const PointerType* get(Root& root, const Type* pointee);
 
@@ -433,11 +465,15 @@ class StructType final : public Type {
 
     /// Private constructor for the type context.
     StructType(const std::vector<const Type*>& fields, const StructDecl* decl)
-        : m_fields(fields), m_decl(decl) {};
+        : Type(Class::StructType), m_fields(fields), m_decl(decl) {};
 
 public:
+    static bool classof(const Type* type) {
+        return type->get_class() == Class::StructType;
+    }
+
     /// Get an existing struct type by name, if one exists.
-    static const StructType* get(Root& root, const std::string& name);
+    static const StructType* get(Root& root, Symbol name);
 
     /// Create a new struct type with the given field types.
     static const StructType* create(
@@ -475,11 +511,15 @@ class EnumType final : public Type {
     
     /// Private constructor for the type context.
     EnumType(const Type* underlying, const EnumDecl* decl)
-        : m_underlying(underlying), m_decl(decl) {};
+        : Type(Class::EnumType), m_underlying(underlying), m_decl(decl) {};
 
 public:
+    static bool classof(const Type* type) {
+        return type->get_class() == Class::EnumType;
+    }
+
     /// Get an existing enum type by name, if one exists.
-    static const EnumType* get(Root& root, const std::string& name);
+    static const EnumType* get(Root& root, Symbol name);
 
     /// Create a new enum type with the given underlying type.
     static const EnumType* create(Root& root, const Type* underlying,
@@ -219,11 +219,11 @@ class Codegen final : public Visitor {
     siir::BasicBlock* m_merge = nullptr;
     
     /// Stores cached results of the `mangle` function.
-    std::unordered_map<const Decl*, std::string> m_mangled;
+    std::unordered_map<const Decl*, Symbol> m_mangled;
 
     /// Mangle the name of \p decl as per its runes, and cache it for later
     /// references.
-    const std::string& mangle(const Decl* decl);
+    Symbol mangle(const Decl* decl);
 
     /// Fetch or create a runtime function with the given name and function 
     /// signature |type| as an SIIR empty function.
@@ -0,0 +1,40 @@
+#include "types/arena.hpp"
+
+#include <cstdlib>
+
+using namespace stm;
+
+void Arena::grow(u64 size, u64 align) {
+    // Oversized requests get a chunk of their own, so that the rest of the
+    // current chunk is not wasted on them.
+    u64 needed = sizeof(Chunk) + size + align;
+    u64 chunk_size = needed > CHUNK_SIZE / 4 ? needed : CHUNK_SIZE;
+
+    Chunk* chunk = static_cast<Chunk*>(std::malloc(chunk_size));
+    if (!chunk)
+        throw std::bad_alloc();
+
+    chunk->next = m_chunks;
+    chunk->size = chunk_size;
+    m_chunks = chunk;
+
+    m_ptr = reinterpret_cast<char*>(chunk + 1);
+    m_end = reinterpret_cast<char*>(chunk) + chunk_size;
+}
+
+void Arena::reset() {
+    for (Finalizer* fin = m_finalizers; fin; fin = fin->next)
+        fin->destroy(fin->object);
+
+    m_finalizers = nullptr;
+
+    while (m_chunks) {
+        Chunk* next = m_chunks->next;
+        std::free(m_chunks);
+        m_chunks = next;
+    }
+
+    m_ptr = m_end = nullptr;
+    m_bytes = 0;
+    m_objects = 0;
+}
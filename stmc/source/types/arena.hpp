@@ -0,0 +1,169 @@
+#ifndef STATIM_ARENA_HPP_
+#define STATIM_ARENA_HPP_
+
+#include "types/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stm {
+
+/// A bump allocator for objects that all share the same lifetime.
+///
+/// Memory is carved out of large chunks, so that objects created together sit
+/// next to each other and creating one is usually just a pointer bump. Objects
+/// are never freed individually; instead, the whole arena is released at once
+/// when it is reset or destroyed.
+///
+/// Objects with non-trivial destructors are still destroyed when the arena is,
+/// in reverse order of creation, so that any memory they own elsewhere is not
+/// leaked. Destructors must not try to destroy other objects in the arena.
+class Arena final {
+    /// The header of each chunk of memory owned by an arena.
+    struct Chunk final {
+        Chunk* next;
+        u64 size;
+    };
+
+    /// A pending destructor call for an object in the arena. These are kept in
+    /// the arena itself, right before the object they destroy.
+    struct Finalizer final {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    /// The default size of each chunk, including its header.
+    static constexpr u64 CHUNK_SIZE = 64 * 1024;
+
+    Chunk* m_chunks = nullptr;
+    char* m_ptr = nullptr;
+    char* m_end = nullptr;
+    Finalizer* m_finalizers = nullptr;
+    u64 m_bytes = 0;
+    u64 m_objects = 0;
+
+    /// Allocate a new chunk that fits at least |size| bytes at |align|, and
+    /// bump out of it from now on.
+    void grow(u64 size, u64 align);
+
+public:
+    Arena() = default;
+
+    Arena(const Arena&) = delete;
+    Arena& operator = (const Arena&) = delete;
+
+    ~Arena() { reset(); }
+
+    /// Returns |size| bytes of uninitialized memory aligned to |align|, which
+    /// must be a power of two.
+    void* allocate(u64 size, u64 align) {
+        char* ptr = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(m_ptr) + align - 1) & ~(align - 1));
+
+        if (!m_ptr || ptr + size > m_end) {
+            grow(size, align);
+            ptr = reinterpret_cast<char*>(
+                (reinterpret_cast<uintptr_t>(m_ptr) + align - 1)
+                    & ~(align - 1));
+        }
+
+        m_ptr = ptr + size;
+        m_bytes += size;
+        return ptr;
+    }
+
+    /// Create a new object of type T in this arena with |args|.
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        m_objects++;
+
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            return ::new (allocate(sizeof(T), alignof(T)))
+                T(std::forward<Args>(args)...);
+        } else {
+            Finalizer* fin = static_cast<Finalizer*>(
+                allocate(sizeof(Finalizer), alignof(Finalizer)));
+            T* obj = ::new (allocate(sizeof(T), alignof(T)))
+                T(std::forward<Args>(args)...);
+
+            *fin = Finalizer {
+                [](void* ptr) { static_cast<T*>(ptr)->~T(); },
+                obj,
+                m_finalizers
+            };
+            m_finalizers = fin;
+            return obj;
+        }
+    }
+
+    /// Destroy every object in this arena and release all of its memory.
+    void reset();
+
+    /// Returns the number of bytes handed out by this arena.
+    u64 bytes() const { return m_bytes; }
+
+    /// Returns the number of objects created in this arena.
+    u64 objects() const { return m_objects; }
+};
+
+/// An allocator for containers whose elements share the lifetime of an arena.
+///
+/// Memory is only released with the arena, so a container that grows leaves
+/// its old storage behind. An allocator without an arena falls back to the
+/// global heap, so that containers built outside of one still work.
+///
+/// Copies of a container are made on the heap, since an arena is not safe to
+/// allocate from on more than one thread, and a copy may be made on another
+/// thread than the one that owns the arena. Containers are moved into place
+/// to keep their storage in the arena.
+template<typename T>
+class ArenaAllocator {
+    template<typename U> friend class ArenaAllocator;
+
+    Arena* m_arena = nullptr;
+
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() = default;
+    ArenaAllocator(Arena& arena) : m_arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+    T* allocate(std::size_t n) {
+        if (!m_arena)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) {
+        if (!m_arena)
+            ::operator delete(ptr);
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+
+    template<typename U>
+    bool operator == (const ArenaAllocator<U>& other) const {
+        return m_arena == other.m_arena;
+    }
+};
+
+/// A vector whose storage lives in an arena.
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace stm
+
+#endif // STATIM_ARENA_HPP_
@@ -0,0 +1,44 @@
+#ifndef STATIM_CASTING_HPP_
+#define STATIM_CASTING_HPP_
+
+#include <cassert>
+#include <type_traits>
+
+namespace stm {
+
+/// Checked casts over class hierarchies that carry their own kind tag.
+///
+/// A hierarchy opts in by storing the kind of each object in its base class,
+/// and giving every class a static classof() that tells from that kind whether
+/// an object is an instance of the class. The casts below then compile down to
+/// a compare of the kind, rather than the walk over type info that a
+/// dynamic_cast does. Each cast keeps the constness of its argument.
+
+/// Returns true if |value| is an instance of To. |value| cannot be null.
+template<typename To, typename From>
+inline bool isa(const From* value) {
+    assert(value && "isa<> used on a null pointer!");
+    return std::remove_cv_t<To>::classof(value);
+}
+
+/// Returns |value| as a To. Fails if |value| is not an instance of To.
+template<typename To, typename From>
+inline auto cast(From* value) {
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+
+    assert(isa<To>(value) && "cast<> to an incompatible type!");
+    return static_cast<Result*>(value);
+}
+
+/// Returns |value| as a To if it is an instance of To, and null otherwise.
+/// Like dynamic_cast, a null |value| gives back null.
+template<typename To, typename From>
+inline auto dyn_cast(From* value) {
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+
+    return value && isa<To>(value) ? static_cast<Result*>(value) : nullptr;
+}
+
+} // namespace stm
+
+#endif // STATIM_CASTING_HPP_
@@ -4,11 +4,18 @@
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/operations.hpp>
 
-#include <fstream>
-#include <ios>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace stm;
 
+InputFile::~InputFile() {
+    if (m_map)
+        ::munmap(const_cast<char*>(m_map), m_map_size);
+}
+
 const std::string& InputFile::filename() const {
     if (!m_name.empty())
         return m_name;
@@ -29,33 +36,45 @@ const std::string& InputFile::absolute() const {
     return (m_absolute = boost::filesystem::absolute(path).string());
 }
 
-const std::string& InputFile::source() const {
+std::string_view InputFile::source() const {
     if (!m_source.empty())
         return m_source;
 
-    // Get the m_absoluteute path for the provided file.
-    std::string absolute;
+    if (m_map)
+        return std::string_view(m_map, m_map_size);
+
     try {
-        absolute = boost::filesystem::canonical(path).string();
+        boost::filesystem::canonical(path);
     } catch (const boost::filesystem::filesystem_error& err) {
         Logger::fatal("file does not exist: '" + std::string(path) + "'");
     }
 
-    try {
-        // Read in the contents of the file to the source string.
-        auto size = boost::filesystem::file_size(path);
-        m_source.resize(size);
-
-        std::ifstream file(path, std::ios::binary);
-        if (!file)
-            Logger::fatal("failed to opeh source file: '" + std::string(path) + "'");
-
-        file.read(m_source.data(), size);
-        if (file.gcount() != static_cast<std::streamsize>(size))
-            Logger::fatal("failed to read source file: '" + std::string(path) + "'");
-    } catch (const std::exception& e) {
-        Logger::fatal("failed to parse source file: '" + std::string(path) + "'");
+    i32 fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        Logger::fatal("failed to open source file: '" + std::string(path) + "'");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        Logger::fatal("failed to read source file: '" + std::string(path) + "'");
     }
 
-    return m_source;
+    // Empty files cannot be mapped, but they also have nothing to lex.
+    if (st.st_size == 0) {
+        ::close(fd);
+        return {};
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (map == MAP_FAILED)
+        Logger::fatal("failed to map source file: '" + std::string(path) + "'");
+
+    // Sources are lexed front to back exactly once.
+    ::madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    m_map = static_cast<const char*>(map);
+    m_map_size = st.st_size;
+    return std::string_view(m_map, m_map_size);
 }
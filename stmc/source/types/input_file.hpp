@@ -1,7 +1,10 @@
 #ifndef STATIM_INPUT_FILE_HPP_
 #define STATIM_INPUT_FILE_HPP_
 
+#include "types.hpp"
+
 #include <string>
+#include <string_view>
 #include <cstring>
 
 namespace stm {
@@ -14,6 +17,11 @@ struct InputFile final {
 
     InputFile(const char* path) : path(path) {}
 
+    InputFile(const InputFile&) = delete;
+    InputFile& operator = (const InputFile&) = delete;
+
+    ~InputFile();
+
     bool operator == (const InputFile& other) const {
         return std::strcmp(path, other.path) == 0;
     }
@@ -22,7 +30,17 @@ private:
     mutable std::string m_name = "";
     mutable std::string m_absolute = "";
     mutable std::string m_source = "";
-    
+
+    /// The read-only mapping of this file's contents, if it has been mapped.
+    mutable const char* m_map = nullptr;
+    mutable u64 m_map_size = 0;
+
+    /// The id given to this file by the source manager, or 0 if it has not
+    /// been registered yet.
+    mutable u32 m_id = 0;
+
+    friend class SourceManager;
+
 public:
     /// Get the filename for this input file.
     const std::string& filename() const;
@@ -30,14 +48,19 @@ public:
     /// Get the absolute path for this input file.
     const std::string& absolute() const;
 
-    /// Get the source code of this input file as a string.
-    const std::string& source() const;
+    /// Get a view of the source code of this input file. The file is mapped
+    /// into memory on first use and the view remains valid for the lifetime
+    /// of this input file.
+    std::string_view source() const;
 
     /// Get the source code of this input file between two locations.
     const std::string& source(const Span& span);
 
     /// Overwrite the source of this input file, for devel purposes.
-    void overwrite(const std::string& source) { m_source = source; }
+    void overwrite(const std::string& source) { 
+        m_source = source;
+        m_id = 0;
+    }
 };
 
 } // namespace stm
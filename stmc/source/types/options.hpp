@@ -9,6 +9,14 @@ namespace stm {
 struct Options final {
     const char* output;
     u8 opt_level;
+
+    /// The number of threads to compile with, or 0 for one per hardware
+    /// thread.
+    u32 jobs;
+
+    /// The directory of the object cache, or null if caching is disabled.
+    const char* cache_dir;
+
     u8 debug:1;
     u8 devel:1;
     u8 dump_ast:1;
@@ -21,6 +29,13 @@ struct Options final {
     u8 llvm:1;
     u8 nostd:1;
     u8 time:1;
+
+    /// If set along with |time|, the timing report is written as JSON.
+    u8 time_json:1;
+
+    /// The file to write a trace of the compilation to, or null if it is not
+    /// traced.
+    const char* trace;
 };
 
 } // namespace stm
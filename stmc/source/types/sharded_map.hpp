@@ -0,0 +1,90 @@
+#ifndef STATIM_SHARDED_MAP_HPP_
+#define STATIM_SHARDED_MAP_HPP_
+
+#include "types/types.hpp"
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace stm {
+
+/// An insert-only hash map that many threads can look up and insert into at
+/// once.
+///
+/// Entries are spread over a fixed number of shards by the hash of their key,
+/// each of which is a plain map behind its own reader-writer lock, so threads
+/// only contend when they touch the same shard. Lookups that hit only take a
+/// shared lock. Entries cannot be removed individually.
+template<typename K, typename V, typename Hash = std::hash<K>>
+class ShardedMap final {
+    /// The number of shards in each map. Must be a power of two.
+    static constexpr u32 SHARDS = 16;
+
+    /// A single shard, padded out to its own cache line so that locking one
+    /// shard does not bounce the lines of its neighbours.
+    struct alignas(64) Shard final {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<K, V, Hash> map;
+    };
+
+    std::array<Shard, SHARDS> m_shards = {};
+
+    /// Returns the shard that |key| belongs to.
+    Shard& shard_of(const K& key) {
+        // Mix the hash first, since std::hash is the identity for integers
+        // and pointers, whose low bits are often all the same.
+        u64 hash = static_cast<u64>(Hash {}(key)) * 0x9E3779B97F4A7C15ull;
+        return m_shards[hash >> 60 & (SHARDS - 1)];
+    }
+
+public:
+    ShardedMap() = default;
+
+    ShardedMap(const ShardedMap&) = delete;
+    ShardedMap& operator = (const ShardedMap&) = delete;
+
+    /// Returns the value mapped to |key|. If there is none, the value returned
+    /// by |create| is mapped to it first. Even if many threads race to map the
+    /// same key, |create| is only ever called once for it.
+    template<typename F>
+    V get_or_create(const K& key, F&& create) {
+        Shard& shard = shard_of(key);
+        {
+            std::shared_lock<std::shared_mutex> lock { shard.mutex };
+            auto it = shard.map.find(key);
+            if (it != shard.map.end())
+                return it->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock { shard.mutex };
+        auto it = shard.map.find(key);
+        if (it != shard.map.end())
+            return it->second;
+
+        return shard.map.emplace(key, create()).first->second;
+    }
+
+    /// Call |fn| with each key and value in this map, in no particular order.
+    /// This must not race with any insertions.
+    template<typename F>
+    void for_each(F&& fn) const {
+        for (const Shard& shard : m_shards)
+            for (const auto& [ key, value ] : shard.map)
+                fn(key, value);
+    }
+
+    /// Remove every entry in this map. This must not race with any other use
+    /// of the map.
+    void clear() {
+        for (Shard& shard : m_shards)
+            shard.map.clear();
+    }
+};
+
+} // namespace stm
+
+#endif // STATIM_SHARDED_MAP_HPP_
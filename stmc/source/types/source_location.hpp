@@ -5,28 +5,36 @@
 
 namespace stm {
 
-struct InputFile;
-
 /// A location in source code.
+///
+/// Locations are offsets into a single space shared by the sources of every
+/// input file, as handed out by the SourceManager. The file, line and column
+/// of a location are recovered through the manager when they are needed.
+/// Offset 0 is reserved for an unknown location.
 struct SourceLocation final {
-    InputFile& file;
-    u32 line;
-    u32 column;
+    u32 offset = 0;
+
+    SourceLocation() = default;
+
+    explicit SourceLocation(u32 offset) : offset(offset) {}
 
-    SourceLocation(InputFile& file, u32 line, u32 column) 
-        : file(file), line(line), column(column) {}
+    /// Returns true if this location points into a source file.
+    bool is_valid() const { return offset != 0; }
 
     bool operator == (const SourceLocation& other) const {
-        return &file == &other.file && line == other.line 
-          && column == other.column;
+        return offset == other.offset;
+    }
+
+    bool operator != (const SourceLocation& other) const {
+        return offset != other.offset;
     }
 
     bool operator < (const SourceLocation& other) const {
-        return line < other.line && column < other.column;
+        return offset < other.offset;
     }
 
     bool operator > (const SourceLocation& other) const {
-        return line > other.line && column > other.column;
+        return offset > other.offset;
     }
 };
 
@@ -36,6 +44,7 @@ struct Span final {
     SourceLocation end;
 
     Span(const Span&) = default;
+    Span& operator = (const Span&) = default;
 
     Span(const SourceLocation& loc) : begin(loc), end(loc) {}
 
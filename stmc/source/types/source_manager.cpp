@@ -0,0 +1,147 @@
+#include "core/logger.hpp"
+#include "core/scan.hpp"
+#include "types/input_file.hpp"
+#include "types/source_manager.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+using namespace stm;
+
+namespace {
+
+/// A source file registered with the manager.
+struct SourceFile final {
+    const InputFile* file;
+    std::string_view source;
+
+    /// The first location in this file's range. The range also covers the
+    /// position just past the end of the source, where end of file is.
+    u32 base;
+
+    /// The offsets of the first character of each line, built on first use.
+    std::vector<u32> lines = {};
+    std::once_flag lines_flag = {};
+
+    SourceFile(const InputFile* file, std::string_view source, u32 base)
+        : file(file), source(source), base(base) {}
+
+    const std::vector<u32>& line_starts() {
+        std::call_once(lines_flag, [this]() {
+            const char* buf = source.data();
+            const u32 size = source.size();
+
+            lines.reserve(size / 32 + 1);
+            lines.push_back(0);
+            for (u32 pos = scan::find(buf, 0, size, '\n'); pos != size; 
+              pos = scan::find(buf, pos + 1, size, '\n'))
+                lines.push_back(pos + 1);
+        });
+
+        return lines;
+    }
+
+    /// Returns the index of the line that |pos| is on.
+    u32 line_index(u32 pos) {
+        const std::vector<u32>& starts = line_starts();
+        return std::upper_bound(starts.begin(), starts.end(), pos) 
+            - starts.begin() - 1;
+    }
+};
+
+/// The global table of source files. Files are never removed, so that any
+/// location handed out stays resolvable.
+class SourceTable final {
+    std::deque<SourceFile> m_files = {};
+    mutable std::shared_mutex m_mutex;
+
+    /// The start of the next range to hand out. Offset 0 is reserved.
+    u64 m_next = 1;
+
+public:
+    u32 add(const InputFile& file, std::string_view source, u32& id) {
+        std::unique_lock lock { m_mutex };
+        if (id != 0)
+            return id;
+
+        if (m_next + source.size() + 1 > UINT32_MAX)
+            Logger::fatal("source files exceed the location space");
+
+        m_files.emplace_back(&file, source, m_next);
+        m_next += source.size() + 1;
+        return (id = m_files.size());
+    }
+
+    SourceFile& get(u32 id) {
+        std::shared_lock lock { m_mutex };
+        assert(id != 0 && id <= m_files.size() && "source id out of range!");
+        return m_files[id - 1];
+    }
+
+    SourceFile& get(SourceLocation loc) {
+        assert(loc.is_valid() && "cannot resolve an unknown location!");
+
+        std::shared_lock lock { m_mutex };
+        auto it = std::upper_bound(m_files.begin(), m_files.end(), loc.offset,
+            [](u32 offset, const SourceFile& file) { 
+                return offset < file.base; 
+            });
+
+        assert(it != m_files.begin() && "location is not in any file!");
+        return *(it - 1);
+    }
+};
+
+} // namespace
+
+/// Returns the global source table, created on first use.
+static SourceTable& table() {
+    static SourceTable instance;
+    return instance;
+}
+
+u32 SourceManager::add(const InputFile& file) {
+    if (file.m_id != 0)
+        return file.m_id;
+
+    return table().add(file, file.source(), file.m_id);
+}
+
+SourceLocation SourceManager::location(u32 id, u32 pos) {
+    const SourceFile& file = table().get(id);
+    assert(pos <= file.source.size() && "position is not in the file!");
+    return SourceLocation(file.base + pos);
+}
+
+const InputFile& SourceManager::file(SourceLocation loc) {
+    return *table().get(loc).file;
+}
+
+u32 SourceManager::line(SourceLocation loc) {
+    SourceFile& file = table().get(loc);
+    return file.line_index(loc.offset - file.base) + 1;
+}
+
+u32 SourceManager::column(SourceLocation loc) {
+    SourceFile& file = table().get(loc);
+    const u32 pos = loc.offset - file.base;
+    return pos - file.line_starts()[file.line_index(pos)] + 1;
+}
+
+std::string_view SourceManager::line_source(SourceLocation loc, u32 line) {
+    SourceFile& file = table().get(loc);
+    const std::vector<u32>& starts = file.line_starts();
+    assert(line != 0 && line <= starts.size() && "line out of range!");
+
+    const u32 begin = starts[line - 1];
+    u32 end = line < starts.size() ? starts[line] - 1 : file.source.size();
+    return file.source.substr(begin, end - begin);
+}
+
+u32 SourceManager::line_count(SourceLocation loc) {
+    return table().get(loc).line_starts().size();
+}
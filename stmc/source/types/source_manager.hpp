@@ -0,0 +1,50 @@
+#ifndef STATIM_SOURCE_MANAGER_HPP_
+#define STATIM_SOURCE_MANAGER_HPP_
+
+#include "types/source_location.hpp"
+#include "types/types.hpp"
+
+#include <string_view>
+
+namespace stm {
+
+struct InputFile;
+
+/// The global registry of source files.
+///
+/// Each input file is given a small id and a range of the location space that
+/// covers every position in its source, so that a location fits in 32 bits
+/// regardless of which file it points into. Lines and columns are not tracked
+/// while lexing; instead, a table of line starts is built for a file the first
+/// time a location in it is resolved, which is usually for a diagnostic.
+class SourceManager final {
+public:
+    SourceManager() = delete;
+
+    /// Returns the id of |file|, registering its current source on first use.
+    /// Overwriting the source of a file registers it again under a new id.
+    static u32 add(const InputFile& file);
+
+    /// Returns the location of position |pos| in the source of file |id|.
+    static SourceLocation location(u32 id, u32 pos);
+
+    /// Returns the file that |loc| points into.
+    static const InputFile& file(SourceLocation loc);
+
+    /// Returns the 1-based line number of |loc| in its file.
+    static u32 line(SourceLocation loc);
+
+    /// Returns the 1-based column number of |loc| on its line.
+    static u32 column(SourceLocation loc);
+
+    /// Returns the source of line number |line| in the file that |loc| points
+    /// into, without its line terminator. |line| must be in range.
+    static std::string_view line_source(SourceLocation loc, u32 line);
+
+    /// Returns the number of lines in the file that |loc| points into.
+    static u32 line_count(SourceLocation loc);
+};
+
+} // namespace stm
+
+#endif // STATIM_SOURCE_MANAGER_HPP_
@@ -0,0 +1,111 @@
+#include "types/symbol.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace stm;
+
+namespace {
+
+/// The global table of interned strings.
+///
+/// Strings are stored in fixed-size pages that never move, so that a symbol
+/// can be resolved to its string without taking a lock. Lookups by string go
+/// through a hash map guarded by a reader-writer lock, since nearly all of
+/// them find an existing symbol.
+class SymbolTable final {
+    static constexpr u32 PAGE_BITS = 12;
+    static constexpr u32 PAGE_SIZE = 1 << PAGE_BITS;
+    static constexpr u32 MAX_PAGES = 1 << 12;
+
+    using Page = std::string[PAGE_SIZE];
+
+    std::atomic<Page*> m_pages[MAX_PAGES] = {};
+    std::unordered_map<std::string_view, u32> m_ids = {};
+    mutable std::shared_mutex m_mutex;
+    std::atomic<u32> m_count = 0;
+    std::atomic<u64> m_bytes = 0;
+
+public:
+    SymbolTable() {
+        // Reserve id 0 for the empty string.
+        m_pages[0].store(new Page[1]);
+        m_count.store(1);
+    }
+
+    ~SymbolTable() {
+        for (auto& page : m_pages)
+            delete[] page.load();
+    }
+
+    u32 intern(std::string_view str) {
+        if (str.empty())
+            return 0;
+
+        {
+            std::shared_lock lock { m_mutex };
+            auto it = m_ids.find(str);
+            if (it != m_ids.end())
+                return it->second;
+        }
+
+        std::unique_lock lock { m_mutex };
+        auto it = m_ids.find(str);
+        if (it != m_ids.end())
+            return it->second;
+
+        const u32 id = m_count.load(std::memory_order_relaxed);
+        const u32 page = id >> PAGE_BITS;
+        assert(page < MAX_PAGES && "exhausted symbol table!");
+
+        if (!m_pages[page].load(std::memory_order_relaxed))
+            m_pages[page].store(new Page[1], std::memory_order_release);
+
+        std::string& entry = (*m_pages[page].load())[id & (PAGE_SIZE - 1)];
+        entry = str;
+        m_ids.emplace(entry, id);
+        m_bytes += sizeof(std::string) + entry.capacity() + sizeof(u32) +
+            sizeof(std::string_view);
+
+        m_count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    const std::string& get(u32 id) const {
+        assert(id < m_count.load(std::memory_order_acquire) &&
+            "symbol id out of range!");
+
+        Page* page = m_pages[id >> PAGE_BITS].load(std::memory_order_acquire);
+        return (*page)[id & (PAGE_SIZE - 1)];
+    }
+
+    u32 count() const { return m_count.load(); }
+
+    u64 memory() const { return m_bytes.load(); }
+};
+
+} // namespace
+
+/// Returns the global symbol table, created on first use.
+static SymbolTable& table() {
+    static SymbolTable instance;
+    return instance;
+}
+
+Symbol::Symbol(std::string_view str) : m_id(table().intern(str)) {}
+
+const std::string& Symbol::str() const {
+    return table().get(m_id);
+}
+
+u32 Symbol::count() {
+    return table().count();
+}
+
+u64 Symbol::memory() {
+    return table().memory();
+}
@@ -0,0 +1,73 @@
+#ifndef STATIM_SYMBOL_HPP_
+#define STATIM_SYMBOL_HPP_
+
+#include "types.hpp"
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace stm {
+
+/// An interned string, represented by a 32-bit id into a global string table
+/// that is shared by every translation unit.
+///
+/// Interning a string hashes it once, after which symbols compare, hash and
+/// copy as integers. The string table is safe to use from multiple threads,
+/// and the strings it holds live for the rest of the program.
+class Symbol final {
+    u32 m_id = 0;
+
+public:
+    /// Create the empty symbol.
+    Symbol() = default;
+
+    /// Intern |str| and create a symbol for it.
+    Symbol(std::string_view str);
+    Symbol(const std::string& str) : Symbol(std::string_view(str)) {}
+    Symbol(const char* str) : Symbol(std::string_view(str)) {}
+
+    /// Returns the id of this symbol. The empty symbol always has id 0.
+    u32 id() const { return m_id; }
+
+    /// Returns true if this is the empty symbol.
+    bool empty() const { return m_id == 0; }
+
+    /// Returns the string this symbol was interned from.
+    const std::string& str() const;
+
+    operator const std::string& () const { return str(); }
+
+    bool operator == (const Symbol& other) const { return m_id == other.m_id; }
+    bool operator != (const Symbol& other) const { return m_id != other.m_id; }
+
+    /// Returns the number of distinct symbols interned so far.
+    static u32 count();
+
+    /// Returns the number of bytes held by the global string table.
+    static u64 memory();
+};
+
+inline std::ostream& operator << (std::ostream& os, const Symbol& sym) {
+    return os << sym.str();
+}
+
+inline std::string operator + (const std::string& lhs, const Symbol& rhs) {
+    return lhs + rhs.str();
+}
+
+inline std::string operator + (const char* lhs, const Symbol& rhs) {
+    return lhs + rhs.str();
+}
+
+} // namespace stm
+
+template<>
+struct std::hash<stm::Symbol> {
+    std::size_t operator () (const stm::Symbol& sym) const noexcept {
+        return sym.id();
+    }
+};
+
+#endif // STATIM_SYMBOL_HPP_
@@ -0,0 +1,175 @@
+#ifndef STATIM_SYMBOL_MAP_HPP_
+#define STATIM_SYMBOL_MAP_HPP_
+
+#include "types/symbol.hpp"
+#include "types/types.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace stm {
+
+/// A flat hash map keyed on symbols.
+///
+/// Entries are stored inline in a single open-addressed array with linear
+/// probing, so lookups are an integer hash and a short scan over contiguous
+/// memory. The empty symbol cannot be used as a key.
+template<typename V>
+class SymbolMap final {
+public:
+    using Entry = std::pair<Symbol, V>;
+
+private:
+    std::vector<Entry> m_slots = {};
+    u32 m_size = 0;
+
+    /// Returns the slot that |sym| hashes to in a table of |cap| slots.
+    static u32 slot_of(Symbol sym, u32 cap) {
+        // Fibonacci hashing spreads sequential ids across the table.
+        return (u32(sym.id() * 2654435769u) >> 8) & (cap - 1);
+    }
+
+    void grow() {
+        std::vector<Entry> old = std::move(m_slots);
+        m_slots.clear();
+        m_slots.resize(old.empty() ? 16 : old.size() * 2);
+
+        const u32 cap = m_slots.size();
+        for (Entry& entry : old) {
+            if (entry.first.empty())
+                continue;
+
+            u32 idx = slot_of(entry.first, cap);
+            while (!m_slots[idx].first.empty())
+                idx = (idx + 1) & (cap - 1);
+
+            m_slots[idx] = std::move(entry);
+        }
+    }
+
+    const Entry* find_entry(Symbol sym) const {
+        if (m_slots.empty())
+            return nullptr;
+
+        const u32 cap = m_slots.size();
+        for (u32 idx = slot_of(sym, cap); ; idx = (idx + 1) & (cap - 1)) {
+            const Entry& entry = m_slots[idx];
+            if (entry.first == sym)
+                return &entry;
+            else if (entry.first.empty())
+                return nullptr;
+        }
+    }
+
+public:
+    /// Returns the number of entries in this map.
+    u32 size() const { return m_size; }
+
+    /// Returns true if this map has no entries.
+    bool empty() const { return m_size == 0; }
+
+    /// Returns a pointer to the value mapped to |sym|, or null if there is
+    /// none. The pointer is invalidated by any insertion or removal.
+    const V* find(Symbol sym) const {
+        const Entry* entry = find_entry(sym);
+        return entry ? &entry->second : nullptr;
+    }
+
+    V* find(Symbol sym) {
+        return const_cast<V*>(static_cast<const SymbolMap*>(this)->find(sym));
+    }
+
+    /// Returns true if this map has a value for |sym|.
+    bool contains(Symbol sym) const { return find_entry(sym) != nullptr; }
+
+    /// Maps |sym| to |value|. Returns false and leaves this map unchanged if
+    /// |sym| is already mapped.
+    bool insert(Symbol sym, V value) {
+        assert(!sym.empty() && "cannot map the empty symbol!");
+
+        if ((m_size + 1) * 4 > m_slots.size() * 3)
+            grow();
+
+        const u32 cap = m_slots.size();
+        u32 idx = slot_of(sym, cap);
+        for (; !m_slots[idx].first.empty(); idx = (idx + 1) & (cap - 1)) {
+            if (m_slots[idx].first == sym)
+                return false;
+        }
+
+        m_slots[idx] = Entry { sym, std::move(value) };
+        m_size++;
+        return true;
+    }
+
+    /// Remove the value mapped to |sym|, if there is one. Returns true if a
+    /// value was removed.
+    bool erase(Symbol sym) {
+        Entry* entry = const_cast<Entry*>(find_entry(sym));
+        if (!entry)
+            return false;
+
+        // Shift back any entries in the same probe run so that lookups never
+        // stop short at the vacated slot.
+        const u32 cap = m_slots.size();
+        u32 hole = entry - m_slots.data();
+        for (u32 idx = (hole + 1) & (cap - 1); !m_slots[idx].first.empty();
+          idx = (idx + 1) & (cap - 1)) {
+            u32 home = slot_of(m_slots[idx].first, cap);
+            if (((idx - home) & (cap - 1)) >= ((idx - hole) & (cap - 1))) {
+                m_slots[hole] = std::move(m_slots[idx]);
+                hole = idx;
+            }
+        }
+
+        m_slots[hole] = Entry {};
+        m_size--;
+        return true;
+    }
+
+    /// Remove all entries from this map.
+    void clear() {
+        m_slots.clear();
+        m_size = 0;
+    }
+
+    /// Calls |fn| with the symbol and value of each entry in this map, in no
+    /// particular order.
+    template<typename F>
+    void for_each(F&& fn) const {
+        for (const Entry& entry : m_slots) {
+            if (!entry.first.empty())
+                fn(entry.first, entry.second);
+        }
+    }
+
+    /// Returns the values in this map, ordered by the strings of their
+    /// symbols. This is how to iterate a map where the output must be
+    /// reproducible.
+    std::vector<V> sorted() const {
+        std::vector<const Entry*> entries;
+        entries.reserve(m_size);
+        for (const Entry& entry : m_slots) {
+            if (!entry.first.empty())
+                entries.push_back(&entry);
+        }
+
+        std::sort(entries.begin(), entries.end(), 
+            [](const Entry* lhs, const Entry* rhs) {
+                return lhs->first.str() < rhs->first.str();
+            });
+
+        std::vector<V> values;
+        values.reserve(m_size);
+        for (const Entry* entry : entries)
+            values.push_back(entry->second);
+
+        return values;
+    }
+};
+
+} // namespace stm
+
+#endif // STATIM_SYMBOL_MAP_HPP_
@@ -59,6 +59,26 @@ std::string stm::token_kind_to_string(TokenKind kind) {
         case TOKEN_KIND_FLOAT: return "float";
         case TOKEN_KIND_CHARACTER: return "character";
         case TOKEN_KIND_STRING: return "string";
+        case TOKEN_KIND_ASM: return "__asm__";
+        case TOKEN_KIND_BREAK: return "break";
+        case TOKEN_KIND_CAST: return "cast";
+        case TOKEN_KIND_CONTINUE: return "continue";
+        case TOKEN_KIND_ELSE: return "else";
+        case TOKEN_KIND_ENUM: return "enum";
+        case TOKEN_KIND_FALSE: return "false";
+        case TOKEN_KIND_IF: return "if";
+        case TOKEN_KIND_LET: return "let";
+        case TOKEN_KIND_MUT: return "mut";
+        case TOKEN_KIND_NULL: return "null";
+        case TOKEN_KIND_PRIVATE: return "private";
+        case TOKEN_KIND_PUBLIC: return "public";
+        case TOKEN_KIND_RET: return "ret";
+        case TOKEN_KIND_SIZEOF: return "sizeof";
+        case TOKEN_KIND_STRUCT: return "struct";
+        case TOKEN_KIND_TRUE: return "true";
+        case TOKEN_KIND_USE: return "use";
+        case TOKEN_KIND_VOLATILE: return "volatile";
+        case TOKEN_KIND_WHILE: return "while";
         default: return "unknown";
     }
 }
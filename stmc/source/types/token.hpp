@@ -2,9 +2,11 @@
 #define STATIM_TOKEN_HPP_
 
 #include "source_location.hpp"
+#include "symbol.hpp"
 #include "types.hpp"
 
 #include <string>
+#include <string_view>
 
 namespace stm {
 
@@ -65,23 +67,63 @@ enum TokenKind : u8 {
     TOKEN_KIND_FLOAT,
     TOKEN_KIND_CHARACTER,
     TOKEN_KIND_STRING,
+
+    // Keywords, kept contiguous so they can be tested for as a range.
+    TOKEN_KIND_ASM,
+    TOKEN_KIND_BREAK,
+    TOKEN_KIND_CAST,
+    TOKEN_KIND_CONTINUE,
+    TOKEN_KIND_ELSE,
+    TOKEN_KIND_ENUM,
+    TOKEN_KIND_FALSE,
+    TOKEN_KIND_IF,
+    TOKEN_KIND_LET,
+    TOKEN_KIND_MUT,
+    TOKEN_KIND_NULL,
+    TOKEN_KIND_PRIVATE,
+    TOKEN_KIND_PUBLIC,
+    TOKEN_KIND_RET,
+    TOKEN_KIND_SIZEOF,
+    TOKEN_KIND_STRUCT,
+    TOKEN_KIND_TRUE,
+    TOKEN_KIND_USE,
+    TOKEN_KIND_VOLATILE,
+    TOKEN_KIND_WHILE,
+
+    TOKEN_KIND_FIRST_KEYWORD = TOKEN_KIND_ASM,
+    TOKEN_KIND_LAST_KEYWORD = TOKEN_KIND_WHILE,
 };
 
 std::string token_kind_to_string(TokenKind kind);
 
+/// Returns true if |kind| is the kind of a keyword.
+inline bool is_keyword(TokenKind kind) {
+    return kind >= TOKEN_KIND_FIRST_KEYWORD && kind <= TOKEN_KIND_LAST_KEYWORD;
+}
+
 /// Represents a token lexed from source.
+///
+/// The value of a token is a view into the source buffer of the file it was
+/// lexed from, except for literals with escape sequences, whose value views
+/// storage owned by the lexer for as long as the token stays in its window.
+/// Either way, a value should be copied out if it needs to be kept.
+///
+/// Identifiers are also interned as they are lexed, so that names can be kept
+/// as symbols without copying.
 struct Token final {
-    SourceLocation  loc;
-    TokenKind       kind;
-    std::string     value;
+    SourceLocation      loc;
+    TokenKind           kind;
+    std::string_view    value;
+    Symbol              symbol;
 
     Token(SourceLocation loc, 
           TokenKind kind = TOKEN_KIND_END_OF_FILE, 
-          const std::string& value = "") 
+          std::string_view value = {}) 
         : loc(loc), kind(kind), value(value) {};
 
     bool operator == (const Token& other) const {
-        return kind == other.kind && loc == other.loc && value == other.value;
+        return kind == other.kind && loc == other.loc && value == other.value
+          && symbol == other.symbol;
     }
 };
 
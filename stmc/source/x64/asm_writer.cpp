@@ -1,3 +1,5 @@
+#include "core/thread_pool.hpp"
+#include "core/timer.hpp"
 #include "siir/cfg.hpp"
 #include "siir/constant.hpp"
 #include "siir/global.hpp"
@@ -7,13 +9,13 @@
 #include "x64/x64.hpp"
 
 #include <cmath>
+#include <sstream>
+#include <vector>
 
 using namespace stm;
 using namespace stm::siir;
 using namespace stm::siir::x64;
 
-static u32 g_function_id = 0;
-
 static const char* opc_as_string(x64::Opcode opc) {
     switch (opc) {
     case NOP:         return "nop";
@@ -189,8 +191,9 @@ static bool is_redundant_move(const MachineInst& MI,
     return reg1 == reg2 && oper1.get_subreg() == oper2.get_subreg();
 }
 
-/// Emits the operand |MO| to output stream |os|.
-static void emit_operand(std::ostream& os, const MachineFunction& MF,
+/// Emits the operand |MO| to output stream |os|. Local labels are numbered
+/// by |id|, the position of |MF| in the object.
+static void emit_operand(std::ostream& os, const MachineFunction& MF, u32 id,
                          const MachineOperand& MO) {
     switch (MO.kind()) {
     case MachineOperand::MO_Register: {
@@ -223,7 +226,7 @@ static void emit_operand(std::ostream& os, const MachineFunction& MF,
     }
 
     case MachineOperand::MO_BasicBlock: {
-        os << ".LBB" << g_function_id << '_' << MO.get_mmb()->position();
+        os << ".LBB" << id << '_' << MO.get_mmb()->position();
         break;
     }
 
@@ -232,7 +235,7 @@ static void emit_operand(std::ostream& os, const MachineFunction& MF,
         const FunctionConstantPoolEntry& constant = 
             cpool.entries.at(MO.get_constant_index());
 
-        os << ".LCPI" << g_function_id << '_' << MO.get_constant_index() << 
+        os << ".LCPI" << id << '_' << MO.get_constant_index() << 
             "(%rip)";
         break;
     }
@@ -247,8 +250,8 @@ static void emit_operand(std::ostream& os, const MachineFunction& MF,
     }
 }
 
-static void emit_instruction(std::ostream& os, const MachineFunction& MF,
-                             const MachineInst& MI) {
+static void emit_instruction(std::ostream& os, const MachineFunction& MF, 
+                             u32 id, const MachineInst& MI) {
     // Skip the emission of redundant moves.
     if (is_redundant_move(MI, MF))
         return;
@@ -266,7 +269,7 @@ static void emit_instruction(std::ostream& os, const MachineFunction& MF,
 
     // Emit all explicit operands of the instruction.
     for (u32 idx = 0, e = MI.num_explicit_operands(); idx != e; ++idx) {    
-        emit_operand(os, MF, MI.get_operand(idx));
+        emit_operand(os, MF, id, MI.get_operand(idx));
 
         if (idx + 1 != e)
             os << ", ";
@@ -279,17 +282,17 @@ static void emit_instruction(std::ostream& os, const MachineFunction& MF,
 }
 
 static void emit_basic_block(std::ostream& os, const MachineFunction& MF, 
-                              const MachineBasicBlock& MBB) {
+                             u32 id, const MachineBasicBlock& MBB) {
     if (!MBB.get_basic_block()->has_preds()) {
         // For basic blocks without predecessors (usually only the entry block),
         // only emit a comment instead of the redundant label.
         os << "#bb" << MBB.position() << ":\n";
     } else {
-        os << ".LBB" << g_function_id << '_' << MBB.position() << ":\n";
+        os << ".LBB" << id << '_' << MBB.position() << ":\n";
     }
 
     for (auto& MI : MBB.insts())
-        emit_instruction(os, MF, MI);
+        emit_instruction(os, MF, id, MI);
 }
 
 static void emit_constant(std::ostream& os, const Target& target,
@@ -298,7 +301,7 @@ static void emit_constant(std::ostream& os, const Target& target,
 
     os << "\t.";
 
-    if (auto CI = dynamic_cast<const ConstantInt*>(constant)) {
+    if (auto CI = dyn_cast<ConstantInt>(constant)) {
         switch (size) {
         case 1:
             os << "byte ";
@@ -315,7 +318,7 @@ static void emit_constant(std::ostream& os, const Target& target,
         }
 
         os << CI->get_value();
-    } else if (auto CFP = dynamic_cast<const ConstantFP*>(constant)) {
+    } else if (auto CFP = dyn_cast<ConstantFP>(constant)) {
         switch (size) {
         case 4: {
             os << "long 0x";
@@ -340,9 +343,9 @@ static void emit_constant(std::ostream& os, const Target& target,
         default:
             assert(false && "unsupported SSE floating point size!");
         }
-    } else if (auto CN = dynamic_cast<const ConstantNull*>(constant)) {
+    } else if (auto CN = dyn_cast<ConstantNull>(constant)) {
         os << "quad 0x0";
-    } else if (auto CS = dynamic_cast<const ConstantString*>(constant)) {
+    } else if (auto CS = dyn_cast<ConstantString>(constant)) {
         os << "string \"";
         
         for (u32 idx = 0, e = CS->get_value().size(); idx != e; ++idx) {
@@ -383,7 +386,8 @@ static void emit_constant(std::ostream& os, const Target& target,
     os << '\n';
 }
 
-static void emit_function(std::ostream& os, const MachineFunction& MF) {
+static void emit_function(std::ostream& os, const MachineFunction& MF, 
+                          u32 id) {
     const std::string& name = MF.get_name();
 
     os << "# begin function " << name << '\n';
@@ -402,7 +406,7 @@ static void emit_function(std::ostream& os, const MachineFunction& MF) {
             last_size = size;
         }
 
-        os << ".LCPI" << g_function_id << '_' << idx << ":\n";
+        os << ".LCPI" << id << '_' << idx << ":\n";
         emit_constant(os, MF.get_target(), entry.constant);
     }
 
@@ -423,10 +427,10 @@ static void emit_function(std::ostream& os, const MachineFunction& MF) {
        << "\tsubq\t$" << MF.get_stack_info().alignment() << ", %rsp\n";
 
     for (const auto* MBB = MF.front(); MBB; MBB = MBB->next())
-        emit_basic_block(os, MF, *MBB);
+        emit_basic_block(os, MF, id, *MBB);
 
-    os << ".LFE" << g_function_id << ":\n"
-       << "\t.size\t" << name << ", .LFE" << g_function_id << '-' << name << '\n'
+    os << ".LFE" << id << ":\n"
+       << "\t.size\t" << name << ", .LFE" << id << '-' << name << '\n'
        << "\t.cfi_endproc\n"
        << "# end function " << name << "\n\n";
 }
@@ -451,7 +455,7 @@ static void emit_global(std::ostream& os, const Target& target,
 }
 
 void X64AsmWriter::run(std::ostream& os) const {
-    g_function_id = 0;
+    STM_TIME_SCOPE("asm emission");
 
     os << "\t.file\t\"" << m_obj.get_graph()->get_file().filename() << "\"\n";
 
@@ -459,11 +463,30 @@ void X64AsmWriter::run(std::ostream& os) const {
         emit_global(os, *m_obj.get_target(), global);
     }
 
-    for (const auto& [name, function] : m_obj.functions()) {
-        emit_function(os, *function);
-        g_function_id++;
+    // Functions are emitted into buffers of their own, possibly at the same
+    // time, and then written out in order. The position of each function
+    // decides the names of its local labels.
+    std::vector<const MachineFunction*> functions;
+    functions.reserve(m_obj.functions().size());
+    for (const auto& [name, function] : m_obj.functions())
+        functions.push_back(function);
+
+    std::vector<std::ostringstream> buffers(functions.size());
+    auto emit = [&](u32 idx) {
+        STM_TIME_SCOPE("function", functions[idx]->get_name());
+        emit_function(buffers[idx], *functions[idx], idx);
+    };
+
+    if (m_pool) {
+        m_pool->parallel_for(functions.size(), emit);
+    } else {
+        for (u32 idx = 0; idx != functions.size(); ++idx)
+            emit(idx);
     }
 
+    for (const std::ostringstream& buffer : buffers)
+        os << buffer.view();
+
     os << "\t.ident\t\t\"stmc: 1.0.0, nwmarino\"\n" 
        << "\t.section\t.note.GNU-stack,\"\",@progbits\n";
 }
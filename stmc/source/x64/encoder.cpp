@@ -0,0 +1,1260 @@
+#include "core/logger.hpp"
+#include "core/thread_pool.hpp"
+#include "core/timer.hpp"
+#include "siir/cfg.hpp"
+#include "siir/constant.hpp"
+#include "siir/global.hpp"
+#include "siir/machine_function.hpp"
+#include "siir/machine_operand.hpp"
+#include "siir/machine_register.hpp"
+#include "siir/object_file.hpp"
+#include "x64/x64.hpp"
+
+#include <cstring>
+#include <elf.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace stm;
+using namespace stm::siir;
+using namespace stm::siir::x64;
+
+namespace {
+
+/// A reference from the code of a function to something whose address is not
+/// known until the object is laid out, resolved into a relocation.
+struct Fixup final {
+    enum Kind : u8 {
+        Call,       ///< PC-relative call to a named function.
+        Absolute,   ///< Absolute, sign-extended 32-bit address of a symbol.
+        Constant,   ///< PC-relative reference to a function constant.
+    };
+
+    Kind kind;
+
+    /// The offset of the 4-byte field to patch, before any branches are
+    /// placed, and the number of branches that come before it.
+    u32 offset;
+    u32 branches;
+
+    /// The symbol or constant pool entry that is referred to.
+    const char* symbol;
+    u32 constant;
+
+    /// The constant added to the address of the target.
+    i64 addend;
+};
+
+/// A jump to a basic block of the same function. Branches are kept out of
+/// the code of a function until their displacements are known, so that each
+/// one can be encoded with the shortest form that reaches its target.
+struct Branch final {
+    /// The offset of this branch in the code of its function, before any
+    /// branches are placed.
+    u32 offset;
+
+    /// The condition code of this branch, or JMP_CC if it is unconditional.
+    u8 cc;
+
+    /// The index of the target basic block in its function.
+    u32 target;
+
+    /// If true, this branch needs a 32-bit displacement to reach its target.
+    bool is_long = false;
+
+    static constexpr u8 JMP_CC = 0xFF;
+
+    /// Returns the number of bytes this branch takes up.
+    u32 size() const {
+        if (!is_long)
+            return 2;
+
+        return cc == JMP_CC ? 5 : 6;
+    }
+};
+
+/// A single encoded function, as it is placed into the object.
+struct EncodedFunction final {
+    /// The final machine code of the function.
+    std::vector<u8> code = {};
+
+    /// The unresolved references of the function, with their offsets final.
+    std::vector<Fixup> fixups = {};
+};
+
+/// The register, memory or immediate form of an instruction operand, as it
+/// is encoded into the ModRM byte and the bytes that follow it.
+struct RM final {
+    enum Kind : u8 {
+        Reg,        ///< A register, |reg|.
+        Base,       ///< Memory at |disp| from the base register |reg|.
+        Constant,   ///< A function constant, relative to %rip.
+        Symbol,     ///< Memory at the absolute address of |symbol|.
+    };
+
+    Kind kind;
+    u8 reg = 0;
+    i32 disp = 0;
+    u32 constant = 0;
+    const char* symbol = nullptr;
+
+    bool is_reg() const { return kind == Reg; }
+};
+
+/// Returns true if |value| can be sign-extended from 8 bits.
+static bool fits_i8(i64 value) { return value >= -128 && value <= 127; }
+
+/// Returns true if |value| can be sign-extended from 32 bits.
+static bool fits_i32(i64 value) {
+    return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+/// Returns |value| truncated to |size| bytes, then sign-extended back. This
+/// matches how assemblers treat immediates of instructions narrower than 64
+/// bits, i.e. `addl $0xffffffff` is the same as `addl $-1`.
+static i64 truncate(i64 value, u32 size) {
+    switch (size) {
+    case 1:
+        return static_cast<i8>(value);
+    case 2:
+        return static_cast<i16>(value);
+    case 4:
+        return static_cast<i32>(value);
+    default:
+        return value;
+    }
+}
+
+/// Returns the hardware encoding of the physical register |reg|.
+static u8 hw_encoding(x64::Register reg) {
+    switch (reg) {
+    case RAX: return 0;
+    case RCX: return 1;
+    case RDX: return 2;
+    case RBX: return 3;
+    case RSP: return 4;
+    case RBP: return 5;
+    case RSI: return 6;
+    case RDI: return 7;
+    case R8:  return 8;
+    case R9:  return 9;
+    case R10: return 10;
+    case R11: return 11;
+    case R12: return 12;
+    case R13: return 13;
+    case R14: return 14;
+    case R15: return 15;
+    default:
+        if (reg >= XMM0 && reg <= XMM15)
+            return reg - XMM0;
+
+        Logger::fatal("cannot encode register: '" + to_string(reg) + "'");
+    }
+}
+
+/// Returns the condition code of the conditional opcode |opc|, as it is
+/// encoded into Jcc and SETcc instructions.
+static u8 condition_code(x64::Opcode opc) {
+    switch (opc) {
+    case JB: case SETB:     return 0x2;
+    case JAE: case SETAE:   return 0x3;
+    case JE: case SETE:
+    case JZ: case SETZ:     return 0x4;
+    case JNE: case SETNE:
+    case JNZ: case SETNZ:   return 0x5;
+    case JBE: case SETBE:   return 0x6;
+    case JA: case SETA:     return 0x7;
+    case JL: case SETL:     return 0xC;
+    case JGE: case SETGE:   return 0xD;
+    case JLE: case SETLE:   return 0xE;
+    case JG: case SETG:     return 0xF;
+    default:
+        Logger::fatal("opcode is not conditional: '" + to_string(opc) + "'");
+    }
+}
+
+/// Returns the operand size in bytes of the sized opcode |opc|, given that
+/// |first| is the 8-bit opcode of its family.
+static u32 family_size(x64::Opcode opc, x64::Opcode first) {
+    return 1u << (opc - first);
+}
+
+/// Append the |size| low bytes of |value| to |bytes|.
+static void put(std::vector<u8>& bytes, u64 value, u32 size) {
+    for (u32 idx = 0; idx != size; ++idx)
+        bytes.push_back(static_cast<u8>(value >> (idx * 8)));
+}
+
+/// The multi-byte no-op instructions recommended for padding, indexed by
+/// their length.
+static const u8 gNops[10][9] = {
+    {},
+    { 0x90 },
+    { 0x66, 0x90 },
+    { 0x0F, 0x1F, 0x00 },
+    { 0x0F, 0x1F, 0x40, 0x00 },
+    { 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+    { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+    { 0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00 },
+    { 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+};
+
+/// Pad |bytes| with no-ops up to a multiple of |align| bytes.
+static void pad_with_nops(std::vector<u8>& bytes, u32 align) {
+    u32 count = (align - bytes.size() % align) % align;
+    while (count) {
+        u32 len = std::min(count, 9u);
+        bytes.insert(bytes.end(), gNops[len], gNops[len] + len);
+        count -= len;
+    }
+}
+
+/// Encodes the instructions of a single machine function.
+class FunctionEncoder final {
+    const MachineFunction& m_function;
+    EncodedFunction& m_out;
+
+    /// The code of the function, less any branches.
+    std::vector<u8> m_code = {};
+    std::vector<Branch> m_branches = {};
+    std::vector<Fixup> m_fixups = {};
+
+    /// The offset of each basic block in |m_code|, and the number of branches
+    /// that come before it.
+    std::vector<std::pair<u32, u32>> m_blocks = {};
+
+    /// The index of each basic block in the function.
+    std::unordered_map<const MachineBasicBlock*, u32> m_block_indices = {};
+
+    /// Returns the physical register that the register operand |MO| was
+    /// allocated to.
+    x64::Register get_reg(const MachineOperand& MO) const {
+        MachineRegister reg = MO.get_reg();
+        if (reg.is_virtual())
+            reg = m_function.get_register_info().vregs.at(reg.id()).alloc;
+
+        return static_cast<x64::Register>(reg.id());
+    }
+
+    /// Returns true if |MO| is a register operand allocated to an SSE
+    /// register.
+    bool is_xmm(const MachineOperand& MO) const {
+        return MO.is_reg() && get_class(get_reg(MO)) == FloatingPoint;
+    }
+
+    /// Returns the base register of the memory operand |MO|.
+    x64::Register get_base(const MachineOperand& MO) const {
+        MachineRegister reg = MO.get_mem_base();
+        if (reg.is_virtual())
+            reg = m_function.get_register_info().vregs.at(reg.id()).alloc;
+
+        return static_cast<x64::Register>(reg.id());
+    }
+
+    /// Returns the encodable form of the register or memory operand |MO|.
+    RM as_rm(const MachineOperand& MO) const {
+        switch (MO.kind()) {
+        case MachineOperand::MO_Register:
+            return { RM::Reg, hw_encoding(get_reg(MO)) };
+
+        case MachineOperand::MO_Memory:
+            return { RM::Base, hw_encoding(get_base(MO)),
+                static_cast<i32>(MO.get_mem_disp()) };
+
+        case MachineOperand::MO_StackIdx: {
+            const FunctionStackEntry& slot =
+                m_function.get_stack_info().entries.at(MO.get_stack_index());
+            return { RM::Base, hw_encoding(RBP),
+                -slot.offset - static_cast<i32>(slot.size) };
+        }
+
+        case MachineOperand::MO_ConstantIdx: {
+            RM rm = { RM::Constant };
+            rm.constant = MO.get_constant_index();
+            return rm;
+        }
+
+        case MachineOperand::MO_Symbol: {
+            RM rm = { RM::Symbol };
+            rm.symbol = MO.get_symbol();
+            return rm;
+        }
+
+        default:
+            Logger::fatal("unsupported x64 operand in function '" +
+                m_function.get_name() + "'");
+        }
+    }
+
+    /// Returns true if |MO| can be used as the register or memory operand of
+    /// an instruction.
+    static bool is_rm(const MachineOperand& MO) {
+        return MO.is_reg() || MO.is_mem() || MO.is_stack_index() ||
+            MO.is_constant_index() || MO.is_symbol();
+    }
+
+    __attribute__((noreturn))
+    void unsupported(const MachineInst& MI) const {
+        Logger::fatal("cannot encode x64 instruction '" +
+            to_string(static_cast<x64::Opcode>(MI.opcode())) +
+            "' in function '" + m_function.get_name() + "'");
+    }
+
+    /// Encode an instruction with the opcode bytes |opc| and the ModRM
+    /// operands |reg| and |rm|, followed by an immediate of |imm_size| bytes.
+    ///
+    /// |prefix| is a mandatory or operand-size prefix if non-zero, |w| sets
+    /// REX.W, and |byte_regs| marks that register operands are 8-bit, so that
+    /// %spl, %bpl, %sil and %dil get the REX prefix they need.
+    void encode(u8 prefix, bool w, std::initializer_list<u8> opc, u8 reg,
+                const RM& rm, u32 imm_size = 0, i64 imm = 0,
+                bool byte_regs = false) {
+        if (prefix)
+            m_code.push_back(prefix);
+
+        u8 rex = (w << 3) | ((reg >> 3) << 2);
+        if (rm.kind == RM::Reg || rm.kind == RM::Base)
+            rex |= rm.reg >> 3;
+
+        bool needs_rex = rex != 0;
+        if (byte_regs) {
+            needs_rex |= reg >= 4 && reg <= 7;
+            needs_rex |= rm.is_reg() && rm.reg >= 4 && rm.reg <= 7;
+        }
+
+        if (needs_rex)
+            m_code.push_back(0x40 | rex);
+
+        m_code.insert(m_code.end(), opc.begin(), opc.end());
+
+        const u8 reg_bits = (reg & 7) << 3;
+        switch (rm.kind) {
+        case RM::Reg:
+            m_code.push_back(0xC0 | reg_bits | (rm.reg & 7));
+            break;
+
+        case RM::Base: {
+            const u8 base = rm.reg & 7;
+            u8 mod;
+            if (rm.disp == 0 && base != 5)
+                mod = 0x00;
+            else if (fits_i8(rm.disp))
+                mod = 0x40;
+            else
+                mod = 0x80;
+
+            if (base == 4) {
+                // %rsp and %r12 can only be a base by way of a SIB byte.
+                m_code.push_back(mod | reg_bits | 0x04);
+                m_code.push_back(0x24);
+            } else {
+                m_code.push_back(mod | reg_bits | base);
+            }
+
+            if (mod == 0x40)
+                put(m_code, rm.disp, 1);
+            else if (mod == 0x80)
+                put(m_code, rm.disp, 4);
+
+            break;
+        }
+
+        case RM::Constant:
+            m_code.push_back(reg_bits | 0x05);
+            m_fixups.push_back({ Fixup::Constant,
+                static_cast<u32>(m_code.size()),
+                static_cast<u32>(m_branches.size()), nullptr, rm.constant,
+                -4 - static_cast<i64>(imm_size) });
+            put(m_code, 0, 4);
+            break;
+
+        case RM::Symbol:
+            m_code.push_back(reg_bits | 0x04);
+            m_code.push_back(0x25);
+            m_fixups.push_back({ Fixup::Absolute,
+                static_cast<u32>(m_code.size()),
+                static_cast<u32>(m_branches.size()), rm.symbol, 0, 0 });
+            put(m_code, 0, 4);
+            break;
+        }
+
+        put(m_code, imm, imm_size);
+    }
+
+    /// Encode an instruction whose opcode |opc| has the register |reg| added
+    /// into its low bits, followed by an immediate of |imm_size| bytes.
+    void encode_plus_reg(u8 prefix, bool w, u8 opc, u8 reg, u32 imm_size = 0,
+                         i64 imm = 0, bool byte_reg = false) {
+        if (prefix)
+            m_code.push_back(prefix);
+
+        u8 rex = (w << 3) | (reg >> 3);
+        if (rex || (byte_reg && reg >= 4 && reg <= 7))
+            m_code.push_back(0x40 | rex);
+
+        m_code.push_back(opc + (reg & 7));
+        put(m_code, imm, imm_size);
+    }
+
+    /// Encode a `add`, `or`, `and`, `sub`, `xor` or `cmp` instruction, given
+    /// the opcode |base| of its family and its /digit |ext|.
+    void encode_alu(const MachineInst& MI, u8 base, u8 ext, u32 size) {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        const u8 prefix = size == 2 ? 0x66 : 0;
+        const bool w = size == 8;
+        const bool byte = size == 1;
+
+        if (src.is_imm() && is_rm(dst)) {
+            const RM rm = as_rm(dst);
+            const i64 imm = truncate(src.get_imm(), size);
+            const u32 imm_size = size == 2 ? 2 : 4;
+            if (!fits_i32(imm))
+                unsupported(MI);
+
+            if (byte && rm.is_reg() && rm.reg == 0) {
+                m_code.push_back(base + 4);
+                put(m_code, imm, 1);
+            } else if (byte) {
+                encode(0, false, { 0x80 }, ext, rm, 1, imm, true);
+            } else if (fits_i8(imm)) {
+                encode(prefix, w, { 0x83 }, ext, rm, 1, imm);
+            } else if (rm.is_reg() && rm.reg == 0) {
+                if (prefix)
+                    m_code.push_back(prefix);
+                if (w)
+                    m_code.push_back(0x48);
+
+                m_code.push_back(base + 5);
+                put(m_code, imm, imm_size);
+            } else {
+                encode(prefix, w, { 0x81 }, ext, rm, imm_size, imm);
+            }
+        } else if (src.is_reg() && is_rm(dst)) {
+            encode(prefix, w, { static_cast<u8>(base + (byte ? 0 : 1)) },
+                hw_encoding(get_reg(src)), as_rm(dst), 0, 0, byte);
+        } else if (is_rm(src) && dst.is_reg()) {
+            encode(prefix, w, { static_cast<u8>(base + (byte ? 2 : 3)) },
+                hw_encoding(get_reg(dst)), as_rm(src), 0, 0, byte);
+        } else {
+            unsupported(MI);
+        }
+    }
+
+    /// Encode a general-purpose `mov` instruction of |size| bytes.
+    void encode_mov(const MachineInst& MI, u32 size) {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        const u8 prefix = size == 2 ? 0x66 : 0;
+        const bool w = size == 8;
+        const bool byte = size == 1;
+
+        if (is_xmm(src) || is_xmm(dst)) {
+            // Moves between general-purpose and SSE registers are only
+            // possible with the whole 64 bits, i.e. `movq %xmm0, %rax`.
+            if (size != 8 || !src.is_reg() || !dst.is_reg())
+                unsupported(MI);
+
+            if (is_xmm(src) && !is_xmm(dst)) {
+                encode(0x66, true, { 0x0F, 0x7E }, hw_encoding(get_reg(src)),
+                    as_rm(dst));
+            } else if (is_xmm(dst) && !is_xmm(src)) {
+                encode(0x66, true, { 0x0F, 0x6E }, hw_encoding(get_reg(dst)),
+                    as_rm(src));
+            } else {
+                unsupported(MI);
+            }
+        } else if (src.is_imm() && dst.is_reg()) {
+            const u8 reg = hw_encoding(get_reg(dst));
+            const i64 imm = src.get_imm();
+            if (byte) {
+                encode_plus_reg(0, false, 0xB0, reg, 1, imm, true);
+            } else if (size == 8 && fits_i32(imm)) {
+                encode(0, true, { 0xC7 }, 0, as_rm(dst), 4, imm);
+            } else {
+                encode_plus_reg(prefix, w, 0xB8, reg, size, imm);
+            }
+        } else if (src.is_imm() && is_rm(dst)) {
+            const i64 imm = src.get_imm();
+            if (size == 8 && !fits_i32(imm))
+                unsupported(MI);
+
+            encode(prefix, w, { static_cast<u8>(byte ? 0xC6 : 0xC7) }, 0,
+                as_rm(dst), std::min(size, 4u), imm);
+        } else if (src.is_reg() && is_rm(dst)) {
+            encode(prefix, w, { static_cast<u8>(byte ? 0x88 : 0x89) },
+                hw_encoding(get_reg(src)), as_rm(dst), 0, 0, byte);
+        } else if (is_rm(src) && dst.is_reg()) {
+            encode(prefix, w, { static_cast<u8>(byte ? 0x8A : 0x8B) },
+                hw_encoding(get_reg(dst)), as_rm(src), 0, 0, byte);
+        } else {
+            unsupported(MI);
+        }
+    }
+
+    /// Encode a `not`, `neg`, `mul`, `imul`, `div` or `idiv` instruction with
+    /// a single operand, given its /digit |ext|.
+    void encode_unary(const MachineInst& MI, u8 ext, u32 size) {
+        if (MI.num_explicit_operands() != 1 || !is_rm(MI.get_operand(0)))
+            unsupported(MI);
+
+        encode(size == 2 ? 0x66 : 0, size == 8,
+            { static_cast<u8>(size == 1 ? 0xF6 : 0xF7) }, ext,
+            as_rm(MI.get_operand(0)), 0, 0, size == 1);
+    }
+
+    /// Encode a signed multiply of |size| bytes.
+    void encode_imul(const MachineInst& MI, u32 size) {
+        const u32 num_ops = MI.num_explicit_operands();
+        if (num_ops == 1)
+            return encode_unary(MI, 5, size);
+
+        if (size == 1)
+            unsupported(MI);
+
+        const u8 prefix = size == 2 ? 0x66 : 0;
+        const bool w = size == 8;
+        const MachineOperand& dst = MI.get_operand(num_ops - 1);
+        if (!dst.is_reg())
+            unsupported(MI);
+
+        const u8 reg = hw_encoding(get_reg(dst));
+        if (num_ops == 2 && is_rm(MI.get_operand(0))) {
+            encode(prefix, w, { 0x0F, 0xAF }, reg, as_rm(MI.get_operand(0)));
+            return;
+        }
+
+        // The immediate forms multiply some source by the immediate, which for
+        // the two operand form is the destination itself.
+        if (!MI.get_operand(0).is_imm())
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(1);
+        if (!is_rm(src) || num_ops > 3)
+            unsupported(MI);
+
+        const i64 imm = truncate(MI.get_operand(0).get_imm(), size);
+        if (fits_i8(imm)) {
+            encode(prefix, w, { 0x6B }, reg, as_rm(src), 1, imm);
+        } else if (fits_i32(imm)) {
+            encode(prefix, w, { 0x69 }, reg, as_rm(src), size == 2 ? 2 : 4,
+                imm);
+        } else {
+            unsupported(MI);
+        }
+    }
+
+    /// Encode a `shl`, `shr` or `sar` instruction, given its /digit |ext|.
+    void encode_shift(const MachineInst& MI, u8 ext, u32 size) {
+        if (MI.num_explicit_operands() != 2 || !is_rm(MI.get_operand(1)))
+            unsupported(MI);
+
+        const MachineOperand& amount = MI.get_operand(0);
+        const RM rm = as_rm(MI.get_operand(1));
+        const u8 prefix = size == 2 ? 0x66 : 0;
+        const bool w = size == 8;
+        const bool byte = size == 1;
+
+        if (amount.is_imm() && amount.get_imm() == 1) {
+            encode(prefix, w, { static_cast<u8>(byte ? 0xD0 : 0xD1) }, ext,
+                rm, 0, 0, byte);
+        } else if (amount.is_imm()) {
+            encode(prefix, w, { static_cast<u8>(byte ? 0xC0 : 0xC1) }, ext,
+                rm, 1, amount.get_imm(), byte);
+        } else if (amount.is_reg() && get_reg(amount) == RCX) {
+            encode(prefix, w, { static_cast<u8>(byte ? 0xD2 : 0xD3) }, ext,
+                rm, 0, 0, byte);
+        } else {
+            unsupported(MI);
+        }
+    }
+
+    /// Encode a sign or zero extending move, `movsx`, `movsxd` or `movzx`.
+    void encode_extend(const MachineInst& MI, bool sign) {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        if (!src.is_reg() || !dst.is_reg())
+            unsupported(MI);
+
+        const u32 src_size = src.get_subreg();
+        const u32 dst_size = dst.get_subreg();
+        const u8 prefix = dst_size == 2 ? 0x66 : 0;
+        const bool w = dst_size == 8;
+        const u8 reg = hw_encoding(get_reg(dst));
+        const RM rm = as_rm(src);
+
+        if (src_size == 1) {
+            encode(prefix, w, { 0x0F, static_cast<u8>(sign ? 0xBE : 0xB6) },
+                reg, rm, 0, 0, true);
+        } else if (src_size == 2) {
+            encode(prefix, w, { 0x0F, static_cast<u8>(sign ? 0xBF : 0xB7) },
+                reg, rm);
+        } else if (src_size == 4 && sign) {
+            encode(prefix, w, { 0x63 }, reg, rm);
+        } else {
+            unsupported(MI);
+        }
+    }
+
+    /// Encode a scalar or packed SSE instruction with the opcode |opc| that
+    /// takes the destination register in its ModRM reg field.
+    void encode_sse(const MachineInst& MI, u8 prefix, u8 opc) {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        if (!is_xmm(dst) || !is_rm(src) || (src.is_reg() && !is_xmm(src)))
+            unsupported(MI);
+
+        encode(prefix, false, { 0x0F, opc }, hw_encoding(get_reg(dst)),
+            as_rm(src));
+    }
+
+    /// Encode a SSE move, given the opcodes of its load and store forms.
+    void encode_sse_move(const MachineInst& MI, u8 prefix, u8 load,
+                         u8 store) {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        if (is_xmm(dst) && is_rm(src) && (!src.is_reg() || is_xmm(src))) {
+            encode(prefix, false, { 0x0F, load }, hw_encoding(get_reg(dst)),
+                as_rm(src));
+        } else if (is_xmm(src) && is_rm(dst) && !dst.is_reg()) {
+            encode(prefix, false, { 0x0F, store }, hw_encoding(get_reg(src)),
+                as_rm(dst));
+        } else {
+            unsupported(MI);
+        }
+    }
+
+    /// Encode a conversion from an integer to a scalar float.
+    void encode_cvtsi2f(const MachineInst& MI, u8 prefix) {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        if (!is_xmm(dst) || !is_rm(src) || is_xmm(src))
+            unsupported(MI);
+
+        const bool w = src.is_reg() && src.get_subreg() == 8;
+        encode(prefix, w, { 0x0F, 0x2A }, hw_encoding(get_reg(dst)),
+            as_rm(src));
+    }
+
+    /// Encode a conversion from a scalar float to an integer of |size| bytes.
+    void encode_cvtf2si(const MachineInst& MI, u8 prefix, u32 size) {
+        if (MI.num_explicit_operands() != 2 || size < 4)
+            unsupported(MI);
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        if (!dst.is_reg() || is_xmm(dst) || !is_rm(src) ||
+          (src.is_reg() && !is_xmm(src)))
+            unsupported(MI);
+
+        encode(prefix, size == 8, { 0x0F, 0x2D }, hw_encoding(get_reg(dst)),
+            as_rm(src));
+    }
+
+    /// Returns true if |MI| is a move between the same physical register,
+    /// which is not emitted at all.
+    bool is_redundant_move(const MachineInst& MI) const {
+        if (!is_move_opcode(static_cast<x64::Opcode>(MI.opcode())))
+            return false;
+
+        if (MI.num_operands() != 2)
+            return false;
+
+        const MachineOperand& src = MI.get_operand(0);
+        const MachineOperand& dst = MI.get_operand(1);
+        if (!src.is_reg() || !dst.is_reg())
+            return false;
+
+        return get_reg(src) == get_reg(dst) &&
+            src.get_subreg() == dst.get_subreg();
+    }
+
+    /// Returns the operand size of a generic `mov`, as decided by the size
+    /// of its register operands.
+    u32 get_generic_mov_size(const MachineInst& MI) const {
+        if (MI.num_explicit_operands() != 2)
+            unsupported(MI);
+
+        if (MI.get_operand(1).is_reg())
+            return MI.get_operand(1).get_subreg();
+        else if (MI.get_operand(0).is_reg())
+            return MI.get_operand(0).get_subreg();
+
+        unsupported(MI);
+    }
+
+    void encode_branch(const MachineInst& MI, u8 cc) {
+        if (MI.num_explicit_operands() != 1 || !MI.get_operand(0).is_mmb())
+            unsupported(MI);
+
+        m_branches.push_back({ static_cast<u32>(m_code.size()), cc,
+            m_block_indices.at(MI.get_operand(0).get_mmb()) });
+    }
+
+    void encode_instruction(const MachineInst& MI) {
+        if (is_redundant_move(MI))
+            return;
+
+        const x64::Opcode opc = static_cast<x64::Opcode>(MI.opcode());
+        switch (opc) {
+        case NOP:
+            m_code.push_back(0x90);
+            break;
+
+        case UD2:
+            m_code.insert(m_code.end(), { 0x0F, 0x0B });
+            break;
+
+        case CQO:
+            m_code.insert(m_code.end(), { 0x48, 0x99 });
+            break;
+
+        case JMP:
+            encode_branch(MI, Branch::JMP_CC);
+            break;
+
+        case JE: case JNE: case JZ: case JNZ:
+        case JL: case JLE: case JG: case JGE:
+        case JA: case JAE: case JB: case JBE:
+            encode_branch(MI, condition_code(opc));
+            break;
+
+        case CALL64: {
+            if (MI.num_explicit_operands() != 1 ||
+              !MI.get_operand(0).is_symbol())
+                unsupported(MI);
+
+            m_code.push_back(0xE8);
+            m_fixups.push_back({ Fixup::Call,
+                static_cast<u32>(m_code.size()),
+                static_cast<u32>(m_branches.size()),
+                MI.get_operand(0).get_symbol(), 0, -4 });
+            put(m_code, 0, 4);
+            break;
+        }
+
+        case RET64: {
+            // Inject the epilogue, as is done for assembly:
+            //  addq $align, %rsp; popq %rbp; retq
+            const i64 align = m_function.get_stack_info().alignment();
+            const RM rsp = { RM::Reg, hw_encoding(RSP) };
+            if (fits_i8(align))
+                encode(0, true, { 0x83 }, 0, rsp, 1, align);
+            else
+                encode(0, true, { 0x81 }, 0, rsp, 4, align);
+
+            m_code.insert(m_code.end(), { 0x5D, 0xC3 });
+            break;
+        }
+
+        case LEA32:
+        case LEA64: {
+            if (MI.num_explicit_operands() != 2 ||
+              !MI.get_operand(1).is_reg() || !is_rm(MI.get_operand(0)) ||
+              MI.get_operand(0).is_reg())
+                unsupported(MI);
+
+            encode(0, opc == LEA64, { 0x8D },
+                hw_encoding(get_reg(MI.get_operand(1))),
+                as_rm(MI.get_operand(0)));
+            break;
+        }
+
+        case PUSH64:
+        case POP64: {
+            const MachineOperand& MO = MI.get_operand(0);
+            if (MI.num_explicit_operands() != 1 || !MO.is_reg() || is_xmm(MO))
+                unsupported(MI);
+
+            encode_plus_reg(0, false, opc == PUSH64 ? 0x50 : 0x58,
+                hw_encoding(get_reg(MO)));
+            break;
+        }
+
+        case MOV:
+            encode_mov(MI, get_generic_mov_size(MI));
+            break;
+
+        case MOV8: case MOV16: case MOV32: case MOV64:
+            encode_mov(MI, family_size(opc, MOV8));
+            break;
+
+        case MOVABS: {
+            if (MI.num_explicit_operands() != 2 ||
+              !MI.get_operand(0).is_imm() || !MI.get_operand(1).is_reg())
+                unsupported(MI);
+
+            encode_plus_reg(0, true, 0xB8,
+                hw_encoding(get_reg(MI.get_operand(1))), 8,
+                MI.get_operand(0).get_imm());
+            break;
+        }
+
+        case ADD8: case ADD16: case ADD32: case ADD64:
+            encode_alu(MI, 0x00, 0, family_size(opc, ADD8));
+            break;
+
+        case OR8: case OR16: case OR32: case OR64:
+            encode_alu(MI, 0x08, 1, family_size(opc, OR8));
+            break;
+
+        case AND8: case AND16: case AND32: case AND64:
+            encode_alu(MI, 0x20, 4, family_size(opc, AND8));
+            break;
+
+        case SUB8: case SUB16: case SUB32: case SUB64:
+            encode_alu(MI, 0x28, 5, family_size(opc, SUB8));
+            break;
+
+        case XOR8: case XOR16: case XOR32: case XOR64:
+            encode_alu(MI, 0x30, 6, family_size(opc, XOR8));
+            break;
+
+        case CMP8: case CMP16: case CMP32: case CMP64:
+            encode_alu(MI, 0x38, 7, family_size(opc, CMP8));
+            break;
+
+        case NOT8: case NOT16: case NOT32: case NOT64:
+            encode_unary(MI, 2, family_size(opc, NOT8));
+            break;
+
+        case NEG8: case NEG16: case NEG32: case NEG64:
+            encode_unary(MI, 3, family_size(opc, NEG8));
+            break;
+
+        case MUL8: case MUL16: case MUL32: case MUL64:
+            encode_unary(MI, 4, family_size(opc, MUL8));
+            break;
+
+        case IMUL8: case IMUL16: case IMUL32: case IMUL64:
+            encode_imul(MI, family_size(opc, IMUL8));
+            break;
+
+        case DIV8: case DIV16: case DIV32: case DIV64:
+            encode_unary(MI, 6, family_size(opc, DIV8));
+            break;
+
+        case IDIV8: case IDIV16: case IDIV32: case IDIV64:
+            encode_unary(MI, 7, family_size(opc, IDIV8));
+            break;
+
+        case SHL8: case SHL16: case SHL32: case SHL64:
+            encode_shift(MI, 4, family_size(opc, SHL8));
+            break;
+
+        case SHR8: case SHR16: case SHR32: case SHR64:
+            encode_shift(MI, 5, family_size(opc, SHR8));
+            break;
+
+        case SAR8: case SAR16: case SAR32: case SAR64:
+            encode_shift(MI, 7, family_size(opc, SAR8));
+            break;
+
+        case MOVSX:
+        case MOVSXD:
+            encode_extend(MI, true);
+            break;
+
+        case MOVZX:
+            encode_extend(MI, false);
+            break;
+
+        case SETE: case SETNE: case SETZ: case SETNZ:
+        case SETL: case SETLE: case SETG: case SETGE:
+        case SETA: case SETAE: case SETB: case SETBE: {
+            if (MI.num_explicit_operands() != 1 || !is_rm(MI.get_operand(0)))
+                unsupported(MI);
+
+            encode(0, false,
+                { 0x0F, static_cast<u8>(0x90 | condition_code(opc)) }, 0,
+                as_rm(MI.get_operand(0)), 0, 0, true);
+            break;
+        }
+
+        case MOVSS:
+            encode_sse_move(MI, 0xF3, 0x10, 0x11);
+            break;
+        case MOVSD:
+            encode_sse_move(MI, 0xF2, 0x10, 0x11);
+            break;
+        case MOVAPS:
+            encode_sse_move(MI, 0, 0x28, 0x29);
+            break;
+        case MOVAPD:
+            encode_sse_move(MI, 0x66, 0x28, 0x29);
+            break;
+        case UCOMISS:
+            encode_sse(MI, 0, 0x2E);
+            break;
+        case UCOMISD:
+            encode_sse(MI, 0x66, 0x2E);
+            break;
+        case ADDSS:
+            encode_sse(MI, 0xF3, 0x58);
+            break;
+        case ADDSD:
+            encode_sse(MI, 0xF2, 0x58);
+            break;
+        case SUBSS:
+            encode_sse(MI, 0xF3, 0x5C);
+            break;
+        case SUBSD:
+            encode_sse(MI, 0xF2, 0x5C);
+            break;
+        case MULSS:
+            encode_sse(MI, 0xF3, 0x59);
+            break;
+        case MULSD:
+            encode_sse(MI, 0xF2, 0x59);
+            break;
+        case DIVSS:
+            encode_sse(MI, 0xF3, 0x5E);
+            break;
+        case DIVSD:
+            encode_sse(MI, 0xF2, 0x5E);
+            break;
+        case ANDPS:
+            encode_sse(MI, 0, 0x54);
+            break;
+        case ANDPD:
+            encode_sse(MI, 0x66, 0x54);
+            break;
+        case ORPS:
+            encode_sse(MI, 0, 0x56);
+            break;
+        case ORPD:
+            encode_sse(MI, 0x66, 0x56);
+            break;
+        case XORPS:
+            encode_sse(MI, 0, 0x57);
+            break;
+        case XORPD:
+            encode_sse(MI, 0x66, 0x57);
+            break;
+        case CVTSS2SD:
+            encode_sse(MI, 0xF3, 0x5A);
+            break;
+        case CVTSD2SS:
+            encode_sse(MI, 0xF2, 0x5A);
+            break;
+        case CVTSI2SS:
+            encode_cvtsi2f(MI, 0xF3);
+            break;
+        case CVTSI2SD:
+            encode_cvtsi2f(MI, 0xF2);
+            break;
+
+        // These are emitted as `cvtss2si` and `cvtsd2si` in assembly, so they
+        // are encoded the same way to keep both outputs alike.
+        case CVTTSS2SI8: case CVTTSS2SI16:
+        case CVTTSS2SI32: case CVTTSS2SI64:
+            encode_cvtf2si(MI, 0xF3, family_size(opc, CVTTSS2SI8));
+            break;
+        case CVTTSD2SI8: case CVTTSD2SI16:
+        case CVTTSD2SI32: case CVTTSD2SI64:
+            encode_cvtf2si(MI, 0xF2, family_size(opc, CVTTSD2SI8));
+            break;
+
+        default:
+            unsupported(MI);
+        }
+    }
+
+    /// Choose the form of each branch, and then place them into the code of
+    /// the function.
+    void relax_branches() {
+        // Every branch starts out short. A branch is made long when its target
+        // is out of reach of a short one, which can only ever push other
+        // targets further away, so this stops once no branch changes.
+        std::vector<u32> before(m_branches.size() + 1, 0);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+
+            for (u32 idx = 0, e = m_branches.size(); idx != e; ++idx)
+                before[idx + 1] = before[idx] + m_branches[idx].size();
+
+            for (u32 idx = 0, e = m_branches.size(); idx != e; ++idx) {
+                Branch& branch = m_branches[idx];
+                if (branch.is_long)
+                    continue;
+
+                const auto& [ offset, branches ] = m_blocks[branch.target];
+                const i64 target = offset + before[branches];
+                const i64 next = branch.offset + before[idx + 1];
+                if (!fits_i8(target - next)) {
+                    branch.is_long = true;
+                    changed = true;
+                }
+            }
+        }
+
+        std::vector<u8>& code = m_out.code;
+        code.reserve(m_code.size() + before.back());
+
+        u32 copied = 0;
+        for (u32 idx = 0, e = m_branches.size(); idx != e; ++idx) {
+            const Branch& branch = m_branches[idx];
+            code.insert(code.end(), m_code.begin() + copied,
+                m_code.begin() + branch.offset);
+            copied = branch.offset;
+
+            const auto& [ offset, branches ] = m_blocks[branch.target];
+            const i64 target = offset + before[branches];
+            const i64 disp = target - (branch.offset + before[idx + 1]);
+
+            if (!branch.is_long) {
+                code.push_back(branch.cc == Branch::JMP_CC
+                    ? 0xEB : 0x70 | branch.cc);
+                put(code, disp, 1);
+            } else if (branch.cc == Branch::JMP_CC) {
+                code.push_back(0xE9);
+                put(code, disp, 4);
+            } else {
+                code.push_back(0x0F);
+                code.push_back(0x80 | branch.cc);
+                put(code, disp, 4);
+            }
+        }
+
+        code.insert(code.end(), m_code.begin() + copied, m_code.end());
+
+        for (Fixup& fixup : m_fixups) {
+            fixup.offset += before[fixup.branches];
+            m_out.fixups.push_back(fixup);
+        }
+    }
+
+public:
+    FunctionEncoder(const MachineFunction& function, EncodedFunction& out)
+        : m_function(function), m_out(out) {}
+
+    FunctionEncoder(const FunctionEncoder&) = delete;
+    FunctionEncoder& operator = (const FunctionEncoder&) = delete;
+
+    void run() {
+        u32 num_blocks = 0;
+        for (const auto* MBB = m_function.front(); MBB; MBB = MBB->next())
+            m_block_indices.emplace(MBB, num_blocks++);
+
+        m_blocks.reserve(num_blocks);
+
+        // Emit the prologue: pushq %rbp; movq %rsp, %rbp; subq $align, %rsp
+        const i64 align = m_function.get_stack_info().alignment();
+        const RM rsp = { RM::Reg, hw_encoding(RSP) };
+        m_code.insert(m_code.end(), { 0x55, 0x48, 0x89, 0xE5 });
+        if (fits_i8(align))
+            encode(0, true, { 0x83 }, 5, rsp, 1, align);
+        else
+            encode(0, true, { 0x81 }, 5, rsp, 4, align);
+
+        for (const auto* MBB = m_function.front(); MBB; MBB = MBB->next()) {
+            m_blocks.emplace_back(m_code.size(), m_branches.size());
+
+            for (const auto& MI : MBB->insts())
+                encode_instruction(MI);
+        }
+
+        relax_branches();
+    }
+};
+
+/// Append the bytes of |constant| to |bytes|, as they would be laid out in
+/// memory on |target|.
+static void emit_constant(std::vector<u8>& bytes, const Target& target,
+                          const Constant* constant) {
+    const u32 size = target.get_type_size(constant->get_type());
+
+    if (auto CI = dyn_cast<ConstantInt>(constant)) {
+        put(bytes, CI->get_value(), size);
+    } else if (auto CFP = dyn_cast<ConstantFP>(constant)) {
+        switch (size) {
+        case 4: {
+            u32 bits;
+            f32 value = CFP->get_value();
+            std::memcpy(&bits, &value, sizeof(bits));
+            put(bytes, bits, 4);
+            break;
+        }
+
+        case 8: {
+            u64 bits;
+            f64 value = CFP->get_value();
+            std::memcpy(&bits, &value, sizeof(bits));
+            put(bytes, bits, 8);
+            break;
+        }
+
+        default:
+            assert(false && "unsupported SSE floating point size!");
+        }
+    } else if (isa<ConstantNull>(constant)) {
+        put(bytes, 0, 8);
+    } else if (auto CS = dyn_cast<ConstantString>(constant)) {
+        const std::string& value = CS->get_value();
+        bytes.insert(bytes.end(), value.begin(), value.end());
+        bytes.push_back('\0');
+    } else {
+        Logger::fatal("cannot emit constant of unsupported kind to object");
+    }
+}
+
+} // namespace
+
+void X64ObjectWriter::run(ObjectFile& file) const {
+    STM_TIME_SCOPE("object emission");
+
+    const Target& target = *m_obj.get_target();
+    file.set_machine(EM_X86_64);
+
+    const u32 text = file.add_section(
+        ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16);
+    const u32 data = file.add_section(
+        ".data", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 1);
+    const u32 rodata = file.add_section(
+        ".rodata", SHT_PROGBITS, SHF_ALLOC, 1);
+    const u32 comment = file.add_section(
+        ".comment", SHT_PROGBITS, SHF_MERGE | SHF_STRINGS, 1, 1);
+    file.add_section(".note.GNU-stack", SHT_PROGBITS, 0, 1);
+
+    for (const auto& global : m_obj.get_graph()->globals()) {
+        const Type* type = global->get_initializer()->get_type();
+        const u32 section = global->is_read_only() ? rodata : data;
+        ObjectSection& sect = file.sections()[section];
+        sect.align_to(target.get_type_align(type));
+
+        file.define_symbol(
+            file.get_symbol(global->get_name()),
+            section,
+            sect.data.size(),
+            target.get_type_size(type),
+            STT_OBJECT,
+            global->get_linkage() == Global::LINKAGE_EXTERNAL
+                ? STB_GLOBAL : STB_LOCAL);
+        emit_constant(sect.data, target, global->get_initializer());
+    }
+
+    // Functions are encoded into buffers of their own, possibly at the same
+    // time, and then placed in the same order as they are written out as
+    // assembly.
+    std::vector<const MachineFunction*> functions;
+    functions.reserve(m_obj.functions().size());
+    for (const auto& [name, function] : m_obj.functions())
+        functions.push_back(function);
+
+    std::vector<EncodedFunction> encoded(functions.size());
+    auto encode = [&](u32 idx) {
+        STM_TIME_SCOPE("function", functions[idx]->get_name());
+        FunctionEncoder encoder { *functions[idx], encoded[idx] };
+        encoder.run();
+    };
+
+    if (m_pool) {
+        m_pool->parallel_for(functions.size(), encode);
+    } else {
+        for (u32 idx = 0; idx != functions.size(); ++idx)
+            encode(idx);
+    }
+
+    // Lay out the constant pool of each function after any read-only globals.
+    std::vector<std::vector<u64>> constants(functions.size());
+    ObjectSection& rodata_sect = file.sections()[rodata];
+    for (u32 idx = 0, e = functions.size(); idx != e; ++idx) {
+        const FunctionConstantPool& pool = functions[idx]->get_constant_pool();
+        for (const FunctionConstantPoolEntry& entry : pool.entries) {
+            rodata_sect.align_to(std::max(entry.align, 1u));
+            constants[idx].push_back(rodata_sect.data.size());
+            emit_constant(rodata_sect.data, target, entry.constant);
+        }
+    }
+
+    ObjectSection& text_sect = file.sections()[text];
+    std::vector<u64> offsets(functions.size());
+    for (u32 idx = 0, e = functions.size(); idx != e; ++idx) {
+        const MachineFunction* function = functions[idx];
+        pad_with_nops(text_sect.data, 16);
+        offsets[idx] = text_sect.data.size();
+
+        file.define_symbol(
+            file.get_symbol(function->get_name()),
+            text,
+            offsets[idx],
+            encoded[idx].code.size(),
+            STT_FUNC,
+            function->get_function()->get_linkage() ==
+                Function::LINKAGE_EXTERNAL ? STB_GLOBAL : STB_LOCAL);
+
+        text_sect.data.insert(text_sect.data.end(),
+            encoded[idx].code.begin(), encoded[idx].code.end());
+    }
+
+    // Now that every function and constant has been placed, the references
+    // between them are turned into relocations.
+    const u32 rodata_sym = file.get_section_symbol(rodata);
+    for (u32 idx = 0, e = functions.size(); idx != e; ++idx) {
+        for (const Fixup& fixup : encoded[idx].fixups) {
+            ObjectRelocation reloc;
+            reloc.offset = offsets[idx] + fixup.offset;
+
+            switch (fixup.kind) {
+            case Fixup::Call: {
+                reloc.symbol = file.get_symbol(fixup.symbol);
+                reloc.type = R_X86_64_PLT32;
+                reloc.addend = fixup.addend;
+
+                // Calls to internal functions can't be interposed, so their
+                // displacement is already known.
+                const ObjectSymbol& callee = file.symbols()[reloc.symbol];
+                if (callee.section == text && callee.binding == STB_LOCAL) {
+                    const i64 disp = callee.value + reloc.addend -
+                        reloc.offset;
+                    std::memcpy(&text_sect.data[reloc.offset], &disp, 4);
+                    continue;
+                }
+
+                break;
+            }
+
+            case Fixup::Absolute:
+                reloc.symbol = file.get_symbol(fixup.symbol);
+                reloc.type = R_X86_64_32S;
+                reloc.addend = fixup.addend;
+                break;
+
+            case Fixup::Constant:
+                reloc.symbol = rodata_sym;
+                reloc.type = R_X86_64_PC32;
+                reloc.addend = constants[idx].at(fixup.constant) +
+                    fixup.addend;
+                break;
+            }
+
+            text_sect.relocs.push_back(reloc);
+        }
+    }
+
+    const std::string ident = "stmc: 1.0.0, nwmarino";
+    std::vector<u8>& comment_data = file.sections()[comment].data;
+    comment_data.push_back('\0');
+    comment_data.insert(comment_data.end(), ident.begin(), ident.end());
+    comment_data.push_back('\0');
+}
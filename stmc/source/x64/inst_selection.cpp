@@ -1,3 +1,4 @@
+#include "core/timer.hpp"
 #include "siir/basicblock.hpp"
 #include "siir/constant.hpp"
 #include "siir/function.hpp"
@@ -144,9 +145,11 @@ static x64::Opcode negate_setcc(x64::Opcode setcc) {
 }
 
 void X64InstSelection::run() {
+    STM_TIME_SCOPE("select", m_function->get_name());
+
     FunctionStackInfo& frame = m_function->get_stack_info();
     u32 stack_index = 0, stack_offset = 0;
-    for (const auto& [name, local] : m_function->get_function()->locals()) {
+    for (auto local : m_function->get_function()->locals()) {
         FunctionStackEntry entry;
         entry.offset = stack_offset;
 
@@ -670,7 +673,7 @@ x64::Opcode X64InstSelection::get_setcc_op(siir::Opcode opc) const {
 }
 
 MachineOperand X64InstSelection::as_operand(const Value* value) {
-    if (auto CI = dynamic_cast<const ConstantInt*>(value)) {
+    if (auto CI = dyn_cast<ConstantInt>(value)) {
         MachineOperand reg = MachineOperand::create_reg(
             scratch(GeneralPurpose), get_subreg(value->get_type()), true);
 
@@ -680,7 +683,7 @@ MachineOperand X64InstSelection::as_operand(const Value* value) {
 
         reg.set_is_use();
         return reg;
-    } else if (auto CFP = dynamic_cast<const ConstantFP*>(value)) {
+    } else if (auto CFP = dyn_cast<ConstantFP>(value)) {
         MachineOperand reg = MachineOperand::create_reg(
             scratch(FloatingPoint), 0, true);
         u32 cidx = m_function->get_constant_pool().get_or_create_constant(
@@ -692,7 +695,7 @@ MachineOperand X64InstSelection::as_operand(const Value* value) {
 
         reg.set_is_use();
         return reg;
-    } else if (auto CN = dynamic_cast<const ConstantNull*>(value)) {
+    } else if (auto CN = dyn_cast<ConstantNull>(value)) {
         MachineOperand reg = MachineOperand::create_reg(
             scratch(GeneralPurpose), 8, true);
 
@@ -702,20 +705,20 @@ MachineOperand X64InstSelection::as_operand(const Value* value) {
 
         reg.set_is_use();
         return reg;
-    } else if (auto CBA = dynamic_cast<const BlockAddress*>(value)) {
+    } else if (auto CBA = dyn_cast<BlockAddress>(value)) {
         // TODO: Rewrite to accomodate for possible positional changes in 
         // machine blocks.
         return MachineOperand::create_block(
             m_function->at(CBA->get_block()->get_number()));
-    } else if (auto CGL = dynamic_cast<const Global*>(value)) {
+    } else if (auto CGL = dyn_cast<Global>(value)) {
         return MachineOperand::create_symbol(CGL->get_name().c_str());
-    } else if (auto ARG = dynamic_cast<const Argument*>(value)) {
+    } else if (auto ARG = dyn_cast<Argument>(value)) {
         return as_call_argument(ARG, ARG->get_number());
-    } else if (auto FN = dynamic_cast<const Function*>(value)) {
+    } else if (auto FN = dyn_cast<Function>(value)) {
         return MachineOperand::create_symbol(FN->get_name().c_str());
-    } else if (auto LCL = dynamic_cast<const Local*>(value)) {
+    } else if (auto LCL = dyn_cast<Local>(value)) {
         return MachineOperand::create_stack_index(m_stack_indices.at(LCL));
-    } else if (auto IN = dynamic_cast<const Instruction*>(value)) {
+    } else if (auto IN = dyn_cast<Instruction>(value)) {
         /// TODO: Remove with instruction selection completion, without this,
         /// opcodes that are not yet implemented won't ever produce a virtual
         /// register mapping.
@@ -1011,7 +1014,7 @@ void X64InstSelection::select_load_store(const Instruction* inst) {
         if (src.get_mem_base().is_physical()) {
             src.set_is_use(true);
 
-            if (dynamic_cast<const Argument*>(inst->get_operand(0)))
+            if (isa<Argument>(inst->get_operand(0)))
                 src.set_is_kill(true);
         }
     }
@@ -1020,7 +1023,7 @@ void X64InstSelection::select_load_store(const Instruction* inst) {
         if (src.is_reg() && src.get_reg().is_physical()) {
             src.set_is_use(true);
 
-            if (dynamic_cast<const Argument*>(inst->get_operand(0)))
+            if (isa<Argument>(inst->get_operand(0)))
                 src.set_is_kill(true);
         } else if (src.is_symbol() || src.is_mem() || src.is_stack_index() || src.is_constant_index()) {
             // Both the store source and destination are memory references, so
@@ -1072,7 +1075,7 @@ void X64InstSelection::select_access_ptr(const Instruction* inst) {
         src_type)->get_pointee();
 
     x64::Opcode opc;
-    if (dynamic_cast<const Local*>(src_value)) {
+    if (isa<Local>(src_value)) {
         opc = x64::LEA64;
     } else {
         opc = get_move_op(src_type);
@@ -1081,7 +1084,7 @@ void X64InstSelection::select_access_ptr(const Instruction* inst) {
     emit(opc, { src, dst });
 
     i64 offset;
-    if (auto constant = dynamic_cast<const ConstantInt*>(inst->get_operand(1))) {
+    if (auto constant = dyn_cast<ConstantInt>(inst->get_operand(1))) {
         if (pointee->is_struct_type()) {
             offset = m_target.get_field_offset(
                 static_cast<const StructType*>(pointee), 
@@ -1142,7 +1145,7 @@ void X64InstSelection::select_branch_if(const Instruction* inst) {
     assert(condition->get_type()->is_integer_type(1) &&
         "BranchIfInstr condition type is not 'i1'!");
 
-    const auto* instr = dynamic_cast<const Instruction*>(condition);
+    const auto* instr = dyn_cast<Instruction>(condition);
     if (instr && instr->is_comparison() && is_deferred(instr)) {
         x64::Opcode jcc = get_jcc_op(instr->opcode());
         MachineOperand lhs = as_operand(instr->get_operand(0));
@@ -1187,8 +1190,7 @@ void X64InstSelection::select_phi(const Instruction* inst) {
         // copies, the implementation probably won't hold up.
 
         const Value* operand = inst->get_operand(i);
-        const PhiOperand* phi_op = dynamic_cast<const PhiOperand*>(operand);
-        assert(phi_op && "unexpected phi operand");
+        const PhiOperand* phi_op = cast<PhiOperand>(operand);
 
         const Value* incoming = phi_op->get_value();
         const BasicBlock* pred = phi_op->get_pred();
@@ -1238,7 +1240,7 @@ void X64InstSelection::select_call(const Instruction* inst) {
         "cannot call a function with more than 6 arguments!");
     
     const Value* first_oper = inst->get_operand(0);
-    if (const auto* iasm = dynamic_cast<const InlineAsm*>(first_oper)) {
+    if (const auto* iasm = dyn_cast<InlineAsm>(first_oper)) {
         // TODO: Implement inline assembly selection.
         return;
     }
@@ -1256,7 +1258,7 @@ void X64InstSelection::select_call(const Instruction* inst) {
         regs.push_back(dst.get_reg());
 
         x64::Opcode opc;
-        if (dynamic_cast<const Local*>(arg)) {
+        if (isa<Local>(arg)) {
             opc = x64::LEA64;
         } else {
             opc = get_move_op(arg->get_type());
@@ -1265,9 +1267,7 @@ void X64InstSelection::select_call(const Instruction* inst) {
         emit(opc, { src, dst });
     }
 
-    const Function* callee = dynamic_cast<const Function*>(first_oper);
-    assert(callee && 
-        "CallInstr first operand is not a function or inline assembly!");
+    const Function* callee = cast<Function>(first_oper);
 
     MachineInst& call = emit(x64::CALL64)
         .add_symbol(callee->get_name());
@@ -1693,7 +1693,7 @@ void X64InstSelection::select_fp_to_int_cvt(const Instruction* inst) {
 void X64InstSelection::select_ptr_to_int_cvt(const Instruction* inst) {
     const Value* src = inst->get_operand(0);
     x64::Opcode opc;
-    if (dynamic_cast<const Local*>(src)) {
+    if (isa<Local>(src)) {
         opc = x64::LEA64;
     } else {
         opc = get_move_op(src->get_type());
@@ -1713,7 +1713,7 @@ void X64InstSelection::select_int_to_ptr_cvt(const Instruction* inst) {
 void X64InstSelection::select_type_reinterpret(const Instruction* inst) {
     const Value* src = inst->get_operand(0);
     x64::Opcode opc;
-    if (dynamic_cast<const Local*>(src)) {
+    if (isa<Local>(src)) {
         opc = x64::LEA64;
     } else {
         opc = get_move_op(src->get_type());
@@ -1730,7 +1730,7 @@ void X64InstSelection::select_comparison(const Instruction* inst) {
         // we defer this instruction until later (at the location of the
         // branch) so that we can skip a set and subsequent comparison.
         const User* user = inst->use_front()->get_user();
-        const auto* instr = dynamic_cast<const Instruction*>(user);
+        const auto* instr = dyn_cast<Instruction>(user);
         if (instr && instr->is_branch_if()) {
             defer(inst);
             return;
@@ -12,12 +12,19 @@
 #include <string>
 #include <unordered_map>
 
+namespace stm {
+
+class ThreadPool;
+
+} // namespace stm
+
 namespace stm::siir {
 
 class MachineOperand;
 class MachineInst;
 class MachineBasicBlock;
 class MachineFunction;
+class ObjectFile;
 
 namespace x64 {
 
@@ -232,9 +239,13 @@ public:
 /// Machine code pass to emit raw assembly for x64 machine objects.
 class X64AsmWriter final {
     const MachineObject& m_obj;
+    ThreadPool* m_pool;
 
 public:
-    X64AsmWriter(MachineObject& obj) : m_obj(obj) {}
+    /// Create a new writer for |obj|. If |pool| is provided, functions are
+    /// emitted on it concurrently.
+    X64AsmWriter(MachineObject& obj, ThreadPool* pool = nullptr) 
+        : m_obj(obj), m_pool(pool) {}
 
     X64AsmWriter(const X64AsmWriter&) = delete;
     X64AsmWriter& operator = (const X64AsmWriter&) = delete;
@@ -242,6 +253,27 @@ public:
     void run(std::ostream& os) const;
 };
 
+/// Machine code pass to encode x64 machine objects straight into relocatable
+/// objects, without going through an assembler.
+///
+/// The code and data of the object are laid out the same way as they are by
+/// X64AsmWriter, with the exception of call frame information.
+class X64ObjectWriter final {
+    const MachineObject& m_obj;
+    ThreadPool* m_pool;
+
+public:
+    /// Create a new writer for |obj|. If |pool| is provided, functions are
+    /// encoded on it concurrently.
+    X64ObjectWriter(MachineObject& obj, ThreadPool* pool = nullptr)
+        : m_obj(obj), m_pool(pool) {}
+
+    X64ObjectWriter(const X64ObjectWriter&) = delete;
+    X64ObjectWriter& operator = (const X64ObjectWriter&) = delete;
+
+    void run(ObjectFile& file) const;
+};
+
 /// Returns true if the opcode |opc| is considered a call instruction.
 bool is_call_opcode(x64::Opcode opc);
 
@@ -0,0 +1,142 @@
+#include "siir/object_file.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <elf.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace stm {
+
+namespace test {
+
+class DriverTest : public ::testing::Test {
+protected:
+    fs::path m_dir;
+
+    void SetUp() override {
+        m_dir = fs::temp_directory_path() / ("stmc-driver-test-" +
+            std::to_string(::getpid()));
+        fs::remove_all(m_dir);
+        fs::create_directories(m_dir);
+    }
+
+    void TearDown() override { fs::remove_all(m_dir); }
+
+    /// Write |src| out to the file |path| under the test directory.
+    void write(const fs::path& path, const std::string& src) {
+        fs::create_directories((m_dir / path).parent_path());
+        std::ofstream file(m_dir / path, std::ios::binary);
+        file << src;
+    }
+
+    /// Run |command| from the directory |dir| under the test directory, and
+    /// return its exit status, or -1 if it did not exit normally. If |output|
+    /// is not null, the standard error of the command is stored in it.
+    i32 run(const fs::path& dir, const std::string& command,
+            std::string* output = nullptr) {
+        const fs::path log = m_dir / "stderr.log";
+        const std::string line = "cd '" + (m_dir / dir).string() + "' && " +
+            command + " >/dev/null 2>'" + log.string() + "'";
+        const i32 status = std::system(line.c_str());
+        if (output) {
+            std::ifstream file(log, std::ios::binary);
+            output->assign(std::istreambuf_iterator<char>(file), {});
+        }
+
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    /// Returns the contents of the file |path| under the test directory.
+    std::string read(const fs::path& path) {
+        std::ifstream file(m_dir / path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(file), {} };
+    }
+
+    /// Write a stand-in for the runtime to std/rt.o under the directory |dir|,
+    /// which calls main and exits with its result.
+    void write_runtime(const fs::path& dir) {
+        siir::ObjectFile rt { "rt" };
+        rt.set_machine(EM_X86_64);
+        const u32 text = rt.add_section(
+            ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16);
+        rt.sections()[text].data = {
+            0xE8, 0, 0, 0, 0,               // call main
+            0x48, 0x89, 0xC7,               // movq %rax, %rdi
+            0xB8, 0x3C, 0, 0, 0,            // movl $60, %eax
+            0x0F, 0x05,                     // syscall
+        };
+
+        rt.sections()[text].relocs = {
+            { 1, rt.get_symbol("main"), R_X86_64_PLT32, -4 },
+        };
+
+        rt.define_symbol(
+            rt.get_symbol("_start"), text, 0, 15, STT_FUNC, STB_GLOBAL);
+
+        fs::create_directories(m_dir / dir / "std");
+        std::ofstream file(m_dir / dir / "std" / "rt.o", std::ios::binary);
+        rt.write(file);
+    }
+};
+
+TEST_F(DriverTest, use_module_compiled_elsewhere) {
+    write("lib/m.stm",
+        "$public\n"
+        "twice :: (x: s64) -> s64 { ret x * 2; }\n");
+    write("lib/app.stm",
+        "use \"m\";\n"
+        "main :: (argc: s64, argv: **char) -> s64 { ret twice(21); }\n");
+
+    write_runtime("work");
+
+    // The module is compiled from another directory than its source, and its
+    // outputs should still land beside the source, where uses look for them.
+    const std::string stmc = STMC_BINARY;
+    ASSERT_EQ(run("work", stmc + " -c -S ../lib/m.stm"), 0);
+    EXPECT_TRUE(fs::exists(m_dir / "lib" / "m.stmi"));
+    EXPECT_TRUE(fs::exists(m_dir / "lib" / "m.stm.o"));
+    EXPECT_TRUE(fs::exists(m_dir / "lib" / "m.stm.s"));
+    EXPECT_FALSE(fs::exists(m_dir / "work" / "m.stmi"));
+    EXPECT_FALSE(fs::exists(m_dir / "work" / "m.stm.o"));
+    EXPECT_FALSE(fs::exists(m_dir / "work" / "m.stm.s"));
+
+    // The use is then resolved through the interface of the module alone, and
+    // its object is linked in.
+    ASSERT_EQ(run("work", stmc + " -o app ../lib/app.stm"), 0);
+    ASSERT_TRUE(fs::exists(m_dir / "work" / "app"));
+    EXPECT_EQ(run("work", "./app"), 42);
+}
+
+TEST_F(DriverTest, cache_hit_links_same_executable) {
+    write("work/app.stm",
+        "main :: (argc: s64, argv: **char) -> s64 { ret 7; }\n");
+    write_runtime("work");
+
+    // The first build misses the cache and stores the object of the unit, and
+    // the second links the stored object instead of compiling it again.
+    const std::string stmc = STMC_BINARY;
+    const std::string build = stmc + " -t -cache-dir cache";
+    std::string log;
+    ASSERT_EQ(run("work", build + " -o first app.stm", &log), 0);
+    EXPECT_NE(log.find("cache: 0 hits, 1 misses"), std::string::npos) << log;
+    ASSERT_EQ(run("work", build + " -o second app.stm", &log), 0);
+    EXPECT_NE(log.find("cache: 1 hits, 0 misses"), std::string::npos) << log;
+
+    const std::string first = read("work/first");
+    ASSERT_FALSE(first.empty());
+    EXPECT_TRUE(read("work/second") == first) << "executables differ";
+    EXPECT_EQ(run("work", "./first"), 7);
+    EXPECT_EQ(run("work", "./second"), 7);
+}
+
+} // namespace test
+
+} // namespace stm
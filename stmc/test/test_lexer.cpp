@@ -1,8 +1,14 @@
 #include "core/lexer.hpp"
+#include "types/source_manager.hpp"
 #include "types/token.hpp"
 
 #include <gtest/gtest.h>
 
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <fstream>
+
 namespace stm {
 
 namespace test {
@@ -21,6 +27,29 @@ TEST_F(LexerTest, lex_identifier) {
     EXPECT_EQ(lexer.last().kind, TOKEN_KIND_END_OF_FILE);
 }
 
+TEST_F(LexerTest, lex_identifier_symbol) {
+    InputFile file { "test" };
+    Lexer lexer { file, "alpha beta alpha if" };
+
+    lexer.lex();
+    Symbol alpha = lexer.last().symbol;
+    EXPECT_FALSE(alpha.empty());
+    EXPECT_EQ(alpha.str(), "alpha");
+
+    lexer.lex();
+    Symbol beta = lexer.last().symbol;
+    EXPECT_NE(alpha, beta);
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().symbol, alpha);
+    EXPECT_EQ(lexer.last().symbol.id(), alpha.id());
+
+    // Keywords are classified by kind and are not interned.
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_IF);
+    EXPECT_TRUE(lexer.last().symbol.empty());
+}
+
 TEST_F(LexerTest, lex_identifier_many) {
     InputFile file { "test" };
     Lexer lexer { file, "one_ _two" };
@@ -37,6 +66,31 @@ TEST_F(LexerTest, lex_identifier_many) {
     EXPECT_EQ(lexer.last().kind, TOKEN_KIND_END_OF_FILE);
 }
 
+TEST_F(LexerTest, lex_keywords) {
+    InputFile file { "test" };
+    Lexer lexer { file, "__asm__ break cast continue else enum false if let "
+        "mut null private public ret sizeof struct true use volatile while" };
+
+    for (u32 kind = TOKEN_KIND_FIRST_KEYWORD; kind <= TOKEN_KIND_LAST_KEYWORD; 
+      ++kind) {
+        lexer.lex();
+        EXPECT_EQ(lexer.last().kind, kind);
+        EXPECT_EQ(lexer.last().value, 
+            token_kind_to_string(static_cast<TokenKind>(kind)));
+    }
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_END_OF_FILE);
+}
+
+TEST_F(LexerTest, lex_keyword_near_misses) {
+    InputFile file { "test" };
+    Lexer lexer { file, "i rett whil use_ lets Struct __asm" };
+
+    while (lexer.lex().kind != TOKEN_KIND_END_OF_FILE)
+        EXPECT_EQ(lexer.last().kind, TOKEN_KIND_IDENTIFIER);
+}
+
 TEST_F(LexerTest, lex_literal_character) {
     InputFile file { "test" };
     Lexer lexer { file, "'a'" };
@@ -73,6 +127,145 @@ TEST_F(LexerTest, lex_literal_string_escape_sequence) {
     EXPECT_EQ(lexer.last().value, "hey\nbye\t");
 }
 
+TEST_F(LexerTest, lex_literal_string_escape_sequence_octal) {
+    InputFile file { "test" };
+    Lexer lexer { file, "\"x\\n\\101y\"" };
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_STRING);
+    EXPECT_EQ(lexer.last().value, "x\nAy");
+}
+
+TEST_F(LexerTest, lex_mapped_source_view) {
+    {
+        std::ofstream out { "lex_mapped_source_view.stm" };
+        out << "main \"hey!\"";
+    }
+
+    InputFile file { "lex_mapped_source_view.stm" };
+    Lexer lexer { file };
+    std::string_view source = file.source();
+
+    // Tokens without escape sequences should view the mapped source.
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_IDENTIFIER);
+    EXPECT_EQ(lexer.last().value, "main");
+    EXPECT_EQ(lexer.last().value.data(), source.data());
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_STRING);
+    EXPECT_EQ(lexer.last().value, "hey!");
+    EXPECT_EQ(lexer.last().value.data(), source.data() + 6);
+
+    std::remove("lex_mapped_source_view.stm");
+}
+
+TEST_F(LexerTest, lex_window_lookbehind) {
+    InputFile file { "test" };
+    Lexer lexer { file, "a b \"c\\t\" d e" };
+
+    for (u32 idx = 0; idx < 5; ++idx)
+        lexer.lex();
+
+    EXPECT_EQ(lexer.last().value, "e");
+    EXPECT_EQ(lexer.last(1).value, "d");
+    EXPECT_EQ(lexer.last(2).value, "c\t");
+    EXPECT_EQ(lexer.last(3).value, "b");
+}
+
+TEST_F(LexerTest, lex_long_runs) {
+    // Each run is longer than a vector so that the vectorized scanning paths
+    // and their scalar tails are both taken.
+    const std::string ident = "a_very_long_identifier_name_that_spans_vectors_0123";
+    const std::string space(70, ' ');
+    const std::string str = "\"a string body that spans many vectors\\t!\"";
+
+    InputFile file { "test" };
+    Lexer lexer { file, ident + space + "// " + space + "\n/*" + space + 
+        "*\n*/\t" + str + " 12345678901234567890123456789012345.75" };
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_IDENTIFIER);
+    EXPECT_EQ(lexer.last().value, ident);
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_STRING);
+    EXPECT_EQ(lexer.last().value, "a string body that spans many vectors\t!");
+    EXPECT_EQ(SourceManager::line(lexer.last().loc), 3);
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_FLOAT);
+    EXPECT_EQ(lexer.last().value, "12345678901234567890123456789012345.75");
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_END_OF_FILE);
+}
+
+TEST_F(LexerTest, lex_many_comments) {
+    std::string src;
+    for (u32 idx = 0; idx < 200000; ++idx)
+        src += "// comment\n";
+
+    InputFile file { "test" };
+    Lexer lexer { file, src + "end" };
+
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_IDENTIFIER);
+    EXPECT_EQ(SourceManager::line(lexer.last().loc), 200001);
+}
+
+TEST_F(LexerTest, lex_token_location) {
+    InputFile file { "test" };
+    Lexer lexer { file, "a :: b\n\t/* x\n */ c -> d" };
+
+    lexer.lex();
+    lexer.lex();
+    EXPECT_EQ(lexer.last().kind, TOKEN_KIND_PATH);
+    EXPECT_EQ(SourceManager::line(lexer.last().loc), 1);
+    EXPECT_EQ(SourceManager::column(lexer.last().loc), 3);
+
+    lexer.lex();
+    lexer.lex();
+    EXPECT_EQ(lexer.last().value, "c");
+    EXPECT_EQ(SourceManager::line(lexer.last().loc), 3);
+    EXPECT_EQ(SourceManager::column(lexer.last().loc), 5);
+    EXPECT_EQ(&SourceManager::file(lexer.last().loc), &file);
+    EXPECT_EQ(SourceManager::line_source(lexer.last().loc, 2), "\t/* x");
+
+    lexer.lex();
+    lexer.lex();
+    EXPECT_EQ(lexer.last().value, "d");
+    EXPECT_EQ(SourceManager::column(lexer.last().loc), 10);
+}
+
+TEST_F(LexerTest, lex_large_source_flat_memory) {
+    const std::string line = "foo :: (a: i64) -> i64 { ret a + 1; } // x\n";
+    const u32 lines = (8 << 20) / line.size();
+
+    std::string src;
+    src.reserve(line.size() * lines);
+    for (u32 idx = 0; idx < lines; ++idx)
+        src += line;
+
+    InputFile file { "test" };
+    file.overwrite(src);
+    Lexer lexer { file };
+
+    rusage before;
+    getrusage(RUSAGE_SELF, &before);
+
+    u64 count = 0;
+    while (lexer.lex().kind != TOKEN_KIND_END_OF_FILE)
+        count++;
+
+    rusage after;
+    getrusage(RUSAGE_SELF, &after);
+
+    // Over a million tokens are lexed, which the lexer should not hold onto.
+    EXPECT_GT(count, u64(1) << 20);
+    EXPECT_LT(after.ru_maxrss - before.ru_maxrss, 1024);
+}
+
 TEST_F(LexerTest, lex_literal_integer) {
     InputFile file { "test" };
     Lexer lexer { file, "1" };
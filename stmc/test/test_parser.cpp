@@ -1,5 +1,8 @@
+#include "core/logger.hpp"
+#include "core/thread_pool.hpp"
 #include "tree/decl.hpp"
 #include "tree/expr.hpp"
+#include "tree/interface.hpp"
 #include "tree/parser.hpp"
 #include "tree/root.hpp"
 #include "tree/rune.hpp"
@@ -8,6 +11,12 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace stm {
 
 namespace test {
@@ -28,7 +37,7 @@ TEST_F(ParserTest, parse_use_basic) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto use = dynamic_cast<UseDecl*>(decl);
+    auto use = dyn_cast<UseDecl>(decl);
     EXPECT_NE(use, nullptr);
     EXPECT_EQ(use->path(), "testing");
 }
@@ -47,7 +56,7 @@ TEST_F(ParserTest, parse_function_basic) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -55,7 +64,7 @@ TEST_F(ParserTest, parse_function_basic) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 0);
 }
@@ -74,7 +83,7 @@ TEST_F(ParserTest, parse_function_params) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 2);
@@ -104,28 +113,28 @@ TEST_F(ParserTest, parse_variable_local) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto decl_stmt = dynamic_cast<const DeclStmt*>(stmt);
+    auto decl_stmt = dyn_cast<DeclStmt>(stmt);
     EXPECT_NE(decl_stmt, nullptr);
 
     auto decl_stmt_decl = decl_stmt->get_decl();
     EXPECT_NE(decl_stmt_decl, nullptr);
     EXPECT_EQ(decl_stmt_decl->get_name(), "x");
 
-    auto var = dynamic_cast<const VariableDecl*>(decl_stmt_decl);
+    auto var = dyn_cast<VariableDecl>(decl_stmt_decl);
     EXPECT_NE(var, nullptr);
     EXPECT_EQ(var->get_type()->to_string(), "u32");
     EXPECT_FALSE(var->has_init());
@@ -145,28 +154,28 @@ TEST_F(ParserTest, parse_variable_local_with_init) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto decl_stmt = dynamic_cast<const DeclStmt*>(stmt);
+    auto decl_stmt = dyn_cast<DeclStmt>(stmt);
     EXPECT_NE(decl_stmt, nullptr);
 
     auto decl_stmt_decl = decl_stmt->get_decl();
     EXPECT_NE(decl_stmt_decl, nullptr);
     EXPECT_EQ(decl_stmt_decl->get_name(), "x");
 
-    auto var = dynamic_cast<const VariableDecl*>(decl_stmt_decl);
+    auto var = dyn_cast<VariableDecl>(decl_stmt_decl);
     EXPECT_NE(var, nullptr);
     EXPECT_EQ(var->get_type()->to_string(), "u32");
     EXPECT_TRUE(var->has_init());
@@ -174,7 +183,7 @@ TEST_F(ParserTest, parse_variable_local_with_init) {
     auto init = var->get_init();
     EXPECT_NE(init, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(init);
+    auto integer = dyn_cast<IntegerLiteral>(init);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 1);
 }
@@ -193,7 +202,7 @@ TEST_F(ParserTest, parse_struct) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
     
-    auto structure = dynamic_cast<const StructDecl*>(decl);
+    auto structure = dyn_cast<StructDecl>(decl);
     EXPECT_NE(structure, nullptr);
     EXPECT_EQ(structure->get_name(), "box");
     EXPECT_EQ(structure->num_fields(), 3);
@@ -233,7 +242,7 @@ TEST_F(ParserTest, parse_enum) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto enumeration = dynamic_cast<const EnumDecl*>(decl);
+    auto enumeration = dyn_cast<EnumDecl>(decl);
     EXPECT_NE(enumeration, nullptr);
     EXPECT_EQ(enumeration->get_name(), "colors");
     EXPECT_EQ(enumeration->get_type()->get_underlying()->to_string(), "i16");
@@ -276,21 +285,21 @@ TEST_F(ParserTest, parse_break_stmt) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto break_stmt = dynamic_cast<const BreakStmt*>(stmt);
+    auto break_stmt = dyn_cast<BreakStmt>(stmt);
     EXPECT_NE(break_stmt, nullptr);
 }
 
@@ -308,21 +317,21 @@ TEST_F(ParserTest, parse_continue_stmt) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto continue_stmt = dynamic_cast<const ContinueStmt*>(stmt);
+    auto continue_stmt = dyn_cast<ContinueStmt>(stmt);
     EXPECT_NE(continue_stmt, nullptr);
 }
 
@@ -340,35 +349,35 @@ TEST_F(ParserTest, parse_if_stmt) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto if_stmt = dynamic_cast<const IfStmt*>(stmt);
+    auto if_stmt = dyn_cast<IfStmt>(stmt);
     EXPECT_NE(if_stmt, nullptr);
     EXPECT_FALSE(if_stmt->has_else());
 
     auto if_cond = if_stmt->get_cond();
     EXPECT_NE(if_cond, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(if_cond);
+    auto integer = dyn_cast<IntegerLiteral>(if_cond);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 365);
 
     auto then_stmt = if_stmt->get_then();
     EXPECT_NE(then_stmt, nullptr);
 
-    auto block2 = dynamic_cast<const BlockStmt*>(then_stmt);
+    auto block2 = dyn_cast<BlockStmt>(then_stmt);
     EXPECT_NE(block2, nullptr);
     EXPECT_EQ(block2->size(), 0);
 }
@@ -387,42 +396,42 @@ TEST_F(ParserTest, parse_if_stmt_with_else) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto if_stmt = dynamic_cast<const IfStmt*>(stmt);
+    auto if_stmt = dyn_cast<IfStmt>(stmt);
     EXPECT_NE(if_stmt, nullptr);
     EXPECT_TRUE(if_stmt->has_else());
 
     auto if_cond = if_stmt->get_cond();
     EXPECT_NE(if_cond, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(if_cond);
+    auto integer = dyn_cast<IntegerLiteral>(if_cond);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 41);
 
     auto then_stmt = if_stmt->get_then();
     EXPECT_NE(then_stmt, nullptr);
 
-    auto block2 = dynamic_cast<const BlockStmt*>(then_stmt);
+    auto block2 = dyn_cast<BlockStmt>(then_stmt);
     EXPECT_NE(block2, nullptr);
     EXPECT_EQ(block2->size(), 0);
 
     auto else_stmt = if_stmt->get_else();
     EXPECT_NE(else_stmt, nullptr);
 
-    auto block3 = dynamic_cast<const BlockStmt*>(else_stmt);
+    auto block3 = dyn_cast<BlockStmt>(else_stmt);
     EXPECT_NE(block3, nullptr);
     EXPECT_EQ(block3->size(), 0);
 }
@@ -441,56 +450,56 @@ TEST_F(ParserTest, parse_if_stmt_with_else_if_else) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
 
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto if_stmt = dynamic_cast<const IfStmt*>(stmt);
+    auto if_stmt = dyn_cast<IfStmt>(stmt);
     EXPECT_NE(if_stmt, nullptr);
     EXPECT_TRUE(if_stmt->has_else());
 
     auto if_cond = if_stmt->get_cond();
     EXPECT_NE(if_cond, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(if_cond);
+    auto integer = dyn_cast<IntegerLiteral>(if_cond);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 0);
 
     auto then_stmt = if_stmt->get_then();
     EXPECT_NE(then_stmt, nullptr);
 
-    auto block2 = dynamic_cast<const BlockStmt*>(then_stmt);
+    auto block2 = dyn_cast<BlockStmt>(then_stmt);
     EXPECT_NE(block2, nullptr);
     EXPECT_EQ(block2->size(), 0);
 
     auto else_stmt = if_stmt->get_else();
     EXPECT_NE(else_stmt, nullptr);
 
-    auto if_stmt2 = dynamic_cast<const IfStmt*>(else_stmt);
+    auto if_stmt2 = dyn_cast<IfStmt>(else_stmt);
     EXPECT_NE(if_stmt2, nullptr);
     EXPECT_TRUE(if_stmt2->has_else());
     
     auto if_cond2 = if_stmt2->get_cond();
     EXPECT_NE(if_cond2, nullptr);
 
-    auto integer2 = dynamic_cast<const IntegerLiteral*>(if_cond2);
+    auto integer2 = dyn_cast<IntegerLiteral>(if_cond2);
     EXPECT_NE(integer2, nullptr);
     EXPECT_EQ(integer2->get_value(), 42);
 
     auto else_stmt2 = if_stmt2->get_else();
     EXPECT_NE(else_stmt2, nullptr);
 
-    auto block3 = dynamic_cast<const BlockStmt*>(else_stmt2);
+    auto block3 = dyn_cast<BlockStmt>(else_stmt2);
     EXPECT_NE(block3, nullptr);
     EXPECT_EQ(block3->size(), 0);
 }
@@ -509,7 +518,7 @@ TEST_F(ParserTest, parse_while_stmt) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -517,28 +526,28 @@ TEST_F(ParserTest, parse_while_stmt) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto while_stmt = dynamic_cast<const WhileStmt*>(stmt);
+    auto while_stmt = dyn_cast<WhileStmt>(stmt);
     EXPECT_NE(while_stmt, nullptr);
     EXPECT_TRUE(while_stmt->has_body());
 
     auto while_cond = while_stmt->get_cond();
     EXPECT_NE(while_cond, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(while_cond);
+    auto integer = dyn_cast<IntegerLiteral>(while_cond);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 77);
 
     auto while_body = while_stmt->get_body();
     EXPECT_NE(while_body, nullptr);
 
-    auto block2 = dynamic_cast<const BlockStmt*>(while_body);
+    auto block2 = dyn_cast<BlockStmt>(while_body);
     EXPECT_NE(block2, nullptr);
     EXPECT_EQ(block2->size(), 0);
 }
@@ -557,7 +566,7 @@ TEST_F(ParserTest, parse_return_basic) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -565,21 +574,21 @@ TEST_F(ParserTest, parse_return_basic) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto ret = dynamic_cast<RetStmt*>(stmt);
+    auto ret = dyn_cast<RetStmt>(stmt);
     EXPECT_NE(ret, nullptr);
     EXPECT_TRUE(ret->has_expr());
 
     auto val = ret->get_expr();
     EXPECT_NE(val, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(val);
+    auto integer = dyn_cast<IntegerLiteral>(val);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 42);
 }
@@ -598,7 +607,7 @@ TEST_F(ParserTest, parse_bool_literal) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -606,14 +615,14 @@ TEST_F(ParserTest, parse_bool_literal) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto boolean = dynamic_cast<const BoolLiteral*>(stmt);
+    auto boolean = dyn_cast<BoolLiteral>(stmt);
     EXPECT_NE(boolean, nullptr);
     EXPECT_EQ(boolean->get_value(), true);
 }
@@ -632,7 +641,7 @@ TEST_F(ParserTest, parse_float_literal) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -640,14 +649,14 @@ TEST_F(ParserTest, parse_float_literal) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto fp = dynamic_cast<const FloatLiteral*>(stmt);
+    auto fp = dyn_cast<FloatLiteral>(stmt);
     EXPECT_NE(fp, nullptr);
     EXPECT_EQ(fp->get_value(), 3.14);
 }
@@ -666,7 +675,7 @@ TEST_F(ParserTest, parse_char_literal) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -674,14 +683,14 @@ TEST_F(ParserTest, parse_char_literal) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto character = dynamic_cast<const CharLiteral*>(stmt);
+    auto character = dyn_cast<CharLiteral>(stmt);
     EXPECT_NE(character, nullptr);
     EXPECT_EQ(character->get_value(), 'z');
 }
@@ -700,7 +709,7 @@ TEST_F(ParserTest, parse_string_literal) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -708,14 +717,14 @@ TEST_F(ParserTest, parse_string_literal) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto string = dynamic_cast<const StringLiteral*>(stmt);
+    auto string = dyn_cast<StringLiteral>(stmt);
     EXPECT_NE(string, nullptr);
     EXPECT_EQ(string->get_value(), "abc");
 }
@@ -734,7 +743,7 @@ TEST_F(ParserTest, parse_null_literal) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -742,14 +751,14 @@ TEST_F(ParserTest, parse_null_literal) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto null = dynamic_cast<const NullLiteral*>(stmt);
+    auto null = dyn_cast<NullLiteral>(stmt);
     EXPECT_NE(null, nullptr);
 }
 
@@ -767,7 +776,7 @@ TEST_F(ParserTest, parse_binary_expr_basic) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -775,28 +784,28 @@ TEST_F(ParserTest, parse_binary_expr_basic) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto binary = dynamic_cast<const BinaryExpr*>(stmt);
+    auto binary = dyn_cast<BinaryExpr>(stmt);
     EXPECT_NE(binary, nullptr);
     EXPECT_EQ(binary->get_operator(), BinaryExpr::Operator::Add);
 
     auto lhs = binary->get_lhs();
     EXPECT_NE(lhs, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(lhs);
+    auto integer = dyn_cast<IntegerLiteral>(lhs);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 1);
 
     auto rhs = binary->get_rhs();
     EXPECT_NE(rhs, nullptr);
 
-    auto fp = dynamic_cast<const FloatLiteral*>(rhs);
+    auto fp = dyn_cast<FloatLiteral>(rhs);
     EXPECT_NE(fp, nullptr);
     EXPECT_EQ(fp->get_value(), 3.14);
 }
@@ -823,7 +832,7 @@ TEST_F(ParserTest, parse_unary_expr_prefix_basic) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -831,14 +840,14 @@ TEST_F(ParserTest, parse_unary_expr_prefix_basic) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto unary = dynamic_cast<const UnaryExpr*>(stmt);
+    auto unary = dyn_cast<UnaryExpr>(stmt);
     EXPECT_NE(unary, nullptr);
     EXPECT_EQ(unary->get_operator(), UnaryExpr::Operator::Dereference);
     EXPECT_TRUE(unary->is_prefix());
@@ -858,7 +867,7 @@ TEST_F(ParserTest, parse_unary_expr_postfix_basic) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -866,14 +875,14 @@ TEST_F(ParserTest, parse_unary_expr_postfix_basic) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto unary = dynamic_cast<const UnaryExpr*>(stmt);
+    auto unary = dyn_cast<UnaryExpr>(stmt);
     EXPECT_NE(unary, nullptr);
     EXPECT_EQ(unary->get_operator(), UnaryExpr::Operator::Increment);
     EXPECT_TRUE(unary->is_postfix());
@@ -893,7 +902,7 @@ TEST_F(ParserTest, parse_unary_expr_complex) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -901,14 +910,14 @@ TEST_F(ParserTest, parse_unary_expr_complex) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto unary = dynamic_cast<const UnaryExpr*>(stmt);
+    auto unary = dyn_cast<UnaryExpr>(stmt);
     EXPECT_NE(unary, nullptr);
     EXPECT_EQ(unary->get_operator(), UnaryExpr::Operator::Dereference);
     EXPECT_TRUE(unary->is_prefix());
@@ -916,7 +925,7 @@ TEST_F(ParserTest, parse_unary_expr_complex) {
     auto unary_expr = unary->get_expr();
     EXPECT_NE(unary_expr, nullptr);
 
-    auto unary2 = dynamic_cast<const UnaryExpr*>(unary_expr);
+    auto unary2 = dyn_cast<UnaryExpr>(unary_expr);
     EXPECT_NE(unary2, nullptr);
     EXPECT_EQ(unary2->get_operator(), UnaryExpr::Operator::Increment);
     EXPECT_TRUE(unary2->is_postfix());
@@ -936,7 +945,7 @@ TEST_F(ParserTest, parse_cast_expr) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -944,21 +953,21 @@ TEST_F(ParserTest, parse_cast_expr) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto cast = dynamic_cast<const CastExpr*>(stmt);
+    auto cast = dyn_cast<CastExpr>(stmt);
     EXPECT_NE(cast, nullptr);
     EXPECT_EQ(cast->get_type()->to_string(), "u32");
 
     auto cast_expr = cast->get_expr();
     EXPECT_NE(cast_expr, nullptr);
     
-    auto integer = dynamic_cast<const IntegerLiteral*>(cast_expr);
+    auto integer = dyn_cast<IntegerLiteral>(cast_expr);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 5);
 }
@@ -977,7 +986,7 @@ TEST_F(ParserTest, parse_paren_expr) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -985,20 +994,20 @@ TEST_F(ParserTest, parse_paren_expr) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto paren = dynamic_cast<const ParenExpr*>(stmt);
+    auto paren = dyn_cast<ParenExpr>(stmt);
     EXPECT_NE(paren, nullptr);
 
     auto paren_expr = paren->get_expr();
     EXPECT_NE(paren_expr, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(paren_expr);
+    auto integer = dyn_cast<IntegerLiteral>(paren_expr);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 5);
 }
@@ -1017,7 +1026,7 @@ TEST_F(ParserTest, parse_sizeof_expr) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -1025,14 +1034,14 @@ TEST_F(ParserTest, parse_sizeof_expr) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto size_of = dynamic_cast<const SizeofExpr*>(stmt);
+    auto size_of = dyn_cast<SizeofExpr>(stmt);
     EXPECT_NE(size_of, nullptr);
     EXPECT_EQ(size_of->get_target()->to_string(), "u32");
 }
@@ -1051,7 +1060,7 @@ TEST_F(ParserTest, parse_subscript_expr) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -1059,27 +1068,27 @@ TEST_F(ParserTest, parse_subscript_expr) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto subscript = dynamic_cast<const SubscriptExpr*>(stmt);
+    auto subscript = dyn_cast<SubscriptExpr>(stmt);
     EXPECT_NE(subscript, nullptr);
     
     auto base = subscript->get_base();
     EXPECT_NE(base, nullptr);
 
-    auto reference = dynamic_cast<const ReferenceExpr*>(base);
+    auto reference = dyn_cast<ReferenceExpr>(base);
     EXPECT_NE(reference, nullptr);
     EXPECT_EQ(reference->get_name(), "x");
 
     auto index = subscript->get_index();
     EXPECT_NE(index, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(index);
+    auto integer = dyn_cast<IntegerLiteral>(index);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 42);
 }
@@ -1098,7 +1107,7 @@ TEST_F(ParserTest, parse_member_expr) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -1106,21 +1115,21 @@ TEST_F(ParserTest, parse_member_expr) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto member = dynamic_cast<const MemberExpr*>(stmt);
+    auto member = dyn_cast<MemberExpr>(stmt);
     EXPECT_NE(member, nullptr);
     EXPECT_EQ(member->get_name(), "a");
 
     auto base = member->get_base();
     EXPECT_NE(base, nullptr);
 
-    auto ref = dynamic_cast<const ReferenceExpr*>(base);
+    auto ref = dyn_cast<ReferenceExpr>(base);
     EXPECT_NE(ref, nullptr);
     EXPECT_EQ(ref->get_name(), "x");
 }
@@ -1139,7 +1148,7 @@ TEST_F(ParserTest, parse_call_expr) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -1147,14 +1156,14 @@ TEST_F(ParserTest, parse_call_expr) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto call = dynamic_cast<const CallExpr*>(stmt);
+    auto call = dyn_cast<CallExpr>(stmt);
     EXPECT_NE(call, nullptr);
     EXPECT_EQ(call->get_name(), "foo");
     EXPECT_EQ(call->num_args(), 0);
@@ -1174,7 +1183,7 @@ TEST_F(ParserTest, parse_call_expr_with_args) {
     auto decl = root.decls()[0];
     EXPECT_NE(decl, nullptr);
 
-    auto function = dynamic_cast<FunctionDecl*>(decl);
+    auto function = dyn_cast<FunctionDecl>(decl);
     EXPECT_NE(function, nullptr);
     EXPECT_EQ(function->get_name(), "main");
     EXPECT_EQ(function->num_params(), 0);
@@ -1182,14 +1191,14 @@ TEST_F(ParserTest, parse_call_expr_with_args) {
     auto body = function->get_body();
     EXPECT_NE(body, nullptr);
 
-    auto block = dynamic_cast<const BlockStmt*>(body);
+    auto block = dyn_cast<BlockStmt>(body);
     EXPECT_NE(block, nullptr);
     EXPECT_EQ(block->size(), 1);
 
     auto stmt = block->get_stmts()[0];
     EXPECT_NE(stmt, nullptr);
 
-    auto call = dynamic_cast<const CallExpr*>(stmt);
+    auto call = dyn_cast<CallExpr>(stmt);
     EXPECT_NE(call, nullptr);
     EXPECT_EQ(call->get_name(), "foo");
     EXPECT_EQ(call->num_args(), 2);
@@ -1197,18 +1206,190 @@ TEST_F(ParserTest, parse_call_expr_with_args) {
     auto arg1 = call->get_args()[0];
     EXPECT_NE(arg1, nullptr);
 
-    auto integer = dynamic_cast<const IntegerLiteral*>(arg1);
+    auto integer = dyn_cast<IntegerLiteral>(arg1);
     EXPECT_NE(integer, nullptr);
     EXPECT_EQ(integer->get_value(), 1);
 
     auto arg2 = call->get_args()[1];
     EXPECT_NE(arg2, nullptr);
 
-    auto ref = dynamic_cast<const ReferenceExpr*>(arg2);
+    auto ref = dyn_cast<ReferenceExpr>(arg2);
     EXPECT_NE(ref, nullptr);
     EXPECT_EQ(ref->get_name(), "y");
 }
 
+TEST_F(ParserTest, parse_nodes_in_tree_arena) {
+    InputFile file { "test" };
+    file.overwrite("main :: () -> void { let x: i32 = 1; }");
+
+    TranslationUnit unit { file };
+    Parser parser { file };
+    parser.parse(unit);
+
+    // The global, function and body scopes, the function, its body, the
+    // variable and its declaration statement, and the initializer.
+    const Root& root = unit.get_root();
+    EXPECT_EQ(root.arena().objects(), 8);
+    EXPECT_GT(root.arena().bytes(), 0);
+}
+
+TEST_F(ParserTest, parse_child_lists_in_tree_arena) {
+    InputFile file { "test" };
+    file.overwrite(
+        "f :: (a: s64, b: s64) -> s64 { ret a; }\n"
+        "main :: (x: s64) -> s64 { let y: s64 = f(x, 2); ret y; }");
+
+    TranslationUnit unit { file };
+    Parser parser { file };
+    parser.parse(unit);
+
+    Root& root = unit.get_root();
+    ASSERT_EQ(root.num_decls(), 2);
+
+    // Lists from the tree share its allocator, and so its arena.
+    auto function = dyn_cast<FunctionDecl>(root.decls()[0]);
+    ASSERT_NE(function, nullptr);
+    EXPECT_EQ(function->num_params(), 2);
+    EXPECT_TRUE(function->get_params().get_allocator() ==
+        root.list<ParameterDecl*>().get_allocator());
+
+    auto main = dyn_cast<FunctionDecl>(root.decls()[1]);
+    ASSERT_NE(main, nullptr);
+    auto block = dyn_cast<BlockStmt>(main->get_body());
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(block->size(), 2);
+    EXPECT_TRUE(block->get_stmts().get_allocator() ==
+        root.list<Stmt*>().get_allocator());
+
+    auto decl = dyn_cast<DeclStmt>(block->get_stmts()[0]);
+    ASSERT_NE(decl, nullptr);
+    auto var = dyn_cast<VariableDecl>(decl->get_decl());
+    ASSERT_NE(var, nullptr);
+    auto call = dyn_cast<CallExpr>(var->get_init());
+    ASSERT_NE(call, nullptr);
+    EXPECT_EQ(call->num_args(), 2);
+    EXPECT_TRUE(call->get_args().get_allocator() ==
+        root.list<Expr*>().get_allocator());
+
+    // A copy of a list is made on the heap instead.
+    const ArenaVector<Expr*> args = call->get_args();
+    EXPECT_FALSE(args.get_allocator() == call->get_args().get_allocator());
+}
+
+TEST_F(ParserTest, parse_units_concurrently) {
+    const u32 count = 16;
+    std::vector<std::unique_ptr<InputFile>> files;
+    std::vector<std::unique_ptr<TranslationUnit>> units;
+    std::vector<Logger::Buffer> logs(count);
+
+    for (u32 idx = 0; idx != count; ++idx) {
+        files.push_back(std::make_unique<InputFile>("test"));
+        files.back()->overwrite(idx == 5 
+            ? "broken :: (" 
+            : "f" + std::to_string(idx) + " :: () -> s64 { ret 1; }");
+        units.push_back(std::make_unique<TranslationUnit>(*files.back()));
+    }
+
+    ThreadPool pool { 4 };
+    for (u32 idx = 0; idx != count; ++idx) {
+        pool.submit([&units, &logs, idx] {
+            Logger::capture(logs[idx], [&units, idx] {
+                Parser parser { units[idx]->get_file() };
+                parser.parse(*units[idx]);
+            });
+        });
+    }
+
+    pool.wait();
+
+    // Only the broken unit fails, and it does not stop any of the others.
+    for (u32 idx = 0; idx != count; ++idx) {
+        EXPECT_EQ(logs[idx].failed(), idx == 5);
+        if (idx == 5)
+            continue;
+
+        Root& root = units[idx]->get_root();
+        EXPECT_EQ(root.num_decls(), 1);
+        EXPECT_EQ(root.decls()[0]->get_name(), "f" + std::to_string(idx));
+    }
+}
+
+TEST_F(ParserTest, module_interface_round_trip) {
+    InputFile file { "test" };
+    file.overwrite(
+        "$public\n"
+        "Point :: struct { x: s64, y: *char }\n"
+        "$public\n"
+        "Color :: enum u8 { Red, Green = 5 }\n"
+        "$public\n"
+        "count :: s32 = 3;\n"
+        "$public\n"
+        "move :: (p: *Point, dx: s64) -> Color {\n"
+        "    ret Red;\n"
+        "}\n"
+        "hidden :: () -> void {}\n");
+
+    TranslationUnit unit { file };
+    Parser parser { file };
+    parser.parse(unit);
+    unit.get_root().validate();
+
+    const std::string path = (std::filesystem::temp_directory_path() / 
+        "stmc_test_interface.stmi").string();
+    {
+        std::ofstream os(path, std::ios::binary);
+        ModuleInterface::write(unit.get_root(), os);
+    }
+
+    InputFile module_file { path.c_str() };
+    Root root { module_file };
+    ModuleInterface::read(path, root);
+    std::filesystem::remove(path);
+
+    // Only the exports come back, and each is an export of the new tree.
+    ASSERT_EQ(root.num_decls(), 4);
+    EXPECT_EQ(root.exports().size(), 4);
+
+    auto structure = dyn_cast<StructDecl>(root.decls()[0]);
+    ASSERT_NE(structure, nullptr);
+    EXPECT_EQ(structure->get_name(), "Point");
+    EXPECT_TRUE(structure->has_decorator(Rune::Public));
+    ASSERT_EQ(structure->num_fields(), 2);
+    EXPECT_EQ(structure->get_fields()[1]->get_name(), "y");
+    EXPECT_EQ(structure->get_fields()[1]->get_parent(), structure);
+    EXPECT_EQ(structure->get_fields()[1]->get_type()->to_string(), "*char");
+
+    auto enumeration = dyn_cast<EnumDecl>(root.decls()[1]);
+    ASSERT_NE(enumeration, nullptr);
+    EXPECT_EQ(enumeration->get_name(), "Color");
+    EXPECT_TRUE(enumeration->get_type()->get_underlying()->is_unsigned_int());
+    ASSERT_EQ(enumeration->num_values(), 2);
+    EXPECT_EQ(enumeration->get_values()[1]->get_name(), "Green");
+    EXPECT_EQ(enumeration->get_values()[1]->get_value(), 5);
+    EXPECT_EQ(root.get_scope()->get("Green"), enumeration->get_values()[1]);
+
+    auto variable = dyn_cast<VariableDecl>(root.decls()[2]);
+    ASSERT_NE(variable, nullptr);
+    EXPECT_EQ(variable->get_name(), "count");
+    EXPECT_TRUE(variable->is_global());
+    EXPECT_FALSE(variable->has_init());
+    EXPECT_TRUE(variable->get_type()->is_signed_int());
+
+    auto function = dyn_cast<FunctionDecl>(root.decls()[3]);
+    ASSERT_NE(function, nullptr);
+    EXPECT_EQ(function->get_name(), "move");
+    EXPECT_FALSE(function->has_body());
+    EXPECT_TRUE(function->get_return_type()->is_enum());
+    EXPECT_EQ(function->get_return_type()->as_enum(), 
+        enumeration->get_type());
+    ASSERT_EQ(function->num_params(), 2);
+    EXPECT_EQ(function->get_param(0)->get_name(), "p");
+    EXPECT_EQ(function->get_param(0)->get_type()->as_pointer()->get_pointee(),
+        structure->get_type());
+    EXPECT_EQ(root.get_scope()->get("move"), function);
+    EXPECT_EQ(root.get_scope()->get("hidden"), nullptr);
+}
+
 } // namespace test
 
 } // namespace stm
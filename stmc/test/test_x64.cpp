@@ -1,10 +1,474 @@
+#include "core/thread_pool.hpp"
+#include "siir/cfg.hpp"
+#include "siir/linker.hpp"
+#include "siir/machine_analysis.hpp"
+#include "siir/machine_object.hpp"
+#include "siir/ssa_rewrite_pass.hpp"
+#include "siir/target.hpp"
+#include "siir/trivial_dce_pass.hpp"
+#include "tree/parser.hpp"
+#include "tree/root.hpp"
+#include "tree/visitor.hpp"
+#include "types/input_file.hpp"
+#include "types/options.hpp"
+#include "types/translation_unit.hpp"
+
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <elf.h>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace stm {
 
 namespace test {
 
-class X64Test : public ::testing::Test {};
+class X64Test : public ::testing::Test {
+protected:
+    /// Compile |src| down to SIIR, running the SIIR passes on |pool| if
+    /// |optimize| is set, and then hand the graph to |emit|.
+    void generate(const std::string& src, ThreadPool* pool, bool optimize,
+                  const std::function<void(siir::CFG&)>& emit) {
+        InputFile file { "test" };
+        file.overwrite(src);
+
+        TranslationUnit unit { file };
+        Parser parser { file };
+        parser.parse(unit);
+
+        Options opts {};
+        Root& root = unit.get_root();
+        root.validate();
+
+        SymbolAnalysis syma { opts, root };
+        root.accept(syma);
+
+        SemanticAnalysis sema { opts, root };
+        root.accept(sema);
+
+        siir::Target target { 
+            siir::Target::x64, siir::Target::SystemV, siir::Target::Linux 
+        };
+
+        siir::CFG graph { file, target };
+        Codegen cgn { opts, root, graph };
+        root.accept(cgn);
+
+        if (optimize) {
+            siir::SSARewritePass SSAR { graph, pool };
+            SSAR.run();
+
+            siir::TrivialDCEPass TDCE { graph, pool };
+            TDCE.run();
+        }
+
+        emit(graph);
+    }
+
+    /// Compile |src| down to x64 machine code, running the SIIR passes if
+    /// |optimize| is set and the backend on |pool| if it is provided, and
+    /// then hand the machine object to |emit|.
+    void lower(const std::string& src, ThreadPool* pool, bool optimize,
+               const std::function<void(siir::MachineObject&)>& emit) {
+        generate(src, pool, optimize, [&](siir::CFG& graph) {
+            siir::MachineObject obj { &graph, &graph.get_target() };
+            siir::CFGMachineAnalysis CMA { graph, pool };
+            CMA.run(obj);
+
+            siir::FunctionRegisterAnalysis FRA { obj, pool };
+            FRA.run();
+
+            emit(obj);
+        });
+    }
+
+    /// Compile |src| down to x64 assembly.
+    std::string compile(const std::string& src, ThreadPool* pool,
+                        bool optimize = false) {
+        std::ostringstream os;
+        lower(src, pool, optimize, [&](siir::MachineObject& obj) {
+            siir::MachineObjectAsmWriter writer { obj, pool };
+            writer.run(os);
+        });
+
+        return os.str();
+    }
+
+    /// Compile |src| down to a relocatable x64 object.
+    siir::ObjectFile encode(const std::string& src, ThreadPool* pool) {
+        siir::ObjectFile file { "test" };
+        lower(src, pool, false, [&](siir::MachineObject& obj) {
+            siir::MachineObjectWriter writer { obj, pool };
+            writer.run(file);
+        });
+
+        return file;
+    }
+};
+
+TEST_F(X64Test, emit_functions_concurrently) {
+    std::string src;
+    for (u32 idx = 0; idx != 64; ++idx) {
+        const std::string name = "f" + std::to_string(idx);
+        src += name + " :: (x: s64) -> s64 {\n"
+            "    let y: f64 = 1.5;\n"
+            "    if x > " + std::to_string(idx) + " { ret x * 2; }\n"
+            "    ret x + cast<s64>(y);\n"
+            "}\n";
+    }
+
+    const std::string serial = compile(src, nullptr);
+    
+    ThreadPool pool { 4 };
+    EXPECT_EQ(compile(src, &pool), serial);
+
+    // Each function numbers its labels by its own position in the object.
+    EXPECT_NE(serial.find(".LFE63:"), std::string::npos);
+    EXPECT_NE(serial.find(".LCPI63_0:"), std::string::npos);
+}
+
+TEST_F(X64Test, rewrite_functions_concurrently) {
+    std::string src;
+    for (u32 idx = 0; idx != 64; ++idx) {
+        const std::string name = "f" + std::to_string(idx);
+        src += name + " :: (x: s64) -> s64 {\n"
+            "    let y: mut s64 = x;\n"
+            "    let z: f64 = 2.5;\n"
+            "    if y < " + std::to_string(idx) + " { y = y * 3; }\n"
+            "    else { y = y + " + std::to_string(idx % 7) + "; }\n"
+            "    if y > 100 { y = y - cast<s64>(z); }\n"
+            "    ret y;\n"
+            "}\n";
+    }
+
+    const std::string serial = compile(src, nullptr, true);
+
+    // Locals are promoted, so loads of them should not survive.
+    EXPECT_EQ(serial.find("-8(%rbp)"), std::string::npos);
+
+    ThreadPool pool { 4 };
+    for (u32 run = 0; run != 4; ++run)
+        EXPECT_EQ(compile(src, &pool, true), serial);
+}
+
+TEST_F(X64Test, track_uses_through_rewrite) {
+    const std::string src =
+        "sum :: (n: s64) -> s64 {\n"
+        "    let total: mut s64 = 0;\n"
+        "    let i: mut s64 = 0;\n"
+        "    while i < n {\n"
+        "        if i > 3 { total = total + i; }\n"
+        "        else { total = total - 1; }\n"
+        "        i = i + 1;\n"
+        "    }\n"
+        "    ret total;\n"
+        "}\n";
+
+    generate(src, nullptr, true, [](siir::CFG& graph) {
+        // Count the operands that refer to each instruction, looking through
+        // the incoming edges of phi nodes.
+        std::unordered_map<const siir::Value*, u32> refs;
+        std::vector<siir::Instruction*> insts;
+        u32 phis = 0;
+        for (auto fn : graph.functions()) {
+            for (auto blk = fn->front(); blk; blk = blk->next()) {
+                for (auto inst = blk->front(); inst; inst = inst->next()) {
+                    insts.push_back(inst);
+                    phis += inst->is_phi();
+                    for (auto& op : inst->get_operand_list()) {
+                        const siir::Value* value = op.get_value();
+                        if (auto phi_op = dyn_cast<siir::PhiOperand>(value))
+                            value = phi_op->get_value();
+
+                        refs[value]++;
+                    }
+                }
+            }
+        }
+
+        // The loop carries both locals, so their phis should survive.
+        EXPECT_GE(phis, 2);
+
+        for (auto inst : insts) {
+            u32 count = 0;
+            for (auto use = inst->use_front(); use; use = use->next()) {
+                count++;
+                EXPECT_NE(use->get_user(), nullptr);
+            }
+
+            EXPECT_EQ(count, inst->num_uses());
+            EXPECT_EQ(count, refs[inst]);
+        }
+    });
+}
+
+TEST_F(X64Test, classify_values) {
+    const std::string src =
+        "limit :: s64 = 10;\n"
+        "twice :: (x: s64) -> s64 { ret x * 2; }\n"
+        "run :: () -> s64 {\n"
+        "    let acc: mut s64 = 0;\n"
+        "    if limit > 5 { acc = twice(limit); }\n"
+        "    else { acc = 1; }\n"
+        "    ret acc + 3;\n"
+        "}\n";
+
+    generate(src, nullptr, true, [](siir::CFG& graph) {
+        u32 phis = 0, calls = 0, globals = 0, ints = 0;
+        for (auto fn : graph.functions()) {
+            EXPECT_TRUE(isa<siir::Function>(fn));
+            EXPECT_FALSE(isa<siir::Constant>(fn));
+            for (auto blk = fn->front(); blk; blk = blk->next()) {
+                for (auto inst = blk->front(); inst; inst = inst->next()) {
+                    const siir::Value* value = inst;
+                    EXPECT_TRUE(isa<siir::Instruction>(value));
+                    EXPECT_TRUE(isa<siir::User>(value));
+                    EXPECT_EQ(dyn_cast<siir::Constant>(value), nullptr);
+
+                    for (auto& op : inst->get_operand_list()) {
+                        const siir::Value* opnd = op.get_value();
+                        if (inst->is_phi()) {
+                            phis++;
+                            opnd = cast<siir::PhiOperand>(opnd)->get_value();
+                        } else {
+                            EXPECT_FALSE(isa<siir::PhiOperand>(opnd));
+                        }
+
+                        if (auto global = dyn_cast<siir::Global>(opnd)) {
+                            globals++;
+                            EXPECT_TRUE(isa<siir::Constant>(global));
+                        } else if (isa<siir::ConstantInt>(opnd)) {
+                            ints++;
+                            EXPECT_TRUE(isa<siir::Constant>(opnd));
+                            EXPECT_TRUE(isa<siir::User>(opnd));
+                        } else if (dyn_cast<siir::Function>(opnd)) {
+                            calls++;
+                        }
+                    }
+                }
+            }
+        }
+
+        EXPECT_GE(phis, 2);
+        EXPECT_EQ(calls, 1);
+        EXPECT_GE(globals, 2);
+        EXPECT_GE(ints, 3);
+    });
+}
+
+TEST_F(X64Test, encode_object) {
+    std::string src =
+        "counter :: mut s64 = 7;\n"
+        "scale :: (x: f64) -> f64 {\n"
+        "    ret x * 2.5;\n"
+        "}\n"
+        "pick :: (x: s64, y: s64) -> s64 {\n"
+        "    if x < y {\n";
+
+    // Make the body big enough that the branch over it cannot be short.
+    for (u32 idx = 0; idx != 16; ++idx)
+        src += "        counter = counter * 3 + " + std::to_string(idx) + ";\n";
+
+    src += "    }\n"
+        "    ret counter;\n"
+        "}\n"
+        "$public\n"
+        "entry :: (x: s64) -> s64 {\n"
+        "    ret pick(x, 4) + cast<s64>(scale(1.0));\n"
+        "}\n";
+
+    const siir::ObjectFile serial = encode(src, nullptr);
+    const siir::ObjectSection& text = serial.sections().front();
+    EXPECT_EQ(text.name, ".text");
+
+    // Internal calls are resolved in place, so the only relocations left are
+    // for the global, which is loaded and stored by each statement and then
+    // loaded once more to return it, and for the two float constants.
+    u32 num_abs = 0, num_pcrel = 0;
+    for (const siir::ObjectRelocation& reloc : text.relocs) {
+        num_abs += reloc.type == R_X86_64_32S;
+        num_pcrel += reloc.type == R_X86_64_PC32;
+        EXPECT_NE(reloc.type, R_X86_64_PLT32);
+    }
+
+    EXPECT_EQ(num_abs, 33);
+    EXPECT_EQ(num_pcrel, 2);
+
+    const siir::ObjectSymbol* entry = nullptr;
+    const siir::ObjectSymbol* pick = nullptr;
+    for (const siir::ObjectSymbol& symbol : serial.symbols()) {
+        if (symbol.name == "entry")
+            entry = &symbol;
+        else if (symbol.name == "pick")
+            pick = &symbol;
+    }
+
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(pick, nullptr);
+    EXPECT_EQ(entry->binding, STB_GLOBAL);
+    EXPECT_EQ(pick->binding, STB_LOCAL);
+    EXPECT_EQ(entry->value % 16, 0);
+    EXPECT_EQ(pick->value % 16, 0);
+
+    // The jump over the body of the if statement was made long.
+    bool has_long_jump = false;
+    for (u64 idx = pick->value; idx != pick->value + pick->size; ++idx)
+        has_long_jump |= text.data[idx] == 0xE9;
+
+    EXPECT_TRUE(has_long_jump);
+
+    std::ostringstream os;
+    serial.write(os);
+    const std::string bytes = os.str();
+    ASSERT_GE(bytes.size(), sizeof(Elf64_Ehdr));
+    EXPECT_EQ(bytes.substr(0, 4), std::string(ELFMAG));
+
+    Elf64_Ehdr ehdr;
+    std::memcpy(&ehdr, bytes.data(), sizeof(ehdr));
+    EXPECT_EQ(ehdr.e_type, ET_REL);
+    EXPECT_EQ(ehdr.e_machine, EM_X86_64);
+
+    ThreadPool pool { 4 };
+    std::ostringstream pooled;
+    encode(src, &pool).write(pooled);
+    EXPECT_EQ(pooled.str(), bytes);
+}
+
+TEST_F(X64Test, link_executable) {
+    const std::string src =
+        "counter :: mut s64 = 7;\n"
+        "$public\n"
+        "entry :: (x: s64) -> s64 {\n"
+        "    counter = counter + x;\n"
+        "    ret counter;\n"
+        "}\n";
+
+    // Read the encoded object back, as the runtime object would be.
+    std::ostringstream encoded;
+    encode(src, nullptr).write(encoded);
+    const std::string bytes = encoded.str();
+    const siir::ObjectFile object = siir::ObjectFile::read(
+        "test", reinterpret_cast<const u8*>(bytes.data()), bytes.size());
+
+    ASSERT_FALSE(object.sections().empty());
+    EXPECT_EQ(object.sections().front().name, ".text");
+    EXPECT_FALSE(object.sections().front().relocs.empty());
+
+    // A stand-in for the runtime, which calls the entry function directly
+    // and then loads its address from the global offset table.
+    siir::ObjectFile start { "start" };
+    start.set_machine(EM_X86_64);
+    const u32 text = start.add_section(
+        ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16);
+    start.sections()[text].data = {
+        0xE8, 0, 0, 0, 0,               // call entry
+        0x48, 0x8B, 0x05, 0, 0, 0, 0,   // movq entry@GOTPCREL(%rip), %rax
+        0xC3,                           // ret
+    };
+
+    const u32 entry = start.get_symbol("entry");
+    start.sections()[text].relocs = {
+        { 1, entry, R_X86_64_PLT32, -4 },
+        { 8, entry, R_X86_64_REX_GOTPCRELX, -4 },
+    };
+
+    start.define_symbol(
+        start.get_symbol("_start"), text, 0, 13, STT_FUNC, STB_GLOBAL);
+
+    siir::Linker linker {};
+    linker.add(start);
+    linker.add(object);
+
+    std::ostringstream os;
+    linker.run(os);
+    const std::string exe = os.str();
+    ASSERT_GE(exe.size(), sizeof(Elf64_Ehdr));
+
+    Elf64_Ehdr ehdr;
+    std::memcpy(&ehdr, exe.data(), sizeof(ehdr));
+    EXPECT_EQ(exe.substr(0, 4), std::string(ELFMAG));
+    EXPECT_EQ(ehdr.e_type, ET_EXEC);
+    EXPECT_EQ(ehdr.e_machine, EM_X86_64);
+    ASSERT_GE(ehdr.e_entry, siir::Linker::BASE_ADDRESS);
+
+    // Segments are loaded at the same offset from the base as in the file.
+    auto at = [&](u64 address) -> const char* {
+        const u64 offset = address - siir::Linker::BASE_ADDRESS;
+        EXPECT_LT(offset, exe.size());
+        return exe.data() + offset;
+    };
+
+    i32 call_disp, got_disp;
+    std::memcpy(&call_disp, at(ehdr.e_entry + 1), 4);
+    std::memcpy(&got_disp, at(ehdr.e_entry + 8), 4);
+    const u64 target = ehdr.e_entry + 5 + call_disp;
+    const u64 got_entry = ehdr.e_entry + 12 + got_disp;
+
+    // The entry function is placed after the start function, and the global
+    // offset table entry holds its address.
+    u64 entry_address;
+    std::memcpy(&entry_address, at(got_entry), 8);
+    EXPECT_EQ(target % 16, 0);
+    EXPECT_GT(target, ehdr.e_entry);
+    EXPECT_EQ(entry_address, target);
+
+    u32 num_loads = 0;
+    for (u32 idx = 0; idx != ehdr.e_phnum; ++idx) {
+        Elf64_Phdr phdr;
+        std::memcpy(&phdr, exe.data() + ehdr.e_phoff + idx * sizeof(phdr),
+            sizeof(phdr));
+
+        num_loads += phdr.p_type == PT_LOAD;
+        EXPECT_EQ(phdr.p_vaddr % siir::Linker::PAGE_SIZE, 0);
+        if (phdr.p_flags & PF_X) {
+            EXPECT_GE(ehdr.e_entry, phdr.p_vaddr);
+            EXPECT_LT(target, phdr.p_vaddr + phdr.p_memsz);
+        }
+    }
+
+    EXPECT_EQ(num_loads, 3);
+}
+
+TEST_F(X64Test, link_drops_unloaded_sections) {
+    auto link = [](bool comment) {
+        siir::ObjectFile start { "start" };
+        start.set_machine(EM_X86_64);
+        const u32 text = start.add_section(
+            ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16);
+        start.sections()[text].data = {
+            0xB8, 0x3C, 0, 0, 0,            // movl $60, %eax
+            0x0F, 0x05,                     // syscall
+        };
+
+        start.define_symbol(
+            start.get_symbol("_start"), text, 0, 7, STT_FUNC, STB_GLOBAL);
+
+        // Neither section is loaded, so neither should change the image.
+        if (comment) {
+            const std::string str = "stmc";
+            const u32 idx = start.add_section(
+                ".comment", SHT_PROGBITS, SHF_MERGE | SHF_STRINGS, 1);
+            start.sections()[idx].data = { str.begin(), str.end() };
+            start.sections()[idx].data.push_back(0);
+            start.add_section(".note.GNU-stack", SHT_PROGBITS, 0, 1);
+        }
+
+        siir::Linker linker {};
+        linker.add(start);
+
+        std::ostringstream os;
+        linker.run(os);
+        return os.str();
+    };
+
+    const std::string plain = link(false);
+    ASSERT_GE(plain.size(), sizeof(Elf64_Ehdr));
+    EXPECT_EQ(link(true), plain);
+}
 
 } // namespace test
 